@@ -0,0 +1,83 @@
+/*
+ * batch_benchmark.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <thread>
+
+#include "bench.h"
+
+extern "C" {
+#include "bitp/batch.h"
+}
+
+// a variable-length record: 4-bit count, then count fields of 3 to 33 bits
+struct record {
+    unsigned n_fields;
+    uint8_t widths[15];
+    uint32_t vals[15];
+};
+
+static bitp_status_t pack(bitp_packer_t *packer, const void *msg, void *) {
+    const record *r = (const record *)msg;
+    bitp_packer_add_u8(packer, (uint8_t)r->n_fields, 4);
+    for (unsigned i = 0; i < r->n_fields; ++i) {
+        bitp_packer_add_u8(packer, r->widths[i] - 3, 5);
+        bitp_packer_add_u64(packer, r->vals[i], r->widths[i]);
+    }
+    return BITP_OK;
+}
+
+static size_t size(const void *msg, void *) {
+    const record *r = (const record *)msg;
+    size_t n_bits = 4;
+    for (unsigned i = 0; i < r->n_fields; ++i) {
+        n_bits += 5 + r->widths[i];
+    }
+    return n_bits;
+}
+
+int main() {
+    const size_t n_msgs = 1 << 20;
+    std::mt19937_64 rng(33);
+    std::vector<record> msgs(n_msgs);
+    size_t total = 0;
+    for (record &r : msgs) {
+        r.n_fields = 1 + rng() % 15;
+        for (unsigned i = 0; i < r.n_fields; ++i) {
+            r.widths[i] = (uint8_t)(3 + rng() % 31);
+            r.vals[i] = (uint32_t)(rng() & ((1ULL << r.widths[i]) - 1));
+        }
+        total += size(&r, NULL);
+    }
+    std::vector<char> out(total / CHAR_BIT + 16);
+    double bytes = total / CHAR_BIT;
+
+    bench_run("serial packer", bytes, n_msgs, [&] {
+        bitp_packer_t packer;
+        bitp_packer_init(&packer, out.data(), total, 1);
+        for (const record &r : msgs) {
+            pack(&packer, &r, NULL);
+        }
+        bench_keep(packer.iter);
+    });
+
+    unsigned hw = std::thread::hardware_concurrency();
+    for (unsigned n_threads : {1u, 2u, 4u, hw}) {
+        for (int dry_run = 0; dry_run < 2; ++dry_run) {
+            bitp_batch_t batch = {pack, dry_run ? NULL : size, 4 + 15 * 38, NULL, n_threads};
+            char name[64];
+            snprintf(name, sizeof(name), "batch, %u threads, %s", n_threads, dry_run ? "dry run" : "size function");
+            bench_run(name, bytes, n_msgs, [&] {
+                bitp_packer_t packer;
+                bitp_packer_init(&packer, out.data(), total, 1);
+                bitp_batch_pack(&batch, &packer, msgs.data(), sizeof(record), n_msgs, NULL);
+                bench_keep(packer.iter);
+            });
+        }
+    }
+
+    return 0;
+}
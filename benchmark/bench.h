@@ -0,0 +1,62 @@
+/*
+ * bench.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#ifndef BENCHMARK_BENCH_H_
+#define BENCHMARK_BENCH_H_
+
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// keeps the optimizer from dropping the benchmarked work
+template <typename T>
+inline void bench_keep(const T &val) {
+#if defined(__GNUC__)
+    __asm__ volatile("" : : "g"(val) : "memory");
+#else
+    static volatile T sink;
+    sink = val;
+    (void)sink;
+#endif
+}
+
+inline std::vector<uint8_t> bench_random_bytes(size_t n, uint64_t seed = 1) {
+    std::mt19937_64 rng(seed);
+    std::vector<uint8_t> res(n);
+    for (auto &b : res) {
+        b = (uint8_t)rng();
+    }
+    return res;
+}
+
+// runs fn() `repeat` times and reports the best run; returns best seconds
+template <typename Fn>
+inline double bench_run(const char *name, double bytes, double items, Fn &&fn, int repeat = 5) {
+    double best = 1e30;
+    for (int i = 0; i < repeat; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (elapsed.count() < best) {
+            best = elapsed.count();
+        }
+    }
+
+    std::printf("%-44s %10.3f ms", name, best * 1e3);
+    if (bytes > 0) {
+        std::printf(" %9.3f GB/s", bytes / best / 1e9);
+    }
+    if (items > 0) {
+        std::printf(" %9.2f M/s", items / best / 1e6);
+    }
+    std::printf("\n");
+    return best;
+}
+
+#endif /* BENCHMARK_BENCH_H_ */
@@ -0,0 +1,109 @@
+/*
+ * bitmap_benchmark.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include "bench.h"
+
+extern "C" {
+#include "bitp/bitmap.h"
+}
+
+int main() {
+    const size_t n_bytes = 1 << 20;
+    const size_t n_bits = n_bytes * CHAR_BIT - 16;
+    // a dense bitmap and a sparse one (1 bit in 4096) at an odd bit offset
+    std::vector<uint8_t> dense = bench_random_bytes(n_bytes, 1);
+    std::vector<uint8_t> sparse(n_bytes);
+    for (size_t i = 0; i < n_bytes; i += 512) {
+        sparse[i + 100] = 0x10;
+    }
+    std::vector<uint8_t> other = bench_random_bytes(n_bytes, 2);
+    const bitp_view_t dense_view = {(const char *)dense.data(), 3, 3 + n_bits};
+    const bitp_view_t sparse_view = {(const char *)sparse.data(), 3, 3 + n_bits};
+    const char *isa_names[] = {"scalar", "SSE2", "AVX2", "AVX-512"};
+    char name[64];
+
+    bench_run("popcount, extract_u8 per bit", n_bits / CHAR_BIT, 0, [&] {
+        bitp_parser_t parser;
+        bitp_parser_init(&parser, (const char *)dense.data(), n_bits + 3);
+        bitp_parser_skip(&parser, 3);
+        size_t count = 0;
+        for (size_t i = 0; i < n_bits; ++i) {
+            uint8_t bit;
+            bitp_parser_extract_u8(&parser, &bit, 1);
+            count += bit;
+        }
+        bench_keep(count);
+    });
+    for (int isa = BITP_ISA_SCALAR; isa <= bitp_cpu_isa(bitp_cpu_features()); ++isa) {
+        snprintf(name, sizeof(name), "popcount, %s", isa_names[isa]);
+        bench_run(name, n_bits / CHAR_BIT, 0, [&] {
+            bench_keep(bitp_bitmap_popcount_isa(&dense_view, (bitp_isa_t)isa));
+        }, 20);
+    }
+
+    bench_run("sparse set bits, extract_u8 per bit", n_bits / CHAR_BIT, 0, [&] {
+        bitp_parser_t parser;
+        bitp_parser_init(&parser, (const char *)sparse.data(), n_bits + 3);
+        bitp_parser_skip(&parser, 3);
+        size_t sum = 0;
+        for (size_t i = 0; i < n_bits; ++i) {
+            uint8_t bit;
+            bitp_parser_extract_u8(&parser, &bit, 1);
+            if (bit) {
+                sum += i;
+            }
+        }
+        bench_keep(sum);
+    });
+    bench_run("sparse set bits, iterator", n_bits / CHAR_BIT, 0, [&] {
+        bitp_bitmap_iter_t it;
+        size_t pos;
+        size_t sum = 0;
+        bitp_bitmap_iter_init(&it, &sparse_view);
+        while (bitp_bitmap_iter_next(&it, &pos)) {
+            sum += pos;
+        }
+        bench_keep(sum);
+    }, 20);
+    for (int isa = BITP_ISA_SCALAR; isa <= bitp_cpu_isa(bitp_cpu_features()); ++isa) {
+        snprintf(name, sizeof(name), "sparse set bits, find_set %s", isa_names[isa]);
+        bench_run(name, n_bits / CHAR_BIT, 0, [&] {
+            size_t sum = 0;
+            for (size_t pos = bitp_bitmap_find_set_isa(&sparse_view, 0, (bitp_isa_t)isa); pos != BITP_BITMAP_NPOS;
+                 pos = bitp_bitmap_find_set_isa(&sparse_view, pos + 1, (bitp_isa_t)isa)) {
+                sum += pos;
+            }
+            bench_keep(sum);
+        }, 20);
+    }
+
+    std::vector<char> dst(n_bytes);
+    bench_run("AND, extract_u8 and write per bit", n_bits / CHAR_BIT, 0, [&] {
+        bitp_parser_t src;
+        bitp_parser_init(&src, (const char *)other.data(), n_bits + 5);
+        bitp_parser_skip(&src, 5);
+        for (size_t i = 0; i < n_bits; ++i) {
+            uint8_t bit;
+            bitp_parser_extract_u8(&src, &bit, 1);
+            if (!bit) {
+                dst[(i + 3) / CHAR_BIT] &= (char)~(0x80 >> ((i + 3) % CHAR_BIT));
+            }
+        }
+        bench_keep(dst[100]);
+    });
+    for (int isa = BITP_ISA_SCALAR; isa <= BITP_ISA_AVX2 && isa <= bitp_cpu_isa(bitp_cpu_features()); ++isa) {
+        snprintf(name, sizeof(name), "AND, %s", isa_names[isa]);
+        bench_run(name, n_bits / CHAR_BIT, 0, [&] {
+            bitp_packer_t packer = {dst.data(), n_bits + 3, 3};
+            bitp_parser_t parser = {(const char *)other.data(), n_bits + 5, 5};
+            bitp_bitmap_apply_isa(&packer, &parser, n_bits, BITP_BITMAP_AND, (bitp_isa_t)isa);
+            bench_keep(dst[100]);
+        }, 20);
+    }
+
+    return 0;
+}
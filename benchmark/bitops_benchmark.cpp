@@ -0,0 +1,119 @@
+/*
+ * bitops_benchmark.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <algorithm>
+
+#include "bench.h"
+
+extern "C" {
+#include "bitp/bitops.h"
+}
+
+static const char *const isa_names[] = {"scalar", "sse2", "avx2", "avx512"};
+
+int main() {
+    const size_t n_bytes = 1 << 22;
+    const size_t n_bits = n_bytes * CHAR_BIT;
+    std::vector<uint8_t> src = bench_random_bytes(n_bytes + 64);
+    std::vector<char> dst(n_bytes + 64);
+    char label[64];
+
+    // what the kernels replace
+    bench_run("reverse bit by bit", n_bytes, 0, [&] {
+        std::fill(dst.begin(), dst.end(), 0);
+        bitp_packer_t packer;
+        bitp_packer_init(&packer, dst.data(), n_bits, 1);
+        for (size_t i = n_bits; i-- > 0;) {
+            bitp_parser_t parser;
+            uint8_t bit = 0;
+            bitp_parser_init(&parser, (const char *)src.data(), n_bits);
+            parser.iter = i;
+            bitp_parser_extract_u8(&parser, &bit, 1);
+            bitp_packer_add_u8(&packer, bit, 1);
+        }
+    });
+
+    for (bitp_isa_t isa : {BITP_ISA_SCALAR, BITP_ISA_AVX2}) {
+        if (isa > bitp_cpu_isa(bitp_cpu_features())) {
+            continue;
+        }
+        // whole bytes, and bit 3 to bit 5
+        for (unsigned off : {0u, 3u}) {
+            std::snprintf(label, sizeof(label), "reverse %s %s", off ? "unaligned" : "bytes", isa_names[isa]);
+            bench_run(label, n_bytes, 0, [&] {
+                std::fill(dst.begin(), dst.end(), 0);
+                bitp_parser_t parser;
+                bitp_parser_init(&parser, (const char *)src.data(), n_bits + off);
+                parser.iter = off;
+                bitp_packer_t packer;
+                bitp_packer_init(&packer, dst.data(), n_bits + 5, 1);
+                packer.iter = off ? 5 : 0;
+                bitp_bits_reverse_isa(&packer, &parser, n_bits - off, isa);
+            });
+        }
+    }
+
+    // block interleaver of 32 columns over 6144-bit code blocks, as row-in column-out
+    const size_t block_rows = 6144 / 32;
+    const size_t n_blocks = n_bits / 6144;
+    bench_run("interleave 192x32 bit by bit", (double)n_blocks * 6144 / CHAR_BIT, 0, [&] {
+        std::fill(dst.begin(), dst.end(), 0);
+        bitp_packer_t packer;
+        bitp_packer_init(&packer, dst.data(), n_bits, 1);
+        for (size_t b = 0; b < n_blocks; ++b) {
+            for (size_t c = 0; c < 32; ++c) {
+                for (size_t r = 0; r < block_rows; ++r) {
+                    bitp_parser_t parser;
+                    uint8_t bit = 0;
+                    bitp_parser_init(&parser, (const char *)src.data(), n_bits);
+                    parser.iter = b * 6144 + r * 32 + c;
+                    bitp_parser_extract_u8(&parser, &bit, 1);
+                    bitp_packer_add_u8(&packer, bit, 1);
+                }
+            }
+        }
+    });
+    for (bitp_isa_t isa : {BITP_ISA_SCALAR, BITP_ISA_AVX2}) {
+        if (isa > bitp_cpu_isa(bitp_cpu_features())) {
+            continue;
+        }
+        std::snprintf(label, sizeof(label), "interleave 192x32 %s", isa_names[isa]);
+        bench_run(label, (double)n_blocks * 6144 / CHAR_BIT, 0, [&] {
+            std::fill(dst.begin(), dst.end(), 0);
+            bitp_parser_t parser;
+            bitp_parser_init(&parser, (const char *)src.data(), n_bits);
+            bitp_packer_t packer;
+            bitp_packer_init(&packer, dst.data(), n_bits, 1);
+            for (size_t b = 0; b < n_blocks; ++b) {
+                bitp_bits_transpose_isa(&packer, &parser, block_rows, 32, isa);
+            }
+        });
+
+        // bit planes of 16-bit samples
+        std::snprintf(label, sizeof(label), "bit planes of 16-bit values %s", isa_names[isa]);
+        bench_run(label, n_bytes, 0, [&] {
+            std::fill(dst.begin(), dst.end(), 0);
+            bitp_parser_t parser;
+            bitp_parser_init(&parser, (const char *)src.data(), n_bits);
+            bitp_packer_t packer;
+            bitp_packer_init(&packer, dst.data(), n_bits, 1);
+            bitp_bits_transpose_isa(&packer, &parser, n_bits / 16, 16, isa);
+        });
+
+        std::snprintf(label, sizeof(label), "transpose 64x64 %s", isa_names[isa]);
+        std::vector<uint64_t> m(n_bytes / sizeof(uint64_t));
+        memcpy(m.data(), src.data(), n_bytes);
+        bench_run(label, n_bytes, 0, [&] {
+            for (size_t i = 0; i < m.size(); i += 64) {
+                bitp_transpose_64x64_isa(&m[i], isa);
+            }
+            bench_keep(m[0]);
+        });
+    }
+
+    return 0;
+}
@@ -0,0 +1,147 @@
+/*
+ * cache_benchmark.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <cstring>
+
+#include "bench.h"
+
+extern "C" {
+#include "bitp/cache.h"
+#include "bitp/hash.h"
+}
+
+// a SIB-like broadcast message: a presence bitmap of 8 optional groups of 6 constrained integers,
+// then a list of up to 15 neighbours with optional fields, decoded the way generated UPER code does
+static const unsigned n_groups = 8;
+static const unsigned group_fields = 6;
+static const unsigned widths[group_fields] = {3, 7, 12, 5, 1, 9};
+static const int lower_bounds[group_fields] = {0, -64, 0, -15, 0, -140};
+
+// the size of the transport block the messages come in, the longest message fits
+static const size_t msg_bits = 640;
+
+struct neighbour {
+    uint16_t cell_id;
+    int8_t offset;
+    bool has_offset;
+    bool barred;
+};
+
+struct decoded {
+    uint8_t present;
+    int32_t groups[n_groups][group_fields];
+    unsigned n_neighbours;
+    neighbour neighbours[15];
+};
+
+static bitp_status_t decode(bitp_parser_t *parser, void *res, void *) {
+    decoded *d = (decoded *)res;
+    bitp_status_t s = bitp_parser_extract_u8(parser, &d->present, n_groups);
+    for (unsigned g = 0; g < n_groups && s == BITP_OK; ++g) {
+        for (unsigned f = 0; f < group_fields && s == BITP_OK; ++f) {
+            uint16_t v = 0;
+            if ((d->present >> g) & 1) {
+                s = bitp_parser_extract_u16(parser, &v, widths[f]);
+            }
+            d->groups[g][f] = (int32_t)v + lower_bounds[f];
+        }
+    }
+    uint8_t n = 0;
+    if (s == BITP_OK) {
+        s = bitp_parser_extract_u8(parser, &n, 4);
+    }
+    d->n_neighbours = n;
+    for (unsigned i = 0; i < n && s == BITP_OK; ++i) {
+        neighbour &nb = d->neighbours[i];
+        uint8_t opt = 0, v = 0;
+        s = bitp_parser_extract_u8(parser, &opt, 2);
+        if (s == BITP_OK) {
+            s = bitp_parser_extract_u16(parser, &nb.cell_id, 9);
+        }
+        nb.has_offset = opt & 2;
+        nb.offset = 0;
+        if (s == BITP_OK && nb.has_offset) {
+            s = bitp_parser_extract_u8(parser, &v, 5);
+            nb.offset = (int8_t)(v - 15);
+        }
+        nb.barred = false;
+        if (s == BITP_OK && (opt & 1)) {
+            s = bitp_parser_extract_u8(parser, &v, 1);
+            nb.barred = v;
+        }
+    }
+    return s;
+}
+
+int main() {
+    std::mt19937 rng(7);
+    const size_t slot = msg_bits / CHAR_BIT;
+
+    // hash throughput over a long range, aligned and at a bit phase
+    std::vector<uint8_t> big = bench_random_bytes((1 << 20) + 64);
+    const char *isa_names[] = {"hash 1 MiB, scalar", "hash 1 MiB, scalar (SSE2)", "hash 1 MiB, AVX2"};
+    for (int isa = BITP_ISA_SCALAR; isa <= bitp_cpu_isa(bitp_cpu_features()) && isa <= BITP_ISA_AVX2; ++isa) {
+        if (isa == BITP_ISA_SSE2) {
+            continue;
+        }
+        for (unsigned phase : {0u, 3u}) {
+            char name[64];
+            snprintf(name, sizeof(name), "%s, bit phase %u", isa_names[isa], phase);
+            bench_run(name, 16 << 20, 0, [&] {
+                for (int r = 0; r < 16; ++r) {
+                    bench_keep(bitp_hash_bits_isa((const char *)big.data(), phase, (size_t)8 << 20, (bitp_isa_t)isa));
+                }
+            }, 5);
+        }
+    }
+
+    // a stream of messages, a share of them repeats of 32 broadcast payloads, the rest all different;
+    // any bits decode, the presence bits pick the fields
+    const size_t n_msgs = 1 << 16;
+    const size_t n_broadcast = 32;
+    std::vector<uint8_t> broadcast = bench_random_bytes(n_broadcast * slot, 2);
+    std::vector<uint8_t> unique = bench_random_bytes(n_msgs * slot, 3);
+    std::vector<char> stream(n_msgs * slot + sizeof(uint64_t));
+    std::vector<decoded> res(256);
+
+    bench_run("decode every message", (double)n_msgs * slot, n_msgs, [&] {
+        bitp_parser_t parser;
+        bitp_parser_init(&parser, (const char *)unique.data(), n_msgs * slot * CHAR_BIT);
+        for (size_t i = 0; i < n_msgs; ++i) {
+            parser.iter = i * slot * CHAR_BIT;
+            decode(&parser, &res[i % res.size()], NULL);
+        }
+        bench_keep(res[7].groups[3][2]);
+    });
+
+    bitp_cache_t *cache = bitp_cache_create(1024, sizeof(decoded), 16);
+    for (unsigned percent : {0u, 50u, 90u, 99u}) {
+        for (size_t i = 0; i < n_msgs; ++i) {
+            const uint8_t *src = rng() % 100 < percent ? &broadcast[rng() % n_broadcast * slot] : &unique[i * slot];
+            memcpy(&stream[i * slot], src, slot);
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "cache, %u%% repeats", percent);
+        bitp_cache_clear(cache);
+        bench_run(name, (double)n_msgs * slot, n_msgs, [&] {
+            bitp_parser_t parser;
+            bitp_parser_init(&parser, stream.data(), n_msgs * slot * CHAR_BIT);
+            for (size_t i = 0; i < n_msgs; ++i) {
+                parser.iter = i * slot * CHAR_BIT;
+                bitp_cache_decode(cache, &parser, msg_bits, decode, NULL, &res[i % res.size()]);
+            }
+            bench_keep(res[7].groups[3][2]);
+        });
+        bitp_cache_stats_t stats;
+        bitp_cache_stats(cache, &stats);
+        printf("    hit rate %.1f%%, %llu evictions\n", 100.0 * stats.hits / (stats.hits + stats.misses),
+               (unsigned long long)stats.evictions);
+    }
+    bitp_cache_destroy(cache);
+
+    return 0;
+}
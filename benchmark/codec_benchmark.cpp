@@ -0,0 +1,75 @@
+/*
+ * codec_benchmark.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include "bench.h"
+
+extern "C" {
+#include "bitp/codec.h"
+}
+
+static const char *const isa_names[] = {"scalar", "sse2", "avx2", "avx512"};
+
+static void run(const char *name, const std::vector<uint32_t> &vals, bitp_codec_mode_t mode) {
+    const size_t n = vals.size();
+    std::vector<char> buf(bitp_codec_max_bits(n) / CHAR_BIT + 16);
+    std::vector<uint32_t> res(n);
+    size_t n_bits = 0;
+    char label[64];
+
+    std::snprintf(label, sizeof(label), "%s encode", name);
+    bench_run(label, (double)n * sizeof(uint32_t), (double)n, [&] {
+        std::fill(buf.begin(), buf.end(), 0);
+        bitp_packer_t packer;
+        bitp_packer_init(&packer, buf.data(), bitp_codec_max_bits(n), 1);
+        bitp_codec_encode_u32(&packer, vals.data(), n, mode);
+        n_bits = packer.iter;
+    });
+
+    // GB/s of decoded values
+    for (bitp_isa_t isa : {BITP_ISA_SCALAR, BITP_ISA_AVX2}) {
+        if (isa > bitp_cpu_isa(bitp_cpu_features())) {
+            continue;
+        }
+        std::snprintf(label, sizeof(label), "%s decode %s", name, isa_names[isa]);
+        bench_run(label, (double)n * sizeof(uint32_t), (double)n, [&] {
+            bitp_parser_t parser;
+            bitp_parser_init(&parser, buf.data(), n_bits);
+            bitp_codec_decode_u32_isa(&parser, res.data(), n, mode, isa);
+            bench_keep(res[n / 2]);
+        });
+    }
+    std::printf("%-44s %10.2f x %9.2f bits/value\n", name, 32.0 * n / n_bits, (double)n_bits / n);
+}
+
+int main() {
+    const size_t n = 1 << 22;
+    std::mt19937 rng(1);
+
+    std::vector<uint32_t> small(n);
+    for (auto &v : small) {
+        v = rng() % 1000;
+    }
+    run("uniform 10-bit", small, BITP_CODEC_FOR);
+
+    // mostly small with 1% outliers, patched as exceptions
+    std::vector<uint32_t> outliers = small;
+    for (size_t i = 0; i < n; i += 100) {
+        outliers[i] = rng();
+    }
+    run("10-bit with 1% outliers", outliers, BITP_CODEC_FOR);
+
+    std::vector<uint32_t> ts(n);
+    uint32_t t = 0;
+    for (auto &v : ts) {
+        t += 1000 + rng() % 64;
+        v = t;
+    }
+    run("timestamps, delta", ts, BITP_CODEC_DELTA);
+    run("timestamps, frame of reference", ts, BITP_CODEC_FOR);
+
+    return 0;
+}
@@ -0,0 +1,141 @@
+/*
+ * edit_benchmark.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <cstring>
+
+#include "bench.h"
+
+extern "C" {
+#include "bitp/edit.h"
+#include "bitp/parser.h"
+}
+
+/*
+ * A message of n_fields fields of 1 to 16 bits. The transcoding edits: a presence bit inserted
+ * before field 1, field 3 widened from its width to 2 bits more, fields 10 to 14 (an optional
+ * element) dropped, and then undone. Against it the full re-encode: every field parsed and packed
+ * again with the same changes.
+ */
+
+static const unsigned widths[] = {3, 1, 9, 7, 16, 2, 5, 12, 1, 8, 4, 6, 11, 3, 14, 2};
+
+static size_t width(size_t i) {
+    return widths[i % (sizeof(widths) / sizeof(widths[0]))];
+}
+
+static size_t field_off(size_t i) {
+    size_t off = 0;
+    for (size_t k = 0; k < i; ++k) {
+        off += width(k);
+    }
+    return off;
+}
+
+static void reencode(const char *src, size_t n_bits, size_t n_fields, char *dst, size_t dst_bits, uint64_t *vals) {
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, src, n_bits);
+    for (size_t i = 0; i < n_fields; ++i) {
+        bitp_parser_extract_u64(&parser, &vals[i], width(i));
+    }
+    bitp_packer_t packer;
+    bitp_packer_init(&packer, dst, dst_bits, 1);
+    for (size_t i = 0; i < n_fields; ++i) {
+        if (i == 1) {
+            bitp_packer_add_u64(&packer, 1, 1);
+        }
+        if (i >= 10 && i <= 14) {
+            continue;
+        }
+        bitp_packer_add_u64(&packer, vals[i], width(i) + (i == 3 ? 2 : 0));
+    }
+    bench_keep(packer.iter);
+}
+
+int main() {
+    const char *isa_names[] = {"scalar", "SSE2", "AVX2", "AVX-512"};
+    char name[64];
+
+    for (size_t n_fields : {(size_t)100, (size_t)20000}) {
+        const size_t n_bits = field_off(n_fields);
+        const size_t cap = n_bits + 64;
+        const size_t n_bytes = (cap + CHAR_BIT - 1) / CHAR_BIT + sizeof(uint64_t);
+        const size_t reps = n_fields < 1000 ? 20000 : 200;
+        std::mt19937_64 rng(47);
+        std::vector<char> orig(n_bytes), work(n_bytes), out(n_bytes);
+        std::vector<uint64_t> vals(n_fields);
+        bitp_packer_t packer;
+        bitp_packer_init(&packer, orig.data(), cap, 1);
+        for (size_t i = 0; i < n_fields; ++i) {
+            bitp_packer_add_u64(&packer, rng() & ((1ULL << width(i)) - 1), width(i));
+        }
+        snprintf(name, sizeof(name), "%zu bits, parse and repack", n_bits);
+        bench_run(name, (double)reps * n_bits / CHAR_BIT, reps, [&] {
+            for (size_t r = 0; r < reps; ++r) {
+                reencode(orig.data(), n_bits, n_fields, out.data(), cap, vals.data());
+            }
+        });
+
+        // the edits and the ones that undo them, a run edits the message 2 * reps times in place
+        uint64_t f3 = 0;
+        bitp_parser_t parser;
+        bitp_parser_init(&parser, orig.data(), n_bits);
+        parser.iter = field_off(3);
+        bitp_parser_extract_u64(&parser, &f3, width(3));
+        char f3_bytes[sizeof(uint64_t)], one[1] = {(char)0x80};
+        bitp_store_be_64(f3_bytes, f3 << (64 - width(3) - 2));
+        const size_t dropped = field_off(15) - field_off(10);
+        const bitp_edit_t edits[3] = {{field_off(1), 0, one, 0, 1},
+                                      {field_off(3), width(3), f3_bytes, 0, width(3) + 2},
+                                      {field_off(10), dropped, NULL, 0, 0}};
+        const bitp_edit_t undo[3] = {{field_off(1), 1, NULL, 0, 0},
+                                     {field_off(3) + 1, width(3) + 2, orig.data(), field_off(3), width(3)},
+                                     {field_off(10) + 3, 0, orig.data(), field_off(10), dropped}};
+        memcpy(work.data(), orig.data(), n_bytes);
+        const double bytes = 2.0 * reps * n_bits / CHAR_BIT;
+
+        snprintf(name, sizeof(name), "%zu bits, 3 single edits", n_bits);
+        bench_run(name, bytes, 2.0 * reps, [&] {
+            bitp_packer_t msg = {work.data(), cap, n_bits};
+            for (size_t r = 0; r < reps; ++r) {
+                // from the back, the offsets before the edits stay valid
+                for (size_t k = 3; k-- > 0;) {
+                    bitp_edit_apply(&msg, &edits[k], 1);
+                }
+                for (size_t k = 3; k-- > 0;) {
+                    bitp_edit_apply(&msg, &undo[k], 1);
+                }
+            }
+            bench_keep(msg.iter);
+        });
+        for (int isa = BITP_ISA_SCALAR; isa <= bitp_cpu_isa(bitp_cpu_features()) && isa <= BITP_ISA_AVX2; ++isa) {
+            if (isa == BITP_ISA_SSE2) {
+                continue;
+            }
+            snprintf(name, sizeof(name), "%zu bits, a batch of 3, %s", n_bits, isa_names[isa]);
+            bench_run(name, bytes, 2.0 * reps, [&] {
+                bitp_packer_t msg = {work.data(), cap, n_bits};
+                for (size_t r = 0; r < reps; ++r) {
+                    bitp_edit_apply_isa(&msg, edits, 3, (bitp_isa_t)isa);
+                    bitp_edit_apply_isa(&msg, undo, 3, (bitp_isa_t)isa);
+                }
+                bench_keep(msg.iter);
+            });
+        }
+
+        // the same result both ways, and the message back after the undos
+        if (memcmp(work.data(), orig.data(), n_bytes) != 0) {
+            printf("    the message changed\n");
+        }
+        reencode(orig.data(), n_bits, n_fields, out.data(), cap, vals.data());
+        bitp_packer_t msg = {work.data(), cap, n_bits};
+        bitp_edit_apply(&msg, edits, 3);
+        if (memcmp(work.data(), out.data(), n_bytes) != 0) {
+            printf("    edits and re-encode differ\n");
+        }
+    }
+    return 0;
+}
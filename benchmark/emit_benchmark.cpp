@@ -0,0 +1,125 @@
+/*
+ * emit_benchmark.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <sstream>
+
+#include "bench.h"
+
+extern "C" {
+#include "bitp/emit.h"
+}
+
+// a MIB-NB like record: 4 + 6 + 4 + 5 + 1 + 2 + 5 + 1 + 11 + 40 (bit string) + 17 (signed) bits
+static const bitp_emit_field_t fields[] = {
+    {"sfn_msb", 4, BITP_EMIT_UNSIGNED},
+    {"hsfn_lsb", 6, BITP_EMIT_UNSIGNED},
+    {"sib1_sched", 4, BITP_EMIT_UNSIGNED},
+    {"value_tag", 5, BITP_EMIT_UNSIGNED},
+    {"ab_enabled", 1, BITP_EMIT_UNSIGNED},
+    {"mode", 2, BITP_EMIT_UNSIGNED},
+    {"mode_info", 5, BITP_EMIT_UNSIGNED},
+    {"spare", 1, BITP_EMIT_SKIP},
+    {"cell_id", 11, BITP_EMIT_UNSIGNED},
+    {"payload", 40, BITP_EMIT_HEX},
+    {"offset", 17, BITP_EMIT_SIGNED},
+};
+static const unsigned n_fields = sizeof(fields) / sizeof(fields[0]);
+static const unsigned record_bits = 96;
+
+int main() {
+    const size_t n_records = 1 << 21;
+    std::vector<uint8_t> buf = bench_random_bytes(n_records * record_bits / CHAR_BIT + 64);
+    std::vector<char> out(1 << 16);
+    size_t total = 0;
+
+    bench_run("parse only", 0, n_records, [&] {
+        bitp_parser_t parser;
+        bitp_parser_init(&parser, (const char *)buf.data(), n_records * record_bits);
+        uint64_t sum = 0;
+        for (size_t r = 0; r < n_records; ++r) {
+            for (unsigned i = 0; i < n_fields; ++i) {
+                uint64_t v = 0;
+                bitp_parser_extract_u64(&parser, &v, fields[i].n_bits);
+                sum += v;
+            }
+        }
+        bench_keep(sum);
+    });
+
+    // the style of example.cpp
+    bench_run("ostream", 0, n_records, [&] {
+        bitp_parser_t parser;
+        bitp_parser_init(&parser, (const char *)buf.data(), n_records * record_bits);
+        std::ostringstream os;
+        for (size_t r = 0; r < n_records; ++r) {
+            for (unsigned i = 0; i < n_fields; ++i) {
+                uint64_t v = 0;
+                bitp_parser_extract_u64(&parser, &v, fields[i].n_bits);
+                if (fields[i].kind == BITP_EMIT_SKIP) {
+                    continue;
+                }
+                if (fields[i].kind == BITP_EMIT_HEX) {
+                    os << std::hex << v << std::dec;
+                }
+                else {
+                    os << v;
+                }
+                os << (i + 1 < n_fields ? ',' : '\n');
+            }
+            if (os.tellp() > 1 << 20) {
+                os.str("");
+            }
+        }
+        bench_keep((size_t)os.tellp());
+    });
+
+    bench_run("snprintf", 0, n_records, [&] {
+        bitp_parser_t parser;
+        bitp_parser_init(&parser, (const char *)buf.data(), n_records * record_bits);
+        size_t len = 0;
+        for (size_t r = 0; r < n_records; ++r) {
+            if (out.size() - len < 512) {
+                len = 0;
+            }
+            for (unsigned i = 0; i < n_fields; ++i) {
+                uint64_t v = 0;
+                bitp_parser_extract_u64(&parser, &v, fields[i].n_bits);
+                if (fields[i].kind == BITP_EMIT_SKIP) {
+                    continue;
+                }
+                const char *fmt = fields[i].kind == BITP_EMIT_HEX ? "%010llx%c" : "%llu%c";
+                len += std::snprintf(&out[len], out.size() - len, fmt, (unsigned long long)v,
+                                     i + 1 < n_fields ? ',' : '\n');
+            }
+        }
+        bench_keep(len);
+    });
+
+    for (bitp_emit_format_t format : {BITP_EMIT_CSV, BITP_EMIT_JSON}) {
+        bitp_emit_t emit;
+        bitp_emit_init(&emit, fields, n_fields, format);
+        bench_run(format == BITP_EMIT_CSV ? "bitp_emit csv" : "bitp_emit json lines", 0, n_records, [&] {
+            bitp_parser_t parser;
+            bitp_parser_init(&parser, (const char *)buf.data(), n_records * record_bits);
+            size_t len = 0;
+            total = 0;
+            for (size_t r = 0; r < n_records; ++r) {
+                // a full buffer would be written out here
+                if (bitp_emit_record(&emit, &parser, out.data(), out.size(), &len) != BITP_OK) {
+                    total += len;
+                    len = 0;
+                    bitp_emit_record(&emit, &parser, out.data(), out.size(), &len);
+                }
+            }
+            total += len;
+            bench_keep(len);
+        });
+        std::printf("%-44s %10.1f MB of text\n", "", total / 1e6);
+    }
+
+    return 0;
+}
@@ -0,0 +1,92 @@
+/*
+ * fields_benchmark.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include "bench.h"
+
+extern "C" {
+#include "bitp/fields.h"
+}
+
+static const unsigned widths[] = {4, 2, 4, 5, 1, 2, 5, 1, 3, 7};
+static const unsigned n_fields = sizeof(widths) / sizeof(widths[0]);
+static const unsigned msg_bits = 34;
+
+static uint64_t decode_single(const std::vector<uint8_t> &buf, size_t n_msgs) {
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, (const char *)buf.data(), n_msgs * msg_bits);
+    uint64_t sum = 0;
+    for (size_t m = 0; m < n_msgs; ++m) {
+        for (unsigned i = 0; i < n_fields; ++i) {
+            uint8_t v;
+            bitp_parser_extract_u8(&parser, &v, widths[i]);
+            sum += v;
+        }
+    }
+    return sum;
+}
+
+static uint64_t decode_fields(const std::vector<uint8_t> &buf, size_t n_msgs, int use_pdep) {
+    bitp_fields_t fields;
+    bitp_fields_init(&fields, widths, n_fields, 8);
+    fields.use_pdep = use_pdep;
+
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, (const char *)buf.data(), n_msgs * msg_bits);
+    uint64_t sum = 0;
+    uint8_t res[BITP_FIELDS_MAX];
+    for (size_t m = 0; m < n_msgs; ++m) {
+        bitp_parser_extract_fields_u8(&parser, &fields, res);
+        for (unsigned i = 0; i < n_fields; ++i) {
+            sum += res[i];
+        }
+    }
+    return sum;
+}
+
+static void encode_fields(std::vector<uint8_t> &buf, size_t n_msgs, int use_pdep) {
+    bitp_fields_t fields;
+    bitp_fields_init(&fields, widths, n_fields, 8);
+    fields.use_pdep = use_pdep;
+
+    bitp_packer_t packer;
+    bitp_packer_init(&packer, (char *)buf.data(), n_msgs * msg_bits, 1);
+    const uint8_t vals[BITP_FIELDS_MAX] = {1, 2, 3, 4, 1, 2, 3, 1, 5, 6};
+    for (size_t m = 0; m < n_msgs; ++m) {
+        bitp_packer_add_fields_u8(&packer, &fields, vals);
+    }
+}
+
+static void encode_single(std::vector<uint8_t> &buf, size_t n_msgs) {
+    bitp_packer_t packer;
+    bitp_packer_init(&packer, (char *)buf.data(), n_msgs * msg_bits, 1);
+    const uint8_t vals[BITP_FIELDS_MAX] = {1, 2, 3, 4, 1, 2, 3, 1, 5, 6};
+    for (size_t m = 0; m < n_msgs; ++m) {
+        for (unsigned i = 0; i < n_fields; ++i) {
+            bitp_packer_add_u8(&packer, vals[i], widths[i]);
+        }
+    }
+}
+
+int main() {
+    const size_t n_msgs = 4 << 20;
+    std::vector<uint8_t> buf = bench_random_bytes(n_msgs * msg_bits / CHAR_BIT + 16);
+    int pdep = (bitp_cpu_features() & BITP_CPU_BMI2) != 0;
+
+    bench_run("decode, one call per field", 0, n_msgs, [&] { bench_keep(decode_single(buf, n_msgs)); });
+    bench_run("decode, field group shift/mask", 0, n_msgs, [&] { bench_keep(decode_fields(buf, n_msgs, 0)); });
+    if (pdep) {
+        bench_run("decode, field group pext/pdep", 0, n_msgs, [&] { bench_keep(decode_fields(buf, n_msgs, 1)); });
+    }
+
+    bench_run("encode, one call per field", 0, n_msgs, [&] { encode_single(buf, n_msgs); });
+    bench_run("encode, field group shift/mask", 0, n_msgs, [&] { encode_fields(buf, n_msgs, 0); });
+    if (pdep) {
+        bench_run("encode, field group pext/pdep", 0, n_msgs, [&] { encode_fields(buf, n_msgs, 1); });
+    }
+
+    return 0;
+}
@@ -0,0 +1,169 @@
+/*
+ * ingest_benchmark.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "bench.h"
+
+extern "C" {
+#include "bitp/ingest.h"
+}
+
+static const size_t block_size = 1 << 20;
+
+// a 64-bit word of every cache line, the decoder touches all of the data
+static uint64_t consume(bitp_parser_t *parser) {
+    uint64_t sum = 0;
+    while (parser->capacity - parser->iter >= 64) {
+        uint64_t v = 0;
+        bitp_parser_extract_u64(parser, &v, 64);
+        sum += v;
+        parser->iter += 512 - 64;
+        if (parser->iter > parser->capacity) {
+            break;
+        }
+    }
+    return sum;
+}
+
+static void drop_cache(int fd) {
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+}
+
+static uint64_t run_read(int fd, char *buf) {
+    uint64_t sum = 0;
+    off_t offset = 0;
+    for (;;) {
+        ssize_t n = pread(fd, buf, block_size, offset);
+        if (n <= 0) {
+            break;
+        }
+        bitp_parser_t parser;
+        bitp_parser_init(&parser, buf, (size_t)n * CHAR_BIT);
+        sum += consume(&parser);
+        offset += n;
+    }
+    return sum;
+}
+
+static uint64_t run_mmap(int fd, size_t size) {
+    char *p = (char *)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) {
+        return 0;
+    }
+    madvise(p, size, MADV_SEQUENTIAL);
+    bitp_parser_t parser;
+    // the parser reads words, the last cache line isn't touched
+    bitp_parser_init(&parser, p, (size - 64) * CHAR_BIT);
+    uint64_t sum = consume(&parser);
+    munmap(p, size);
+    return sum;
+}
+
+static uint64_t run_ingest(int fd, bitp_ingest_backend_t backend) {
+    bitp_ingest_config_t config = {block_size, 8, backend};
+    bitp_ingest_t *ingest;
+    if (bitp_ingest_open(&ingest, fd, &config) != BITP_OK) {
+        return 0;
+    }
+    uint64_t sum = 0;
+    bitp_ingest_block_t block;
+    while (bitp_ingest_next(ingest, &block) == BITP_OK) {
+        sum += consume(&block.parser);
+        bitp_ingest_release(ingest, &block);
+    }
+    bitp_ingest_close(ingest);
+    return sum;
+}
+
+int main(int argc, char **argv) {
+    const size_t size = (size_t)1 << 30;
+    const char *path = argc > 1 ? argv[1] : "bitp_ingest_benchmark.dat";
+
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::perror(path);
+        return 1;
+    }
+    std::vector<uint8_t> chunk = bench_random_bytes(block_size);
+    for (size_t off = 0; off < size; off += block_size) {
+        if (write(fd, chunk.data(), block_size) != (ssize_t)block_size) {
+            std::perror(path);
+            return 1;
+        }
+    }
+    fsync(fd);
+    int direct = open(path, O_RDONLY | O_DIRECT);
+
+    void *buf = NULL;
+    if (posix_memalign(&buf, 4096, block_size + BITP_INGEST_PADDING) != 0) {
+        return 1;
+    }
+    bitp_ingest_t *probe;
+    bitp_ingest_config_t auto_config = {block_size, 8, BITP_INGEST_AUTO};
+    bool uring = bitp_ingest_open(&probe, fd, &auto_config) == BITP_OK;
+    if (uring) {
+        uring = bitp_ingest_backend(probe) == BITP_INGEST_URING;
+        bitp_ingest_close(probe);
+    }
+    std::printf("io_uring: %s, O_DIRECT: %s\n", uring ? "yes" : "no", direct >= 0 ? "yes" : "no");
+
+    for (int cold = 0; cold < 2; ++cold) {
+        const char *cache = cold ? "cold" : "page cache";
+        char label[64];
+
+        std::snprintf(label, sizeof(label), "read, %s", cache);
+        bench_run(label, (double)size, 0, [&] {
+            if (cold) {
+                drop_cache(fd);
+            }
+            bench_keep(run_read(fd, (char *)buf));
+        });
+        std::snprintf(label, sizeof(label), "mmap, %s", cache);
+        bench_run(label, (double)size, 0, [&] {
+            if (cold) {
+                drop_cache(fd);
+            }
+            bench_keep(run_mmap(fd, size));
+        });
+        std::snprintf(label, sizeof(label), "ingest pread, %s", cache);
+        bench_run(label, (double)size, 0, [&] {
+            if (cold) {
+                drop_cache(fd);
+            }
+            bench_keep(run_ingest(fd, BITP_INGEST_READ));
+        });
+        if (uring) {
+            std::snprintf(label, sizeof(label), "ingest io_uring, %s", cache);
+            bench_run(label, (double)size, 0, [&] {
+                if (cold) {
+                    drop_cache(fd);
+                }
+                bench_keep(run_ingest(fd, BITP_INGEST_URING));
+            });
+        }
+    }
+
+    if (direct >= 0) {
+        bench_run("read, O_DIRECT", (double)size, 0, [&] { bench_keep(run_read(direct, (char *)buf)); });
+        bench_run("ingest pread, O_DIRECT", (double)size, 0,
+                  [&] { bench_keep(run_ingest(direct, BITP_INGEST_READ)); });
+        if (uring) {
+            bench_run("ingest io_uring, O_DIRECT", (double)size, 0,
+                      [&] { bench_keep(run_ingest(direct, BITP_INGEST_URING)); });
+        }
+        close(direct);
+    }
+
+    free(buf);
+    close(fd);
+    unlink(path);
+    return 0;
+}
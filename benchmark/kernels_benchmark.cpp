@@ -0,0 +1,74 @@
+/*
+ * kernels_benchmark.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <string>
+
+#include "bench.h"
+
+extern "C" {
+#include "bitp/kernels.h"
+}
+
+static const char *const isa_names[] = {"scalar", "sse2", "avx2", "avx512"};
+
+static size_t count_matches(const std::vector<uint8_t> &buf, uint64_t value, unsigned n_bits, unsigned max_errors) {
+    bitp_pattern_t pattern;
+    bitp_pattern_init(&pattern, value, n_bits, max_errors);
+
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, (const char *)buf.data(), buf.size() * CHAR_BIT);
+
+    size_t n = 0;
+    while (bitp_kernels_parser_find(&parser, &pattern) == BITP_OK) {
+        n++;
+        parser.iter++;
+    }
+    return n;
+}
+
+static const size_t batch = 1024;
+
+static uint64_t decode_fields(const std::vector<uint8_t> &buf, std::vector<uint8_t> &res, size_t n_msgs) {
+    static const unsigned widths[] = {4, 2, 4, 5, 1, 2, 5, 1, 3, 7};
+    bitp_fields_t fields;
+    bitp_fields_init(&fields, widths, sizeof(widths) / sizeof(widths[0]), 8);
+
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, (const char *)buf.data(), n_msgs * fields.n_bits);
+    uint64_t sum = 0;
+    // batches that stay in L1
+    for (size_t m = 0; m < n_msgs; m += batch) {
+        bitp_kernels_extract_fields(&parser, &fields, res.data(), batch);
+        sum += res[m % batch];
+    }
+    return sum;
+}
+
+int main() {
+    const size_t size = 64 << 20;
+    const size_t n_msgs = 4 << 20;
+    std::vector<uint8_t> buf = bench_random_bytes(size);
+    std::vector<uint8_t> res(batch * BITP_FIELDS_ARRAY_SIZE(10, 8));
+
+    std::printf("startup tier: %s\n", isa_names[bitp_kernels_isa()]);
+    for (int isa = BITP_ISA_SCALAR; isa <= BITP_ISA_AVX512; ++isa) {
+        if (bitp_kernels_force((bitp_isa_t)isa) != BITP_OK) {
+            continue;
+        }
+        std::string prefix = std::string(isa_names[isa]) + ", ";
+        bench_run((prefix + "find 32 bit exact").c_str(), size, 0,
+                  [&] { bench_keep(count_matches(buf, 0x1ACFFC1D, 32, 0)); });
+        bench_run((prefix + "find 16 bit exact").c_str(), size, 0,
+                  [&] { bench_keep(count_matches(buf, 0x1ACF, 16, 0)); });
+        bench_run((prefix + "find 32 bit, 2 errors").c_str(), size, 0,
+                  [&] { bench_keep(count_matches(buf, 0x1ACFFC1D, 32, 2)); });
+        bench_run((prefix + "extract 10 fields").c_str(), 0, n_msgs,
+                  [&] { bench_keep(decode_fields(buf, res, n_msgs)); });
+    }
+
+    return 0;
+}
@@ -0,0 +1,97 @@
+/*
+ * numeric_benchmark.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include "bench.h"
+
+extern "C" {
+#include "bitp/numeric.h"
+}
+
+static const char *const isa_names[] = {"scalar", "sse2", "avx2", "avx512"};
+
+// n fields starting at bit 3, so no field is byte-aligned
+static void run(const char *name, const bitp_numeric_t &num, const std::vector<float> &vals) {
+    const size_t n = vals.size();
+    const size_t n_bits = 3 + n * num.n_bits;
+    std::vector<char> buf(n_bits / CHAR_BIT + 16);
+    std::vector<float> res(n);
+    char label[64];
+
+    for (bitp_isa_t isa : {BITP_ISA_SCALAR, BITP_ISA_AVX2}) {
+        if (isa > bitp_cpu_isa(bitp_cpu_features())) {
+            continue;
+        }
+        std::snprintf(label, sizeof(label), "%s pack %s", name, isa_names[isa]);
+        bench_run(label, 0, (double)n, [&] {
+            std::fill(buf.begin(), buf.end(), 0);
+            bitp_packer_t packer;
+            bitp_packer_init(&packer, buf.data(), n_bits, 1);
+            packer.iter = 3;
+            bitp_packer_add_numeric_array_isa(&packer, &num, vals.data(), n, isa);
+        });
+        std::snprintf(label, sizeof(label), "%s parse %s", name, isa_names[isa]);
+        bench_run(label, 0, (double)n, [&] {
+            bitp_parser_t parser;
+            bitp_parser_init(&parser, buf.data(), n_bits);
+            parser.iter = 3;
+            bitp_parser_extract_numeric_array_isa(&parser, &num, res.data(), n, isa);
+            bench_keep(res[n / 2]);
+        });
+    }
+}
+
+int main() {
+    const size_t n = 1 << 22;
+    std::mt19937 rng(1);
+    std::vector<float> vals(n);
+
+    // what the scaled fields replace: extract, then convert in a loop of its own
+    std::vector<char> buf(n * 2 + 16);
+    for (auto &b : buf) {
+        b = (char)rng();
+    }
+    std::vector<int16_t> raw(n);
+    std::vector<float> res(n);
+    bench_run("Q1.15 extract_i16 + convert loop", 0, (double)n, [&] {
+        bitp_parser_t parser;
+        bitp_parser_init(&parser, buf.data(), n * 16 + 3);
+        parser.iter = 3;
+        for (size_t i = 0; i < n; ++i) {
+            bitp_parser_extract_i16(&parser, &raw[i], 16);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            res[i] = raw[i] * (1.0f / 32768);
+        }
+        bench_keep(res[n / 2]);
+    });
+
+    bitp_numeric_t num;
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    for (auto &v : vals) {
+        v = unit(rng);
+    }
+    bitp_numeric_init_q(&num, 16, 1, 15);
+    run("Q1.15", num, vals);
+
+    bitp_numeric_init_f16(&num);
+    for (auto &v : vals) {
+        v = unit(rng) * 1000.0f;
+    }
+    run("f16", num, vals);
+
+    bitp_numeric_init_bf16(&num);
+    run("bf16", num, vals);
+
+    // RSRP, 7 bits in 1 dB steps from -140 dBm
+    bitp_numeric_init_scaled(&num, 7, 0, 1.0f, -140.0f);
+    for (auto &v : vals) {
+        v = -140.0f + (float)(rng() % 98);
+    }
+    run("rsrp 7-bit", num, vals);
+
+    return 0;
+}
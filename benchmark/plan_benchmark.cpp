@@ -0,0 +1,192 @@
+/*
+ * plan_benchmark.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include "bench.h"
+
+extern "C" {
+#include "bitp/plan.h"
+}
+
+// vendor trace record, 129 bits so that records start at every bit phase
+static const char layout[] =
+    "sfn      u10\n"
+    "subframe u4\n"
+    "spare    x2\n"
+    "rnti     u16\n"
+    "rsrp     i8\n"
+    "rsrq     i6\n"
+    "sinr     i9\n"
+    "cqi      u4\n"
+    "ri       u2\n"
+    "mcs      u5\n"
+    "tbs      u17\n"
+    "harq     u3\n"
+    "spare2   x3\n"
+    "ts       u40\n";
+
+// MIB-NB, 34 bits
+static const char mib_layout[] =
+    "sfn_msb    u4\n"
+    "hsfn_lsb   u2\n"
+    "sib1       u4\n"
+    "value_tag  u5\n"
+    "ab         u1\n"
+    "mode       u2\n"
+    "mode_info  u5\n"
+    "add_sib1   u1\n"
+    "spare      x10\n";
+
+static inline uint64_t sign_extend(uint64_t v, unsigned n_bits) {
+    uint64_t m = 1ULL << (n_bits - 1);
+    return (v ^ m) - m;
+}
+
+// the same record written out by hand
+static void decode_by_hand(bitp_parser_t *parser, uint64_t *res) {
+    uint64_t v;
+    bitp_parser_extract_u64(parser, &res[0], 10);
+    bitp_parser_extract_u64(parser, &res[1], 4);
+    bitp_parser_skip(parser, 2);
+    bitp_parser_extract_u64(parser, &res[2], 16);
+    bitp_parser_extract_u64(parser, &v, 8);
+    res[3] = sign_extend(v, 8);
+    bitp_parser_extract_u64(parser, &v, 6);
+    res[4] = sign_extend(v, 6);
+    bitp_parser_extract_u64(parser, &v, 9);
+    res[5] = sign_extend(v, 9);
+    bitp_parser_extract_u64(parser, &res[6], 4);
+    bitp_parser_extract_u64(parser, &res[7], 2);
+    bitp_parser_extract_u64(parser, &res[8], 5);
+    bitp_parser_extract_u64(parser, &res[9], 17);
+    bitp_parser_extract_u64(parser, &res[10], 3);
+    bitp_parser_skip(parser, 3);
+    bitp_parser_extract_u64(parser, &res[11], 40);
+}
+
+int main() {
+    const size_t n_records = 1 << 20;
+
+    bitp_plan_t plan;
+    if (bitp_plan_load(&plan, layout, sizeof(layout) - 1, NULL) != BITP_OK) {
+        return 1;
+    }
+    // the descriptors a generic interpreter walks
+    bitp_plan_field_t fields[BITP_PLAN_MAX];
+    unsigned n_fields = 0;
+    for (const char *p = layout; *p; ++p) {
+        while (*p != ' ') {
+            ++p;
+        }
+        while (*p == ' ') {
+            ++p;
+        }
+        fields[n_fields].name = NULL;
+        fields[n_fields].kind = *p == 'u' ? BITP_PLAN_UNSIGNED : *p == 'i' ? BITP_PLAN_SIGNED : BITP_PLAN_SKIP;
+        fields[n_fields].n_bits = (unsigned)strtoul(p + 1, NULL, 10);
+        n_fields++;
+        while (*p != '\n') {
+            ++p;
+        }
+    }
+
+    const size_t n_bits = n_records * plan.record_bits;
+    std::vector<uint8_t> data = bench_random_bytes(n_bits / CHAR_BIT + 1 + sizeof(uint64_t));
+    const char *buf = (const char *)data.data();
+    // decoded in blocks that stay in cache, as a consumer would
+    const size_t block = 256;
+    std::vector<uint64_t> res(block * plan.n_out);
+
+    bench_run("interpreted descriptors", (double)n_bits / CHAR_BIT, n_records, [&] {
+        bitp_parser_t parser;
+        bitp_parser_init(&parser, buf, n_bits);
+        for (size_t r = 0; r < n_records; ++r) {
+            uint64_t *out = &res[r % block * plan.n_out];
+            for (unsigned i = 0; i < n_fields; ++i) {
+                uint64_t v;
+                switch (fields[i].kind) {
+                case BITP_PLAN_UNSIGNED:
+                    bitp_parser_extract_u64(&parser, &v, fields[i].n_bits);
+                    *out++ = v;
+                    break;
+                case BITP_PLAN_SIGNED:
+                    bitp_parser_extract_u64(&parser, &v, fields[i].n_bits);
+                    *out++ = sign_extend(v, fields[i].n_bits);
+                    break;
+                default:
+                    bitp_parser_skip(&parser, fields[i].n_bits);
+                }
+            }
+        }
+        bench_keep(res[block / 2]);
+    });
+    bench_run("hand-written", (double)n_bits / CHAR_BIT, n_records, [&] {
+        bitp_parser_t parser;
+        bitp_parser_init(&parser, buf, n_bits);
+        for (size_t r = 0; r < n_records; ++r) {
+            decode_by_hand(&parser, &res[r % block * plan.n_out]);
+        }
+        bench_keep(res[block / 2]);
+    });
+    bench_run("compiled plan", (double)n_bits / CHAR_BIT, n_records, [&] {
+        bitp_parser_t parser;
+        bitp_parser_init(&parser, buf, n_bits);
+        for (size_t r = 0; r < n_records; r += block) {
+            bitp_plan_run(&plan, &parser, res.data(), block);
+        }
+        bench_keep(res[block / 2]);
+    });
+
+    // independent MIB-NB messages, one per 16-byte slot, a pool that stays in cache decoded again and again
+    bitp_plan_t mib;
+    if (bitp_plan_load(&mib, mib_layout, sizeof(mib_layout) - 1, NULL) != BITP_OK) {
+        return 1;
+    }
+    const size_t n_msgs = 1 << 14;
+    const size_t n_passes = 256;
+    const size_t slot = 16;
+    std::vector<uint8_t> msg_data = bench_random_bytes(n_msgs * slot, 2);
+    std::vector<const char *> msgs(n_msgs);
+    for (size_t i = 0; i < n_msgs; ++i) {
+        msgs[i] = (const char *)&msg_data[i * slot];
+    }
+    const size_t lane_block = 1024;
+    std::vector<uint64_t> lane_data(mib.n_out * lane_block);
+    std::vector<uint64_t *> lanes(mib.n_out);
+    for (unsigned k = 0; k < mib.n_out; ++k) {
+        lanes[k] = &lane_data[k * lane_block];
+    }
+
+    bench_run("MIB-NB extract_u8 per message", 0, n_msgs * n_passes, [&] {
+        for (size_t i = 0; i < n_msgs * n_passes; ++i) {
+            bitp_parser_t parser;
+            bitp_parser_init(&parser, msgs[i % n_msgs], 34);
+            size_t j = i % lane_block;
+            uint8_t v;
+            for (unsigned k = 0; k < mib.n_out; ++k) {
+                static const unsigned widths[] = {4, 2, 4, 5, 1, 2, 5, 1};
+                bitp_parser_extract_u8(&parser, &v, widths[k]);
+                lanes[k][j] = v;
+            }
+        }
+        bench_keep(lanes[3][lane_block / 2]);
+    });
+    const char *isa_names[] = {"MIB-NB lanes, scalar", "MIB-NB lanes, scalar (SSE2)", "MIB-NB lanes, AVX2",
+                               "MIB-NB lanes, AVX-512"};
+    for (int isa = BITP_ISA_SCALAR; isa <= bitp_cpu_isa(bitp_cpu_features()); ++isa) {
+        if (isa == BITP_ISA_SSE2) {
+            continue;
+        }
+        bench_run(isa_names[isa], 0, n_msgs * n_passes, [&] {
+            for (size_t i = 0; i < n_msgs * n_passes; i += lane_block) {
+                bitp_plan_run_lanes_isa(&mib, msgs.data() + i % n_msgs, lane_block, lanes.data(), (bitp_isa_t)isa);
+            }
+            bench_keep(lanes[3][lane_block / 2]);
+        });
+    }
+
+    return 0;
+}
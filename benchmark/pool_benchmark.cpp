@@ -0,0 +1,111 @@
+/*
+ * pool_benchmark.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <algorithm>
+#include <memory>
+
+#include "bench.h"
+
+extern "C" {
+#include "bitp/pool.h"
+}
+
+// 1M flows with 16 bytes of pending data each, visited in random order; a visit decodes the next
+// 13-bit field of the flow and bumps a per-flow counter, starting over at the end of the data
+static const uint32_t n_flows = 1 << 20;
+static const uint32_t flow_bits = 16 * CHAR_BIT;
+static const size_t n_visits = 1 << 23;
+
+struct heap_flow {
+    bitp_parser_t parser;
+    uint32_t counter;
+};
+
+int main() {
+    std::vector<uint8_t> arena = bench_random_bytes((size_t)n_flows * flow_bits / CHAR_BIT + 64);
+    std::vector<uint32_t> visits(n_visits);
+    std::mt19937 rng(7);
+    for (auto &v : visits) {
+        v = rng() % n_flows;
+    }
+    std::vector<uint32_t> counters(n_flows, 0);
+
+    // the usual per-flow object on the heap, allocated in a random order
+    {
+        std::vector<std::unique_ptr<heap_flow>> flows(n_flows);
+        std::vector<uint32_t> order(n_flows);
+        for (uint32_t f = 0; f < n_flows; ++f) {
+            order[f] = f;
+        }
+        std::shuffle(order.begin(), order.end(), rng);
+        for (uint32_t f : order) {
+            flows[f].reset(new heap_flow());
+            bitp_parser_init(&flows[f]->parser, (const char *)arena.data(), (size_t)(f + 1) * flow_bits);
+            flows[f]->parser.iter = (size_t)f * flow_bits;
+        }
+        bench_run("heap object per flow (24 + 4 bytes)", 0, n_visits, [&] {
+            uint64_t sum = 0;
+            for (uint32_t f : visits) {
+                heap_flow *flow = flows[f].get();
+                uint16_t v = 0;
+                if (bitp_parser_extract_u16(&flow->parser, &v, 13) != BITP_OK) {
+                    flow->parser.iter = flow->parser.capacity - flow_bits;
+                }
+                flow->counter++;
+                sum += v;
+            }
+            bench_keep(sum);
+        });
+    }
+
+    {
+        std::vector<bitp_parser_t> parsers(n_flows);
+        for (uint32_t f = 0; f < n_flows; ++f) {
+            bitp_parser_init(&parsers[f], (const char *)arena.data(), (size_t)(f + 1) * flow_bits);
+            parsers[f].iter = (size_t)f * flow_bits;
+        }
+        bench_run("bitp_parser_t array (24 bytes)", 0, n_visits, [&] {
+            uint64_t sum = 0;
+            for (uint32_t f : visits) {
+                uint16_t v = 0;
+                if (bitp_parser_extract_u16(&parsers[f], &v, 13) != BITP_OK) {
+                    parsers[f].iter = parsers[f].capacity - flow_bits;
+                }
+                counters[f]++;
+                sum += v;
+            }
+            bench_keep(sum);
+        });
+    }
+
+    {
+        std::vector<bitp_cursor_t> slots(n_flows);
+        bitp_pool_t pool;
+        bitp_pool_init(&pool, (char *)arena.data(), (size_t)n_flows * flow_bits, slots.data(), n_flows);
+        std::vector<uint32_t> handles(n_flows);
+        for (uint32_t f = 0; f < n_flows; ++f) {
+            bitp_pool_alloc(&pool, f * flow_bits, flow_bits, &handles[f]);
+        }
+        bench_run("bitp_pool cursors (8 bytes)", 0, n_visits, [&] {
+            uint64_t sum = 0;
+            for (uint32_t f : visits) {
+                bitp_parser_t parser;
+                uint16_t v = 0;
+                bitp_pool_load_parser(&pool, f, &parser);
+                if (bitp_parser_extract_u16(&parser, &v, 13) != BITP_OK) {
+                    parser.iter = parser.capacity - flow_bits;
+                }
+                bitp_pool_store_parser(&pool, f, &parser);
+                counters[f]++;
+                sum += v;
+            }
+            bench_keep(sum);
+        });
+    }
+
+    return 0;
+}
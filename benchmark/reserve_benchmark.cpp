@@ -0,0 +1,95 @@
+/*
+ * reserve_benchmark.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include "bench.h"
+
+extern "C" {
+#define BITP_CHECK_ALL
+#include "bitp/packer.h"
+#include "bitp/parser.h"
+}
+
+// fixed header of 20 fields, 180 bits
+static const unsigned widths[] = {4, 2, 4, 5, 1, 12, 16, 3, 7, 9, 14, 6, 1, 1, 24, 11, 8, 13, 10, 29};
+static const unsigned n_fields = sizeof(widths) / sizeof(widths[0]);
+static const unsigned msg_bits = 180;
+
+static uint64_t decode_checked(const std::vector<uint8_t> &buf, size_t n_msgs) {
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, (const char *)buf.data(), n_msgs * msg_bits);
+    uint64_t sum = 0;
+    for (size_t m = 0; m < n_msgs; ++m) {
+        for (unsigned i = 0; i < n_fields; ++i) {
+            uint32_t v;
+            if (bitp_parser_extract_u32(&parser, &v, widths[i]) != BITP_OK) {
+                return 0;
+            }
+            sum += v;
+        }
+    }
+    return sum;
+}
+
+static uint64_t decode_reserved(const std::vector<uint8_t> &buf, size_t n_msgs) {
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, (const char *)buf.data(), n_msgs * msg_bits);
+    uint64_t sum = 0;
+    for (size_t m = 0; m < n_msgs; ++m) {
+        bitp_parser_reserved_t reserved;
+        if (bitp_parser_reserve(&parser, msg_bits, &reserved) != BITP_OK) {
+            return 0;
+        }
+        for (unsigned i = 0; i < n_fields; ++i) {
+            uint32_t v;
+            bitp_parser_reserved_extract_u32(&reserved, &v, widths[i]);
+            sum += v;
+        }
+    }
+    return sum;
+}
+
+static bitp_status_t encode_checked(std::vector<uint8_t> &buf, size_t n_msgs) {
+    bitp_packer_t packer;
+    bitp_packer_init(&packer, (char *)buf.data(), n_msgs * msg_bits, 1);
+    for (size_t m = 0; m < n_msgs; ++m) {
+        for (unsigned i = 0; i < n_fields; ++i) {
+            bitp_status_t status = bitp_packer_add_u32(&packer, (uint32_t)(m + i) & ((1u << widths[i]) - 1), widths[i]);
+            if (status != BITP_OK) {
+                return status;
+            }
+        }
+    }
+    return BITP_OK;
+}
+
+static bitp_status_t encode_reserved(std::vector<uint8_t> &buf, size_t n_msgs) {
+    bitp_packer_t packer;
+    bitp_packer_init(&packer, (char *)buf.data(), n_msgs * msg_bits, 1);
+    for (size_t m = 0; m < n_msgs; ++m) {
+        bitp_packer_reserved_t reserved;
+        bitp_status_t status = bitp_packer_reserve(&packer, msg_bits, &reserved);
+        if (status != BITP_OK) {
+            return status;
+        }
+        for (unsigned i = 0; i < n_fields; ++i) {
+            bitp_packer_reserved_add_u32(&reserved, (uint32_t)(m + i) & ((1u << widths[i]) - 1), widths[i]);
+        }
+    }
+    return BITP_OK;
+}
+
+int main() {
+    const size_t n_msgs = 1 << 20;
+    std::vector<uint8_t> buf = bench_random_bytes(n_msgs * msg_bits / CHAR_BIT + 16);
+
+    bench_run("decode, checked per field", 0, n_msgs, [&] { bench_keep(decode_checked(buf, n_msgs)); });
+    bench_run("decode, reserved per message", 0, n_msgs, [&] { bench_keep(decode_reserved(buf, n_msgs)); });
+    bench_run("encode, checked per field", 0, n_msgs, [&] { bench_keep(encode_checked(buf, n_msgs)); });
+    bench_run("encode, reserved per message", 0, n_msgs, [&] { bench_keep(encode_reserved(buf, n_msgs)); });
+
+    return 0;
+}
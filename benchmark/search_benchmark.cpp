@@ -0,0 +1,54 @@
+/*
+ * search_benchmark.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include "bench.h"
+
+extern "C" {
+#include "bitp/search.h"
+}
+
+static size_t count_matches(const std::vector<uint8_t> &buf, uint64_t value, unsigned n_bits, unsigned max_errors) {
+    bitp_pattern_t pattern;
+    bitp_pattern_init(&pattern, value, n_bits, max_errors);
+
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, (const char *)buf.data(), buf.size() * CHAR_BIT);
+
+    size_t n = 0;
+    while (bitp_parser_find(&parser, &pattern) == BITP_OK) {
+        n++;
+        parser.iter++;
+    }
+    return n;
+}
+
+// bit-by-bit shift register, the way sync search is usually written
+static size_t count_matches_shift_register(const std::vector<uint8_t> &buf, uint64_t value, unsigned n_bits) {
+    uint64_t mask = n_bits == 64 ? ~0ULL : (1ULL << n_bits) - 1;
+    uint64_t reg = 0;
+    size_t n = 0;
+    for (size_t i = 0; i < buf.size() * CHAR_BIT; ++i) {
+        reg = (reg << 1) | ((buf[i / CHAR_BIT] >> (7 - i % CHAR_BIT)) & 1);
+        if (i + 1 >= n_bits && (reg & mask) == value) {
+            n++;
+        }
+    }
+    return n;
+}
+
+int main() {
+    const size_t size = 64 << 20;
+    std::vector<uint8_t> buf = bench_random_bytes(size);
+
+    bench_run("shift register, 32 bit", size, 0, [&] { bench_keep(count_matches_shift_register(buf, 0x1ACFFC1D, 32)); });
+    bench_run("bitp_parser_find, 32 bit exact", size, 0, [&] { bench_keep(count_matches(buf, 0x1ACFFC1D, 32, 0)); });
+    bench_run("bitp_parser_find, 64 bit exact", size, 0, [&] { bench_keep(count_matches(buf, 0x1ACFFC1D0123ABCDULL, 64, 0)); });
+    bench_run("bitp_parser_find, 12 bit exact", size, 0, [&] { bench_keep(count_matches(buf, 0xA5A, 12, 0)); });
+    bench_run("bitp_parser_find, 32 bit, 3 errors", size, 0, [&] { bench_keep(count_matches(buf, 0x1ACFFC1D, 32, 3)); });
+
+    return 0;
+}
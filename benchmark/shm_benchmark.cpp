@@ -0,0 +1,296 @@
+/*
+ * shm_benchmark.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <sched.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <string>
+
+#include "bench.h"
+
+extern "C" {
+#include "bitp/shm.h"
+}
+
+/*
+ * An encoder process sends packed messages to a decoder process: through the ring, packed in place
+ * and parsed in place, and through a socketpair, packed into a buffer, written, read into another
+ * buffer and parsed there. Both sides wait with sched_yield, on one core a wait is a switch to the
+ * other process.
+ */
+
+static const size_t batch_bytes = 1 << 16;
+
+// MIB-NB-like fields; longer messages carry a payload for another layer up to n_bits, the last
+// word of it is written
+static void pack(bitp_packer_t *packer, uint32_t i, size_t n_bits) {
+    bitp_packer_add_u8(packer, (uint8_t)(i & 0xF), 4);
+    bitp_packer_add_u8(packer, 2, 2);
+    bitp_packer_add_u8(packer, (uint8_t)(i % 19), 5);
+    bitp_packer_add_u8(packer, 17, 5);
+    bitp_packer_add_u16(packer, (uint16_t)(i & 0xFFFF), 16);
+    bitp_packer_add_u8(packer, 1, 2);
+    if (n_bits >= packer->iter + 64) {
+        packer->iter = n_bits - 64;
+        bitp_packer_add_u64(packer, i * 0x9E3779B97F4A7C15ULL, 64);
+    }
+}
+
+static uint64_t parse(bitp_parser_t *parser) {
+    uint8_t a = 0, b = 0, c = 0, d = 0, e = 0;
+    uint16_t f = 0;
+    bitp_parser_extract_u8(parser, &a, 4);
+    bitp_parser_extract_u8(parser, &b, 2);
+    bitp_parser_extract_u8(parser, &c, 5);
+    bitp_parser_extract_u8(parser, &d, 5);
+    bitp_parser_extract_u16(parser, &f, 16);
+    bitp_parser_extract_u8(parser, &e, 2);
+    uint64_t sum = a + b + c + d + e + f;
+    if (parser->capacity - parser->iter >= 64) {
+        uint64_t v = 0;
+        parser->iter = parser->capacity - 64;
+        bitp_parser_extract_u64(parser, &v, 64);
+        sum += v;
+    }
+    return sum;
+}
+
+static void run_ring_producer(const char *name, size_t n_msgs, size_t n_bits) {
+    bitp_shm_t *prod;
+    if (bitp_shm_open(&prod, name) != BITP_OK) {
+        _exit(1);
+    }
+    for (size_t i = 0; i < n_msgs; ++i) {
+        bitp_packer_t packer;
+        while (bitp_shm_reserve(prod, n_bits, &packer) == BITP_EFULL) {
+            sched_yield();
+        }
+        pack(&packer, (uint32_t)i, n_bits);
+        bitp_shm_commit(prod, &packer);
+    }
+    bitp_shm_close(prod);
+    _exit(0);
+}
+
+static uint64_t run_ring(const char *name, bitp_shm_t *cons, size_t n_msgs, size_t n_bits) {
+    pid_t child = fork();
+    if (child == 0) {
+        run_ring_producer(name, n_msgs, n_bits);
+    }
+    uint64_t sum = 0;
+    for (size_t i = 0; i < n_msgs;) {
+        bitp_parser_t parser;
+        if (bitp_shm_next(cons, &parser) != BITP_OK) {
+            bitp_shm_release(cons);
+            sched_yield();
+            continue;
+        }
+        sum += parse(&parser);
+        if (++i % 64 == 0) {
+            bitp_shm_release(cons);
+        }
+    }
+    bitp_shm_release(cons);
+    waitpid(child, NULL, 0);
+    return sum;
+}
+
+// messages of one size, packed into a buffer and written in batches of up to batch_bytes
+static uint64_t run_socket(size_t n_msgs, size_t n_bits) {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        return 0;
+    }
+    const size_t msg_bytes = (n_bits + CHAR_BIT - 1) / CHAR_BIT;
+    const size_t per_batch = batch_bytes / msg_bytes;
+    pid_t child = fork();
+    if (child == 0) {
+        close(fds[0]);
+        std::vector<char> msg(msg_bytes), out(per_batch * msg_bytes);
+        for (size_t i = 0; i < n_msgs;) {
+            size_t n = 0;
+            for (; n < per_batch && i < n_msgs; ++n, ++i) {
+                bitp_packer_t packer;
+                bitp_packer_init(&packer, msg.data(), n_bits, 1);
+                pack(&packer, (uint32_t)i, n_bits);
+                memcpy(&out[n * msg_bytes], msg.data(), msg_bytes);
+            }
+            for (size_t off = 0; off < n * msg_bytes;) {
+                ssize_t w = write(fds[1], &out[off], n * msg_bytes - off);
+                if (w <= 0) {
+                    _exit(1);
+                }
+                off += (size_t)w;
+            }
+        }
+        _exit(0);
+    }
+    close(fds[1]);
+
+    std::vector<char> in(batch_bytes + msg_bytes + sizeof(uint64_t)), msg(msg_bytes + sizeof(uint64_t));
+    uint64_t sum = 0;
+    size_t have = 0;
+    for (size_t i = 0; i < n_msgs;) {
+        ssize_t r = read(fds[0], &in[have], batch_bytes);
+        if (r <= 0) {
+            break;
+        }
+        have += (size_t)r;
+        size_t off = 0;
+        for (; off + msg_bytes <= have && i < n_msgs; off += msg_bytes, ++i) {
+            memcpy(msg.data(), &in[off], msg_bytes);
+            bitp_parser_t parser;
+            bitp_parser_init(&parser, msg.data(), n_bits);
+            sum += parse(&parser);
+        }
+        memmove(in.data(), &in[off], have - off);
+        have -= off;
+    }
+    close(fds[0]);
+    waitpid(child, NULL, 0);
+    return sum;
+}
+
+// round trips of a message through a second process, which sends back its first 32 bits
+static void run_ring_ping(const char *ping, const char *pong, size_t n_trips, size_t n_bits) {
+    bitp_shm_t *out, *in;
+    bitp_shm_open(&out, ping);
+    bitp_shm_open(&in, pong);
+    pid_t child = fork();
+    if (child == 0) {
+        std::swap(out, in);
+    }
+    for (size_t i = 0; i < n_trips; ++i) {
+        bitp_packer_t packer;
+        bitp_parser_t parser;
+        if (child != 0) {
+            bitp_shm_reserve(out, n_bits, &packer);
+            pack(&packer, (uint32_t)i, n_bits);
+            bitp_shm_commit(out, &packer);
+        }
+        while (bitp_shm_next(in, &parser) != BITP_OK) {
+            sched_yield();
+        }
+        uint32_t v = 0;
+        bitp_parser_extract_u32(&parser, &v, 32);
+        bitp_shm_release(in);
+        if (child == 0) {
+            bitp_shm_reserve(out, 32, &packer);
+            bitp_packer_add_u32(&packer, v, 32);
+            bitp_shm_commit(out, &packer);
+        }
+        bench_keep(v);
+    }
+    if (child == 0) {
+        _exit(0);
+    }
+    waitpid(child, NULL, 0);
+    bitp_shm_close(out);
+    bitp_shm_close(in);
+}
+
+static void run_socket_ping(size_t n_trips, size_t n_bits) {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) != 0) {
+        return;
+    }
+    const size_t msg_bytes = (n_bits + CHAR_BIT - 1) / CHAR_BIT;
+    std::vector<char> buf(msg_bytes + sizeof(uint64_t));
+    pid_t child = fork();
+    int fd = fds[child == 0 ? 1 : 0];
+    for (size_t i = 0; i < n_trips; ++i) {
+        bitp_packer_t packer;
+        bitp_parser_t parser;
+        if (child != 0) {
+            bitp_packer_init(&packer, buf.data(), n_bits, 1);
+            pack(&packer, (uint32_t)i, n_bits);
+            if (write(fd, buf.data(), msg_bytes) != (ssize_t)msg_bytes) {
+                break;
+            }
+        }
+        ssize_t r = read(fd, buf.data(), msg_bytes);
+        if (r <= 0) {
+            break;
+        }
+        bitp_parser_init(&parser, buf.data(), (size_t)r * CHAR_BIT);
+        uint32_t v = 0;
+        bitp_parser_extract_u32(&parser, &v, 32);
+        if (child == 0) {
+            bitp_packer_init(&packer, buf.data(), 32, 1);
+            bitp_packer_add_u32(&packer, v, 32);
+            if (write(fd, buf.data(), 4) != 4) {
+                break;
+            }
+        }
+        bench_keep(v);
+    }
+    if (child == 0) {
+        _exit(0);
+    }
+    waitpid(child, NULL, 0);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+int main() {
+    std::string pid = std::to_string(getpid());
+    std::string name = "/bitp_bench_" + pid, ping = "/bitp_bench_ping_" + pid, pong = "/bitp_bench_pong_" + pid;
+    bitp_shm_t *ring, *ping_ring, *pong_ring;
+    if (bitp_shm_create(&ring, name.c_str(), 1 << 20, BITP_SHM_SPSC) != BITP_OK ||
+        bitp_shm_create(&ping_ring, ping.c_str(), 1 << 16, BITP_SHM_SPSC) != BITP_OK ||
+        bitp_shm_create(&pong_ring, pong.c_str(), 1 << 16, BITP_SHM_SPSC) != BITP_OK) {
+        std::perror("bitp_shm_create");
+        return 1;
+    }
+    std::printf("online CPUs: %ld\n", sysconf(_SC_NPROCESSORS_ONLN));
+
+    const size_t n_msgs = 1 << 21;
+    for (size_t n_bits : {(size_t)34, (size_t)4000}) {
+        const double bytes = (double)n_msgs * ((n_bits + CHAR_BIT - 1) / CHAR_BIT);
+        char label[64];
+        std::vector<char> buf(n_bits / CHAR_BIT + 1 + sizeof(uint64_t));
+        std::snprintf(label, sizeof(label), "pack and parse only, %zu-bit messages", n_bits);
+        bench_run(label, bytes, n_msgs, [&] {
+            uint64_t sum = 0;
+            for (size_t i = 0; i < n_msgs; ++i) {
+                bitp_packer_t packer;
+                bitp_packer_init(&packer, buf.data(), n_bits, 1);
+                pack(&packer, (uint32_t)i, n_bits);
+                bitp_parser_t parser;
+                bitp_parser_init(&parser, buf.data(), packer.iter);
+                sum += parse(&parser);
+            }
+            bench_keep(sum);
+        });
+        std::snprintf(label, sizeof(label), "ring, %zu-bit messages", n_bits);
+        bench_run(label, bytes, n_msgs, [&] { bench_keep(run_ring(name.c_str(), ring, n_msgs, n_bits)); });
+        std::snprintf(label, sizeof(label), "socket batched, %zu-bit messages", n_bits);
+        bench_run(label, bytes, n_msgs, [&] { bench_keep(run_socket(n_msgs, n_bits)); });
+    }
+
+    const size_t n_trips = 1 << 15;
+    for (size_t n_bits : {(size_t)34, (size_t)4000}) {
+        char label[64];
+        std::snprintf(label, sizeof(label), "ring round trip, %zu-bit messages", n_bits);
+        double t = bench_run(label, 0, n_trips, [&] { run_ring_ping(ping.c_str(), pong.c_str(), n_trips, n_bits); });
+        std::printf("    %.2f us per round trip\n", t / n_trips * 1e6);
+        std::snprintf(label, sizeof(label), "socket round trip, %zu-bit messages", n_bits);
+        t = bench_run(label, 0, n_trips, [&] { run_socket_ping(n_trips, n_bits); });
+        std::printf("    %.2f us per round trip\n", t / n_trips * 1e6);
+    }
+
+    bitp_shm_close(ring);
+    bitp_shm_close(ping_ring);
+    bitp_shm_close(pong_ring);
+    bitp_shm_unlink(name.c_str());
+    bitp_shm_unlink(ping.c_str());
+    bitp_shm_unlink(pong.c_str());
+    return 0;
+}
@@ -0,0 +1,61 @@
+/*
+ * template_benchmark.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include "bench.h"
+
+extern "C" {
+#include "bitp/template.h"
+}
+
+// periodic message: 18 constant fields, a 16-bit sequence number and a 40-bit timestamp
+static const unsigned widths[] = {4, 2, 4, 5, 1, 12, 3, 7, 9, 14, 6, 1, 1, 24, 11, 8, 13, 10};
+static const unsigned n_fields = sizeof(widths) / sizeof(widths[0]);
+static const size_t msg_bytes = 25;
+
+static void pack_full(char *msg, uint64_t seq, uint64_t ts) {
+    bitp_packer_t packer;
+    bitp_packer_init(&packer, msg, msg_bytes * CHAR_BIT, 1);
+    for (unsigned i = 0; i < n_fields; ++i) {
+        bitp_packer_add_u32(&packer, (1u << (widths[i] - 1)) | i, widths[i]);
+        if (i == 5) {
+            bitp_packer_add_u16(&packer, (uint16_t)seq, 16);
+        }
+    }
+    bitp_packer_add_u64(&packer, ts, 40);
+}
+
+int main() {
+    const size_t n_msgs = 1 << 21;
+    std::vector<char> out(msg_bytes * 1024);
+
+    char tmpl_buf[msg_bytes];
+    bitp_template_t tmpl;
+    bitp_template_init(&tmpl, tmpl_buf, msg_bytes * CHAR_BIT);
+    for (unsigned i = 0; i < n_fields; ++i) {
+        bitp_packer_add_u32(&tmpl.packer, (1u << (widths[i] - 1)) | i, widths[i]);
+        if (i == 5) {
+            bitp_template_add_var(&tmpl, 0, 16, NULL);
+        }
+    }
+    bitp_template_add_var(&tmpl, 0, 40, NULL);
+
+    bench_run("full re-pack", 0, n_msgs, [&] {
+        for (size_t m = 0; m < n_msgs; ++m) {
+            pack_full(&out[(m % 1024) * msg_bytes], m & 0xFFFF, m);
+        }
+        bench_keep(out[0]);
+    });
+    bench_run("template instance", 0, n_msgs, [&] {
+        for (size_t m = 0; m < n_msgs; ++m) {
+            const uint64_t vals[] = {m & 0xFFFF, m};
+            bitp_template_instance(&tmpl, &out[(m % 1024) * msg_bytes], vals);
+        }
+        bench_keep(out[0]);
+    });
+
+    return 0;
+}
@@ -0,0 +1,156 @@
+/*
+ * trace_benchmark.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include "bench.h"
+
+extern "C" {
+#define BITP_TRACE
+#include "bitp/packer.h"
+#include "bitp/parser.h"
+#include "bitp/trace.h"
+}
+
+/*
+ * Two message types decoded field by field: "MIB", 4 fields, and "SIB", a header and a list of
+ * 1 to 16 cells of 4 fields each. The decoder is built twice, without the tags and with them, the
+ * first is what a build without BITP_TRACE runs. The traced run leaves its events in
+ * bitp_trace_benchmark.txt for bitp_tracereport.
+ */
+
+#define TAG_BEGIN(parser, name) \
+    if (traced)                 \
+    BITP_TRACE_BEGIN(parser, name)
+#define TAG_END(parser, name) \
+    if (traced)               \
+    BITP_TRACE_END(parser, name)
+#define TAG_FIELD(parser, name, stmt) \
+    do {                              \
+        TAG_BEGIN(parser, name);      \
+        stmt;                         \
+        TAG_END(parser, name);        \
+    } while (0)
+
+struct cell {
+    uint16_t pci;
+    uint8_t offset;
+    int16_t q_rx_lev_min;
+    uint8_t barred;
+};
+
+struct decoded {
+    uint8_t sfn, bandwidth, phich, spare, type;
+    uint8_t n_cells;
+    uint32_t cell_id;
+    cell cells[16];
+};
+
+template <bool traced>
+static size_t decode_mib(bitp_parser_t *parser, decoded *d) {
+    size_t errors = 0;
+    TAG_BEGIN(parser, "MIB");
+    TAG_FIELD(parser, "dl-Bandwidth", errors += bitp_parser_extract_u8(parser, &d->bandwidth, 3) != BITP_OK);
+    TAG_FIELD(parser, "phich-Config", errors += bitp_parser_extract_u8(parser, &d->phich, 3) != BITP_OK);
+    TAG_FIELD(parser, "systemFrameNumber", errors += bitp_parser_extract_u8(parser, &d->sfn, 8) != BITP_OK);
+    TAG_FIELD(parser, "spare", errors += bitp_parser_extract_u8(parser, &d->spare, 8) != BITP_OK);
+    TAG_END(parser, "MIB");
+    return errors;
+}
+
+template <bool traced>
+static size_t decode_sib(bitp_parser_t *parser, decoded *d) {
+    size_t errors = 0;
+    TAG_BEGIN(parser, "SIB");
+    TAG_FIELD(parser, "cellIdentity", errors += bitp_parser_extract_u32(parser, &d->cell_id, 28) != BITP_OK);
+    TAG_FIELD(parser, "count", errors += bitp_parser_extract_u8(parser, &d->n_cells, 4) != BITP_OK);
+    TAG_BEGIN(parser, "neighCellList");
+    for (size_t i = 0; i <= d->n_cells; ++i) {
+        cell &c = d->cells[i];
+        TAG_BEGIN(parser, "cell");
+        TAG_FIELD(parser, "physCellId", errors += bitp_parser_extract_u16(parser, &c.pci, 9) != BITP_OK);
+        TAG_FIELD(parser, "q-OffsetCell", errors += bitp_parser_extract_u8(parser, &c.offset, 5) != BITP_OK);
+        TAG_FIELD(parser, "q-RxLevMin", errors += bitp_parser_extract_i16(parser, &c.q_rx_lev_min, 7) != BITP_OK);
+        TAG_FIELD(parser, "cellBarred", errors += bitp_parser_extract_u8(parser, &c.barred, 1) != BITP_OK);
+        TAG_END(parser, "cell");
+    }
+    TAG_END(parser, "neighCellList");
+    TAG_END(parser, "SIB");
+    return errors;
+}
+
+// a stream of messages: a type bit, then the message; a sum of the fields, they're used
+template <bool traced>
+static uint64_t decode_stream(const char *buf, size_t n_bits, size_t n_msgs, decoded *d) {
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, buf, n_bits);
+    uint64_t sum = 0;
+    for (size_t i = 0; i < n_msgs; ++i) {
+        sum += bitp_parser_extract_u8(&parser, &d->type, 1) != BITP_OK;
+        if (!d->type) {
+            sum += decode_mib<traced>(&parser, d) + d->bandwidth + d->phich + d->sfn + d->spare;
+            continue;
+        }
+        sum += decode_sib<traced>(&parser, d) + d->cell_id;
+        for (size_t c = 0; c <= d->n_cells; ++c) {
+            sum += d->cells[c].pci + d->cells[c].offset + d->cells[c].q_rx_lev_min + d->cells[c].barred;
+        }
+    }
+    return sum;
+}
+
+int main() {
+    const size_t n_msgs = 10000, reps = 10;
+    std::mt19937_64 rng(48);
+    std::vector<char> buf(n_msgs * 240 / CHAR_BIT + 64);
+    bitp_packer_t packer;
+    bitp_packer_init(&packer, buf.data(), (buf.size() - sizeof(uint64_t)) * CHAR_BIT, 1);
+    size_t n_tags = 0;
+    for (size_t i = 0; i < n_msgs; ++i) {
+        // a SIB in 4
+        bool sib = rng() % 4 == 0;
+        bitp_packer_add_u8(&packer, sib, 1);
+        if (!sib) {
+            bitp_packer_add_u32(&packer, (uint32_t)rng() & 0x3fffff, 22);
+            n_tags += 2 * 5;
+            continue;
+        }
+        size_t n_cells = rng() % 16;
+        bitp_packer_add_u32(&packer, (uint32_t)rng() & 0xfffffff, 28);
+        bitp_packer_add_u8(&packer, (uint8_t)n_cells, 4);
+        for (size_t c = 0; c <= n_cells; ++c) {
+            bitp_packer_add_u32(&packer, (uint32_t)rng() & 0x3fffff, 22);
+        }
+        n_tags += 2 * (4 + 5 * (n_cells + 1));
+    }
+    const size_t n_bits = packer.iter;
+    decoded d = {};
+    printf("%zu messages, %zu bits, %zu tags\n", n_msgs, n_bits, n_tags);
+
+    double plain = bench_run("decode, untraced", (double)reps * n_bits / CHAR_BIT, (double)reps * n_msgs, [&] {
+        for (size_t r = 0; r < reps; ++r) {
+            bench_keep(decode_stream<false>(buf.data(), n_bits, n_msgs, &d));
+        }
+    });
+    // enough room that the last run is in the dump whole
+    bitp_trace_init(2 * n_tags);
+    double traced = bench_run("decode, traced", (double)reps * n_bits / CHAR_BIT, (double)reps * n_msgs, [&] {
+        for (size_t r = 0; r < reps; ++r) {
+            bitp_trace_clear();
+            bench_keep(decode_stream<true>(buf.data(), n_bits, n_msgs, &d));
+        }
+    });
+    printf("    %.2f ns per message, %.2f ns per tag\n", (traced - plain) / (reps * n_msgs) * 1e9,
+           (traced - plain) / ((double)reps * n_tags) * 1e9);
+
+    FILE *f = fopen("bitp_trace_benchmark.txt", "w");
+    if (!f || bitp_trace_dump(f) != BITP_OK) {
+        printf("    can't write bitp_trace_benchmark.txt\n");
+    }
+    if (f) {
+        fclose(f);
+    }
+    return 0;
+}
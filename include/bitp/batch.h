@@ -0,0 +1,51 @@
+/*
+ * batch.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#ifndef INCLUDE_BITP_BATCH_H_
+#define INCLUDE_BITP_BATCH_H_
+
+#include "packer.h"
+
+/*
+ * Packing a batch of variable-length messages back to back into one buffer on several threads,
+ * part of the compiled bitp_kernels library. The bit length of every message is known first, so
+ * every thread packs its messages directly at their final offsets. Messages aren't byte-aligned,
+ * the bytes shared by the messages of different threads are written one thread at a time.
+ */
+
+/* packs one message, must pack the same number of bits on every call */
+typedef bitp_status_t (*bitp_batch_pack_fn_t)(bitp_packer_t *packer, const void *msg, void *ctx);
+
+/* bit length of one message */
+typedef size_t (*bitp_batch_size_fn_t)(const void *msg, void *ctx);
+
+typedef struct bitp_batch_tag {
+    bitp_batch_pack_fn_t pack;
+    // NULL to measure the messages with a dry run of pack into a scratch buffer
+    bitp_batch_size_fn_t size;
+    // scratch size of the dry run, the longest message
+    size_t max_msg_bits;
+    void *ctx;
+    // 0 for the number of hardware threads
+    unsigned n_threads;
+} bitp_batch_t;
+
+/*
+ * Packs messages msgs, msgs + msg_stride, ... at inst->iter and moves it past the batch. The
+ * buffer must be zeroed, like for bitp_packer_add_*. offsets, if not NULL, gets n_msgs + 1 bit
+ * offsets of the messages and of the end. BITP_EFULL if the batch doesn't fit (nothing is
+ * written), the status of pack on errors, BITP_EINVALID_ARG if a message packs to a size other
+ * than measured.
+ */
+bitp_status_t bitp_batch_pack(const bitp_batch_t *batch,
+                              bitp_packer_t *inst,
+                              const void *msgs,
+                              size_t msg_stride,
+                              size_t n_msgs,
+                              size_t *offsets);
+
+#endif /* INCLUDE_BITP_BATCH_H_ */
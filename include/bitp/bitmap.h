@@ -0,0 +1,412 @@
+/*
+ * bitmap.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#ifndef INCLUDE_BITP_BITMAP_H_
+#define INCLUDE_BITP_BITMAP_H_
+
+#include "bitops.h"
+#include "view.h"
+
+/* no such bit */
+#define BITP_BITMAP_NPOS ((size_t)-1)
+
+/*
+ * Bitmaps at any bit offset of a message (resource block allocations, HARQ ACK bitmaps,
+ * measurement masks) queried in place through a view, bit 0 is the first bit of the view. The
+ * whole bytes in the middle go 64 bits per step; scans skip 32 or 64 bytes per step with AVX2
+ * and AVX-512, counts use POPCNT from the AVX2 tier on.
+ */
+
+size_t bitp_bitmap_popcount(const bitp_view_t *inst);
+
+/* offset of the first set (clear) bit at or after from, BITP_BITMAP_NPOS if there is none */
+size_t bitp_bitmap_find_set(const bitp_view_t *inst, size_t from);
+
+size_t bitp_bitmap_find_clear(const bitp_view_t *inst, size_t from);
+
+/* the same with an instruction set tier no higher than the CPU supports, for tests and benchmarks */
+size_t bitp_bitmap_popcount_isa(const bitp_view_t *inst, bitp_isa_t isa);
+
+size_t bitp_bitmap_find_set_isa(const bitp_view_t *inst, size_t from, bitp_isa_t isa);
+
+size_t bitp_bitmap_find_clear_isa(const bitp_view_t *inst, size_t from, bitp_isa_t isa);
+
+/*
+ * Set bits of a view in increasing order, a word at a time:
+ *
+ *     bitp_bitmap_iter_t it;
+ *     size_t pos;
+ *     bitp_bitmap_iter_init(&it, &view);
+ *     while (bitp_bitmap_iter_next(&it, &pos)) { ... }
+ */
+typedef struct bitp_bitmap_iter_tag {
+    const char *buf;
+    size_t begin;
+    size_t end;
+    // first bit of the current word and its bits not returned yet, MSB first
+    size_t chunk;
+    uint64_t word;
+} bitp_bitmap_iter_t;
+
+void bitp_bitmap_iter_init(bitp_bitmap_iter_t *inst, const bitp_view_t *view);
+
+/* 1 and the offset of the next set bit in pos, 0 after the last one */
+int bitp_bitmap_iter_next(bitp_bitmap_iter_t *inst, size_t *pos);
+
+typedef enum bitp_bitmap_op_tag {
+    BITP_BITMAP_AND = 0,
+    BITP_BITMAP_OR,
+    BITP_BITMAP_XOR,
+    // dst & ~src
+    BITP_BITMAP_ANDNOT,
+} bitp_bitmap_op_t;
+
+/*
+ * n_bits at the packer's position become dst op src, src read at the parser's position; both
+ * are moved past them. Unlike bitp_packer_add_*, the packer's bits are read and overwritten in
+ * place. BITP_EFULL if either side has fewer than n_bits (nothing is done then). The two ranges
+ * must not overlap.
+ */
+bitp_status_t bitp_bitmap_apply(bitp_packer_t *dst, bitp_parser_t *src, size_t n_bits, bitp_bitmap_op_t op);
+
+bitp_status_t bitp_bitmap_apply_isa(bitp_packer_t *dst, bitp_parser_t *src, size_t n_bits, bitp_bitmap_op_t op, bitp_isa_t isa);
+
+/*
+ **************************************************************************************************
+  Realization
+ **************************************************************************************************
+ */
+
+/* the bits of a byte from bit from (0 is the MSB) to bit to, exclusive */
+inline uint8_t bitp_bitmap_byte_mask_(unsigned from, unsigned to) {
+    return (uint8_t)((0xFFu >> from) & ~(0xFFu >> to));
+}
+
+inline size_t bitp_bitmap_popcount_bytes_scalar_(const char *p, size_t n_bytes) {
+    size_t res = 0;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= n_bytes; i += sizeof(uint64_t)) {
+        uint64_t w;
+        memcpy(&w, p + i, sizeof(w));
+        res += bitp_popcount_64(w);
+    }
+    for (; i < n_bytes; ++i) {
+        res += bitp_popcount_64((uint8_t)p[i]);
+    }
+    return res;
+}
+
+/* number of leading bytes equal to fill (0 or 0xFF), checked 8 at a time, a multiple of 8 */
+inline size_t bitp_bitmap_skip_scalar_(const char *p, size_t n_bytes, uint64_t fill) {
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= n_bytes; i += sizeof(uint64_t)) {
+        uint64_t w;
+        memcpy(&w, p + i, sizeof(w));
+        if (w != fill) {
+            break;
+        }
+    }
+    return i;
+}
+
+inline uint64_t bitp_bitmap_op_64_(uint64_t d, uint64_t s, bitp_bitmap_op_t op) {
+    switch (op) {
+    case BITP_BITMAP_AND:
+        return d & s;
+    case BITP_BITMAP_OR:
+        return d | s;
+    case BITP_BITMAP_XOR:
+        return d ^ s;
+    default:
+        return d & ~s;
+    }
+}
+
+#if BITP_X86_64
+/* the POPCNT instruction, which comes with the AVX2 tier, beats vector nibble lookups */
+BITP_TARGET("popcnt")
+inline size_t bitp_bitmap_popcount_bytes_popcnt_(const char *p, size_t n_bytes, size_t *res) {
+    uint64_t acc[4] = {0, 0, 0, 0};
+    size_t i = 0;
+
+    for (; i + 4 * sizeof(uint64_t) <= n_bytes; i += 4 * sizeof(uint64_t)) {
+        for (unsigned k = 0; k < 4; ++k) {
+            uint64_t w;
+            memcpy(&w, p + i + k * sizeof(uint64_t), sizeof(w));
+            acc[k] += (uint64_t)_mm_popcnt_u64(w);
+        }
+    }
+    *res = (size_t)(acc[0] + acc[1] + acc[2] + acc[3]);
+    return i;
+}
+
+BITP_TARGET("avx2")
+inline size_t bitp_bitmap_skip_avx2_(const char *p, size_t n_bytes, uint64_t fill) {
+    const __m256i f = _mm256_set1_epi64x((long long)fill);
+    size_t i = 0;
+    for (; i + 32 <= n_bytes; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(p + i));
+        if ((unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, f)) != 0xFFFFFFFFu) {
+            break;
+        }
+    }
+    return i;
+}
+
+/*
+ * 256 dst bits per step from a src at bit phase p: a src word is the big-endian word at its byte
+ * shifted up by p, its low p bits are the top of the word one byte further shifted down by 8 - p
+ * (where both have a bit, it is the same bit). n_bytes of dst, n_bytes + 1 of src readable.
+ */
+BITP_TARGET("avx2")
+inline size_t bitp_bitmap_apply_avx2_(char *d, const char *s, unsigned p, size_t n_bytes, bitp_bitmap_op_t op) {
+    const __m256i rev_bytes = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                               7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    const __m128i up = _mm_cvtsi32_si128((int)p);
+    const __m128i down = _mm_cvtsi32_si128((int)(CHAR_BIT - p));
+    size_t i = 0;
+
+    for (; i + 32 <= n_bytes; i += 32) {
+        __m256i sv = _mm256_loadu_si256((const __m256i *)(s + i));
+        if (p) {
+            __m256i s0 = _mm256_shuffle_epi8(sv, rev_bytes);
+            __m256i s1 = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(s + i + 1)), rev_bytes);
+            // dst stays in memory byte order, the src words are swapped back to it
+            sv = _mm256_shuffle_epi8(_mm256_or_si256(_mm256_sll_epi64(s0, up), _mm256_srl_epi64(s1, down)), rev_bytes);
+        }
+        __m256i dv = _mm256_loadu_si256((const __m256i *)(d + i));
+        switch (op) {
+        case BITP_BITMAP_AND:
+            dv = _mm256_and_si256(dv, sv);
+            break;
+        case BITP_BITMAP_OR:
+            dv = _mm256_or_si256(dv, sv);
+            break;
+        case BITP_BITMAP_XOR:
+            dv = _mm256_xor_si256(dv, sv);
+            break;
+        default:
+            dv = _mm256_andnot_si256(sv, dv);
+        }
+        _mm256_storeu_si256((__m256i *)(d + i), dv);
+    }
+    return i;
+}
+
+BITP_TARGET("avx512f,avx512bw")
+inline size_t bitp_bitmap_skip_avx512_(const char *p, size_t n_bytes, uint64_t fill) {
+    const __m512i f = _mm512_set1_epi64((long long)fill);
+    size_t i = 0;
+    for (; i + 64 <= n_bytes; i += 64) {
+        __m512i v = _mm512_loadu_si512((const void *)(p + i));
+        if (_mm512_cmpneq_epi64_mask(v, f)) {
+            break;
+        }
+    }
+    return i;
+}
+#endif
+
+inline size_t bitp_bitmap_popcount_isa(const bitp_view_t *inst, bitp_isa_t isa) {
+    const char *buf = inst->buf;
+    size_t b0 = inst->begin / CHAR_BIT;
+    size_t b1 = inst->end / CHAR_BIT;
+    unsigned p0 = inst->begin % CHAR_BIT;
+    unsigned p1 = inst->end % CHAR_BIT;
+
+    if (inst->begin >= inst->end) {
+        return 0;
+    }
+    if (b0 == b1) {
+        return bitp_popcount_64((uint8_t)buf[b0] & bitp_bitmap_byte_mask_(p0, p1));
+    }
+
+    // the bytes [b0, b1), less the bits of b0 before begin, plus the bits of b1 before end
+    const char *p = buf + b0;
+    size_t n_bytes = b1 - b0;
+    size_t res = 0;
+    size_t done = 0;
+#if BITP_X86_64
+    if (isa >= BITP_ISA_AVX2) {
+        done = bitp_bitmap_popcount_bytes_popcnt_(p, n_bytes, &res);
+    }
+#else
+    (void)isa;
+#endif
+    res += bitp_bitmap_popcount_bytes_scalar_(p + done, n_bytes - done);
+    res -= bitp_popcount_64((uint8_t)buf[b0] & bitp_bitmap_byte_mask_(0, p0));
+    if (p1) {
+        res += bitp_popcount_64((uint8_t)buf[b1] & bitp_bitmap_byte_mask_(0, p1));
+    }
+    return res;
+}
+
+inline size_t bitp_bitmap_popcount(const bitp_view_t *inst) {
+    return bitp_bitmap_popcount_isa(inst, BITP_ISA_NATIVE);
+}
+
+/* the first bit at or after from that differs from fill (0 or all ones) */
+inline size_t bitp_bitmap_find_(const bitp_view_t *inst, size_t from, uint64_t fill, bitp_isa_t isa) {
+    const char *buf = inst->buf;
+    size_t end = inst->end;
+
+    if (from >= inst->end - inst->begin) {
+        return BITP_BITMAP_NPOS;
+    }
+    size_t pos = inst->begin + from;
+    // up to the next byte boundary and 56 bits more, then whole words
+    size_t n = CHAR_BIT - pos % CHAR_BIT + 56;
+    for (;;) {
+        if (n > end - pos) {
+            n = end - pos;
+        }
+        uint64_t w = bitp_bits_top_(bitp_read_bits_64(buf, end, pos) ^ fill, (unsigned)n);
+        if (w) {
+            return pos + bitp_clz_64(w) - inst->begin;
+        }
+        pos += n;
+        if (pos == end) {
+            return BITP_BITMAP_NPOS;
+        }
+        n = 64;
+
+        // pos is byte aligned from here on
+        const char *p = buf + pos / CHAR_BIT;
+        size_t n_bytes = (end - pos) / CHAR_BIT;
+        size_t skip = 0;
+#if BITP_X86_64
+        if (isa >= BITP_ISA_AVX512) {
+            skip = bitp_bitmap_skip_avx512_(p, n_bytes, fill);
+        }
+        else if (isa >= BITP_ISA_AVX2) {
+            skip = bitp_bitmap_skip_avx2_(p, n_bytes, fill);
+        }
+#else
+        (void)isa;
+#endif
+        skip += bitp_bitmap_skip_scalar_(p + skip, n_bytes - skip, fill);
+        pos += skip * CHAR_BIT;
+        if (pos == end) {
+            return BITP_BITMAP_NPOS;
+        }
+    }
+}
+
+inline size_t bitp_bitmap_find_set_isa(const bitp_view_t *inst, size_t from, bitp_isa_t isa) {
+    return bitp_bitmap_find_(inst, from, 0, isa);
+}
+
+inline size_t bitp_bitmap_find_clear_isa(const bitp_view_t *inst, size_t from, bitp_isa_t isa) {
+    return bitp_bitmap_find_(inst, from, 0xFFFFFFFFFFFFFFFFULL, isa);
+}
+
+inline size_t bitp_bitmap_find_set(const bitp_view_t *inst, size_t from) {
+    return bitp_bitmap_find_(inst, from, 0, BITP_ISA_NATIVE);
+}
+
+inline size_t bitp_bitmap_find_clear(const bitp_view_t *inst, size_t from) {
+    return bitp_bitmap_find_(inst, from, 0xFFFFFFFFFFFFFFFFULL, BITP_ISA_NATIVE);
+}
+
+/* the word at chunk, bits past the end cleared */
+inline uint64_t bitp_bitmap_iter_load_(const bitp_bitmap_iter_t *inst) {
+    size_t n = inst->end - inst->chunk;
+    uint64_t w = bitp_read_bits_64(inst->buf, inst->end, inst->chunk);
+    return n < 64 ? bitp_bits_top_(w, (unsigned)n) : w;
+}
+
+inline void bitp_bitmap_iter_init(bitp_bitmap_iter_t *inst, const bitp_view_t *view) {
+    inst->buf = view->buf;
+    inst->begin = view->begin;
+    inst->end = view->end;
+    inst->chunk = view->begin;
+    inst->word = view->begin < view->end ? bitp_bitmap_iter_load_(inst) : 0;
+}
+
+inline int bitp_bitmap_iter_next(bitp_bitmap_iter_t *inst, size_t *pos) {
+    while (!inst->word) {
+        if (inst->end - inst->chunk <= 64) {
+            inst->chunk = inst->end;
+            return 0;
+        }
+        inst->chunk += 64;
+        inst->word = bitp_bitmap_iter_load_(inst);
+    }
+    unsigned z = bitp_clz_64(inst->word);
+    inst->word &= ~(0x8000000000000000ULL >> z);
+    *pos = inst->chunk + z - inst->begin;
+    return 1;
+}
+
+/* up to 64 bits, read and written back whole */
+inline void bitp_bitmap_apply_word_(char *dst, size_t dst_cap, size_t d, const char *src, size_t src_cap, size_t s, unsigned n, bitp_bitmap_op_t op) {
+    uint64_t dw = bitp_read_bits_64(dst, dst_cap, d);
+    uint64_t sw = bitp_read_bits_64(src, src_cap, s);
+    bitp_write_bits_64(dst, dst_cap, d, bitp_bitmap_op_64_(dw, sw, op), n);
+}
+
+inline bitp_status_t bitp_bitmap_apply_isa(bitp_packer_t *dst, bitp_parser_t *src, size_t n_bits, bitp_bitmap_op_t op, bitp_isa_t isa) {
+    bitp_status_t status = bitp_bits_check_(dst, src, n_bits);
+    if (status != BITP_OK) {
+        return status;
+    }
+
+    size_t d = dst->iter;
+    size_t s = src->iter;
+    size_t done = 0;
+
+    // up to the dst byte boundary
+    size_t head = (CHAR_BIT - d % CHAR_BIT) % CHAR_BIT;
+    if (head > n_bits) {
+        head = n_bits;
+    }
+    if (head) {
+        bitp_bitmap_apply_word_(dst->buf, dst->capacity, d, src->buf, src->capacity, s, (unsigned)head, op);
+        done = head;
+    }
+
+    // whole dst bytes, the src at a fixed bit phase; a step reads one src byte past its bits
+    char *dp = dst->buf + (d + done) / CHAR_BIT;
+    const char *sp = src->buf + (s + done) / CHAR_BIT;
+    unsigned p = (s + done) % CHAR_BIT;
+    size_t n_bytes = (n_bits - done) / CHAR_BIT;
+    // the src byte after the last whole one has to be inside the src range
+    if (n_bytes && (s + done + n_bytes * CHAR_BIT) / CHAR_BIT + 1 > (s + n_bits + CHAR_BIT - 1) / CHAR_BIT) {
+        n_bytes--;
+    }
+    size_t i = 0;
+#if BITP_X86_64
+    if (isa >= BITP_ISA_AVX2) {
+        i = bitp_bitmap_apply_avx2_(dp, sp, p, n_bytes, op);
+    }
+#else
+    (void)isa;
+#endif
+    for (; i + sizeof(uint64_t) <= n_bytes; i += sizeof(uint64_t)) {
+        uint64_t sw = bitp_load_be_64(sp + i);
+        if (p) {
+            sw = (sw << p) | ((uint8_t)sp[i + sizeof(uint64_t)] >> (CHAR_BIT - p));
+        }
+        bitp_store_be_64(dp + i, bitp_bitmap_op_64_(bitp_load_be_64(dp + i), sw, op));
+    }
+    done += i * CHAR_BIT;
+
+    for (; done < n_bits; done += 64) {
+        unsigned n = n_bits - done < 64 ? (unsigned)(n_bits - done) : 64;
+        bitp_bitmap_apply_word_(dst->buf, dst->capacity, d + done, src->buf, src->capacity, s + done, n, op);
+    }
+
+    src->iter += n_bits;
+    dst->iter += n_bits;
+    return BITP_OK;
+}
+
+inline bitp_status_t bitp_bitmap_apply(bitp_packer_t *dst, bitp_parser_t *src, size_t n_bits, bitp_bitmap_op_t op) {
+    return bitp_bitmap_apply_isa(dst, src, n_bits, op, BITP_ISA_NATIVE);
+}
+
+#endif /* INCLUDE_BITP_BITMAP_H_ */
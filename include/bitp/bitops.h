@@ -0,0 +1,272 @@
+/*
+ * bitops.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#ifndef INCLUDE_BITP_BITOPS_H_
+#define INCLUDE_BITP_BITOPS_H_
+
+#include "cpu.h"
+#include "packer.h"
+#include "parser.h"
+
+/*
+ * Bulk bit permutations of bit ranges: n_bits are read at the parser's position and written at
+ * the packer's, both are moved past them. The packer's buffer must be zeroed, like for
+ * bitp_packer_add_*. BITP_EFULL if either side has fewer than n_bits (nothing is done then).
+ * Source and destination must not overlap.
+ */
+
+/* copies n_bits */
+bitp_status_t bitp_bits_copy(bitp_packer_t *dst, bitp_parser_t *src, size_t n_bits);
+
+/* writes n_bits in reverse order, the last bit read is written first */
+bitp_status_t bitp_bits_reverse(bitp_packer_t *dst, bitp_parser_t *src, size_t n_bits);
+
+/*
+ * Reads a matrix of n_rows rows of n_cols bits and writes its transpose, n_cols rows of n_rows
+ * bits. This is the row-in, column-out block interleaver (and, with the sizes swapped, its
+ * deinterleaver), the bit interleaving of n_rows streams of n_cols bits each, and the bit-plane
+ * split of n_rows values of n_cols bits. Column permutations of sub-block interleavers are
+ * bitp_bits_copy of the written rows in the permuted order.
+ */
+bitp_status_t bitp_bits_transpose(bitp_packer_t *dst, bitp_parser_t *src, size_t n_rows, size_t n_cols);
+
+/* the same with an instruction set tier no higher than the CPU supports, for tests and benchmarks */
+bitp_status_t bitp_bits_reverse_isa(bitp_packer_t *dst, bitp_parser_t *src, size_t n_bits, bitp_isa_t isa);
+
+bitp_status_t bitp_bits_transpose_isa(bitp_packer_t *dst, bitp_parser_t *src, size_t n_rows, size_t n_cols, bitp_isa_t isa);
+
+/* word primitives; a matrix row is MSB first */
+uint64_t bitp_reverse_64(uint64_t x);
+
+/* 8x8 bit matrix, row 0 in the most significant byte */
+uint64_t bitp_transpose_8x8(uint64_t x);
+
+/* 64x64 bit matrix in place, row i in rows[i] */
+void bitp_transpose_64x64(uint64_t rows[64]);
+
+void bitp_transpose_64x64_isa(uint64_t rows[64], bitp_isa_t isa);
+
+/*
+ **************************************************************************************************
+  Realization
+ **************************************************************************************************
+ */
+
+inline uint64_t bitp_reverse_64(uint64_t x) {
+    x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+    x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+    x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+    x = ((x >> 8) & 0x00FF00FF00FF00FFULL) | ((x & 0x00FF00FF00FF00FFULL) << 8);
+    x = ((x >> 16) & 0x0000FFFF0000FFFFULL) | ((x & 0x0000FFFF0000FFFFULL) << 16);
+    return (x >> 32) | (x << 32);
+}
+
+inline uint64_t bitp_transpose_8x8(uint64_t x) {
+    uint64_t t;
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+    x ^= t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+    x ^= t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+    x ^= t ^ (t << 28);
+    return x;
+}
+
+/* swaps the off-diagonal j x j blocks of every 2j x 2j block, j = 32 .. 1 */
+inline void bitp_transpose_64x64_scalar_(uint64_t rows[64]) {
+    uint64_t m = 0x00000000FFFFFFFFULL;
+    for (unsigned j = 32; j != 0; j >>= 1, m ^= m << j) {
+        for (unsigned k = 0; k < 64; k = (k + j + 1) & ~j) {
+            uint64_t t = (rows[k] ^ (rows[k + j] >> j)) & m;
+            rows[k] ^= t;
+            rows[k + j] ^= t << j;
+        }
+    }
+}
+
+#if BITP_X86_64
+/* the same on 4 rows per register, the rounds of j < 4 swap within a register */
+BITP_TARGET("avx2")
+inline void bitp_transpose_64x64_avx2_(uint64_t rows[64]) {
+    __m256i r[16];
+    for (unsigned i = 0; i < 16; ++i) {
+        r[i] = _mm256_loadu_si256((const __m256i *)(rows + 4 * i));
+    }
+
+    uint64_t m = 0x00000000FFFFFFFFULL;
+    for (unsigned j = 32; j >= 4; j >>= 1, m ^= m << j) {
+        __m256i vm = _mm256_set1_epi64x((long long)m);
+        __m128i sh = _mm_cvtsi32_si128((int)j);
+        for (unsigned k = 0; k < 16; k = (k + j / 4 + 1) & ~(j / 4)) {
+            __m256i t = _mm256_and_si256(_mm256_xor_si256(r[k], _mm256_srl_epi64(r[k + j / 4], sh)), vm);
+            r[k] = _mm256_xor_si256(r[k], t);
+            r[k + j / 4] = _mm256_xor_si256(r[k + j / 4], _mm256_sll_epi64(t, sh));
+        }
+    }
+    // j = 2 pairs rows 0, 2 and 1, 3 of a register, j = 1 pairs 0, 1 and 2, 3
+    __m256i m2 = _mm256_set1_epi64x(0x3333333333333333LL);
+    __m256i m1 = _mm256_set1_epi64x(0x5555555555555555LL);
+    for (unsigned k = 0; k < 16; ++k) {
+        __m256i v = r[k];
+        __m256i t = _mm256_and_si256(_mm256_xor_si256(v, _mm256_srli_epi64(_mm256_permute4x64_epi64(v, 0x4E), 2)), m2);
+        v = _mm256_xor_si256(v, _mm256_blend_epi32(t, _mm256_slli_epi64(_mm256_permute4x64_epi64(t, 0x4E), 2), 0xF0));
+        t = _mm256_and_si256(_mm256_xor_si256(v, _mm256_srli_epi64(_mm256_permute4x64_epi64(v, 0xB1), 1)), m1);
+        v = _mm256_xor_si256(v, _mm256_blend_epi32(t, _mm256_slli_epi64(_mm256_permute4x64_epi64(t, 0xB1), 1), 0xCC));
+        _mm256_storeu_si256((__m256i *)(rows + 4 * k), v);
+    }
+}
+#endif
+
+inline void bitp_transpose_64x64_isa(uint64_t rows[64], bitp_isa_t isa) {
+#if BITP_X86_64
+    if (isa >= BITP_ISA_AVX2) {
+        bitp_transpose_64x64_avx2_(rows);
+        return;
+    }
+#endif
+    (void)isa;
+    bitp_transpose_64x64_scalar_(rows);
+}
+
+inline void bitp_transpose_64x64(uint64_t rows[64]) {
+    bitp_transpose_64x64_isa(rows, BITP_ISA_NATIVE);
+}
+
+inline bitp_status_t bitp_bits_check_(const bitp_packer_t *dst, const bitp_parser_t *src, size_t n_bits) {
+    if (src->iter > src->capacity || src->capacity - src->iter < n_bits) {
+        return BITP_EFULL;
+    }
+    if (dst->iter > dst->capacity || dst->capacity - dst->iter < n_bits) {
+        return BITP_EFULL;
+    }
+    return BITP_OK;
+}
+
+/* the top n_bits of a word, n_bits 1..64 */
+inline uint64_t bitp_bits_top_(uint64_t x, unsigned n_bits) {
+    return x & (0xFFFFFFFFFFFFFFFFULL << (64 - n_bits));
+}
+
+inline bitp_status_t bitp_bits_copy(bitp_packer_t *dst, bitp_parser_t *src, size_t n_bits) {
+    bitp_status_t status = bitp_bits_check_(dst, src, n_bits);
+    if (status != BITP_OK) {
+        return status;
+    }
+
+    size_t done = 0;
+    if (src->iter % CHAR_BIT == 0 && dst->iter % CHAR_BIT == 0) {
+        done = n_bits / CHAR_BIT * CHAR_BIT;
+        memcpy(dst->buf + dst->iter / CHAR_BIT, src->buf + src->iter / CHAR_BIT, done / CHAR_BIT);
+    }
+    for (; done < n_bits; done += 64) {
+        unsigned w = n_bits - done < 64 ? (unsigned)(n_bits - done) : 64;
+        uint64_t word = bitp_read_bits_64(src->buf, src->capacity, src->iter + done);
+        bitp_or_bits_64(dst->buf, dst->capacity, dst->iter + done, bitp_bits_top_(word, w), w);
+    }
+
+    src->iter += n_bits;
+    dst->iter += n_bits;
+    return BITP_OK;
+}
+
+#if BITP_X86_64
+/* whole bytes: the byte order is reversed by the shuffles, the bits of a byte by two nibble lookups */
+BITP_TARGET("avx2")
+inline size_t bitp_bits_reverse_bytes_avx2_(char *dst, const char *src_end, size_t n_bytes) {
+    const __m256i rev_bytes = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+                                               15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    // the reversed low nibble goes high and the reversed high nibble low
+    const __m256i rev_lo = _mm256_setr_epi64x((long long)0xE060A020C0408000ULL, (long long)0xF070B030D0509010ULL,
+                                              (long long)0xE060A020C0408000ULL, (long long)0xF070B030D0509010ULL);
+    const __m256i rev_hi = _mm256_setr_epi64x(0x0E060A020C040800LL, 0x0F070B030D050901LL,
+                                              0x0E060A020C040800LL, 0x0F070B030D050901LL);
+    const __m256i low = _mm256_set1_epi8(0x0F);
+    size_t i = 0;
+
+    for (; i + 32 <= n_bytes; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(src_end - i - 32));
+        v = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(v, rev_bytes), 0x4E);
+        __m256i lo = _mm256_shuffle_epi8(rev_lo, _mm256_and_si256(v, low));
+        __m256i hi = _mm256_shuffle_epi8(rev_hi, _mm256_and_si256(_mm256_srli_epi16(v, 4), low));
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_or_si256(lo, hi));
+    }
+    return i;
+}
+#endif
+
+inline bitp_status_t bitp_bits_reverse_isa(bitp_packer_t *dst, bitp_parser_t *src, size_t n_bits, bitp_isa_t isa) {
+    bitp_status_t status = bitp_bits_check_(dst, src, n_bits);
+    if (status != BITP_OK) {
+        return status;
+    }
+    size_t end = src->iter + n_bits;
+    size_t done = 0;
+    (void)isa;
+
+#if BITP_X86_64
+    if (isa >= BITP_ISA_AVX2 && end % CHAR_BIT == 0 && dst->iter % CHAR_BIT == 0) {
+        done = CHAR_BIT * bitp_bits_reverse_bytes_avx2_(dst->buf + dst->iter / CHAR_BIT, src->buf + end / CHAR_BIT,
+                                                        n_bits / CHAR_BIT);
+    }
+#endif
+    // output word k is the reversed input word ending 64 k bits before the end
+    for (; done < n_bits; done += 64) {
+        unsigned w = n_bits - done < 64 ? (unsigned)(n_bits - done) : 64;
+        uint64_t word = bitp_read_bits_64(src->buf, src->capacity, end - done - w);
+        bitp_or_bits_64(dst->buf, dst->capacity, dst->iter + done, bitp_reverse_64(bitp_bits_top_(word, w)) << (64 - w), w);
+    }
+
+    src->iter += n_bits;
+    dst->iter += n_bits;
+    return BITP_OK;
+}
+
+inline bitp_status_t bitp_bits_reverse(bitp_packer_t *dst, bitp_parser_t *src, size_t n_bits) {
+    return bitp_bits_reverse_isa(dst, src, n_bits, BITP_ISA_NATIVE);
+}
+
+/* the matrix is done in tiles of 64 x 64, padded with zeros at the right and bottom edges */
+inline bitp_status_t bitp_bits_transpose_isa(bitp_packer_t *dst, bitp_parser_t *src, size_t n_rows, size_t n_cols, bitp_isa_t isa) {
+    if (n_cols && n_rows > (size_t)-1 / n_cols) {
+        return BITP_EFULL;
+    }
+    size_t n_bits = n_rows * n_cols;
+    bitp_status_t status = bitp_bits_check_(dst, src, n_bits);
+    if (status != BITP_OK) {
+        return status;
+    }
+    uint64_t tile[64];
+
+    for (size_t r0 = 0; r0 < n_rows; r0 += 64) {
+        unsigned h = n_rows - r0 < 64 ? (unsigned)(n_rows - r0) : 64;
+        for (size_t c0 = 0; c0 < n_cols; c0 += 64) {
+            unsigned w = n_cols - c0 < 64 ? (unsigned)(n_cols - c0) : 64;
+            size_t at = src->iter + r0 * n_cols + c0;
+            for (unsigned i = 0; i < h; ++i, at += n_cols) {
+                tile[i] = bitp_bits_top_(bitp_read_bits_64(src->buf, src->capacity, at), w);
+            }
+            for (unsigned i = h; i < 64; ++i) {
+                tile[i] = 0;
+            }
+            bitp_transpose_64x64_isa(tile, isa);
+            at = dst->iter + c0 * n_rows + r0;
+            for (unsigned i = 0; i < w; ++i, at += n_rows) {
+                bitp_or_bits_64(dst->buf, dst->capacity, at, tile[i], h);
+            }
+        }
+    }
+
+    src->iter += n_bits;
+    dst->iter += n_bits;
+    return BITP_OK;
+}
+
+inline bitp_status_t bitp_bits_transpose(bitp_packer_t *dst, bitp_parser_t *src, size_t n_rows, size_t n_cols) {
+    return bitp_bits_transpose_isa(dst, src, n_rows, n_cols, BITP_ISA_NATIVE);
+}
+
+#endif /* INCLUDE_BITP_BITOPS_H_ */
@@ -0,0 +1,68 @@
+/*
+ * cache.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#ifndef INCLUDE_BITP_CACHE_H_
+#define INCLUDE_BITP_CACHE_H_
+
+#include "parser.h"
+
+/*
+ * Cache of decoded messages keyed by the hash and bit length of their payload, part of the
+ * compiled bitp_kernels library. Broadcast messages repeat byte for byte, a repeat is hashed and
+ * its decoded result copied instead of decoding it again. Results are fixed-size blobs, the
+ * structure a decoder fills. The cache is split into shards by the hash, every shard an LRU list
+ * of its own under a mutex, so that several decoder threads seldom wait for each other. Payloads
+ * aren't kept and compared: two payloads of the same length and 64-bit hash share an entry.
+ */
+
+typedef struct bitp_cache_tag bitp_cache_t;
+
+typedef struct bitp_cache_stats_tag {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t inserts;
+    // entries dropped to make room
+    uint64_t evictions;
+} bitp_cache_stats_t;
+
+/* decodes one message of the bits the parser ends at into res */
+typedef bitp_status_t (*bitp_cache_decode_fn_t)(bitp_parser_t *parser, void *res, void *ctx);
+
+/*
+ * A cache of capacity results of value_size bytes, rounded up to a multiple of n_shards, a power
+ * of 2 (0 for 16). Every shard evicts on its own once its share is full. NULL if capacity is
+ * smaller than n_shards or value_size is 0, or on allocation failure.
+ */
+bitp_cache_t *bitp_cache_create(size_t capacity, size_t value_size, unsigned n_shards);
+
+void bitp_cache_destroy(bitp_cache_t *inst);
+
+/* copies the result of a payload into res and marks it recently used: 1 if found, 0 otherwise */
+int bitp_cache_get(bitp_cache_t *inst, uint64_t hash, size_t n_bits, void *res);
+
+/* stores or replaces the result of a payload, evicting the least recently used of its shard */
+void bitp_cache_put(bitp_cache_t *inst, uint64_t hash, size_t n_bits, const void *value);
+
+/*
+ * The result of the next n_bits of the parser, from the cache or decoded by decode on a parser
+ * that ends after them and then stored. The parser moves past the n_bits if the result is there,
+ * nothing is stored if decode fails. BITP_EFULL if fewer bits are left, the status of decode.
+ */
+bitp_status_t bitp_cache_decode(bitp_cache_t *inst,
+                                bitp_parser_t *parser,
+                                size_t n_bits,
+                                bitp_cache_decode_fn_t decode,
+                                void *ctx,
+                                void *res);
+
+/* counters of all shards since creation or the last bitp_cache_clear */
+void bitp_cache_stats(bitp_cache_t *inst, bitp_cache_stats_t *res);
+
+/* drops all entries and zeroes the counters */
+void bitp_cache_clear(bitp_cache_t *inst);
+
+#endif /* INCLUDE_BITP_CACHE_H_ */
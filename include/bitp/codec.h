@@ -0,0 +1,397 @@
+/*
+ * codec.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#ifndef INCLUDE_BITP_CODEC_H_
+#define INCLUDE_BITP_CODEC_H_
+
+#include "cpu.h"
+#include "packer.h"
+#include "parser.h"
+
+/*
+ * Block codec for integer columns: frame of reference (values minus the block minimum) packed
+ * in the minimal width, values that don't fit the chosen width patched as exceptions (PFor),
+ * optionally over zigzag deltas. Blocks start at a byte boundary:
+ *
+ *     width 8 | n_exceptions 8 | reference 32 | [exception width 8]
+ *     n values of width bits, padded to a byte
+ *     n_exceptions indexes of 7 bits, then their high bits of exception width, padded to a byte
+ *
+ * Every block but the last has BITP_CODEC_BLOCK values, the count isn't stored.
+ */
+
+#define BITP_CODEC_BLOCK 128
+
+typedef enum bitp_codec_mode_tag {
+    // values as they are
+    BITP_CODEC_FOR = 0,
+    // zigzag-coded differences of consecutive values, for counters and timestamps
+    BITP_CODEC_DELTA,
+} bitp_codec_mode_t;
+
+/* the largest encoding of n values */
+size_t bitp_codec_max_bits(size_t n);
+
+/* encodes n values from the next byte boundary, the buffer must be zeroed */
+bitp_status_t bitp_codec_encode_u32(bitp_packer_t *inst, const uint32_t *vals, size_t n, bitp_codec_mode_t mode);
+
+/* BITP_EINVALID_ARG for corrupt blocks */
+bitp_status_t bitp_codec_decode_u32(bitp_parser_t *inst, uint32_t *res, size_t n, bitp_codec_mode_t mode);
+
+/* the same with the given instruction set tier, the CPU must support it */
+bitp_status_t bitp_codec_decode_u32_isa(bitp_parser_t *inst,
+                                        uint32_t *res,
+                                        size_t n,
+                                        bitp_codec_mode_t mode,
+                                        bitp_isa_t isa);
+
+/*
+ **************************************************************************************************
+  Realization
+ **************************************************************************************************
+ */
+
+#define BITP_CODEC_HEADER_BITS_ 48
+#define BITP_CODEC_INDEX_BITS_ 7
+
+inline size_t bitp_codec_max_bits(size_t n) {
+    size_t n_blocks = (n + BITP_CODEC_BLOCK - 1) / BITP_CODEC_BLOCK;
+    // a block never takes more than its values at full width
+    return n_blocks * (BITP_CODEC_HEADER_BITS_ + CHAR_BIT) + n * 32;
+}
+
+inline unsigned bitp_codec_width_(uint32_t v) {
+    return v ? 64 - (unsigned)bitp_clz_64(v) : 0;
+}
+
+inline uint32_t bitp_codec_zigzag_(uint32_t delta) {
+    return (delta << 1) ^ (uint32_t)((int32_t)delta >> 31);
+}
+
+inline uint32_t bitp_codec_unzigzag_(uint32_t z) {
+    return (z >> 1) ^ (0 - (z & 1));
+}
+
+/* MSB-first writer of a zeroed region, whole big-endian words while it can */
+typedef struct bitp_codec_acc_tag_ {
+    char *p;
+    uint64_t acc;
+    unsigned n_acc;
+} bitp_codec_acc_t_;
+
+inline void bitp_codec_put_(bitp_codec_acc_t_ *w, const uint32_t *vals, size_t n, unsigned n_bits) {
+    uint64_t acc = w->acc;
+    unsigned n_acc = w->n_acc;
+    char *p = w->p;
+
+    if (n_bits == 0) {
+        return;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        acc |= (uint64_t)vals[i] << (64 - n_acc - n_bits);
+        n_acc += n_bits;
+        if (n_acc >= 32) {
+            uint32_t word = bitp_ntoh_32((uint32_t)(acc >> 32));
+            memcpy(p, &word, sizeof(word));
+            p += sizeof(word);
+            acc <<= 32;
+            n_acc -= 32;
+        }
+    }
+    w->acc = acc;
+    w->n_acc = n_acc;
+    w->p = p;
+}
+
+inline void bitp_codec_flush_(bitp_codec_acc_t_ *w) {
+    for (; w->n_acc > 0; w->n_acc -= w->n_acc < CHAR_BIT ? w->n_acc : CHAR_BIT) {
+        *w->p++ = (char)(uint8_t)(w->acc >> 56);
+        w->acc <<= CHAR_BIT;
+    }
+}
+
+inline bitp_status_t bitp_codec_encode_u32(bitp_packer_t *inst, const uint32_t *vals, size_t n, bitp_codec_mode_t mode) {
+    uint32_t prev = 0;
+    size_t start = (inst->iter + CHAR_BIT - 1) / CHAR_BIT * CHAR_BIT;
+
+    if (inst->iter > inst->capacity || start > inst->capacity) {
+        return BITP_EFULL;
+    }
+    inst->iter = start;
+
+    for (size_t off = 0; off < n; off += BITP_CODEC_BLOCK) {
+        size_t count = n - off < BITP_CODEC_BLOCK ? n - off : BITP_CODEC_BLOCK;
+        uint32_t t[BITP_CODEC_BLOCK];
+        uint32_t ref = 0xFFFFFFFF;
+
+        for (size_t i = 0; i < count; ++i) {
+            if (mode == BITP_CODEC_DELTA) {
+                t[i] = bitp_codec_zigzag_(vals[off + i] - prev);
+                prev = vals[off + i];
+            }
+            else {
+                t[i] = vals[off + i];
+            }
+            ref = t[i] < ref ? t[i] : ref;
+        }
+
+        // values by width, the chosen width minimizes the block with its exceptions
+        unsigned hist[33] = {0};
+        for (size_t i = 0; i < count; ++i) {
+            t[i] -= ref;
+            hist[bitp_codec_width_(t[i])]++;
+        }
+        unsigned max_width = 32;
+        while (max_width > 0 && hist[max_width] == 0) {
+            max_width--;
+        }
+        unsigned width = max_width;
+        size_t best = count * max_width;
+        unsigned n_exc = 0;
+        unsigned above = 0;
+        for (unsigned w = max_width; w-- > 0;) {
+            above += hist[w + 1];
+            size_t cost = count * w + CHAR_BIT + above * (BITP_CODEC_INDEX_BITS_ + max_width - w);
+            if (cost < best) {
+                best = cost;
+                width = w;
+                n_exc = above;
+            }
+        }
+        unsigned exc_width = n_exc ? max_width - width : 0;
+
+        size_t data_bytes = (count * width + CHAR_BIT - 1) / CHAR_BIT;
+        size_t exc_bytes = (n_exc * (BITP_CODEC_INDEX_BITS_ + exc_width) + CHAR_BIT - 1) / CHAR_BIT;
+        size_t n_bits = BITP_CODEC_HEADER_BITS_ + (n_exc ? CHAR_BIT : 0) + (data_bytes + exc_bytes) * CHAR_BIT;
+
+        bitp_packer_reserved_t r;
+        if (bitp_packer_reserve(inst, n_bits, &r) != BITP_OK) {
+            return BITP_EFULL;
+        }
+        bitp_packer_reserved_add_u8(&r, (uint8_t)width, 8);
+        bitp_packer_reserved_add_u8(&r, (uint8_t)n_exc, 8);
+        bitp_packer_reserved_add_u32(&r, ref, 32);
+        if (n_exc) {
+            bitp_packer_reserved_add_u8(&r, (uint8_t)exc_width, 8);
+        }
+
+        // exceptions keep their low bits in the packed values
+        uint32_t exc[2 * BITP_CODEC_BLOCK];
+        unsigned k = 0;
+        if (n_exc) {
+            uint32_t mask = width ? 0xFFFFFFFFu >> (32 - width) : 0;
+            for (size_t i = 0; i < count; ++i) {
+                if (bitp_codec_width_(t[i]) > width) {
+                    exc[k] = (uint32_t)i;
+                    exc[n_exc + k++] = t[i] >> width;
+                    t[i] &= mask;
+                }
+            }
+        }
+
+        bitp_codec_acc_t_ w = {inst->buf + inst->iter / CHAR_BIT, 0, 0};
+        bitp_codec_put_(&w, t, count, width);
+        bitp_codec_flush_(&w);
+        bitp_codec_put_(&w, exc, n_exc, BITP_CODEC_INDEX_BITS_);
+        bitp_codec_put_(&w, exc + n_exc, n_exc, exc_width);
+        bitp_codec_flush_(&w);
+        inst->iter += (data_bytes + exc_bytes) * CHAR_BIT;
+    }
+
+    return BITP_OK;
+}
+
+/* unpacks n values of n_bits from bit phase (0..7) of byte p, n_bytes are readable from p */
+inline void bitp_codec_unpack_scalar_(const char *p, size_t n_bytes, uint32_t *res, size_t n, unsigned n_bits, unsigned phase) {
+    if (n_bits == 0) {
+        memset(res, 0, n * sizeof(*res));
+        return;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        size_t bit = phase + i * n_bits;
+        uint64_t word = bit / CHAR_BIT + sizeof(uint64_t) <= n_bytes
+                            ? bitp_load_be_64(p + bit / CHAR_BIT) << (bit % CHAR_BIT)
+                            : bitp_read_bits_64(p, n_bytes * CHAR_BIT, bit);
+        res[i] = (uint32_t)(word >> (64 - n_bits));
+    }
+}
+
+#if BITP_X86_64
+/*
+ * 8 values of n_bits take n_bits bytes, so the byte offsets and shifts within a group are the
+ * same for every group. Each 128-bit half gets 4 values from its own load, a value is the
+ * big-endian word at its first byte shifted left by the bit phase, plus the top bits of the
+ * fifth byte, shifted right to n_bits. The 4 values of a half must fit its 16 bytes, which
+ * they do for any phase up to 30 bits and for phase 0 up to 32; 0 is returned otherwise.
+ */
+BITP_TARGET("avx2")
+inline size_t bitp_codec_unpack_avx2_(const char *p, size_t n_bytes, uint32_t *res, size_t n, unsigned n_bits, unsigned phase) {
+    unsigned high = phase + 4 * n_bits;
+
+    if (n_bits == 0 || high > 128 || high % 8 + 4 * n_bits > 128) {
+        return 0;
+    }
+    // both loads of a group read 16 bytes
+    size_t n_groups = n / 8;
+    while (n_groups && (n_groups - 1) * n_bits + high / 8 + 16 > n_bytes) {
+        n_groups--;
+    }
+
+    const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 0, 1, 2, 3);
+    __m256i start_phase = _mm256_setr_epi32((int)phase, (int)phase, (int)phase, (int)phase,
+                                            (int)(high % 8), (int)(high % 8), (int)(high % 8), (int)(high % 8));
+    __m256i start = _mm256_add_epi32(start_phase, _mm256_mullo_epi32(lane, _mm256_set1_epi32((int)n_bits)));
+    __m256i first = _mm256_srli_epi32(start, 3);
+    __m256i shift = _mm256_and_si256(start, _mm256_set1_epi32(7));
+    // little-endian lane bytes from big-endian bytes first + 3 .. first, the fifth byte alone
+    __m256i mask_a = _mm256_add_epi32(_mm256_mullo_epi32(first, _mm256_set1_epi32(0x01010101)),
+                                      _mm256_set1_epi32(0x00010203));
+    __m256i mask_b = _mm256_or_si256(_mm256_add_epi32(first, _mm256_set1_epi32(4)),
+                                     _mm256_set1_epi32((int)0x80808000));
+    __m256i shift_b = _mm256_sub_epi32(_mm256_set1_epi32(8), shift);
+    __m128i shift_out = _mm_cvtsi32_si128((int)(32 - n_bits));
+
+    for (size_t g = 0; g < n_groups; ++g) {
+        const char *q = p + g * n_bits;
+        __m256i bytes = _mm256_loadu2_m128i((const __m128i *)(q + high / 8), (const __m128i *)q);
+        __m256i a = _mm256_sllv_epi32(_mm256_shuffle_epi8(bytes, mask_a), shift);
+        __m256i b = _mm256_srlv_epi32(_mm256_shuffle_epi8(bytes, mask_b), shift_b);
+        __m256i v = _mm256_srl_epi32(_mm256_or_si256(a, b), shift_out);
+        _mm256_storeu_si256((__m256i *)(res + g * 8), v);
+    }
+
+    return n_groups * 8;
+}
+
+/* res[i] += ref, or the prefix sum of the unzigzagged values starting from prev */
+BITP_TARGET("avx2")
+inline uint32_t bitp_codec_finish_avx2_(uint32_t *res, size_t n, uint32_t ref, bitp_codec_mode_t mode, uint32_t prev) {
+    __m256i vref = _mm256_set1_epi32((int)ref);
+    __m256i carry = _mm256_set1_epi32((int)prev);
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)(res + i)), vref);
+        if (mode == BITP_CODEC_DELTA) {
+            __m256i sign = _mm256_sub_epi32(_mm256_setzero_si256(), _mm256_and_si256(v, _mm256_set1_epi32(1)));
+            v = _mm256_xor_si256(_mm256_srli_epi32(v, 1), sign);
+            v = _mm256_add_epi32(v, _mm256_slli_si256(v, 4));
+            v = _mm256_add_epi32(v, _mm256_slli_si256(v, 8));
+            // the low half's total into the high half
+            __m256i low = _mm256_permute2x128_si256(v, v, 0x08);
+            v = _mm256_add_epi32(v, _mm256_shuffle_epi32(low, 0xFF));
+            v = _mm256_add_epi32(v, carry);
+            carry = _mm256_permutevar8x32_epi32(v, _mm256_set1_epi32(7));
+        }
+        _mm256_storeu_si256((__m256i *)(res + i), v);
+    }
+
+    prev = (uint32_t)_mm256_cvtsi256_si32(carry);
+    for (; i < n; ++i) {
+        res[i] += ref;
+        if (mode == BITP_CODEC_DELTA) {
+            prev += bitp_codec_unzigzag_(res[i]);
+            res[i] = prev;
+        }
+    }
+    return prev;
+}
+#endif
+
+inline bitp_status_t bitp_codec_decode_u32_isa(bitp_parser_t *inst,
+                                               uint32_t *res,
+                                               size_t n,
+                                               bitp_codec_mode_t mode,
+                                               bitp_isa_t isa) {
+    uint32_t prev = 0;
+    size_t iter = (inst->iter + CHAR_BIT - 1) / CHAR_BIT * CHAR_BIT;
+    size_t n_bytes = inst->capacity / CHAR_BIT;
+    (void)isa;
+
+    for (size_t off = 0; off < n; off += BITP_CODEC_BLOCK) {
+        size_t count = n - off < BITP_CODEC_BLOCK ? n - off : BITP_CODEC_BLOCK;
+        uint32_t *out = res + off;
+
+        if (iter > inst->capacity || inst->capacity - iter < BITP_CODEC_HEADER_BITS_) {
+            return BITP_EFULL;
+        }
+        uint64_t header = bitp_read_bits_64(inst->buf, inst->capacity, iter);
+        unsigned width = (unsigned)(header >> 56);
+        unsigned n_exc = (unsigned)(header >> 48) & 0xFF;
+        uint32_t ref = (uint32_t)(header >> 16);
+        iter += BITP_CODEC_HEADER_BITS_;
+
+        unsigned exc_width = 0;
+        if (n_exc) {
+            if (inst->capacity - iter < CHAR_BIT) {
+                return BITP_EFULL;
+            }
+            exc_width = (uint8_t)inst->buf[iter / CHAR_BIT];
+            iter += CHAR_BIT;
+        }
+        if (width > 32 || exc_width > 32 - width || n_exc > count) {
+            return BITP_EINVALID_ARG;
+        }
+
+        size_t data_bytes = (count * width + CHAR_BIT - 1) / CHAR_BIT;
+        size_t exc_bytes = (n_exc * (BITP_CODEC_INDEX_BITS_ + exc_width) + CHAR_BIT - 1) / CHAR_BIT;
+        if ((inst->capacity - iter) / CHAR_BIT < data_bytes + exc_bytes) {
+            return BITP_EFULL;
+        }
+
+        const char *p = inst->buf + iter / CHAR_BIT;
+        size_t avail = n_bytes - iter / CHAR_BIT;
+        size_t done = 0;
+#if BITP_X86_64
+        if (isa >= BITP_ISA_AVX2) {
+            done = bitp_codec_unpack_avx2_(p, avail, out, count, width, 0);
+        }
+#endif
+        bitp_codec_unpack_scalar_(p + done * width / CHAR_BIT, avail - done * width / CHAR_BIT, out + done, count - done,
+                                  width, 0);
+
+        if (n_exc) {
+            const char *q = p + data_bytes;
+            size_t idx_bits = n_exc * BITP_CODEC_INDEX_BITS_;
+            for (unsigned k = 0; k < n_exc; ++k) {
+                uint64_t word = bitp_read_bits_64(q, exc_bytes * CHAR_BIT, k * BITP_CODEC_INDEX_BITS_);
+                unsigned idx = (unsigned)(word >> (64 - BITP_CODEC_INDEX_BITS_));
+                if (idx >= count) {
+                    return BITP_EINVALID_ARG;
+                }
+                if (exc_width) {
+                    word = bitp_read_bits_64(q, exc_bytes * CHAR_BIT, idx_bits + k * exc_width);
+                    out[idx] |= (uint32_t)(word >> (64 - exc_width)) << width;
+                }
+            }
+        }
+        iter += (data_bytes + exc_bytes) * CHAR_BIT;
+
+#if BITP_X86_64
+        if (isa >= BITP_ISA_AVX2) {
+            prev = bitp_codec_finish_avx2_(out, count, ref, mode, prev);
+            continue;
+        }
+#endif
+        for (size_t i = 0; i < count; ++i) {
+            out[i] += ref;
+            if (mode == BITP_CODEC_DELTA) {
+                prev += bitp_codec_unzigzag_(out[i]);
+                out[i] = prev;
+            }
+        }
+    }
+
+    inst->iter = iter;
+    return BITP_OK;
+}
+
+inline bitp_status_t bitp_codec_decode_u32(bitp_parser_t *inst, uint32_t *res, size_t n, bitp_codec_mode_t mode) {
+    return bitp_codec_decode_u32_isa(inst, res, n, mode, BITP_ISA_NATIVE);
+}
+
+#endif /* INCLUDE_BITP_CODEC_H_ */
@@ -0,0 +1,222 @@
+/*
+ * constexpr.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#ifndef INCLUDE_BITP_CONSTEXPR_H_
+#define INCLUDE_BITP_CONSTEXPR_H_
+
+/*
+ * C++17 constexpr packer and parser, for constant messages built at compile time:
+ *
+ *     constexpr std::array<uint8_t, 5> make_mib() {
+ *         bitp_cx_packer<5> p;
+ *         p.add_u64(0xA, 4);
+ *         p.add_i64(-3, 5);
+ *         ...
+ *         return p.bytes();
+ *     }
+ *     constexpr auto mib = make_mib();              // in read-only data, nothing runs at startup
+ *     static_assert(bitp_cx_read(mib, 4, 5) == 0x1D);
+ *
+ * The bits are laid out as by bitp_packer_add_* and read as by bitp_parser_extract_*, big-endian
+ * and MSB first. Every check is made whatever BITP_CHECK_* say: EFULL past the end, EINVALID_ARG
+ * for more than 64 bits or a value that doesn't fit. The first error stays in status() and later
+ * calls do nothing, a builder can return the packer and static_assert its status. Include
+ * outside extern "C".
+ */
+
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#define BITP_CONSTEXPR 1
+
+#include <array>
+#if __cplusplus >= 202002L && defined(__has_include)
+#if __has_include(<bit>)
+#include <bit>
+#endif
+#endif
+
+#include "types.h"
+
+template <size_t N>
+class bitp_cx_packer {
+  public:
+    constexpr bitp_cx_packer() = default;
+
+    /* the first n_bits of the buffer, the rest can't be written */
+    constexpr explicit bitp_cx_packer(size_t n_bits) : capacity_(n_bits < N * CHAR_BIT ? n_bits : N * CHAR_BIT) {}
+
+    constexpr bitp_status_t add_u64(uint64_t val, size_t n_bits) {
+        if (status_ == BITP_OK) {
+            status_ = check_(n_bits);
+        }
+        if (status_ == BITP_OK && n_bits < 64 && (val >> n_bits) != 0) {
+            status_ = BITP_EINVALID_ARG;
+        }
+        if (status_ != BITP_OK) {
+            return status_;
+        }
+        put_(val, n_bits);
+        return BITP_OK;
+    }
+
+    constexpr bitp_status_t add_i64(int64_t val, size_t n_bits) {
+        if (status_ == BITP_OK) {
+            status_ = check_(n_bits);
+        }
+        if (status_ == BITP_OK && n_bits && n_bits < 64) {
+            int64_t high = val >> (n_bits - 1);
+            if (high != 0 && high != -1) {
+                status_ = BITP_EINVALID_ARG;
+            }
+        }
+        if (status_ != BITP_OK) {
+            return status_;
+        }
+        put_(n_bits < 64 ? (uint64_t)val & ((1ULL << n_bits) - 1) : (uint64_t)val, n_bits);
+        return BITP_OK;
+    }
+
+    /* n_bits zeros, for spare fields */
+    constexpr bitp_status_t skip(size_t n_bits) {
+        if (status_ == BITP_OK && capacity_ - iter_ < n_bits) {
+            status_ = BITP_EFULL;
+        }
+        if (status_ != BITP_OK) {
+            return status_;
+        }
+        iter_ += n_bits;
+        return BITP_OK;
+    }
+
+#ifdef __cpp_lib_bit_cast
+    constexpr bitp_status_t add_float(float val) {
+        return add_u64(std::bit_cast<uint32_t>(val), 32);
+    }
+
+    constexpr bitp_status_t add_double(double val) {
+        return add_u64(std::bit_cast<uint64_t>(val), 64);
+    }
+#endif
+
+    /* BITP_OK or the first error */
+    constexpr bitp_status_t status() const {
+        return status_;
+    }
+
+    /* bits written */
+    constexpr size_t iter() const {
+        return iter_;
+    }
+
+    constexpr const std::array<uint8_t, N> &bytes() const {
+        return bytes_;
+    }
+
+  private:
+    constexpr bitp_status_t check_(size_t n_bits) const {
+        if (n_bits > 64) {
+            return BITP_EINVALID_ARG;
+        }
+        return capacity_ - iter_ < n_bits ? BITP_EFULL : BITP_OK;
+    }
+
+    // val fits into n_bits
+    constexpr void put_(uint64_t val, size_t n_bits) {
+        while (n_bits) {
+            unsigned free = CHAR_BIT - iter_ % CHAR_BIT;
+            unsigned take = n_bits < free ? (unsigned)n_bits : free;
+            uint8_t chunk = (uint8_t)((val >> (n_bits - take)) & ((1u << take) - 1));
+            bytes_[iter_ / CHAR_BIT] |= (uint8_t)(chunk << (free - take));
+            iter_ += take;
+            n_bits -= take;
+        }
+    }
+
+    std::array<uint8_t, N> bytes_{};
+    size_t capacity_ = N * CHAR_BIT;
+    size_t iter_ = 0;
+    bitp_status_t status_ = BITP_OK;
+};
+
+class bitp_cx_parser {
+  public:
+    constexpr bitp_cx_parser(const uint8_t *buf, size_t n_bits) : buf_(buf), capacity_(n_bits) {}
+
+    template <size_t N>
+    constexpr explicit bitp_cx_parser(const std::array<uint8_t, N> &bytes, size_t n_bits = N * CHAR_BIT)
+        : buf_(bytes.data()), capacity_(n_bits < N * CHAR_BIT ? n_bits : N * CHAR_BIT) {}
+
+    /* the parser doesn't move on errors */
+    constexpr bitp_status_t extract_u64(uint64_t *res, size_t n_bits) {
+        if (n_bits > 64) {
+            return BITP_EINVALID_ARG;
+        }
+        if (capacity_ - iter_ < n_bits) {
+            return BITP_EFULL;
+        }
+        uint64_t val = 0;
+        for (size_t left = n_bits; left;) {
+            unsigned avail = CHAR_BIT - iter_ % CHAR_BIT;
+            unsigned take = left < avail ? (unsigned)left : avail;
+            uint8_t byte = buf_[iter_ / CHAR_BIT];
+            val = (val << take) | ((byte >> (avail - take)) & ((1u << take) - 1));
+            iter_ += take;
+            left -= take;
+        }
+        *res = val;
+        return BITP_OK;
+    }
+
+    /* sign-extended from bit n_bits - 1 */
+    constexpr bitp_status_t extract_i64(int64_t *res, size_t n_bits) {
+        uint64_t val = 0;
+        bitp_status_t status = extract_u64(&val, n_bits);
+        if (status != BITP_OK) {
+            return status;
+        }
+        if (n_bits && n_bits < 64 && (val >> (n_bits - 1)) & 1) {
+            val |= ~0ULL << n_bits;
+        }
+        *res = (int64_t)val;
+        return BITP_OK;
+    }
+
+    constexpr bitp_status_t skip(size_t n_bits) {
+        if (capacity_ - iter_ < n_bits) {
+            return BITP_EFULL;
+        }
+        iter_ += n_bits;
+        return BITP_OK;
+    }
+
+    constexpr size_t iter() const {
+        return iter_;
+    }
+
+    constexpr size_t left() const {
+        return capacity_ - iter_;
+    }
+
+  private:
+    const uint8_t *buf_;
+    size_t capacity_;
+    size_t iter_ = 0;
+};
+
+/* n_bits at bit_off of a constant message, 0 if they aren't all in it */
+template <size_t N>
+constexpr uint64_t bitp_cx_read(const std::array<uint8_t, N> &bytes, size_t bit_off, size_t n_bits) {
+    bitp_cx_parser parser(bytes);
+    uint64_t res = 0;
+    if (parser.skip(bit_off) != BITP_OK || parser.extract_u64(&res, n_bits) != BITP_OK) {
+        return 0;
+    }
+    return res;
+}
+
+#endif
+
+#endif /* INCLUDE_BITP_CONSTEXPR_H_ */
@@ -0,0 +1,155 @@
+/*
+ * cpu.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#ifndef INCLUDE_BITP_CPU_H_
+#define INCLUDE_BITP_CPU_H_
+
+#include "types.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define BITP_X86_64 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define BITP_TARGET(isa_) __attribute__((target(isa_)))
+#else
+#define BITP_TARGET(isa_)
+#endif
+
+typedef enum bitp_cpu_feature_tag {
+    BITP_CPU_BMI2 = 1 << 0,
+    // PDEP/PEXT are not microcoded (everything but AMD before Zen 3)
+    BITP_CPU_FAST_PDEP = 1 << 1,
+    BITP_CPU_SSE2 = 1 << 2,
+    // AVX2, F16C, POPCNT and YMM state enabled by the OS
+    BITP_CPU_AVX2 = 1 << 3,
+    // AVX-512 F, BW and VL, ZMM state enabled by the OS
+    BITP_CPU_AVX512 = 1 << 4,
+} bitp_cpu_feature_t;
+
+/* instruction set tiers of the bulk routines, every tier includes the previous one */
+typedef enum bitp_isa_tag {
+    BITP_ISA_SCALAR = 0,
+    BITP_ISA_SSE2,
+    BITP_ISA_AVX2,
+    BITP_ISA_AVX512,
+} bitp_isa_t;
+
+/* the best tier the translation unit is compiled for */
+#if defined(__AVX512F__) && defined(__AVX512BW__) && defined(__AVX512VL__)
+#define BITP_ISA_NATIVE BITP_ISA_AVX512
+#elif defined(__AVX2__)
+#define BITP_ISA_NATIVE BITP_ISA_AVX2
+#elif BITP_X86_64
+#define BITP_ISA_NATIVE BITP_ISA_SSE2
+#else
+#define BITP_ISA_NATIVE BITP_ISA_SCALAR
+#endif
+
+/* queries cpuid on every call, cache the result */
+unsigned bitp_cpu_features(void);
+
+/* the best tier supported by the given features */
+bitp_isa_t bitp_cpu_isa(unsigned features);
+
+/*
+ **************************************************************************************************
+  Realization
+ **************************************************************************************************
+ */
+
+#if BITP_X86_64
+inline void bitp_cpuid_(unsigned leaf, unsigned subleaf, unsigned regs[4]) {
+#if defined(_MSC_VER)
+    int r[4];
+    __cpuidex(r, (int)leaf, (int)subleaf);
+    for (int i = 0; i < 4; ++i) {
+        regs[i] = (unsigned)r[i];
+    }
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+inline uint64_t bitp_xgetbv_(void) {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((uint64_t)edx << 32) | eax;
+#endif
+}
+#endif
+
+inline unsigned bitp_cpu_features(void) {
+    unsigned features = 0;
+#if BITP_X86_64
+    unsigned regs[4];
+    bitp_cpuid_(0, 0, regs);
+    unsigned max_leaf = regs[0];
+    // "AuthenticAMD"
+    int amd = regs[1] == 0x68747541 && regs[3] == 0x69746E65 && regs[2] == 0x444D4163;
+
+    bitp_cpuid_(1, 0, regs);
+    unsigned family = (regs[0] >> 8) & 0xF;
+    if (family == 0xF) {
+        family += (regs[0] >> 20) & 0xFF;
+    }
+    if (regs[3] & (1u << 26)) {
+        features |= BITP_CPU_SSE2;
+    }
+    // F16C and POPCNT
+    int f16c = (regs[2] & (1u << 29)) && (regs[2] & (1u << 23));
+    // OSXSAVE and AVX
+    uint64_t xcr0 = 0;
+    if ((regs[2] & (1u << 27)) && (regs[2] & (1u << 28))) {
+        xcr0 = bitp_xgetbv_();
+    }
+
+    if (max_leaf >= 7) {
+        bitp_cpuid_(7, 0, regs);
+        if (regs[1] & (1u << 8)) {
+            features |= BITP_CPU_BMI2;
+            if (!amd || family >= 0x19) {
+                features |= BITP_CPU_FAST_PDEP;
+            }
+        }
+        // XMM and YMM state; F16C and POPCNT come with every AVX2 CPU, checked for virtual ones
+        if ((regs[1] & (1u << 5)) && f16c && (xcr0 & 0x6) == 0x6) {
+            features |= BITP_CPU_AVX2;
+            // F, BW, VL and opmask/ZMM state
+            unsigned avx512 = (1u << 16) | (1u << 30) | (1u << 31);
+            if ((regs[1] & avx512) == avx512 && (xcr0 & 0xE6) == 0xE6) {
+                features |= BITP_CPU_AVX512;
+            }
+        }
+    }
+#endif
+    return features;
+}
+
+inline bitp_isa_t bitp_cpu_isa(unsigned features) {
+    if (features & BITP_CPU_AVX512) {
+        return BITP_ISA_AVX512;
+    }
+    if (features & BITP_CPU_AVX2) {
+        return BITP_ISA_AVX2;
+    }
+    if (features & BITP_CPU_SSE2) {
+        return BITP_ISA_SSE2;
+    }
+    return BITP_ISA_SCALAR;
+}
+
+#endif /* INCLUDE_BITP_CPU_H_ */
@@ -0,0 +1,283 @@
+/*
+ * edit.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#ifndef INCLUDE_BITP_EDIT_H_
+#define INCLUDE_BITP_EDIT_H_
+
+#include "cpu.h"
+#include "packer.h"
+
+/*
+ * In-place editing of a packed message, for transcoding and sanitizing without a parse and a
+ * repack: bit ranges are deleted, inserted or replaced by ones of another width, and the bits
+ * after them are shifted in the buffer. The message is a packer: msg->iter bits long, it can grow
+ * up to msg->capacity, the bits past msg->iter are zero (as bitp_packer_add_* leave them) and
+ * stay zero. The whole bytes of a shift go 8 bytes per step, 32 with AVX2.
+ */
+
+/* n_bits at bit_off in the message as it is before the edits become ins_bits read from src */
+typedef struct bitp_edit_tag {
+    size_t bit_off;
+    size_t del_bits;
+    // bits inserted at bit_off, src_off is the bit of src to start at; NULL src inserts zeros
+    const char *src;
+    size_t src_off;
+    size_t ins_bits;
+} bitp_edit_t;
+
+/*
+ * Applies n_edits edits sorted by bit_off in one pass over the bits after the first of them, each
+ * kept bit is moved once; msg->iter becomes the new length. BITP_EINVALID_ARG if the edits are out
+ * of order, overlap or reach past msg->iter, BITP_EFULL if the message grows past msg->capacity;
+ * nothing is changed then. src must not be in the message.
+ */
+bitp_status_t bitp_edit_apply(bitp_packer_t *msg, const bitp_edit_t *edits, size_t n_edits);
+
+/* val in n_bits (up to 64) inserted at bit_off; BITP_EINVALID_ARG if it doesn't fit */
+bitp_status_t bitp_edit_insert(bitp_packer_t *msg, size_t bit_off, uint64_t val, size_t n_bits);
+
+bitp_status_t bitp_edit_delete(bitp_packer_t *msg, size_t bit_off, size_t n_bits);
+
+/* the field of old_bits at bit_off becomes val in n_bits, the width may change */
+bitp_status_t bitp_edit_replace(bitp_packer_t *msg, size_t bit_off, size_t old_bits, uint64_t val, size_t n_bits);
+
+/* the same with an instruction set tier no higher than the CPU supports, for tests and benchmarks */
+bitp_status_t bitp_edit_apply_isa(bitp_packer_t *msg, const bitp_edit_t *edits, size_t n_edits, bitp_isa_t isa);
+
+/*
+ **************************************************************************************************
+  Realization
+ **************************************************************************************************
+ */
+
+/* up to 64 bits per step from the front (dst before src) or from the back, safe for overlaps */
+inline void bitp_edit_move_words_(char *buf, size_t cap, size_t dst, size_t src, size_t n_bits, int backward) {
+    for (size_t done = 0; done < n_bits;) {
+        unsigned n = n_bits - done < 64 ? (unsigned)(n_bits - done) : 64;
+        size_t at = backward ? n_bits - done - n : done;
+        bitp_write_bits_64(buf, cap, dst + at, bitp_read_bits_64(buf, cap, src + at), n);
+        done += n;
+    }
+}
+
+#if BITP_X86_64
+/* 32 bytes of a src at bit phase p, in memory byte order: see bitp_bitmap_apply_avx2_ */
+BITP_TARGET("avx2")
+inline __m256i bitp_edit_funnel_avx2_(const char *s, __m128i up, __m128i down) {
+    const __m256i rev_bytes = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                               7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    __m256i s0 = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)s), rev_bytes);
+    __m256i s1 = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(s + 1)), rev_bytes);
+    return _mm256_shuffle_epi8(_mm256_or_si256(_mm256_sll_epi64(s0, up), _mm256_srl_epi64(s1, down)), rev_bytes);
+}
+
+/* n_bytes of d from s at phase p (not 0), from the front; returns the bytes done */
+BITP_TARGET("avx2")
+inline size_t bitp_edit_shift_front_avx2_(char *d, const char *s, unsigned p, size_t n_bytes) {
+    const __m128i up = _mm_cvtsi32_si128((int)p);
+    const __m128i down = _mm_cvtsi32_si128((int)(CHAR_BIT - p));
+    size_t i = 0;
+    for (; i + 32 <= n_bytes; i += 32) {
+        _mm256_storeu_si256((__m256i *)(d + i), bitp_edit_funnel_avx2_(s + i, up, down));
+    }
+    return i;
+}
+
+/* the same from the back, s before d so that the byte after a step is not written yet */
+BITP_TARGET("avx2")
+inline size_t bitp_edit_shift_back_avx2_(char *d, const char *s, unsigned p, size_t n_bytes) {
+    const __m128i up = _mm_cvtsi32_si128((int)p);
+    const __m128i down = _mm_cvtsi32_si128((int)(CHAR_BIT - p));
+    size_t i = n_bytes;
+    for (; i >= 32; i -= 32) {
+        _mm256_storeu_si256((__m256i *)(d + i - 32), bitp_edit_funnel_avx2_(s + i - 32, up, down));
+    }
+    return n_bytes - i;
+}
+#endif
+
+/*
+ * n_bits from src to dst in buf, the ranges may overlap. The edge bits go by words, the whole dst
+ * bytes between them by memmove at the same bit phase and by funnel shifts of the src words at
+ * another. From the front when dst < src, from the back otherwise; going back, the byte past a
+ * step is kept in carry, it may be the dst byte written by the step before.
+ */
+inline void bitp_edit_move_(char *buf, size_t cap, size_t dst, size_t src, size_t n_bits, bitp_isa_t isa) {
+    if (dst == src || n_bits == 0) {
+        return;
+    }
+    size_t head = (CHAR_BIT - dst % CHAR_BIT) % CHAR_BIT;
+    if (head > n_bits) {
+        head = n_bits;
+    }
+    size_t n_bytes = (n_bits - head) / CHAR_BIT;
+    size_t tail = n_bits - head - n_bytes * CHAR_BIT;
+    char *dp = buf + (dst + head) / CHAR_BIT;
+    const char *sp = buf + (src + head) / CHAR_BIT;
+    unsigned p = (src + head) % CHAR_BIT;
+    size_t i = 0;
+    (void)isa;
+
+    if (dst < src) {
+        bitp_edit_move_words_(buf, cap, dst, src, head, 0);
+        if (!p) {
+            memmove(dp, sp, n_bytes);
+            i = n_bytes;
+        }
+#if BITP_X86_64
+        if (isa >= BITP_ISA_AVX2 && p) {
+            i = bitp_edit_shift_front_avx2_(dp, sp, p, n_bytes);
+        }
+#endif
+        for (; i + sizeof(uint64_t) <= n_bytes; i += sizeof(uint64_t)) {
+            uint64_t w = bitp_load_be_64(sp + i);
+            if (p) {
+                w = (w << p) | ((uint8_t)sp[i + sizeof(uint64_t)] >> (CHAR_BIT - p));
+            }
+            bitp_store_be_64(dp + i, w);
+        }
+        size_t done = head + i * CHAR_BIT;
+        bitp_edit_move_words_(buf, cap, dst + done, src + done, n_bits - done, 0);
+        return;
+    }
+
+    // a used bit of the byte past the whole bytes is a src bit, the byte is in the buffer
+    uint8_t carry = p ? (uint8_t)sp[n_bytes] : 0;
+    size_t done = head + n_bytes * CHAR_BIT;
+    bitp_edit_move_words_(buf, cap, dst + done, src + done, tail, 1);
+    if (!p) {
+        memmove(dp, sp, n_bytes);
+        i = n_bytes;
+    }
+#if BITP_X86_64
+    if (isa >= BITP_ISA_AVX2 && p && sp < dp) {
+        i = bitp_edit_shift_back_avx2_(dp, sp, p, n_bytes);
+        if (i < n_bytes) {
+            carry = (uint8_t)sp[n_bytes - i];
+        }
+    }
+#endif
+    for (; i + sizeof(uint64_t) <= n_bytes; i += sizeof(uint64_t)) {
+        size_t at = n_bytes - i - sizeof(uint64_t);
+        uint64_t w = bitp_load_be_64(sp + at);
+        uint64_t out = p ? (w << p) | (carry >> (CHAR_BIT - p)) : w;
+        carry = (uint8_t)(w >> 56);
+        bitp_store_be_64(dp + at, out);
+    }
+    done = head + (n_bytes - i) * CHAR_BIT;
+    bitp_edit_move_words_(buf, cap, dst, src, done, 1);
+}
+
+/* zeros n_bits at bit_off */
+inline void bitp_edit_clear_(char *buf, size_t cap, size_t bit_off, size_t n_bits) {
+    size_t head = (CHAR_BIT - bit_off % CHAR_BIT) % CHAR_BIT;
+    if (head >= n_bits) {
+        bitp_write_bits_64(buf, cap, bit_off, 0, (unsigned)n_bits);
+        return;
+    }
+    bitp_write_bits_64(buf, cap, bit_off, 0, (unsigned)head);
+    size_t n_bytes = (n_bits - head) / CHAR_BIT;
+    memset(buf + (bit_off + head) / CHAR_BIT, 0, n_bytes);
+    size_t done = head + n_bytes * CHAR_BIT;
+    bitp_write_bits_64(buf, cap, bit_off + done, 0, (unsigned)(n_bits - done));
+}
+
+inline bitp_status_t bitp_edit_apply_isa(bitp_packer_t *msg, const bitp_edit_t *edits, size_t n_edits, bitp_isa_t isa) {
+    size_t len = msg->iter;
+    size_t kept = len;
+    size_t inserted = 0;
+    for (size_t k = 0; k < n_edits; ++k) {
+        const bitp_edit_t *e = &edits[k];
+        if (e->bit_off > len || len - e->bit_off < e->del_bits) {
+            return BITP_EINVALID_ARG;
+        }
+        if (k && edits[k - 1].bit_off + edits[k - 1].del_bits > e->bit_off) {
+            return BITP_EINVALID_ARG;
+        }
+        kept -= e->del_bits;
+        if (e->ins_bits > msg->capacity - inserted) {
+            return BITP_EFULL;
+        }
+        inserted += e->ins_bits;
+    }
+    if (inserted > msg->capacity - kept) {
+        return BITP_EFULL;
+    }
+    size_t new_len = kept + inserted;
+    if (n_edits == 0) {
+        return BITP_OK;
+    }
+
+    /*
+     * The kept ranges between the edits move by the sum of the edits before them. Ranges moved
+     * towards the front are moved front to back, then the others back to front: a range is never
+     * written over before it's moved. The inserted bits go last.
+     */
+    size_t shift = 0;
+    for (size_t k = 0; k < n_edits; ++k) {
+        shift += edits[k].ins_bits - edits[k].del_bits;
+        size_t from = edits[k].bit_off + edits[k].del_bits;
+        size_t to = k + 1 < n_edits ? edits[k + 1].bit_off : len;
+        if ((ptrdiff_t)shift < 0) {
+            bitp_edit_move_(msg->buf, msg->capacity, from + shift, from, to - from, isa);
+        }
+    }
+    for (size_t k = n_edits; k-- > 0;) {
+        size_t from = edits[k].bit_off + edits[k].del_bits;
+        size_t to = k + 1 < n_edits ? edits[k + 1].bit_off : len;
+        if ((ptrdiff_t)shift > 0) {
+            bitp_edit_move_(msg->buf, msg->capacity, from + shift, from, to - from, isa);
+        }
+        shift -= edits[k].ins_bits - edits[k].del_bits;
+    }
+
+    for (size_t k = 0; k < n_edits; ++k) {
+        const bitp_edit_t *e = &edits[k];
+        size_t at = e->bit_off + shift;
+        if (e->src) {
+            for (size_t done = 0; done < e->ins_bits; done += 64) {
+                unsigned n = e->ins_bits - done < 64 ? (unsigned)(e->ins_bits - done) : 64;
+                uint64_t w = bitp_read_bits_64(e->src, e->src_off + e->ins_bits, e->src_off + done);
+                bitp_write_bits_64(msg->buf, msg->capacity, at + done, w, n);
+            }
+        }
+        else {
+            bitp_edit_clear_(msg->buf, msg->capacity, at, e->ins_bits);
+        }
+        shift += e->ins_bits - e->del_bits;
+    }
+    if (new_len < len) {
+        bitp_edit_clear_(msg->buf, msg->capacity, new_len, len - new_len);
+    }
+    msg->iter = new_len;
+    return BITP_OK;
+}
+
+inline bitp_status_t bitp_edit_apply(bitp_packer_t *msg, const bitp_edit_t *edits, size_t n_edits) {
+    return bitp_edit_apply_isa(msg, edits, n_edits, BITP_ISA_NATIVE);
+}
+
+inline bitp_status_t bitp_edit_replace(bitp_packer_t *msg, size_t bit_off, size_t old_bits, uint64_t val, size_t n_bits) {
+    if (n_bits > 64 || (n_bits < 64 && (val >> n_bits) != 0)) {
+        return BITP_EINVALID_ARG;
+    }
+    char bytes[sizeof(uint64_t)];
+    bitp_store_be_64(bytes, n_bits ? val << (64 - n_bits) : 0);
+    bitp_edit_t edit = {bit_off, old_bits, bytes, 0, n_bits};
+    return bitp_edit_apply(msg, &edit, 1);
+}
+
+inline bitp_status_t bitp_edit_insert(bitp_packer_t *msg, size_t bit_off, uint64_t val, size_t n_bits) {
+    return bitp_edit_replace(msg, bit_off, 0, val, n_bits);
+}
+
+inline bitp_status_t bitp_edit_delete(bitp_packer_t *msg, size_t bit_off, size_t n_bits) {
+    bitp_edit_t edit = {bit_off, n_bits, NULL, 0, 0};
+    return bitp_edit_apply(msg, &edit, 1);
+}
+
+#endif /* INCLUDE_BITP_EDIT_H_ */
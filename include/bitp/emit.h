@@ -0,0 +1,365 @@
+/*
+ * emit.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#ifndef INCLUDE_BITP_EMIT_H_
+#define INCLUDE_BITP_EMIT_H_
+
+#include "parser.h"
+
+/*
+ * Decoded records as text, one CSV or JSON line per record, written straight into the caller's
+ * output buffer. The layout is prepared once, a record is a bounds check and one pass over its
+ * fields, nothing is allocated.
+ */
+
+#define BITP_EMIT_MAX 64
+
+/* room for the field names with their quotes and separators */
+#define BITP_EMIT_TEXT_SIZE 2048
+
+typedef enum bitp_emit_kind_tag {
+    // decimal, up to 64 bits
+    BITP_EMIT_UNSIGNED = 0,
+    // decimal of a two's complement field, up to 64 bits
+    BITP_EMIT_SIGNED,
+    // bit string of any length as hex digits, the last digit padded with zero bits
+    BITP_EMIT_HEX,
+    // bits that are consumed without output
+    BITP_EMIT_SKIP,
+} bitp_emit_kind_t;
+
+typedef enum bitp_emit_format_tag {
+    BITP_EMIT_CSV = 0,
+    // an object per line, hex strings are quoted
+    BITP_EMIT_JSON,
+} bitp_emit_format_t;
+
+typedef struct bitp_emit_field_tag {
+    // written as it is, no escaping
+    const char *name;
+    unsigned n_bits;
+    bitp_emit_kind_t kind;
+} bitp_emit_field_t;
+
+typedef struct bitp_emit_tag {
+    // separator and key text before every field, then the end of the line
+    char text[BITP_EMIT_TEXT_SIZE];
+    uint16_t prefix_off[BITP_EMIT_MAX + 1];
+    uint16_t prefix_len[BITP_EMIT_MAX + 1];
+    unsigned n_bits[BITP_EMIT_MAX];
+    uint8_t kind[BITP_EMIT_MAX];
+    const bitp_emit_field_t *fields;
+    unsigned n_fields;
+    bitp_emit_format_t format;
+    // bits of a record and the longest line
+    size_t record_bits;
+    size_t max_line;
+} bitp_emit_t;
+
+bitp_status_t bitp_emit_init(bitp_emit_t *inst,
+                             const bitp_emit_field_t *fields,
+                             unsigned n_fields,
+                             bitp_emit_format_t format);
+
+/* the CSV header line at out + *len, nothing for JSON; BITP_EFULL if it doesn't fit */
+bitp_status_t bitp_emit_header(const bitp_emit_t *inst, char *out, size_t size, size_t *len);
+
+/*
+ * Decodes one record at the parser position and appends its line at out + *len. BITP_EFULL if
+ * fewer than inst->max_line bytes are left in out or the record isn't in the parser; nothing is
+ * written and the parser isn't moved then.
+ */
+bitp_status_t bitp_emit_record(const bitp_emit_t *inst, bitp_parser_t *parser, char *out, size_t size, size_t *len);
+
+/*
+ **************************************************************************************************
+  Realization
+ **************************************************************************************************
+ */
+
+/*
+ * Text is written in whole words past the end of what's needed and overwritten by the next
+ * piece: a line may write this much past its end, the prefixes are read as much past theirs.
+ */
+#define BITP_EMIT_SLACK_ 24
+
+inline bitp_status_t bitp_emit_text_(bitp_emit_t *inst, size_t *used, const char *s, size_t n) {
+    if (BITP_EMIT_TEXT_SIZE - BITP_EMIT_SLACK_ - *used < n) {
+        return BITP_EINVALID_ARG;
+    }
+    memcpy(inst->text + *used, s, n);
+    *used += n;
+    return BITP_OK;
+}
+
+inline bitp_status_t bitp_emit_init(bitp_emit_t *inst,
+                                    const bitp_emit_field_t *fields,
+                                    unsigned n_fields,
+                                    bitp_emit_format_t format) {
+    size_t used = 0;
+    unsigned n_out = 0;
+    int json = format == BITP_EMIT_JSON;
+
+    if (n_fields > BITP_EMIT_MAX) {
+        return BITP_EINVALID_ARG;
+    }
+    inst->fields = fields;
+    inst->n_fields = n_fields;
+    inst->format = format;
+    inst->record_bits = 0;
+    inst->max_line = BITP_EMIT_SLACK_;
+    memset(inst->text, 0, sizeof(inst->text));
+
+    for (unsigned i = 0; i < n_fields; ++i) {
+        unsigned n_bits = fields[i].n_bits;
+        bitp_emit_kind_t kind = fields[i].kind;
+        int is_int = kind == BITP_EMIT_UNSIGNED || kind == BITP_EMIT_SIGNED;
+
+        if (n_bits == 0 || kind > BITP_EMIT_SKIP || (is_int && n_bits > 64)) {
+            return BITP_EINVALID_ARG;
+        }
+        inst->n_bits[i] = n_bits;
+        inst->kind[i] = (uint8_t)kind;
+        inst->prefix_off[i] = (uint16_t)used;
+        inst->record_bits += n_bits;
+        if (kind == BITP_EMIT_SKIP) {
+            inst->prefix_len[i] = 0;
+            continue;
+        }
+
+        const char *sep = json ? (n_out ? ",\"" : "{\"") : (n_out ? "," : "");
+        bitp_status_t s = bitp_emit_text_(inst, &used, sep, strlen(sep));
+        if (json && s == BITP_OK) {
+            s = bitp_emit_text_(inst, &used, fields[i].name, strlen(fields[i].name));
+        }
+        if (json && s == BITP_OK) {
+            s = bitp_emit_text_(inst, &used, "\":", 2);
+        }
+        if (s != BITP_OK) {
+            return s;
+        }
+        inst->prefix_len[i] = (uint16_t)(used - inst->prefix_off[i]);
+        inst->max_line += inst->prefix_len[i];
+        if (kind == BITP_EMIT_HEX) {
+            inst->max_line += (n_bits + 3) / 4 + (json ? 2 : 0);
+        }
+        else {
+            // 18446744073709551615 and -9223372036854775808
+            inst->max_line += 20;
+        }
+        n_out++;
+    }
+
+    const char *end = json ? (n_out ? "}\n" : "{}\n") : "\n";
+    inst->prefix_off[n_fields] = (uint16_t)used;
+    if (bitp_emit_text_(inst, &used, end, strlen(end)) != BITP_OK) {
+        return BITP_EINVALID_ARG;
+    }
+    inst->prefix_len[n_fields] = (uint16_t)(used - inst->prefix_off[n_fields]);
+    inst->max_line += inst->prefix_len[n_fields];
+    return BITP_OK;
+}
+
+inline bitp_status_t bitp_emit_header(const bitp_emit_t *inst, char *out, size_t size, size_t *len) {
+    size_t n = 0;
+    unsigned n_out = 0;
+
+    if (inst->format != BITP_EMIT_CSV) {
+        return BITP_OK;
+    }
+    for (unsigned i = 0; i < inst->n_fields; ++i) {
+        if (inst->kind[i] != BITP_EMIT_SKIP) {
+            n += strlen(inst->fields[i].name) + (n_out++ ? 1 : 0);
+        }
+    }
+    if (*len > size || size - *len < n + 1) {
+        return BITP_EFULL;
+    }
+
+    char *p = out + *len;
+    n_out = 0;
+    for (unsigned i = 0; i < inst->n_fields; ++i) {
+        if (inst->kind[i] == BITP_EMIT_SKIP) {
+            continue;
+        }
+        if (n_out++) {
+            *p++ = ',';
+        }
+        size_t name_len = strlen(inst->fields[i].name);
+        memcpy(p, inst->fields[i].name, name_len);
+        p += name_len;
+    }
+    *p++ = '\n';
+    *len = (size_t)(p - out);
+    return BITP_OK;
+}
+
+/* decimal digits of val, from the bit width and one comparison */
+inline unsigned bitp_emit_n_digits_(uint64_t val) {
+    static const uint64_t pow10[20] = {1ULL,
+                                       10ULL,
+                                       100ULL,
+                                       1000ULL,
+                                       10000ULL,
+                                       100000ULL,
+                                       1000000ULL,
+                                       10000000ULL,
+                                       100000000ULL,
+                                       1000000000ULL,
+                                       10000000000ULL,
+                                       100000000000ULL,
+                                       1000000000000ULL,
+                                       10000000000000ULL,
+                                       100000000000000ULL,
+                                       1000000000000000ULL,
+                                       10000000000000000ULL,
+                                       100000000000000000ULL,
+                                       1000000000000000000ULL,
+                                       10000000000000000000ULL};
+
+    unsigned t = (64 - bitp_clz_64(val | 1)) * 1233 >> 12;
+    return t + ((val | 1) >= pow10[t]);
+}
+
+/* val < 10^8 as 8 ASCII digits in memory order */
+inline uint64_t bitp_emit_8_digits_(uint32_t val) {
+    static const char digits[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+
+    uint32_t high = val / 10000;
+    uint32_t low = val % 10000;
+    uint16_t d[4];
+
+    memcpy(&d[0], digits + high / 100 * 2, 2);
+    memcpy(&d[1], digits + high % 100 * 2, 2);
+    memcpy(&d[2], digits + low / 100 * 2, 2);
+    memcpy(&d[3], digits + low % 100 * 2, 2);
+    // combined in a register, loading the word back from d would stall on store forwarding
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    return (uint64_t)d[0] | (uint64_t)d[1] << 16 | (uint64_t)d[2] << 32 | (uint64_t)d[3] << 48;
+#else
+    return (uint64_t)d[0] << 48 | (uint64_t)d[1] << 32 | (uint64_t)d[2] << 16 | (uint64_t)d[3];
+#endif
+}
+
+/* val < 10^8 without leading zeros */
+inline char *bitp_emit_lead_(char *p, uint32_t val) {
+    unsigned n = bitp_emit_n_digits_(val);
+    uint64_t digits = bitp_emit_8_digits_(val);
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    digits >>= 8 * (8 - n);
+#else
+    digits <<= 8 * (8 - n);
+#endif
+    memcpy(p, &digits, sizeof(digits));
+    return p + n;
+}
+
+inline char *bitp_emit_full_(char *p, uint32_t val) {
+    uint64_t digits = bitp_emit_8_digits_(val);
+    memcpy(p, &digits, sizeof(digits));
+    return p + 8;
+}
+
+inline char *bitp_emit_u64_(char *p, uint64_t val) {
+    if (val >= 10000000000000000ULL) {
+        p = bitp_emit_lead_(p, (uint32_t)(val / 10000000000000000ULL));
+        p = bitp_emit_full_(p, (uint32_t)(val / 100000000 % 100000000));
+        return bitp_emit_full_(p, (uint32_t)(val % 100000000));
+    }
+    if (val >= 100000000) {
+        p = bitp_emit_lead_(p, (uint32_t)(val / 100000000));
+        return bitp_emit_full_(p, (uint32_t)(val % 100000000));
+    }
+    return bitp_emit_lead_(p, (uint32_t)val);
+}
+
+/* fixed-size copies, a call to memcpy of a variable length costs more than the field */
+inline char *bitp_emit_prefix_(char *p, const char *text, size_t n) {
+    memcpy(p, text, 8);
+    memcpy(p + 8, text + 8, 8);
+    memcpy(p + 16, text + 16, 8);
+    if (n > BITP_EMIT_SLACK_) {
+        memcpy(p + BITP_EMIT_SLACK_, text + BITP_EMIT_SLACK_, n - BITP_EMIT_SLACK_);
+    }
+    return p + n;
+}
+
+/* n_bits at bit_off as hex digits, writes up to 15 digits more */
+inline char *bitp_emit_hex_bits_(char *p, const char *buf, size_t buf_bits, size_t bit_off, size_t n_bits) {
+    static const char hex[] =
+        "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+        "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+        "404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f"
+        "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+        "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+        "a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+        "c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+        "e0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+
+    for (size_t done = 0; done < n_bits; done += 64) {
+        size_t chunk = n_bits - done < 64 ? n_bits - done : 64;
+        uint64_t word = bitp_read_bits_64(buf, buf_bits, bit_off + done);
+        word &= 0xFFFFFFFFFFFFFFFFULL << (64 - chunk);
+        for (unsigned b = 0; b < 8; ++b) {
+            memcpy(p + 2 * b, hex + ((word >> (56 - 8 * b)) & 0xFF) * 2, 2);
+        }
+        p += (chunk + 3) / 4;
+    }
+    return p;
+}
+
+inline bitp_status_t bitp_emit_record(const bitp_emit_t *inst, bitp_parser_t *parser, char *out, size_t size, size_t *len) {
+    int json = inst->format == BITP_EMIT_JSON;
+
+    if (*len > size || size - *len < inst->max_line || parser->iter > parser->capacity ||
+        parser->capacity - parser->iter < inst->record_bits) {
+        return BITP_EFULL;
+    }
+
+    char *p = out + *len;
+    size_t iter = parser->iter;
+    for (unsigned i = 0; i < inst->n_fields; ++i) {
+        unsigned n_bits = inst->n_bits[i];
+        if (inst->kind[i] == BITP_EMIT_SKIP) {
+            iter += n_bits;
+            continue;
+        }
+        p = bitp_emit_prefix_(p, inst->text + inst->prefix_off[i], inst->prefix_len[i]);
+
+        if (inst->kind[i] == BITP_EMIT_HEX) {
+            *p = '"';
+            p += json;
+            p = bitp_emit_hex_bits_(p, parser->buf, parser->capacity, iter, n_bits);
+            *p = '"';
+            p += json;
+        }
+        else {
+            uint64_t word = bitp_read_bits_64(parser->buf, parser->capacity, iter);
+            uint64_t val = word >> (64 - n_bits);
+            if (inst->kind[i] == BITP_EMIT_SIGNED) {
+                int64_t sval = (int64_t)word >> (64 - n_bits);
+                uint64_t neg = (uint64_t)sval >> 63;
+                *p = '-';
+                p += neg;
+                val = neg ? 0 - (uint64_t)sval : (uint64_t)sval;
+            }
+            p = bitp_emit_u64_(p, val);
+        }
+        iter += n_bits;
+    }
+    p = bitp_emit_prefix_(p, inst->text + inst->prefix_off[inst->n_fields], inst->prefix_len[inst->n_fields]);
+
+    parser->iter = iter;
+    *len = (size_t)(p - out);
+    return BITP_OK;
+}
+
+#endif /* INCLUDE_BITP_EMIT_H_ */
@@ -0,0 +1,302 @@
+/*
+ * fields.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#ifndef INCLUDE_BITP_FIELDS_H_
+#define INCLUDE_BITP_FIELDS_H_
+
+#include "cpu.h"
+#include "packer.h"
+#include "parser.h"
+
+#define BITP_FIELDS_MAX 16
+
+/* width of bits which are consumed (parser) or left zero (packer) but don't produce a field */
+#define BITP_FIELD_SKIP(n_bits_) ((n_bits_) | 0x100u)
+
+/*
+ * Results and values are moved a whole 64-bit chunk of lanes at a time, so arrays passed to
+ * extract/add must have room for n_fields rounded up to a multiple of 64 / lane_bits elements.
+ * An array of BITP_FIELDS_MAX elements always fits.
+ */
+#define BITP_FIELDS_ARRAY_SIZE(n_fields_, lane_bits_) \
+    (((n_fields_) + 64 / (lane_bits_)-1) / (64 / (lane_bits_)) * (64 / (lane_bits_)))
+
+typedef struct bitp_fields_tag {
+    // MSB-aligned window: bits belonging to output fields
+    uint64_t keep_mask;
+    // PDEP mask of every chunk of 64 / lane_bits output lanes
+    uint64_t lane_masks[BITP_FIELDS_MAX];
+    unsigned chunk_bits[BITP_FIELDS_MAX];
+    // shift/mask path: field = (window >> shifts[i]) & masks[i]
+    uint64_t masks[BITP_FIELDS_MAX];
+    uint8_t shifts[BITP_FIELDS_MAX];
+    unsigned n_fields;
+    unsigned n_chunks;
+    unsigned lane_bits;
+    unsigned n_bits;
+    int use_pdep;
+} bitp_fields_t;
+
+bitp_status_t bitp_fields_init(bitp_fields_t *inst,
+                               const unsigned *widths,
+                               unsigned n_widths,
+                               unsigned lane_bits);
+
+bitp_status_t bitp_parser_extract_fields_u8(bitp_parser_t *inst, const bitp_fields_t *fields, uint8_t *res);
+
+bitp_status_t bitp_parser_extract_fields_u16(bitp_parser_t *inst, const bitp_fields_t *fields, uint16_t *res);
+
+bitp_status_t bitp_parser_extract_fields_u32(bitp_parser_t *inst, const bitp_fields_t *fields, uint32_t *res);
+
+bitp_status_t bitp_parser_extract_fields_u64(bitp_parser_t *inst, const bitp_fields_t *fields, uint64_t *res);
+
+bitp_status_t bitp_packer_add_fields_u8(bitp_packer_t *inst, const bitp_fields_t *fields, const uint8_t *vals);
+
+bitp_status_t bitp_packer_add_fields_u16(bitp_packer_t *inst, const bitp_fields_t *fields, const uint16_t *vals);
+
+bitp_status_t bitp_packer_add_fields_u32(bitp_packer_t *inst, const bitp_fields_t *fields, const uint32_t *vals);
+
+bitp_status_t bitp_packer_add_fields_u64(bitp_packer_t *inst, const bitp_fields_t *fields, const uint64_t *vals);
+
+/*
+ **************************************************************************************************
+  Realization
+ **************************************************************************************************
+ */
+
+#if BITP_X86_64 && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define BITP_FIELDS_PDEP 1
+#else
+#define BITP_FIELDS_PDEP 0
+#endif
+
+inline bitp_status_t bitp_fields_init(bitp_fields_t *inst,
+                                      const unsigned *widths,
+                                      unsigned n_widths,
+                                      unsigned lane_bits) {
+    if (lane_bits != 8 && lane_bits != 16 && lane_bits != 32 && lane_bits != 64) {
+        return BITP_EINVALID_ARG;
+    }
+
+    memset(inst, 0, sizeof(*inst));
+    inst->lane_bits = lane_bits;
+
+    unsigned lanes_per_chunk = 64 / lane_bits;
+    unsigned pos = 0;
+    for (unsigned i = 0; i < n_widths; ++i) {
+        unsigned n_bits = widths[i] & 0xFF;
+        if (n_bits == 0 || n_bits > 64 - pos) {
+            return BITP_EINVALID_ARG;
+        }
+        pos += n_bits;
+        if (widths[i] & BITP_FIELD_SKIP(0)) {
+            continue;
+        }
+        if (n_bits > lane_bits || inst->n_fields == BITP_FIELDS_MAX) {
+            return BITP_EINVALID_ARG;
+        }
+
+        unsigned field = inst->n_fields++;
+        unsigned chunk = field / lanes_per_chunk;
+        unsigned lane = lanes_per_chunk - 1 - field % lanes_per_chunk;
+
+        inst->shifts[field] = (uint8_t)(64 - pos);
+        inst->masks[field] = 0xFFFFFFFFFFFFFFFFULL >> (64 - n_bits);
+        inst->keep_mask |= inst->masks[field] << inst->shifts[field];
+        // lanes are filled from the top, so the deposit keeps field order and a lane
+        // reversal puts field j of the chunk into lane j
+        inst->lane_masks[chunk] |= inst->masks[field] << (lane * lane_bits);
+        inst->chunk_bits[chunk] += n_bits;
+        inst->n_chunks = chunk + 1;
+    }
+    inst->n_bits = pos;
+
+#if BITP_FIELDS_PDEP
+    inst->use_pdep = (bitp_cpu_features() & BITP_CPU_FAST_PDEP) != 0;
+#endif
+
+    return BITP_OK;
+}
+
+inline uint64_t bitp_fields_reverse_lanes_(uint64_t x, unsigned lane_bits) {
+    switch (lane_bits) {
+    case 8:
+        return bitp_ntoh_64(x);
+    case 16:
+        x = (x >> 32) | (x << 32);
+        return ((x >> 16) & 0x0000FFFF0000FFFFULL) | ((x & 0x0000FFFF0000FFFFULL) << 16);
+    case 32:
+        return (x >> 32) | (x << 32);
+    default:
+        return x;
+    }
+}
+
+#if BITP_FIELDS_PDEP
+// every CPU with BMI2 has POPCNT as well
+BITP_TARGET("bmi2,popcnt")
+inline void bitp_fields_split_pdep_(const bitp_fields_t *fields,
+                                    uint64_t window,
+                                    void *res,
+                                    unsigned lane_bits) {
+    uint64_t compact = _pext_u64(window, fields->keep_mask);
+    unsigned remaining = bitp_popcount_64(fields->keep_mask);
+
+    for (unsigned c = 0; c < fields->n_chunks && c < BITP_FIELDS_MAX * lane_bits / 64; ++c) {
+        remaining -= fields->chunk_bits[c];
+        uint64_t lanes = _pdep_u64(compact >> remaining, fields->lane_masks[c]);
+        lanes = bitp_fields_reverse_lanes_(lanes, lane_bits);
+        memcpy((char *)res + c * sizeof(lanes), &lanes, sizeof(lanes));
+    }
+}
+
+BITP_TARGET("bmi2,popcnt")
+inline uint64_t bitp_fields_join_pdep_(const bitp_fields_t *fields,
+                                       const void *vals,
+                                       unsigned lane_bits) {
+    uint64_t compact = 0;
+
+    for (unsigned c = 0; c < fields->n_chunks && c < BITP_FIELDS_MAX * lane_bits / 64; ++c) {
+        uint64_t lanes;
+        memcpy(&lanes, (const char *)vals + c * sizeof(lanes), sizeof(lanes));
+        lanes = bitp_fields_reverse_lanes_(lanes, lane_bits);
+        uint64_t bits = _pext_u64(lanes, fields->lane_masks[c]);
+        compact = c ? (compact << fields->chunk_bits[c]) | bits : bits;
+    }
+
+    return _pdep_u64(compact, fields->keep_mask);
+}
+#endif
+
+#define BITP_FIELDS_SPLIT_(fields_, window_, res_, type_)                               \
+    do {                                                                                \
+        for (unsigned i_ = 0; i_ < (fields_)->n_fields; ++i_) {                         \
+            (res_)[i_] = (type_)(((window_) >> (fields_)->shifts[i_]) & (fields_)->masks[i_]); \
+        }                                                                               \
+    } while (0)
+
+#define BITP_FIELDS_JOIN_(fields_, vals_, window_)                                    \
+    do {                                                                              \
+        for (unsigned i_ = 0; i_ < (fields_)->n_fields; ++i_) {                       \
+            (window_) |= (uint64_t)(vals_)[i_] << (fields_)->shifts[i_];              \
+        }                                                                             \
+    } while (0)
+
+#if BITP_CHECK_RANGE == 0
+#define BITP_FIELDS_CHECK_RANGE_(fields_, vals_)
+#else
+#define BITP_FIELDS_CHECK_RANGE_(fields_, vals_)                                      \
+    do {                                                                              \
+        for (unsigned i_ = 0; i_ < (fields_)->n_fields; ++i_) {                       \
+            if ((uint64_t)(vals_)[i_] > (fields_)->masks[i_]) {                       \
+                return BITP_EINVALID_ARG;                                             \
+            }                                                                         \
+        }                                                                             \
+    } while (0)
+#endif
+
+#if BITP_CHECK_PARAM == 0
+#define BITP_FIELDS_CHECK_LANE_(fields_, type_)
+#else
+#define BITP_FIELDS_CHECK_LANE_(fields_, type_)                 \
+    do {                                                        \
+        if ((fields_)->lane_bits != CHAR_BIT * sizeof(type_))   \
+            return BITP_EINVALID_ARG;                           \
+    } while (0)
+#endif
+
+#if BITP_FIELDS_PDEP
+#define BITP_FIELDS_EXTRACT_(inst_, fields_, res_, type_)                                   \
+    do {                                                                                    \
+        BITP_CHECK_OVERFLOW(inst_, (fields_)->n_bits);                                      \
+        BITP_FIELDS_CHECK_LANE_(fields_, type_);                                            \
+        uint64_t window_ = bitp_read_bits_64((inst_)->buf, (inst_)->capacity, (inst_)->iter); \
+        if ((fields_)->use_pdep) {                                                          \
+            bitp_fields_split_pdep_(fields_, window_, res_, CHAR_BIT * sizeof(type_));                                \
+        }                                                                                   \
+        else {                                                                              \
+            BITP_FIELDS_SPLIT_(fields_, window_, res_, type_);                              \
+        }                                                                                   \
+        (inst_)->iter += (fields_)->n_bits;                                                 \
+        return BITP_OK;                                                                     \
+    } while (0)
+
+#define BITP_FIELDS_ADD_(inst_, fields_, vals_, type_)                                      \
+    do {                                                                                    \
+        BITP_CHECK_OVERFLOW(inst_, (fields_)->n_bits);                                      \
+        BITP_FIELDS_CHECK_LANE_(fields_, type_);                                            \
+        BITP_FIELDS_CHECK_RANGE_(fields_, vals_);                                           \
+        uint64_t window_ = 0;                                                               \
+        if ((fields_)->use_pdep) {                                                          \
+            window_ = bitp_fields_join_pdep_(fields_, vals_, CHAR_BIT * sizeof(type_));                               \
+        }                                                                                   \
+        else {                                                                              \
+            BITP_FIELDS_JOIN_(fields_, vals_, window_);                                     \
+        }                                                                                   \
+        bitp_or_bits_64((inst_)->buf, (inst_)->capacity, (inst_)->iter, window_,            \
+                        (fields_)->n_bits);                                                 \
+        (inst_)->iter += (fields_)->n_bits;                                                 \
+        return BITP_OK;                                                                     \
+    } while (0)
+#else
+#define BITP_FIELDS_EXTRACT_(inst_, fields_, res_, type_)                                   \
+    do {                                                                                    \
+        BITP_CHECK_OVERFLOW(inst_, (fields_)->n_bits);                                      \
+        BITP_FIELDS_CHECK_LANE_(fields_, type_);                                            \
+        uint64_t window_ = bitp_read_bits_64((inst_)->buf, (inst_)->capacity, (inst_)->iter); \
+        BITP_FIELDS_SPLIT_(fields_, window_, res_, type_);                                  \
+        (inst_)->iter += (fields_)->n_bits;                                                 \
+        return BITP_OK;                                                                     \
+    } while (0)
+
+#define BITP_FIELDS_ADD_(inst_, fields_, vals_, type_)                                      \
+    do {                                                                                    \
+        BITP_CHECK_OVERFLOW(inst_, (fields_)->n_bits);                                      \
+        BITP_FIELDS_CHECK_LANE_(fields_, type_);                                            \
+        BITP_FIELDS_CHECK_RANGE_(fields_, vals_);                                           \
+        uint64_t window_ = 0;                                                               \
+        BITP_FIELDS_JOIN_(fields_, vals_, window_);                                         \
+        bitp_or_bits_64((inst_)->buf, (inst_)->capacity, (inst_)->iter, window_,            \
+                        (fields_)->n_bits);                                                 \
+        (inst_)->iter += (fields_)->n_bits;                                                 \
+        return BITP_OK;                                                                     \
+    } while (0)
+#endif
+
+inline bitp_status_t bitp_parser_extract_fields_u8(bitp_parser_t *inst, const bitp_fields_t *fields, uint8_t *res) {
+    BITP_FIELDS_EXTRACT_(inst, fields, res, uint8_t);
+}
+
+inline bitp_status_t bitp_parser_extract_fields_u16(bitp_parser_t *inst, const bitp_fields_t *fields, uint16_t *res) {
+    BITP_FIELDS_EXTRACT_(inst, fields, res, uint16_t);
+}
+
+inline bitp_status_t bitp_parser_extract_fields_u32(bitp_parser_t *inst, const bitp_fields_t *fields, uint32_t *res) {
+    BITP_FIELDS_EXTRACT_(inst, fields, res, uint32_t);
+}
+
+inline bitp_status_t bitp_parser_extract_fields_u64(bitp_parser_t *inst, const bitp_fields_t *fields, uint64_t *res) {
+    BITP_FIELDS_EXTRACT_(inst, fields, res, uint64_t);
+}
+
+inline bitp_status_t bitp_packer_add_fields_u8(bitp_packer_t *inst, const bitp_fields_t *fields, const uint8_t *vals) {
+    BITP_FIELDS_ADD_(inst, fields, vals, uint8_t);
+}
+
+inline bitp_status_t bitp_packer_add_fields_u16(bitp_packer_t *inst, const bitp_fields_t *fields, const uint16_t *vals) {
+    BITP_FIELDS_ADD_(inst, fields, vals, uint16_t);
+}
+
+inline bitp_status_t bitp_packer_add_fields_u32(bitp_packer_t *inst, const bitp_fields_t *fields, const uint32_t *vals) {
+    BITP_FIELDS_ADD_(inst, fields, vals, uint32_t);
+}
+
+inline bitp_status_t bitp_packer_add_fields_u64(bitp_packer_t *inst, const bitp_fields_t *fields, const uint64_t *vals) {
+    BITP_FIELDS_ADD_(inst, fields, vals, uint64_t);
+}
+
+#endif /* INCLUDE_BITP_FIELDS_H_ */
@@ -0,0 +1,219 @@
+/*
+ * hash.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#ifndef INCLUDE_BITP_HASH_H_
+#define INCLUDE_BITP_HASH_H_
+
+#include "cpu.h"
+#include "parser.h"
+
+/*
+ * 64-bit hash of a bit range, for lookups (not for security). The bits are taken as big-endian
+ * words whatever their alignment, so a payload hashes the same at any bit offset of any buffer.
+ * Four 64-bit lanes take a word each per 256-bit stripe, the way xxh3 accumulates: the word xor
+ * a key, the product of its 32-bit halves and the neighbour lane's word are added to a lane.
+ * The lanes are scrambled every 16 stripes and mixed with the length at the end. The AVX2 path
+ * gives the same values as the scalar one.
+ */
+uint64_t bitp_hash_bits(const char *buf, size_t bit_off, size_t n_bits);
+
+uint64_t bitp_hash_bits_isa(const char *buf, size_t bit_off, size_t n_bits, bitp_isa_t isa);
+
+/* the next n_bits of a parser, which isn't moved; BITP_EFULL if there are fewer */
+bitp_status_t bitp_parser_hash(const bitp_parser_t *inst, size_t n_bits, uint64_t *res);
+
+/*
+ **************************************************************************************************
+  Realization
+ **************************************************************************************************
+ */
+
+#define BITP_HASH_PRIME32_ 0x9E3779B1ULL
+#define BITP_HASH_PRIME64_1_ 0x9E3779B185EBCA87ULL
+#define BITP_HASH_PRIME64_2_ 0xC2B2AE3D27D4EB4FULL
+
+/* stripes between scrambles */
+#define BITP_HASH_BLOCK_ 16
+
+#define BITP_HASH_KEY0_ 0xBE4BA423396CFEB8ULL
+#define BITP_HASH_KEY1_ 0x1CAD21F72C81017CULL
+#define BITP_HASH_KEY2_ 0xDB979083E96DD4DEULL
+#define BITP_HASH_KEY3_ 0x1F67B3B7A4A44072ULL
+
+inline uint64_t bitp_hash_fmix_(uint64_t h) {
+    h ^= h >> 33;
+    h *= BITP_HASH_PRIME64_2_;
+    h ^= h >> 29;
+    h *= BITP_HASH_PRIME64_1_;
+    h ^= h >> 32;
+    return h;
+}
+
+inline uint64_t bitp_hash_lane_(uint64_t acc, uint64_t w, uint64_t key, uint64_t other) {
+    uint64_t k = w ^ key;
+    return acc + (k & 0xFFFFFFFFULL) * (k >> 32) + other;
+}
+
+/* the lanes written out, -O2 doesn't unroll a loop over them */
+inline void bitp_hash_stripe_(uint64_t acc[4], const uint64_t w[4]) {
+    acc[0] = bitp_hash_lane_(acc[0], w[0], BITP_HASH_KEY0_, w[1]);
+    acc[1] = bitp_hash_lane_(acc[1], w[1], BITP_HASH_KEY1_, w[0]);
+    acc[2] = bitp_hash_lane_(acc[2], w[2], BITP_HASH_KEY2_, w[3]);
+    acc[3] = bitp_hash_lane_(acc[3], w[3], BITP_HASH_KEY3_, w[2]);
+}
+
+inline uint64_t bitp_hash_scramble_lane_(uint64_t acc, uint64_t key) {
+    return (acc ^ (acc >> 47) ^ key) * BITP_HASH_PRIME32_;
+}
+
+inline void bitp_hash_scramble_(uint64_t acc[4]) {
+    acc[0] = bitp_hash_scramble_lane_(acc[0], BITP_HASH_KEY3_);
+    acc[1] = bitp_hash_scramble_lane_(acc[1], BITP_HASH_KEY2_);
+    acc[2] = bitp_hash_scramble_lane_(acc[2], BITP_HASH_KEY1_);
+    acc[3] = bitp_hash_scramble_lane_(acc[3], BITP_HASH_KEY0_);
+}
+
+/* the 4 words of the stripe at byte p and bit phase; with a phase byte 32 is read, its top bits are in the stripe */
+inline void bitp_hash_load_(const char *p, unsigned phase, uint64_t w[4]) {
+    w[0] = bitp_load_be_64(p);
+    w[1] = bitp_load_be_64(p + 8);
+    w[2] = bitp_load_be_64(p + 16);
+    w[3] = bitp_load_be_64(p + 24);
+    if (phase) {
+        w[0] = (w[0] << phase) | ((uint8_t)p[8] >> (CHAR_BIT - phase));
+        w[1] = (w[1] << phase) | ((uint8_t)p[16] >> (CHAR_BIT - phase));
+        w[2] = (w[2] << phase) | ((uint8_t)p[24] >> (CHAR_BIT - phase));
+        w[3] = (w[3] << phase) | ((uint8_t)p[32] >> (CHAR_BIT - phase));
+    }
+}
+
+/*
+ * word i of the last stripe of a range of n_bits at p and bit phase, read without going past
+ * the range and zero past its end; rest is the number of bits in the last stripe
+ */
+inline uint64_t bitp_hash_tail_word_(const char *p, size_t n_bits, unsigned phase, size_t rest, unsigned i) {
+    if (rest <= 64 * i) {
+        return 0;
+    }
+    size_t n_bytes = (phase + n_bits + CHAR_BIT - 1) / CHAR_BIT;
+    size_t b = (n_bits - rest) / CHAR_BIT + i * sizeof(uint64_t);
+    uint64_t w;
+    if (b + sizeof(uint64_t) + (phase ? 1 : 0) <= n_bytes) {
+        w = bitp_load_be_64(p + b);
+        w = phase ? (w << phase) | ((uint8_t)p[b + sizeof(uint64_t)] >> (CHAR_BIT - phase)) : w;
+    }
+    else if (n_bytes >= sizeof(uint64_t)) {
+        // the last 8 bytes of the range, b is one of them
+        w = bitp_load_be_64(p + n_bytes - sizeof(uint64_t)) << ((b + sizeof(uint64_t) - n_bytes) * CHAR_BIT + phase);
+    }
+    else {
+        w = 0;
+        for (size_t j = b; j < n_bytes; ++j) {
+            w |= (uint64_t)(uint8_t)p[j] << (56 - (j - b) * CHAR_BIT);
+        }
+        w <<= phase;
+    }
+    return rest < 64 * (i + 1) ? w & (0xFFFFFFFFFFFFFFFFULL << (64 * (i + 1) - rest)) : w;
+}
+
+inline uint64_t bitp_hash_rotl_(uint64_t x, unsigned n) {
+    return (x << n) | (x >> (64 - n));
+}
+
+inline void bitp_hash_stripes_scalar_(uint64_t acc[4], const char *p, unsigned phase, size_t n_stripes) {
+    uint64_t w[4];
+    for (size_t s = 0; s < n_stripes; ++s) {
+        bitp_hash_load_(p + s * 32, phase, w);
+        bitp_hash_stripe_(acc, w);
+        if (s % BITP_HASH_BLOCK_ == BITP_HASH_BLOCK_ - 1) {
+            bitp_hash_scramble_(acc);
+        }
+    }
+}
+
+#if BITP_X86_64
+BITP_TARGET("avx2")
+inline void bitp_hash_stripes_avx2_(uint64_t acc[4], const char *p, unsigned phase, size_t n_stripes) {
+    const __m256i rev_bytes = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                               7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    const __m256i keys = _mm256_setr_epi64x((long long)BITP_HASH_KEY0_, (long long)BITP_HASH_KEY1_,
+                                            (long long)BITP_HASH_KEY2_, (long long)BITP_HASH_KEY3_);
+    const __m256i keys_rev = _mm256_permute4x64_epi64(keys, 0x1B);
+    const __m256i prime = _mm256_set1_epi64x((long long)BITP_HASH_PRIME32_);
+    const __m128i up = _mm_cvtsi32_si128((int)phase);
+    const __m128i down = _mm_cvtsi32_si128((int)(CHAR_BIT - phase));
+    __m256i a = _mm256_loadu_si256((const __m256i *)acc);
+
+    for (size_t s = 0; s < n_stripes; ++s) {
+        __m256i w = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(p + s * 32)), rev_bytes);
+        if (phase) {
+            __m256i next = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(p + s * 32 + 1)), rev_bytes);
+            w = _mm256_or_si256(_mm256_sll_epi64(w, up), _mm256_srl_epi64(next, down));
+        }
+        __m256i k = _mm256_xor_si256(w, keys);
+        __m256i prod = _mm256_mul_epu32(k, _mm256_srli_epi64(k, 32));
+        // the other word of the same 128-bit half, w[i ^ 1]
+        a = _mm256_add_epi64(a, _mm256_add_epi64(prod, _mm256_shuffle_epi32(w, 0x4E)));
+        if (s % BITP_HASH_BLOCK_ == BITP_HASH_BLOCK_ - 1) {
+            __m256i x = _mm256_xor_si256(_mm256_xor_si256(a, _mm256_srli_epi64(a, 47)), keys_rev);
+            // 64 x 32-bit product from two 32 x 32
+            __m256i lo = _mm256_mul_epu32(x, prime);
+            __m256i hi = _mm256_slli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(x, 32), prime), 32);
+            a = _mm256_add_epi64(lo, hi);
+        }
+    }
+    _mm256_storeu_si256((__m256i *)acc, a);
+}
+#endif
+
+inline uint64_t bitp_hash_bits_isa(const char *buf, size_t bit_off, size_t n_bits, bitp_isa_t isa) {
+    uint64_t acc[4] = {BITP_HASH_PRIME32_, BITP_HASH_PRIME64_1_, BITP_HASH_PRIME64_2_, 0};
+    const char *p = buf + bit_off / CHAR_BIT;
+    unsigned phase = bit_off % CHAR_BIT;
+
+    size_t n_stripes = n_bits / 256;
+#if BITP_X86_64
+    if (isa >= BITP_ISA_AVX2) {
+        bitp_hash_stripes_avx2_(acc, p, phase, n_stripes);
+    } else {
+        bitp_hash_stripes_scalar_(acc, p, phase, n_stripes);
+    }
+#else
+    (void)isa;
+    bitp_hash_stripes_scalar_(acc, p, phase, n_stripes);
+#endif
+
+    // the rest as a last stripe padded with zeros, the length tells them from real zeros
+    size_t rest = n_bits % 256;
+    if (rest) {
+        uint64_t w[4] = {bitp_hash_tail_word_(p, n_bits, phase, rest, 0), bitp_hash_tail_word_(p, n_bits, phase, rest, 1),
+                         bitp_hash_tail_word_(p, n_bits, phase, rest, 2), bitp_hash_tail_word_(p, n_bits, phase, rest, 3)};
+        bitp_hash_stripe_(acc, w);
+    }
+
+    // the lanes mixed side by side, rotated so that swapping two of them changes the hash
+    uint64_t h = (uint64_t)n_bits * BITP_HASH_PRIME64_1_;
+    h ^= bitp_hash_fmix_(acc[0] + BITP_HASH_KEY0_);
+    h ^= bitp_hash_rotl_(bitp_hash_fmix_(acc[1] + BITP_HASH_KEY1_), 16);
+    h ^= bitp_hash_rotl_(bitp_hash_fmix_(acc[2] + BITP_HASH_KEY2_), 32);
+    h ^= bitp_hash_rotl_(bitp_hash_fmix_(acc[3] + BITP_HASH_KEY3_), 48);
+    return bitp_hash_fmix_(h);
+}
+
+inline uint64_t bitp_hash_bits(const char *buf, size_t bit_off, size_t n_bits) {
+    return bitp_hash_bits_isa(buf, bit_off, n_bits, BITP_ISA_NATIVE);
+}
+
+inline bitp_status_t bitp_parser_hash(const bitp_parser_t *inst, size_t n_bits, uint64_t *res) {
+    if (inst->iter > inst->capacity || inst->capacity - inst->iter < n_bits) {
+        return BITP_EFULL;
+    }
+    *res = bitp_hash_bits(inst->buf, inst->iter, n_bits);
+    return BITP_OK;
+}
+
+#endif /* INCLUDE_BITP_HASH_H_ */
@@ -0,0 +1,73 @@
+/*
+ * ingest.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#ifndef INCLUDE_BITP_INGEST_H_
+#define INCLUDE_BITP_INGEST_H_
+
+#include "parser.h"
+
+/*
+ * Reading a file in blocks for the parser, Linux only, compiled bitp_ingest library. Blocks are
+ * read into a pool of buffers with several reads in flight (io_uring with registered buffers
+ * when the kernel allows it, pread otherwise) and handed out in file order without copying.
+ * A block goes back to the pool and is reused for the next read when it's released.
+ */
+
+/* bytes past the data of a block the parser may read */
+#define BITP_INGEST_PADDING 64
+
+typedef enum bitp_ingest_backend_tag {
+    // io_uring if the kernel allows it, pread otherwise
+    BITP_INGEST_AUTO = 0,
+    BITP_INGEST_URING,
+    BITP_INGEST_READ,
+} bitp_ingest_backend_t;
+
+typedef struct bitp_ingest_config_tag {
+    // bytes per read, a multiple of 4096 for files opened with O_DIRECT; 0 for 1 MiB
+    size_t block_size;
+    // buffers in the pool: reads in flight plus blocks held by the caller; 0 for 8
+    unsigned n_blocks;
+    bitp_ingest_backend_t backend;
+} bitp_ingest_config_t;
+
+typedef struct bitp_ingest_block_tag {
+    // over the data of the block
+    bitp_parser_t parser;
+    // file offset of the first byte
+    uint64_t offset;
+    unsigned slot_;
+} bitp_ingest_block_t;
+
+typedef struct bitp_ingest_tag bitp_ingest_t;
+
+/*
+ * Starts reading the regular file fd from offset 0 to its current size, fd stays owned by the
+ * caller. config may be NULL for the defaults. BITP_EINVALID_ARG if fd isn't a regular file, the
+ * config is out of range, the pool can't be allocated or BITP_INGEST_URING is unavailable.
+ */
+bitp_status_t bitp_ingest_open(bitp_ingest_t **res, int fd, const bitp_ingest_config_t *config);
+
+/* BITP_INGEST_URING or BITP_INGEST_READ */
+bitp_ingest_backend_t bitp_ingest_backend(const bitp_ingest_t *inst);
+
+/*
+ * Waits for the next block in file order. BITP_EFULL at the end of the file, BITP_EINVALID_ARG on
+ * a read error (bitp_ingest_error tells the errno) or if every buffer is held by the caller.
+ */
+bitp_status_t bitp_ingest_next(bitp_ingest_t *inst, bitp_ingest_block_t *block);
+
+/* returns the buffer of the block to the pool, blocks may be released in any order */
+void bitp_ingest_release(bitp_ingest_t *inst, const bitp_ingest_block_t *block);
+
+/* errno of the failed read or setup, 0 if none */
+int bitp_ingest_error(const bitp_ingest_t *inst);
+
+/* cancels the reads in flight and frees the pool, blocks still held become invalid */
+void bitp_ingest_close(bitp_ingest_t *inst);
+
+#endif /* INCLUDE_BITP_INGEST_H_ */
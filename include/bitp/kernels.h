@@ -0,0 +1,43 @@
+/*
+ * kernels.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#ifndef INCLUDE_BITP_KERNELS_H_
+#define INCLUDE_BITP_KERNELS_H_
+
+#include "fields.h"
+#include "search.h"
+
+/*
+ * Bulk routines of the compiled bitp_kernels library. Every instruction set tier is built
+ * into the library, the best one supported by the CPU is chosen once at startup.
+ */
+
+/* the tier in use */
+bitp_isa_t bitp_kernels_isa(void);
+
+/* selects a tier for testing and benchmarking, BITP_EINVALID_ARG if the CPU doesn't support it */
+bitp_status_t bitp_kernels_force(bitp_isa_t isa);
+
+bitp_status_t bitp_kernels_parser_find(bitp_parser_t *inst, const bitp_pattern_t *pattern);
+
+size_t bitp_kernels_parser_find_all(const bitp_parser_t *inst,
+                                    const bitp_pattern_t *pattern,
+                                    bitp_parser_t *matches,
+                                    size_t max_matches);
+
+/* n_groups consecutive groups, res holds BITP_FIELDS_ARRAY_SIZE lanes of fields->lane_bits per group */
+bitp_status_t bitp_kernels_extract_fields(bitp_parser_t *inst,
+                                          const bitp_fields_t *fields,
+                                          void *res,
+                                          size_t n_groups);
+
+bitp_status_t bitp_kernels_add_fields(bitp_packer_t *inst,
+                                      const bitp_fields_t *fields,
+                                      const void *vals,
+                                      size_t n_groups);
+
+#endif /* INCLUDE_BITP_KERNELS_H_ */
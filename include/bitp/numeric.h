@@ -0,0 +1,450 @@
+/*
+ * numeric.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#ifndef INCLUDE_BITP_NUMERIC_H_
+#define INCLUDE_BITP_NUMERIC_H_
+
+#include "codec.h"
+
+/*
+ * Fields that hold a real number: IEEE 754 half floats, bfloat16 and scaled integers, which
+ * cover Q-format fixed point (scale 2^-frac_bits) and values like RSRP in 1 dB steps with an
+ * offset. They are read into and written from float, one at a time or as arrays of consecutive
+ * fields, converted with AVX2 and F16C on x86-64.
+ */
+
+typedef enum bitp_numeric_kind_tag {
+    BITP_NUMERIC_F16 = 0,
+    BITP_NUMERIC_BF16,
+    // raw * scale + offset
+    BITP_NUMERIC_SCALED,
+} bitp_numeric_kind_t;
+
+typedef struct bitp_numeric_tag {
+    bitp_numeric_kind_t kind;
+    unsigned n_bits;
+    int is_signed;
+    float scale;
+    float offset;
+    // 1 / scale, and the raw range as floats and integers
+    float inv_scale;
+    float min_f;
+    float max_f;
+    int64_t min;
+    int64_t max;
+} bitp_numeric_t;
+
+void bitp_numeric_init_f16(bitp_numeric_t *inst);
+
+void bitp_numeric_init_bf16(bitp_numeric_t *inst);
+
+/* BITP_EINVALID_ARG if n_bits isn't 1..32 or scale is 0 */
+bitp_status_t bitp_numeric_init_scaled(bitp_numeric_t *inst, unsigned n_bits, int is_signed, float scale, float offset);
+
+/* Q-format fixed point, frac_bits of n_bits are the fraction */
+bitp_status_t bitp_numeric_init_q(bitp_numeric_t *inst, unsigned n_bits, int is_signed, unsigned frac_bits);
+
+/*
+ * A value is written rounded to the nearest representable one, ties to even; scaled values
+ * outside the raw range saturate and NaN is written as raw 0.
+ */
+bitp_status_t bitp_parser_extract_numeric(bitp_parser_t *inst, const bitp_numeric_t *num, float *res);
+
+bitp_status_t bitp_packer_add_numeric(bitp_packer_t *inst, const bitp_numeric_t *num, float val);
+
+/* n consecutive fields, BITP_EFULL if they don't all fit (nothing is read or written then) */
+bitp_status_t bitp_parser_extract_numeric_array(bitp_parser_t *inst, const bitp_numeric_t *num, float *res, size_t n);
+
+bitp_status_t bitp_packer_add_numeric_array(bitp_packer_t *inst, const bitp_numeric_t *num, const float *vals, size_t n);
+
+/* the same with an instruction set tier no higher than the CPU supports, for tests and benchmarks */
+bitp_status_t bitp_parser_extract_numeric_array_isa(bitp_parser_t *inst,
+                                                    const bitp_numeric_t *num,
+                                                    float *res,
+                                                    size_t n,
+                                                    bitp_isa_t isa);
+
+bitp_status_t bitp_packer_add_numeric_array_isa(bitp_packer_t *inst,
+                                                const bitp_numeric_t *num,
+                                                const float *vals,
+                                                size_t n,
+                                                bitp_isa_t isa);
+
+/* half and bfloat16 fields of 16 bits */
+bitp_status_t bitp_parser_extract_f16(bitp_parser_t *inst, float *res);
+
+bitp_status_t bitp_parser_extract_bf16(bitp_parser_t *inst, float *res);
+
+bitp_status_t bitp_packer_add_f16(bitp_packer_t *inst, float val);
+
+bitp_status_t bitp_packer_add_bf16(bitp_packer_t *inst, float val);
+
+/*
+ **************************************************************************************************
+  Realization
+ **************************************************************************************************
+ */
+
+/* values converted per step of the array routines */
+#define BITP_NUMERIC_CHUNK_ 64
+
+inline void bitp_numeric_init_f16(bitp_numeric_t *inst) {
+    memset(inst, 0, sizeof(*inst));
+    inst->kind = BITP_NUMERIC_F16;
+    inst->n_bits = 16;
+}
+
+inline void bitp_numeric_init_bf16(bitp_numeric_t *inst) {
+    memset(inst, 0, sizeof(*inst));
+    inst->kind = BITP_NUMERIC_BF16;
+    inst->n_bits = 16;
+}
+
+inline bitp_status_t bitp_numeric_init_scaled(bitp_numeric_t *inst, unsigned n_bits, int is_signed, float scale, float offset) {
+    if (n_bits == 0 || n_bits > 32 || scale == 0.0f) {
+        return BITP_EINVALID_ARG;
+    }
+    inst->kind = BITP_NUMERIC_SCALED;
+    inst->n_bits = n_bits;
+    inst->is_signed = is_signed;
+    inst->scale = scale;
+    inst->offset = offset;
+    inst->inv_scale = 1.0f / scale;
+    inst->min = is_signed ? -((int64_t)1 << (n_bits - 1)) : 0;
+    inst->max = is_signed ? ((int64_t)1 << (n_bits - 1)) - 1 : ((int64_t)1 << n_bits) - 1;
+    inst->min_f = (float)inst->min;
+    inst->max_f = (float)inst->max;
+    return BITP_OK;
+}
+
+inline bitp_status_t bitp_numeric_init_q(bitp_numeric_t *inst, unsigned n_bits, int is_signed, unsigned frac_bits) {
+    if (frac_bits > n_bits) {
+        return BITP_EINVALID_ARG;
+    }
+    return bitp_numeric_init_scaled(inst, n_bits, is_signed, 1.0f / (float)((uint64_t)1 << frac_bits), 0.0f);
+}
+
+inline float bitp_numeric_f16_to_float_(uint32_t h) {
+    uint32_t sign = (h & 0x8000) << 16;
+    uint32_t exp = (h >> 10) & 0x1F;
+    uint32_t mant = h & 0x3FF;
+    uint32_t bits;
+    float res;
+
+    if (exp == 0) {
+        // subnormal, mant * 2^-24 is exact
+        res = (float)mant * 5.9604644775390625e-8f;
+        return sign ? -res : res;
+    }
+    if (exp == 0x1F) {
+        bits = sign | 0x7F800000 | (mant << 13);
+    }
+    else {
+        bits = sign | ((exp + 127 - 15) << 23) | (mant << 13);
+    }
+    memcpy(&res, &bits, sizeof(res));
+    return res;
+}
+
+/* round to nearest even like VCVTPS2PH; NaN stays a quiet NaN with the top of its payload */
+inline uint32_t bitp_numeric_float_to_f16_(float val) {
+    uint32_t bits;
+    memcpy(&bits, &val, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000;
+    bits &= 0x7FFFFFFF;
+
+    if (bits > 0x7F800000) {
+        return sign | 0x7E00 | ((bits >> 13) & 0x3FF);
+    }
+    if (bits >= 0x47800000) {
+        return sign | 0x7C00;
+    }
+    if (bits < 0x38800000) {
+        // below the smallest normal half: adding 0.5 rounds the mantissa at 2^-24 in the FPU
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        f += 0.5f;
+        memcpy(&bits, &f, sizeof(bits));
+        return sign | (bits - 0x3F000000);
+    }
+    // rebias the exponent and round, a carry out of the mantissa bumps the exponent
+    bits += 0xC8000FFF + ((bits >> 13) & 1);
+    return sign | (bits >> 13);
+}
+
+inline float bitp_numeric_bf16_to_float_(uint32_t h) {
+    uint32_t bits = h << 16;
+    float res;
+    memcpy(&res, &bits, sizeof(res));
+    return res;
+}
+
+inline uint32_t bitp_numeric_float_to_bf16_(float val) {
+    uint32_t bits;
+    memcpy(&bits, &val, sizeof(bits));
+    if ((bits & 0x7FFFFFFF) > 0x7F800000) {
+        return (bits >> 16) | 0x40;
+    }
+    return (bits + 0x7FFF + ((bits >> 16) & 1)) >> 16;
+}
+
+inline float bitp_numeric_to_float_(const bitp_numeric_t *num, uint32_t raw) {
+    switch (num->kind) {
+    case BITP_NUMERIC_F16:
+        return bitp_numeric_f16_to_float_(raw);
+    case BITP_NUMERIC_BF16:
+        return bitp_numeric_bf16_to_float_(raw);
+    default:
+        break;
+    }
+    float v;
+    if (num->is_signed) {
+        v = (float)((int64_t)((uint64_t)raw << (64 - num->n_bits)) >> (64 - num->n_bits));
+    }
+    else {
+        v = (float)raw;
+    }
+    return v * num->scale + num->offset;
+}
+
+inline uint32_t bitp_numeric_from_float_(const bitp_numeric_t *num, float val) {
+    switch (num->kind) {
+    case BITP_NUMERIC_F16:
+        return bitp_numeric_float_to_f16_(val);
+    case BITP_NUMERIC_BF16:
+        return bitp_numeric_float_to_bf16_(val);
+    default:
+        break;
+    }
+    float f = (val - num->offset) * num->inv_scale;
+    if (f != f) {
+        f = 0.0f;
+    }
+    f = f < num->min_f ? num->min_f : f;
+    f = f > num->max_f ? num->max_f : f;
+
+    // f is in 32-bit range, so are its integer part and the rounding
+    int64_t r = (int64_t)f;
+    float frac = f - (float)r;
+    if (frac > 0.5f || (frac == 0.5f && (r & 1))) {
+        r++;
+    }
+    else if (frac < -0.5f || (frac == -0.5f && (r & 1))) {
+        r--;
+    }
+    // max_f may be rounded up past max
+    r = r > num->max ? num->max : r;
+    return (uint32_t)((uint64_t)r & (0xFFFFFFFFu >> (32 - num->n_bits)));
+}
+
+inline bitp_status_t bitp_parser_extract_numeric(bitp_parser_t *inst, const bitp_numeric_t *num, float *res) {
+    uint32_t raw = 0;
+    bitp_status_t status = bitp_parser_extract_u32(inst, &raw, num->n_bits);
+
+    if (status == BITP_OK) {
+        *res = bitp_numeric_to_float_(num, raw);
+    }
+    return status;
+}
+
+inline bitp_status_t bitp_packer_add_numeric(bitp_packer_t *inst, const bitp_numeric_t *num, float val) {
+    return bitp_packer_add_u32(inst, bitp_numeric_from_float_(num, val), num->n_bits);
+}
+
+#if BITP_X86_64
+/*
+ * 8 raw values to floats. The tier is AVX2 and every AVX2 CPU has F16C, scaled values fit int32
+ * because the array routines take this path up to 30 bits only.
+ */
+BITP_TARGET("avx2,f16c")
+inline void bitp_numeric_to_float_avx2_(const bitp_numeric_t *num, const uint32_t *raw, float *res, size_t n) {
+    __m256 scale = _mm256_set1_ps(num->scale);
+    __m256 offset = _mm256_set1_ps(num->offset);
+    __m128i sign_shift = _mm_cvtsi32_si128((int)(32 - num->n_bits));
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(raw + i));
+        __m256 f;
+        if (num->kind == BITP_NUMERIC_F16) {
+            f = _mm256_cvtph_ps(_mm_packus_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)));
+        }
+        else if (num->kind == BITP_NUMERIC_BF16) {
+            f = _mm256_castsi256_ps(_mm256_slli_epi32(v, 16));
+        }
+        else {
+            if (num->is_signed) {
+                v = _mm256_sra_epi32(_mm256_sll_epi32(v, sign_shift), sign_shift);
+            }
+            f = _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(v), scale), offset);
+        }
+        _mm256_storeu_ps(res + i, f);
+    }
+    for (; i < n; ++i) {
+        res[i] = bitp_numeric_to_float_(num, raw[i]);
+    }
+}
+
+BITP_TARGET("avx2,f16c")
+inline void bitp_numeric_from_float_avx2_(const bitp_numeric_t *num, const float *vals, uint32_t *raw, size_t n) {
+    __m256 inv_scale = _mm256_set1_ps(num->inv_scale);
+    __m256 offset = _mm256_set1_ps(num->offset);
+    __m256 min_f = _mm256_set1_ps(num->min_f);
+    __m256 max_f = _mm256_set1_ps(num->max_f);
+    __m256i max = _mm256_set1_epi32((int32_t)num->max);
+    __m256i mask = _mm256_set1_epi32((int)(0xFFFFFFFFu >> (32 - num->n_bits)));
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        __m256 f = _mm256_loadu_ps(vals + i);
+        __m256i v;
+        if (num->kind == BITP_NUMERIC_F16) {
+            v = _mm256_cvtepu16_epi32(_mm256_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT));
+        }
+        else if (num->kind == BITP_NUMERIC_BF16) {
+            __m256i bits = _mm256_castps_si256(f);
+            __m256i odd = _mm256_and_si256(_mm256_srli_epi32(bits, 16), _mm256_set1_epi32(1));
+            __m256i rounded = _mm256_srli_epi32(_mm256_add_epi32(_mm256_add_epi32(bits, _mm256_set1_epi32(0x7FFF)), odd), 16);
+            __m256i quiet = _mm256_or_si256(_mm256_srli_epi32(bits, 16), _mm256_set1_epi32(0x40));
+            v = _mm256_blendv_epi8(rounded, quiet, _mm256_castps_si256(_mm256_cmp_ps(f, f, _CMP_UNORD_Q)));
+        }
+        else {
+            f = _mm256_mul_ps(_mm256_sub_ps(f, offset), inv_scale);
+            f = _mm256_and_ps(f, _mm256_cmp_ps(f, f, _CMP_ORD_Q));
+            f = _mm256_min_ps(_mm256_max_ps(f, min_f), max_f);
+            // the default rounding mode is to nearest even
+            v = _mm256_min_epi32(_mm256_cvtps_epi32(f), max);
+            v = _mm256_and_si256(v, mask);
+        }
+        _mm256_storeu_si256((__m256i *)(raw + i), v);
+    }
+    for (; i < n; ++i) {
+        raw[i] = bitp_numeric_from_float_(num, vals[i]);
+    }
+}
+#endif
+
+inline bitp_status_t bitp_parser_extract_numeric_array_isa(bitp_parser_t *inst,
+                                                           const bitp_numeric_t *num,
+                                                           float *res,
+                                                           size_t n,
+                                                           bitp_isa_t isa) {
+    unsigned n_bits = num->n_bits;
+    uint32_t raw[BITP_NUMERIC_CHUNK_];
+    (void)isa;
+
+    if (inst->iter > inst->capacity || (inst->capacity - inst->iter) / n_bits < n) {
+        return BITP_EFULL;
+    }
+    const char *p = inst->buf + inst->iter / CHAR_BIT;
+    size_t n_bytes = (inst->capacity + CHAR_BIT - 1) / CHAR_BIT - inst->iter / CHAR_BIT;
+    size_t bit = inst->iter % CHAR_BIT;
+
+    for (size_t off = 0; off < n; off += BITP_NUMERIC_CHUNK_) {
+        size_t count = n - off < BITP_NUMERIC_CHUNK_ ? n - off : BITP_NUMERIC_CHUNK_;
+        size_t done = 0;
+#if BITP_X86_64
+        if (isa >= BITP_ISA_AVX2 && n_bits <= 30) {
+            done = bitp_codec_unpack_avx2_(p + bit / CHAR_BIT, n_bytes - bit / CHAR_BIT, raw, count, n_bits,
+                                           bit % CHAR_BIT);
+        }
+#endif
+        size_t rest = bit + done * n_bits;
+        bitp_codec_unpack_scalar_(p + rest / CHAR_BIT, n_bytes - rest / CHAR_BIT, raw + done, count - done, n_bits,
+                                  rest % CHAR_BIT);
+        bit += count * n_bits;
+
+#if BITP_X86_64
+        if (isa >= BITP_ISA_AVX2 && n_bits <= 30) {
+            bitp_numeric_to_float_avx2_(num, raw, res + off, count);
+            continue;
+        }
+#endif
+        for (size_t i = 0; i < count; ++i) {
+            res[off + i] = bitp_numeric_to_float_(num, raw[i]);
+        }
+    }
+
+    inst->iter += n * n_bits;
+    return BITP_OK;
+}
+
+inline bitp_status_t bitp_packer_add_numeric_array_isa(bitp_packer_t *inst,
+                                                       const bitp_numeric_t *num,
+                                                       const float *vals,
+                                                       size_t n,
+                                                       bitp_isa_t isa) {
+    unsigned n_bits = num->n_bits;
+    uint32_t raw[BITP_NUMERIC_CHUNK_];
+    (void)isa;
+
+    if (inst->iter > inst->capacity || (inst->capacity - inst->iter) / n_bits < n) {
+        return BITP_EFULL;
+    }
+    // the writer starts with the bits already in the first byte, the rest of the field is zero
+    bitp_codec_acc_t_ w;
+    w.p = inst->buf + inst->iter / CHAR_BIT;
+    w.n_acc = inst->iter % CHAR_BIT;
+    w.acc = w.n_acc ? (uint64_t)(uint8_t)*w.p << 56 : 0;
+
+    for (size_t off = 0; off < n; off += BITP_NUMERIC_CHUNK_) {
+        size_t count = n - off < BITP_NUMERIC_CHUNK_ ? n - off : BITP_NUMERIC_CHUNK_;
+#if BITP_X86_64
+        if (isa >= BITP_ISA_AVX2 && n_bits <= 30) {
+            bitp_numeric_from_float_avx2_(num, vals + off, raw, count);
+        }
+        else
+#endif
+        {
+            for (size_t i = 0; i < count; ++i) {
+                raw[i] = bitp_numeric_from_float_(num, vals[off + i]);
+            }
+        }
+        bitp_codec_put_(&w, raw, count, n_bits);
+    }
+    bitp_codec_flush_(&w);
+    inst->iter += n * n_bits;
+    return BITP_OK;
+}
+
+inline bitp_status_t bitp_parser_extract_numeric_array(bitp_parser_t *inst, const bitp_numeric_t *num, float *res, size_t n) {
+    return bitp_parser_extract_numeric_array_isa(inst, num, res, n, BITP_ISA_NATIVE);
+}
+
+inline bitp_status_t bitp_packer_add_numeric_array(bitp_packer_t *inst, const bitp_numeric_t *num, const float *vals, size_t n) {
+    return bitp_packer_add_numeric_array_isa(inst, num, vals, n, BITP_ISA_NATIVE);
+}
+
+inline bitp_status_t bitp_parser_extract_f16(bitp_parser_t *inst, float *res) {
+    uint32_t raw = 0;
+    bitp_status_t status = bitp_parser_extract_u32(inst, &raw, 16);
+
+    if (status == BITP_OK) {
+        *res = bitp_numeric_f16_to_float_(raw);
+    }
+    return status;
+}
+
+inline bitp_status_t bitp_parser_extract_bf16(bitp_parser_t *inst, float *res) {
+    uint32_t raw = 0;
+    bitp_status_t status = bitp_parser_extract_u32(inst, &raw, 16);
+
+    if (status == BITP_OK) {
+        *res = bitp_numeric_bf16_to_float_(raw);
+    }
+    return status;
+}
+
+inline bitp_status_t bitp_packer_add_f16(bitp_packer_t *inst, float val) {
+    return bitp_packer_add_u32(inst, bitp_numeric_float_to_f16_(val), 16);
+}
+
+inline bitp_status_t bitp_packer_add_bf16(bitp_packer_t *inst, float val) {
+    return bitp_packer_add_u32(inst, bitp_numeric_float_to_bf16_(val), 16);
+}
+
+#endif /* INCLUDE_BITP_NUMERIC_H_ */
@@ -38,6 +38,37 @@ bitp_status_t bitp_packer_add_float(bitp_packer_t *inst, float val);
 
 bitp_status_t bitp_packer_add_double(bitp_packer_t *inst, double val);
 
+/* overwrites n_bits at bit_off (clears and sets them), iter isn't changed */
+bitp_status_t bitp_packer_set_u64(bitp_packer_t *inst, size_t bit_off, uint64_t val, size_t n_bits);
+
+/* capacity is checked once by bitp_packer_reserve, the reserved bits are written without checks */
+typedef struct bitp_packer_reserved_tag {
+    bitp_packer_t *packer;
+    size_t end;
+} bitp_packer_reserved_t;
+
+bitp_status_t bitp_packer_reserve(bitp_packer_t *inst, size_t n_bits, bitp_packer_reserved_t *res);
+
+void bitp_packer_reserved_add_u8(bitp_packer_reserved_t *inst, uint8_t val, size_t n_bits);
+
+void bitp_packer_reserved_add_u16(bitp_packer_reserved_t *inst, uint16_t val, size_t n_bits);
+
+void bitp_packer_reserved_add_u32(bitp_packer_reserved_t *inst, uint32_t val, size_t n_bits);
+
+void bitp_packer_reserved_add_u64(bitp_packer_reserved_t *inst, uint64_t val, size_t n_bits);
+
+void bitp_packer_reserved_add_i8(bitp_packer_reserved_t *inst, int8_t val, size_t n_bits);
+
+void bitp_packer_reserved_add_i16(bitp_packer_reserved_t *inst, int16_t val, size_t n_bits);
+
+void bitp_packer_reserved_add_i32(bitp_packer_reserved_t *inst, int32_t val, size_t n_bits);
+
+void bitp_packer_reserved_add_i64(bitp_packer_reserved_t *inst, int64_t val, size_t n_bits);
+
+void bitp_packer_reserved_add_float(bitp_packer_reserved_t *inst, float val);
+
+void bitp_packer_reserved_add_double(bitp_packer_reserved_t *inst, double val);
+
 /*
  **************************************************************************************************
   Realization
@@ -195,4 +226,106 @@ inline bitp_status_t bitp_packer_add_double(bitp_packer_t *inst, double val) {
     return BITP_OK;
 }
 
+inline bitp_status_t bitp_packer_set_u64(bitp_packer_t *inst, size_t bit_off, uint64_t val, size_t n_bits) {
+#if BITP_CHECK_BUFFER_BOUNDARY
+    if (bit_off > inst->capacity || inst->capacity - bit_off < n_bits) {
+        return BITP_EFULL;
+    }
+#endif
+    if (n_bits == 0) {
+        return BITP_OK;
+    }
+    BITP_CHECK_PARAM_SIZE(inst, n_bits, uint64_t);
+    BITP_CHECK_PARAM_RANGE(val, n_bits, 0);
+
+    bitp_write_bits_64(inst->buf, inst->capacity, bit_off, val << (64 - n_bits), (unsigned)n_bits);
+
+    return BITP_OK;
+}
+
+inline bitp_status_t bitp_packer_reserve(bitp_packer_t *inst, size_t n_bits, bitp_packer_reserved_t *res) {
+    if (inst->iter > inst->capacity || inst->capacity - inst->iter < n_bits) {
+        return BITP_EFULL;
+    }
+
+    res->packer = inst;
+    res->end = inst->iter + n_bits;
+
+    return BITP_OK;
+}
+
+inline void bitp_packer_reserved_add_u8(bitp_packer_reserved_t *inst, uint8_t val, size_t n_bits) {
+    BITP_ASSERT_RESERVED(inst->end, inst->packer->iter, n_bits, uint8_t);
+    assert(bitp_in_range_(val, n_bits, 0));
+    bitp_packer_add_u8_no_check(inst->packer, val, n_bits);
+}
+
+inline void bitp_packer_reserved_add_i8(bitp_packer_reserved_t *inst, int8_t val, size_t n_bits) {
+    BITP_ASSERT_RESERVED(inst->end, inst->packer->iter, n_bits, int8_t);
+    assert(bitp_in_range_((uint64_t)(int64_t)val, n_bits, 1));
+    bitp_packer_add_u8_no_check(inst->packer, (uint8_t)(val & ((1 << n_bits) - 1)), n_bits);
+}
+
+inline void bitp_packer_reserved_add_u16(bitp_packer_reserved_t *inst, uint16_t val, size_t n_bits) {
+    BITP_ASSERT_RESERVED(inst->end, inst->packer->iter, n_bits, uint16_t);
+    assert(bitp_in_range_(val, n_bits, 0));
+    BITP_PACK_WORD(inst->packer, val, n_bits);
+}
+
+inline void bitp_packer_reserved_add_u32(bitp_packer_reserved_t *inst, uint32_t val, size_t n_bits) {
+    BITP_ASSERT_RESERVED(inst->end, inst->packer->iter, n_bits, uint32_t);
+    assert(bitp_in_range_(val, n_bits, 0));
+    BITP_PACK_WORD(inst->packer, val, n_bits);
+}
+
+inline void bitp_packer_reserved_add_u64(bitp_packer_reserved_t *inst, uint64_t val, size_t n_bits) {
+    BITP_ASSERT_RESERVED(inst->end, inst->packer->iter, n_bits, uint64_t);
+    assert(bitp_in_range_(val, n_bits, 0));
+    BITP_PACK_WORD(inst->packer, val, n_bits);
+}
+
+inline void bitp_packer_reserved_add_i16(bitp_packer_reserved_t *inst, int16_t val, size_t n_bits) {
+    BITP_ASSERT_RESERVED(inst->end, inst->packer->iter, n_bits, int16_t);
+    assert(bitp_in_range_((uint64_t)(int64_t)val, n_bits, 1));
+
+    uint16_t valu = (uint16_t)val;
+    valu &= (1 << n_bits) - 1;
+
+    BITP_PACK_WORD(inst->packer, valu, n_bits);
+}
+
+inline void bitp_packer_reserved_add_i32(bitp_packer_reserved_t *inst, int32_t val, size_t n_bits) {
+    BITP_ASSERT_RESERVED(inst->end, inst->packer->iter, n_bits, int32_t);
+    assert(bitp_in_range_((uint64_t)(int64_t)val, n_bits, 1));
+
+    uint32_t valu = (uint32_t)val;
+    valu &= (uint32_t)((1ULL << n_bits) - 1);
+
+    BITP_PACK_WORD(inst->packer, valu, n_bits);
+}
+
+inline void bitp_packer_reserved_add_i64(bitp_packer_reserved_t *inst, int64_t val, size_t n_bits) {
+    BITP_ASSERT_RESERVED(inst->end, inst->packer->iter, n_bits, int64_t);
+    assert(bitp_in_range_((uint64_t)(int64_t)val, n_bits, 1));
+
+    uint64_t valu = (uint64_t)val;
+    if (n_bits < 64) {
+        valu &= (1ULL << n_bits) - 1;
+    }
+
+    BITP_PACK_WORD(inst->packer, valu, n_bits);
+}
+
+inline void bitp_packer_reserved_add_float(bitp_packer_reserved_t *inst, float val) {
+    uint32_t valu;
+    memcpy(&valu, &val, 4);
+    bitp_packer_reserved_add_u32(inst, valu, CHAR_BIT * 4);
+}
+
+inline void bitp_packer_reserved_add_double(bitp_packer_reserved_t *inst, double val) {
+    uint64_t valu;
+    memcpy(&valu, &val, 8);
+    bitp_packer_reserved_add_u64(inst, valu, CHAR_BIT * 8);
+}
+
 #endif /* INCLUDE_BITP_PACKER_H_ */
@@ -40,6 +40,36 @@ bitp_status_t bitp_parser_extract_float(bitp_parser_t *inst, float *res);
 
 bitp_status_t bitp_parser_extract_double(bitp_parser_t *inst, double *res);
 
+/* capacity is checked once by bitp_parser_reserve, the reserved bits are read without checks */
+typedef struct bitp_parser_reserved_tag {
+    bitp_parser_t *parser;
+    size_t end;
+} bitp_parser_reserved_t;
+
+bitp_status_t bitp_parser_reserve(bitp_parser_t *inst, size_t n_bits, bitp_parser_reserved_t *res);
+
+void bitp_parser_reserved_skip(bitp_parser_reserved_t *inst, size_t n_bits);
+
+void bitp_parser_reserved_extract_u8(bitp_parser_reserved_t *inst, uint8_t *res, unsigned n_bits);
+
+void bitp_parser_reserved_extract_u16(bitp_parser_reserved_t *inst, uint16_t *res, unsigned n_bits);
+
+void bitp_parser_reserved_extract_u32(bitp_parser_reserved_t *inst, uint32_t *res, unsigned n_bits);
+
+void bitp_parser_reserved_extract_u64(bitp_parser_reserved_t *inst, uint64_t *res, unsigned n_bits);
+
+void bitp_parser_reserved_extract_i8(bitp_parser_reserved_t *inst, int8_t *res, unsigned n_bits);
+
+void bitp_parser_reserved_extract_i16(bitp_parser_reserved_t *inst, int16_t *res, unsigned n_bits);
+
+void bitp_parser_reserved_extract_i32(bitp_parser_reserved_t *inst, int32_t *res, unsigned n_bits);
+
+void bitp_parser_reserved_extract_i64(bitp_parser_reserved_t *inst, int64_t *res, unsigned n_bits);
+
+void bitp_parser_reserved_extract_float(bitp_parser_reserved_t *inst, float *res);
+
+void bitp_parser_reserved_extract_double(bitp_parser_reserved_t *inst, double *res);
+
 /*
  **************************************************************************************************
   Realization
@@ -185,4 +215,88 @@ inline bitp_status_t bitp_parser_extract_double(bitp_parser_t *inst, double *res
     return BITP_OK;
 }
 
+inline bitp_status_t bitp_parser_reserve(bitp_parser_t *inst, size_t n_bits, bitp_parser_reserved_t *res) {
+    if (inst->iter > inst->capacity || inst->capacity - inst->iter < n_bits) {
+        return BITP_EFULL;
+    }
+
+    res->parser = inst;
+    res->end = inst->iter + n_bits;
+
+    return BITP_OK;
+}
+
+inline void bitp_parser_reserved_skip(bitp_parser_reserved_t *inst, size_t n_bits) {
+    assert(inst->end - inst->parser->iter >= n_bits);
+    inst->parser->iter += n_bits;
+}
+
+inline void bitp_parser_reserved_extract_u8(bitp_parser_reserved_t *inst, uint8_t *res, unsigned n_bits) {
+    bitp_parser_t *parser = inst->parser;
+    BITP_ASSERT_RESERVED(inst->end, parser->iter, n_bits, uint8_t);
+    BITP_EXTRACT_UINT(parser, res, uint8_t, n_bits, bitp_ntoh_8);
+    parser->iter += n_bits;
+}
+
+inline void bitp_parser_reserved_extract_u16(bitp_parser_reserved_t *inst, uint16_t *res, unsigned n_bits) {
+    bitp_parser_t *parser = inst->parser;
+    BITP_ASSERT_RESERVED(inst->end, parser->iter, n_bits, uint16_t);
+    BITP_EXTRACT_UINT(parser, res, uint16_t, n_bits, bitp_ntoh_16);
+    parser->iter += n_bits;
+}
+
+inline void bitp_parser_reserved_extract_u32(bitp_parser_reserved_t *inst, uint32_t *res, unsigned n_bits) {
+    bitp_parser_t *parser = inst->parser;
+    BITP_ASSERT_RESERVED(inst->end, parser->iter, n_bits, uint32_t);
+    BITP_EXTRACT_UINT(parser, res, uint32_t, n_bits, bitp_ntoh_32);
+    parser->iter += n_bits;
+}
+
+inline void bitp_parser_reserved_extract_u64(bitp_parser_reserved_t *inst, uint64_t *res, unsigned n_bits) {
+    bitp_parser_t *parser = inst->parser;
+    BITP_ASSERT_RESERVED(inst->end, parser->iter, n_bits, uint64_t);
+    BITP_EXTRACT_UINT(parser, res, uint64_t, n_bits, bitp_ntoh_64);
+    parser->iter += n_bits;
+}
+
+inline void bitp_parser_reserved_extract_i8(bitp_parser_reserved_t *inst, int8_t *res, unsigned n_bits) {
+    bitp_parser_t *parser = inst->parser;
+    BITP_ASSERT_RESERVED(inst->end, parser->iter, n_bits, int8_t);
+    BITP_EXTRACT_INT(parser, res, int8_t, n_bits, bitp_ntoh_8);
+    parser->iter += n_bits;
+}
+
+inline void bitp_parser_reserved_extract_i16(bitp_parser_reserved_t *inst, int16_t *res, unsigned n_bits) {
+    bitp_parser_t *parser = inst->parser;
+    BITP_ASSERT_RESERVED(inst->end, parser->iter, n_bits, int16_t);
+    BITP_EXTRACT_INT(parser, res, int16_t, n_bits, bitp_ntoh_16);
+    parser->iter += n_bits;
+}
+
+inline void bitp_parser_reserved_extract_i32(bitp_parser_reserved_t *inst, int32_t *res, unsigned n_bits) {
+    bitp_parser_t *parser = inst->parser;
+    BITP_ASSERT_RESERVED(inst->end, parser->iter, n_bits, int32_t);
+    BITP_EXTRACT_INT(parser, res, int32_t, n_bits, bitp_ntoh_32);
+    parser->iter += n_bits;
+}
+
+inline void bitp_parser_reserved_extract_i64(bitp_parser_reserved_t *inst, int64_t *res, unsigned n_bits) {
+    bitp_parser_t *parser = inst->parser;
+    BITP_ASSERT_RESERVED(inst->end, parser->iter, n_bits, int64_t);
+    BITP_EXTRACT_INT(parser, res, int64_t, n_bits, bitp_ntoh_64);
+    parser->iter += n_bits;
+}
+
+inline void bitp_parser_reserved_extract_float(bitp_parser_reserved_t *inst, float *res) {
+    uint32_t tmp;
+    bitp_parser_reserved_extract_u32(inst, &tmp, CHAR_BIT * sizeof(float));
+    memcpy(res, &tmp, sizeof(tmp));
+}
+
+inline void bitp_parser_reserved_extract_double(bitp_parser_reserved_t *inst, double *res) {
+    uint64_t tmp;
+    bitp_parser_reserved_extract_u64(inst, &tmp, CHAR_BIT * sizeof(double));
+    memcpy(res, &tmp, sizeof(tmp));
+}
+
 #endif /* INCLUDE_BIT_PARSER_PARSER_H_ */
@@ -0,0 +1,464 @@
+/*
+ * plan.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#ifndef INCLUDE_BITP_PLAN_H_
+#define INCLUDE_BITP_PLAN_H_
+
+#include "cpu.h"
+#include "parser.h"
+
+/* fields of a layout, skipped ones included */
+#define BITP_PLAN_MAX 64
+
+/* room for the names of the output fields, with a terminating zero each */
+#define BITP_PLAN_TEXT_SIZE 1024
+
+/*
+ * Record layouts known only at run time, e.g. vendor trace formats from a config file. A layout
+ * is compiled once into a flat plan: the output fields are grouped into 64-bit windows loaded
+ * once per record, every field is two precomputed shifts and a sign fix out of its window, and
+ * a block of records is bounds checked once.
+ */
+
+typedef enum bitp_plan_kind_tag {
+    BITP_PLAN_UNSIGNED = 0,
+    // two's complement, sign extended to 64 bits
+    BITP_PLAN_SIGNED,
+    // consumed, doesn't produce an output
+    BITP_PLAN_SKIP,
+} bitp_plan_kind_t;
+
+typedef struct bitp_plan_field_tag {
+    const char *name;
+    // 1..64, any size for BITP_PLAN_SKIP
+    unsigned n_bits;
+    bitp_plan_kind_t kind;
+} bitp_plan_field_t;
+
+typedef struct bitp_plan_window_tag_ {
+    // first bit of the window within the record
+    uint32_t bit;
+    uint16_t first_op;
+    uint16_t n_ops;
+    // a single field of more than 57 bits, which needs the ninth byte whatever the phase
+    int wide;
+} bitp_plan_window_t_;
+
+typedef struct bitp_plan_op_tag_ {
+    // the field is ((window << lshift) >> rshift ^ sign) - sign
+    uint64_t sign;
+    uint8_t lshift;
+    uint8_t rshift;
+} bitp_plan_op_t_;
+
+typedef struct bitp_plan_tag {
+    bitp_plan_window_t_ windows[BITP_PLAN_MAX];
+    bitp_plan_op_t_ ops[BITP_PLAN_MAX];
+    unsigned n_windows;
+    // outputs per record
+    unsigned n_out;
+    size_t record_bits;
+    uint16_t name_offs[BITP_PLAN_MAX];
+    char text[BITP_PLAN_TEXT_SIZE];
+} bitp_plan_t;
+
+/* BITP_EINVALID_ARG if a field is 0 or over 64 bits, there are too many or the names don't fit */
+bitp_status_t bitp_plan_compile(bitp_plan_t *inst, const bitp_plan_field_t *fields, unsigned n_fields);
+
+/*
+ * Compiles a layout from text, one field per line as a name and a type: uN unsigned, iN signed,
+ * xN skipped, N bits. '#' starts a comment, blank lines are ignored:
+ *
+ *     sfn       u10
+ *     spare     x2
+ *     rsrp_dbm  i8
+ *
+ * BITP_EINVALID_ARG on a syntax error or an invalid field, error_line (if not NULL) gets its
+ * line number, counted from 1, and 0 on success.
+ */
+bitp_status_t bitp_plan_load(bitp_plan_t *inst, const char *text, size_t len, size_t *error_line);
+
+/* output index of a field, -1 if there isn't one */
+int bitp_plan_find(const bitp_plan_t *inst, const char *name);
+
+/*
+ * Decodes n_records back to back at the parser position into res, n_out values per record in
+ * layout order, and moves the parser past them. BITP_EFULL if they aren't all there, nothing is
+ * decoded then. Like the parser, whole words are read: up to 8 bytes past the last record must
+ * be readable.
+ */
+bitp_status_t bitp_plan_run(const bitp_plan_t *inst, bitp_parser_t *parser, uint64_t *res, size_t n_records);
+
+/*
+ * Decodes n_msgs independent messages of the layout, one per SIMD lane: 16 at a time with AVX2,
+ * 32 with AVX-512, the rest one by one. Message i starts at msgs[i] and its output k goes to
+ * res[k][i]. The messages aren't bounds checked: each has to hold a whole record, plus 8 bytes
+ * that can be read past it.
+ */
+void bitp_plan_run_lanes(const bitp_plan_t *inst, const char *const *msgs, size_t n_msgs, uint64_t *const *res);
+
+void bitp_plan_run_lanes_isa(const bitp_plan_t *inst, const char *const *msgs, size_t n_msgs, uint64_t *const *res, bitp_isa_t isa);
+
+/*
+ **************************************************************************************************
+  Realization
+ **************************************************************************************************
+ */
+
+/* bits a window may span so that its 64-bit load covers it at any bit phase */
+#define BITP_PLAN_WINDOW_BITS_ 57
+
+inline bitp_status_t bitp_plan_compile(bitp_plan_t *inst, const bitp_plan_field_t *fields, unsigned n_fields) {
+    size_t text_len = 0;
+    size_t pos = 0;
+    bitp_plan_window_t_ *win = NULL;
+
+    if (n_fields > BITP_PLAN_MAX) {
+        return BITP_EINVALID_ARG;
+    }
+    inst->n_windows = 0;
+    inst->n_out = 0;
+
+    for (unsigned i = 0; i < n_fields; ++i) {
+        const bitp_plan_field_t *f = &fields[i];
+        if (f->kind == BITP_PLAN_SKIP) {
+            pos += f->n_bits;
+            continue;
+        }
+        if (f->n_bits == 0 || f->n_bits > 64 || (f->kind != BITP_PLAN_UNSIGNED && f->kind != BITP_PLAN_SIGNED)) {
+            return BITP_EINVALID_ARG;
+        }
+        size_t name_len = f->name ? strlen(f->name) : 0;
+        if (BITP_PLAN_TEXT_SIZE - text_len < name_len + 1) {
+            return BITP_EINVALID_ARG;
+        }
+
+        // a new window unless the field ends within the current one
+        if (!win || win->wide || f->n_bits > BITP_PLAN_WINDOW_BITS_ || pos + f->n_bits - win->bit > BITP_PLAN_WINDOW_BITS_) {
+            win = &inst->windows[inst->n_windows++];
+            win->bit = (uint32_t)pos;
+            win->first_op = (uint16_t)inst->n_out;
+            win->n_ops = 0;
+            win->wide = f->n_bits > BITP_PLAN_WINDOW_BITS_;
+        }
+        bitp_plan_op_t_ *op = &inst->ops[inst->n_out];
+        op->lshift = (uint8_t)(pos - win->bit);
+        op->rshift = (uint8_t)(64 - f->n_bits);
+        op->sign = f->kind == BITP_PLAN_SIGNED ? 1ULL << (f->n_bits - 1) : 0;
+        win->n_ops++;
+
+        inst->name_offs[inst->n_out] = (uint16_t)text_len;
+        if (name_len) {
+            memcpy(inst->text + text_len, f->name, name_len);
+        }
+        inst->text[text_len + name_len] = '\0';
+        text_len += name_len + 1;
+
+        inst->n_out++;
+        pos += f->n_bits;
+    }
+
+    // window offsets are 32-bit
+    if (pos > 0xFFFFFFFFu) {
+        return BITP_EINVALID_ARG;
+    }
+    inst->record_bits = pos;
+    return BITP_OK;
+}
+
+inline int bitp_plan_is_space_(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline bitp_status_t bitp_plan_load(bitp_plan_t *inst, const char *text, size_t len, size_t *error_line) {
+    bitp_plan_field_t fields[BITP_PLAN_MAX];
+    // the names are terminated in a copy, compile copies them into the plan
+    char names[BITP_PLAN_TEXT_SIZE];
+    size_t names_len = 0;
+    unsigned n_fields = 0;
+    size_t line = 0;
+    size_t i = 0;
+
+    memset(fields, 0, sizeof(fields));
+    if (error_line) {
+        *error_line = 0;
+    }
+    while (i < len) {
+        size_t end = i;
+        while (end < len && text[end] != '\n') {
+            end++;
+        }
+        line++;
+        size_t stop = i;
+        while (stop < end && text[stop] != '#') {
+            stop++;
+        }
+
+        // name
+        while (i < stop && bitp_plan_is_space_(text[i])) {
+            i++;
+        }
+        size_t name = i;
+        while (i < stop && !bitp_plan_is_space_(text[i])) {
+            i++;
+        }
+        size_t name_len = i - name;
+        // type
+        while (i < stop && bitp_plan_is_space_(text[i])) {
+            i++;
+        }
+        size_t type = i;
+        while (i < stop && !bitp_plan_is_space_(text[i])) {
+            i++;
+        }
+        size_t type_len = i - type;
+        while (i < stop && bitp_plan_is_space_(text[i])) {
+            i++;
+        }
+
+        if (name_len || type_len) {
+            bitp_plan_field_t *f = &fields[n_fields];
+            unsigned long n_bits = 0;
+            int ok = i == stop && type_len >= 2 && type_len <= 11 && n_fields < BITP_PLAN_MAX &&
+                     BITP_PLAN_TEXT_SIZE - names_len > name_len;
+            if (ok) {
+                switch (text[type]) {
+                case 'u':
+                    f->kind = BITP_PLAN_UNSIGNED;
+                    break;
+                case 'i':
+                    f->kind = BITP_PLAN_SIGNED;
+                    break;
+                case 'x':
+                    f->kind = BITP_PLAN_SKIP;
+                    break;
+                default:
+                    ok = 0;
+                }
+            }
+            for (size_t k = type + 1; ok && k < type + type_len; ++k) {
+                ok = text[k] >= '0' && text[k] <= '9';
+                n_bits = n_bits * 10 + (unsigned long)(text[k] - '0');
+            }
+            ok = ok && n_bits > 0 && n_bits <= 0xFFFFFFFFu && (f->kind == BITP_PLAN_SKIP || n_bits <= 64);
+            if (!ok) {
+                if (error_line) {
+                    *error_line = line;
+                }
+                return BITP_EINVALID_ARG;
+            }
+            memcpy(names + names_len, text + name, name_len);
+            names[names_len + name_len] = '\0';
+            f->name = names + names_len;
+            f->n_bits = (unsigned)n_bits;
+            names_len += name_len + 1;
+            n_fields++;
+        }
+        i = end + 1;
+    }
+
+    bitp_status_t status = bitp_plan_compile(inst, fields, n_fields);
+    if (status != BITP_OK && error_line) {
+        *error_line = line;
+    }
+    return status;
+}
+
+inline int bitp_plan_find(const bitp_plan_t *inst, const char *name) {
+    for (unsigned i = 0; i < inst->n_out; ++i) {
+        if (strcmp(inst->text + inst->name_offs[i], name) == 0) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+inline bitp_status_t bitp_plan_run(const bitp_plan_t *inst, bitp_parser_t *parser, uint64_t *res, size_t n_records) {
+    size_t record_bits = inst->record_bits;
+
+    if (parser->iter > parser->capacity ||
+        (record_bits && (parser->capacity - parser->iter) / record_bits < n_records)) {
+        return BITP_EFULL;
+    }
+
+    const char *buf = parser->buf;
+    const bitp_plan_window_t_ *windows = inst->windows;
+    const bitp_plan_op_t_ *ops = inst->ops;
+    unsigned n_windows = inst->n_windows;
+    size_t base = parser->iter;
+
+    for (size_t r = 0; r < n_records; ++r, base += record_bits) {
+        for (unsigned w = 0; w < n_windows; ++w) {
+            size_t bit = base + windows[w].bit;
+            const char *p = buf + bit / CHAR_BIT;
+            unsigned phase = bit % CHAR_BIT;
+            uint64_t word = bitp_load_be_64(p) << phase;
+            if (windows[w].wide && phase) {
+                word |= (uint8_t)p[sizeof(uint64_t)] >> (CHAR_BIT - phase);
+            }
+
+            const bitp_plan_op_t_ *op = ops + windows[w].first_op;
+            for (unsigned k = 0; k < windows[w].n_ops; ++k, ++op) {
+                uint64_t v = (word << op->lshift) >> op->rshift;
+                *res++ = (v ^ op->sign) - op->sign;
+            }
+        }
+    }
+
+    parser->iter = base;
+    return BITP_OK;
+}
+
+inline void bitp_plan_run_lanes_scalar_(const bitp_plan_t *inst, const char *const *msgs, size_t from, size_t n_msgs, uint64_t *const *res) {
+    for (size_t i = from; i < n_msgs; ++i) {
+        for (unsigned w = 0; w < inst->n_windows; ++w) {
+            const bitp_plan_window_t_ *win = &inst->windows[w];
+            const char *p = msgs[i] + win->bit / CHAR_BIT;
+            unsigned phase = win->bit % CHAR_BIT;
+            uint64_t word = bitp_load_be_64(p) << phase;
+            if (win->wide && phase) {
+                word |= (uint8_t)p[sizeof(uint64_t)] >> (CHAR_BIT - phase);
+            }
+            for (unsigned k = win->first_op; k < win->first_op + win->n_ops; ++k) {
+                uint64_t v = (word << inst->ops[k].lshift) >> inst->ops[k].rshift;
+                res[k][i] = (v ^ inst->ops[k].sign) - inst->ops[k].sign;
+            }
+        }
+    }
+}
+
+#if BITP_X86_64
+/*
+ * The message pointers are the gather indices: a window is at the same byte and bit phase in
+ * every message, so a window of 4 or 8 messages is one gather, a byte swap and a shift.
+ */
+BITP_TARGET("avx2")
+inline __m256i bitp_plan_window_avx2_(const bitp_plan_window_t_ *win, __m256i ptrs, __m256i rev_bytes) {
+    const long long *base = (const long long *)(const void *)NULL;
+    unsigned phase = win->bit % CHAR_BIT;
+    __m256i addr = _mm256_add_epi64(ptrs, _mm256_set1_epi64x((long long)(win->bit / CHAR_BIT)));
+    __m256i word = _mm256_shuffle_epi8(_mm256_i64gather_epi64(base, addr, 1), rev_bytes);
+    word = _mm256_sll_epi64(word, _mm_cvtsi32_si128((int)phase));
+    if (win->wide && phase) {
+        // the ninth byte is the last of the word one byte further
+        __m256i next = _mm256_i64gather_epi64(base, _mm256_add_epi64(addr, _mm256_set1_epi64x(1)), 1);
+        next = _mm256_srli_epi64(next, 56);
+        word = _mm256_or_si256(word, _mm256_srl_epi64(next, _mm_cvtsi32_si128((int)(CHAR_BIT - phase))));
+    }
+    return word;
+}
+
+BITP_TARGET("avx2")
+inline size_t bitp_plan_run_lanes_avx2_(const bitp_plan_t *inst, const char *const *msgs, size_t n_msgs, uint64_t *const *res) {
+    const __m256i rev_bytes = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                               7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    size_t i = 0;
+
+    // 4 vectors of 4 messages, the field constants are loaded once for all of them
+    for (; i + 16 <= n_msgs; i += 16) {
+        __m256i ptrs[4];
+        for (unsigned v = 0; v < 4; ++v) {
+            ptrs[v] = _mm256_loadu_si256((const __m256i *)(msgs + i + 4 * v));
+        }
+        for (unsigned w = 0; w < inst->n_windows; ++w) {
+            const bitp_plan_window_t_ *win = &inst->windows[w];
+            __m256i words[4];
+            for (unsigned v = 0; v < 4; ++v) {
+                words[v] = bitp_plan_window_avx2_(win, ptrs[v], rev_bytes);
+            }
+            for (unsigned k = win->first_op; k < win->first_op + win->n_ops; ++k) {
+                const bitp_plan_op_t_ *op = &inst->ops[k];
+                __m256i lshift = _mm256_set1_epi64x(op->lshift);
+                __m256i rshift = _mm256_set1_epi64x(op->rshift);
+                __m256i sign = _mm256_set1_epi64x((long long)op->sign);
+                uint64_t *out = res[k] + i;
+                for (unsigned v = 0; v < 4; ++v) {
+                    __m256i val = _mm256_srlv_epi64(_mm256_sllv_epi64(words[v], lshift), rshift);
+                    val = _mm256_sub_epi64(_mm256_xor_si256(val, sign), sign);
+                    _mm256_storeu_si256((__m256i *)(out + 4 * v), val);
+                }
+            }
+        }
+    }
+    return i;
+}
+
+BITP_TARGET("avx512f,avx512bw")
+inline __m512i bitp_plan_window_avx512_(const bitp_plan_window_t_ *win, __m512i ptrs, __m512i rev_bytes) {
+    // maskz forms: the plain ones pass an undefined vector GCC warns about
+    const __mmask8 all = (__mmask8)-1;
+    const __m512i zero = _mm512_setzero_si512();
+    const long long *base = (const long long *)(const void *)NULL;
+    unsigned phase = win->bit % CHAR_BIT;
+    __m512i addr = _mm512_add_epi64(ptrs, _mm512_set1_epi64((long long)(win->bit / CHAR_BIT)));
+    __m512i word = _mm512_shuffle_epi8(_mm512_mask_i64gather_epi64(zero, all, addr, base, 1), rev_bytes);
+    word = _mm512_maskz_sll_epi64(all, word, _mm_cvtsi32_si128((int)phase));
+    if (win->wide && phase) {
+        __m512i next = _mm512_mask_i64gather_epi64(zero, all, _mm512_add_epi64(addr, _mm512_set1_epi64(1)), base, 1);
+        next = _mm512_maskz_srli_epi64(all, next, 56);
+        word = _mm512_or_si512(word, _mm512_maskz_srl_epi64(all, next, _mm_cvtsi32_si128((int)(CHAR_BIT - phase))));
+    }
+    return word;
+}
+
+BITP_TARGET("avx512f,avx512bw")
+inline size_t bitp_plan_run_lanes_avx512_(const bitp_plan_t *inst, const char *const *msgs, size_t n_msgs, uint64_t *const *res) {
+    const __mmask8 all = (__mmask8)-1;
+    const __m512i rev_bytes = _mm512_maskz_broadcast_i32x4(
+        (__mmask16)-1, _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8));
+    size_t i = 0;
+
+    for (; i + 32 <= n_msgs; i += 32) {
+        __m512i ptrs[4];
+        for (unsigned v = 0; v < 4; ++v) {
+            ptrs[v] = _mm512_loadu_si512((const void *)(msgs + i + 8 * v));
+        }
+        for (unsigned w = 0; w < inst->n_windows; ++w) {
+            const bitp_plan_window_t_ *win = &inst->windows[w];
+            __m512i words[4];
+            for (unsigned v = 0; v < 4; ++v) {
+                words[v] = bitp_plan_window_avx512_(win, ptrs[v], rev_bytes);
+            }
+            for (unsigned k = win->first_op; k < win->first_op + win->n_ops; ++k) {
+                const bitp_plan_op_t_ *op = &inst->ops[k];
+                __m512i lshift = _mm512_set1_epi64(op->lshift);
+                __m512i rshift = _mm512_set1_epi64(op->rshift);
+                __m512i sign = _mm512_set1_epi64((long long)op->sign);
+                uint64_t *out = res[k] + i;
+                for (unsigned v = 0; v < 4; ++v) {
+                    __m512i val = _mm512_maskz_srlv_epi64(all, _mm512_maskz_sllv_epi64(all, words[v], lshift), rshift);
+                    val = _mm512_sub_epi64(_mm512_xor_si512(val, sign), sign);
+                    _mm512_storeu_si512((void *)(out + 8 * v), val);
+                }
+            }
+        }
+    }
+    return i;
+}
+#endif
+
+inline void bitp_plan_run_lanes_isa(const bitp_plan_t *inst, const char *const *msgs, size_t n_msgs, uint64_t *const *res, bitp_isa_t isa) {
+    size_t i = 0;
+
+#if BITP_X86_64
+    if (isa >= BITP_ISA_AVX512) {
+        i = bitp_plan_run_lanes_avx512_(inst, msgs, n_msgs, res);
+    }
+    else if (isa >= BITP_ISA_AVX2) {
+        i = bitp_plan_run_lanes_avx2_(inst, msgs, n_msgs, res);
+    }
+#else
+    (void)isa;
+#endif
+    bitp_plan_run_lanes_scalar_(inst, msgs, i, n_msgs, res);
+}
+
+inline void bitp_plan_run_lanes(const bitp_plan_t *inst, const char *const *msgs, size_t n_msgs, uint64_t *const *res) {
+    bitp_plan_run_lanes_isa(inst, msgs, n_msgs, res, BITP_ISA_NATIVE);
+}
+
+#endif /* INCLUDE_BITP_PLAN_H_ */
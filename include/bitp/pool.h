@@ -0,0 +1,141 @@
+/*
+ * pool.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#ifndef INCLUDE_BITP_POOL_H_
+#define INCLUDE_BITP_POOL_H_
+
+#include "packer.h"
+#include "parser.h"
+
+/* no cursor, returned for a failed allocation and usable as "no flow" in side tables */
+#define BITP_POOL_NONE 0xFFFFFFFFu
+
+/*
+ * Compact parser or packer state: bit offsets relative to the base of an arena shared by all
+ * cursors, 8 bytes instead of the 24 of bitp_parser_t. An arena is at most 2^32 - 1 bits
+ * (512 MiB). A cursor is loaded into a bitp_parser_t or bitp_packer_t to be read or written
+ * with the usual calls and stored back after.
+ */
+typedef struct bitp_cursor_tag {
+    uint32_t iter;
+    uint32_t capacity;
+} bitp_cursor_t;
+
+/*
+ * Slab of cursors for many concurrent streams, e.g. one per UE or flow. The caller owns the slot
+ * array; a handle is the index of a slot, so per-flow side tables can be parallel arrays indexed
+ * by the same handle. Free slots are chained through their iter, allocation and release are O(1)
+ * and touch one slot. Not thread-safe, use a pool per thread.
+ */
+typedef struct bitp_pool_tag {
+    char *base;
+    bitp_cursor_t *slots;
+    uint32_t base_len_bits;
+    uint32_t n_slots;
+    uint32_t n_used;
+    uint32_t free_head;
+} bitp_pool_t;
+
+/* n_slots < BITP_POOL_NONE, base_len_bits <= UINT32_MAX, BITP_EINVALID_ARG otherwise */
+bitp_status_t bitp_pool_init(bitp_pool_t *inst, char *base, size_t base_len_bits, bitp_cursor_t *slots, uint32_t n_slots);
+
+/*
+ * a cursor over [begin, begin + n_bits) of the arena; BITP_EFULL if no slot is free,
+ * BITP_EINVALID_ARG if the range isn't inside the arena
+ */
+bitp_status_t bitp_pool_alloc(bitp_pool_t *inst, uint32_t begin, uint32_t n_bits, uint32_t *handle);
+
+void bitp_pool_free(bitp_pool_t *inst, uint32_t handle);
+
+bitp_cursor_t *bitp_pool_get(const bitp_pool_t *inst, uint32_t handle);
+
+/* the cursor as a parser or packer on the arena */
+void bitp_pool_load_parser(const bitp_pool_t *inst, uint32_t handle, bitp_parser_t *res);
+
+void bitp_pool_load_packer(const bitp_pool_t *inst, uint32_t handle, bitp_packer_t *res);
+
+/* the position of a parser or packer loaded from the cursor back into it */
+void bitp_pool_store_parser(bitp_pool_t *inst, uint32_t handle, const bitp_parser_t *parser);
+
+void bitp_pool_store_packer(bitp_pool_t *inst, uint32_t handle, const bitp_packer_t *packer);
+
+/*
+ **************************************************************************************************
+  Realization
+ **************************************************************************************************
+ */
+
+inline bitp_status_t bitp_pool_init(bitp_pool_t *inst, char *base, size_t base_len_bits, bitp_cursor_t *slots, uint32_t n_slots) {
+    if (base_len_bits > 0xFFFFFFFFu || n_slots >= BITP_POOL_NONE) {
+        return BITP_EINVALID_ARG;
+    }
+    inst->base = base;
+    inst->base_len_bits = (uint32_t)base_len_bits;
+    inst->slots = slots;
+    inst->n_slots = n_slots;
+    inst->n_used = 0;
+    // chained in index order so that the first allocations are adjacent
+    for (uint32_t i = 0; i < n_slots; ++i) {
+        slots[i].iter = i + 1 < n_slots ? i + 1 : BITP_POOL_NONE;
+        slots[i].capacity = 0;
+    }
+    inst->free_head = n_slots ? 0 : BITP_POOL_NONE;
+    return BITP_OK;
+}
+
+inline bitp_status_t bitp_pool_alloc(bitp_pool_t *inst, uint32_t begin, uint32_t n_bits, uint32_t *handle) {
+    uint32_t slot = inst->free_head;
+
+    if (slot == BITP_POOL_NONE) {
+        *handle = BITP_POOL_NONE;
+        return BITP_EFULL;
+    }
+    if (begin > inst->base_len_bits || inst->base_len_bits - begin < n_bits) {
+        *handle = BITP_POOL_NONE;
+        return BITP_EINVALID_ARG;
+    }
+    inst->free_head = inst->slots[slot].iter;
+    inst->slots[slot].iter = begin;
+    inst->slots[slot].capacity = begin + n_bits;
+    inst->n_used++;
+    *handle = slot;
+    return BITP_OK;
+}
+
+inline void bitp_pool_free(bitp_pool_t *inst, uint32_t handle) {
+    inst->slots[handle].iter = inst->free_head;
+    inst->slots[handle].capacity = 0;
+    inst->free_head = handle;
+    inst->n_used--;
+}
+
+inline bitp_cursor_t *bitp_pool_get(const bitp_pool_t *inst, uint32_t handle) {
+    return &inst->slots[handle];
+}
+
+inline void bitp_pool_load_parser(const bitp_pool_t *inst, uint32_t handle, bitp_parser_t *res) {
+    res->buf = inst->base;
+    res->capacity = inst->slots[handle].capacity;
+    res->iter = inst->slots[handle].iter;
+}
+
+inline void bitp_pool_load_packer(const bitp_pool_t *inst, uint32_t handle, bitp_packer_t *res) {
+    res->buf = inst->base;
+    res->capacity = inst->slots[handle].capacity;
+    res->iter = inst->slots[handle].iter;
+}
+
+inline void bitp_pool_store_parser(bitp_pool_t *inst, uint32_t handle, const bitp_parser_t *parser) {
+    // a parser loaded from the cursor never moves past its capacity, which fits 32 bits
+    inst->slots[handle].iter = (uint32_t)parser->iter;
+}
+
+inline void bitp_pool_store_packer(bitp_pool_t *inst, uint32_t handle, const bitp_packer_t *packer) {
+    inst->slots[handle].iter = (uint32_t)packer->iter;
+}
+
+#endif /* INCLUDE_BITP_POOL_H_ */
@@ -0,0 +1,516 @@
+/*
+ * search.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#ifndef INCLUDE_BITP_SEARCH_H_
+#define INCLUDE_BITP_SEARCH_H_
+
+#include "cpu.h"
+#include "parser.h"
+
+typedef struct bitp_pattern_tag {
+    uint64_t value;
+    uint64_t mask;
+    unsigned n_bits;
+    unsigned max_errors;
+    uint8_t anchors[CHAR_BIT];
+    uint8_t anchors_next[CHAR_BIT];
+} bitp_pattern_t;
+
+bitp_status_t bitp_pattern_init(bitp_pattern_t *inst,
+                                uint64_t pattern,
+                                unsigned n_bits,
+                                unsigned max_errors);
+
+bitp_status_t bitp_parser_find(bitp_parser_t *inst, const bitp_pattern_t *pattern);
+
+/* same as bitp_parser_find, the CPU must support isa */
+bitp_status_t bitp_parser_find_isa(bitp_parser_t *inst, const bitp_pattern_t *pattern, bitp_isa_t isa);
+
+size_t bitp_parser_find_all(const bitp_parser_t *inst,
+                            const bitp_pattern_t *pattern,
+                            bitp_parser_t *matches,
+                            size_t max_matches);
+
+/*
+ **************************************************************************************************
+  Realization
+ **************************************************************************************************
+ */
+
+#define BITP_SEARCH_NPOS ((size_t)-1)
+
+inline bitp_status_t bitp_pattern_init(bitp_pattern_t *inst,
+                                       uint64_t pattern,
+                                       unsigned n_bits,
+                                       unsigned max_errors) {
+#if BITP_CHECK_PARAM
+    if (n_bits == 0) {
+        return BITP_EINVALID_ARG;
+    }
+#endif
+    BITP_CHECK_PARAM_SIZE(inst, n_bits, uint64_t);
+    BITP_CHECK_PARAM_RANGE(pattern, n_bits, 0);
+
+    inst->n_bits = n_bits;
+    inst->max_errors = max_errors;
+    inst->mask = 0xFFFFFFFFFFFFFFFFULL << (64 - n_bits);
+    inst->value = pattern << (64 - n_bits);
+
+    // first and second whole pattern bytes for a match starting at bit phase p
+    for (unsigned p = 0; p < CHAR_BIT; ++p) {
+        uint64_t aligned = inst->value << ((CHAR_BIT - p) % CHAR_BIT);
+        inst->anchors[p] = (uint8_t)(aligned >> 56);
+        inst->anchors_next[p] = (uint8_t)(aligned >> 48);
+    }
+
+    return BITP_OK;
+}
+
+// loads bytes [b, b + 16) as two big-endian words, bytes past n_bytes read as zeros
+inline void bitp_search_load_(const char *buf,
+                              size_t n_bytes,
+                              size_t b,
+                              uint64_t *w0,
+                              uint64_t *w1) {
+    if (b + 2 * sizeof(uint64_t) <= n_bytes) {
+        *w0 = bitp_load_be_64(buf + b);
+        *w1 = bitp_load_be_64(buf + b + sizeof(uint64_t));
+    }
+    else {
+        char tmp[2 * sizeof(uint64_t)] = {0};
+        memcpy(tmp, buf + b, n_bytes - b);
+        *w0 = bitp_load_be_64(tmp);
+        *w1 = bitp_load_be_64(tmp + sizeof(uint64_t));
+    }
+}
+
+// bit p of the result is set if the pattern matches at bit (b * CHAR_BIT + p)
+inline unsigned bitp_search_phases_(const bitp_pattern_t *pattern, uint64_t w0, uint64_t w1) {
+    unsigned hits = 0;
+    for (unsigned p = 0; p < CHAR_BIT; ++p) {
+        uint64_t w = p ? (w0 << p) | (w1 >> (64 - p)) : w0;
+        if (bitp_popcount_64((w ^ pattern->value) & pattern->mask) <= pattern->max_errors) {
+            hits |= 1u << p;
+        }
+    }
+    return hits;
+}
+
+// first match among the phases of byte b limited to [from, last],
+// BITP_SEARCH_NPOS - 1 if no phase of the byte matches
+inline size_t bitp_search_hit_(unsigned hits, size_t b, size_t from, size_t last) {
+    if (b * CHAR_BIT < from) {
+        hits &= ~0u << (from % CHAR_BIT);
+    }
+    if (!hits) {
+        return BITP_SEARCH_NPOS - 1;
+    }
+    size_t pos = b * CHAR_BIT + bitp_ctz_64(hits);
+    return pos <= last ? pos : BITP_SEARCH_NPOS;
+}
+
+// tests every start position in [from, last] starting at byte b, works for any pattern
+inline size_t bitp_search_generic_scalar_(const bitp_pattern_t *pattern,
+                                          const char *buf,
+                                          size_t b,
+                                          size_t from,
+                                          size_t last) {
+    size_t n_bytes = (last + pattern->n_bits + CHAR_BIT - 1) / CHAR_BIT;
+    uint64_t w0, w1;
+
+    for (; b * CHAR_BIT <= last; ++b) {
+        bitp_search_load_(buf, n_bytes, b, &w0, &w1);
+        size_t pos = bitp_search_hit_(bitp_search_phases_(pattern, w0, w1), b, from, last);
+        if (pos != BITP_SEARCH_NPOS - 1) {
+            return pos;
+        }
+    }
+
+    return BITP_SEARCH_NPOS;
+}
+
+// verifies all bit phases whose first whole pattern byte is buf[k]
+inline size_t bitp_search_candidate_(const bitp_pattern_t *pattern,
+                                     const char *buf,
+                                     size_t n_bytes,
+                                     size_t k,
+                                     size_t from,
+                                     size_t last) {
+    uint8_t byte = (uint8_t)buf[k];
+    uint64_t w0, w1;
+
+    // phases 1..7 start inside byte k - 1 and therefore precede phase 0
+    if (k > 0) {
+        bitp_search_load_(buf, n_bytes, k - 1, &w0, &w1);
+        for (unsigned p = 1; p < CHAR_BIT; ++p) {
+            size_t pos = (k - 1) * CHAR_BIT + p;
+            if (pattern->anchors[p] == byte && pos >= from && pos <= last) {
+                uint64_t w = (w0 << p) | (w1 >> (64 - p));
+                if (((w ^ pattern->value) & pattern->mask) == 0) {
+                    return pos;
+                }
+            }
+        }
+    }
+
+    size_t pos = k * CHAR_BIT;
+    if (pattern->anchors[0] == byte && pos >= from && pos <= last) {
+        bitp_search_load_(buf, n_bytes, k, &w0, &w1);
+        if (((w0 ^ pattern->value) & pattern->mask) == 0) {
+            return pos;
+        }
+    }
+
+    return BITP_SEARCH_NPOS;
+}
+
+// exact search for patterns of 15+ bits: every bit phase contains a whole pattern byte,
+// so the stream is prefiltered bytewise against 8 anchors and only candidates are verified.
+// Patterns of 23+ bits contain two whole bytes in every phase and are prefiltered by pairs.
+// The vector versions below handle whole blocks and leave the rest to this one.
+inline size_t bitp_search_anchored_scalar_(const bitp_pattern_t *pattern,
+                                           const char *buf,
+                                           size_t k,
+                                           size_t from,
+                                           size_t last) {
+    size_t n_bytes = (last + pattern->n_bits + CHAR_BIT - 1) / CHAR_BIT;
+    size_t k_end = last / CHAR_BIT + 2;
+    if (k_end > n_bytes) {
+        k_end = n_bytes;
+    }
+
+    for (; k < k_end; ++k) {
+        uint8_t byte = (uint8_t)buf[k];
+        for (unsigned p = 0; p < CHAR_BIT; ++p) {
+            if (pattern->anchors[p] == byte) {
+                size_t pos = bitp_search_candidate_(pattern, buf, n_bytes, k, from, last);
+                if (pos != BITP_SEARCH_NPOS) {
+                    return pos;
+                }
+                break;
+            }
+        }
+    }
+
+    return BITP_SEARCH_NPOS;
+}
+
+inline int bitp_search_pairs_(const bitp_pattern_t *pattern) {
+    return pattern->n_bits >= 3 * CHAR_BIT - 1;
+}
+
+#if BITP_X86_64
+
+// bits of a vector compare mask are candidate bytes starting at buf[k]
+#define BITP_SEARCH_CANDIDATES_(pattern_, buf_, n_bytes_, k_, bits_, from_, last_)                \
+    do {                                                                                         \
+        while (bits_) {                                                                          \
+            size_t pos_ = bitp_search_candidate_(pattern_, buf_, n_bytes_, (k_) + bitp_ctz_64(bits_), \
+                                                 from_, last_);                                  \
+            if (pos_ != BITP_SEARCH_NPOS) {                                                      \
+                return pos_;                                                                     \
+            }                                                                                    \
+            bits_ &= bits_ - 1;                                                                  \
+        }                                                                                        \
+    } while (0)
+
+inline size_t bitp_search_anchored_sse2_(const bitp_pattern_t *pattern,
+                                         const char *buf,
+                                         size_t from,
+                                         size_t last) {
+    size_t n_bytes = (last + pattern->n_bits + CHAR_BIT - 1) / CHAR_BIT;
+    size_t k_end = last / CHAR_BIT + 2;
+    size_t k = from / CHAR_BIT;
+    int pairs = bitp_search_pairs_(pattern);
+
+    __m128i anchors[CHAR_BIT];
+    __m128i anchors_next[CHAR_BIT];
+    for (unsigned p = 0; p < CHAR_BIT; ++p) {
+        anchors[p] = _mm_set1_epi8((char)pattern->anchors[p]);
+        anchors_next[p] = _mm_set1_epi8((char)pattern->anchors_next[p]);
+    }
+
+    for (; k + sizeof(__m128i) <= k_end && k + sizeof(__m128i) < n_bytes; k += sizeof(__m128i)) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(buf + k));
+        __m128i eq = _mm_setzero_si128();
+        if (pairs) {
+            __m128i v_next = _mm_loadu_si128((const __m128i *)(buf + k + 1));
+            for (unsigned p = 0; p < CHAR_BIT; ++p) {
+                eq = _mm_or_si128(eq, _mm_and_si128(_mm_cmpeq_epi8(v, anchors[p]),
+                                                    _mm_cmpeq_epi8(v_next, anchors_next[p])));
+            }
+        }
+        else {
+            for (unsigned p = 0; p < CHAR_BIT; ++p) {
+                eq = _mm_or_si128(eq, _mm_cmpeq_epi8(v, anchors[p]));
+            }
+        }
+        uint64_t bits = (uint32_t)_mm_movemask_epi8(eq);
+        BITP_SEARCH_CANDIDATES_(pattern, buf, n_bytes, k, bits, from, last);
+    }
+
+    return bitp_search_anchored_scalar_(pattern, buf, k, from, last);
+}
+
+BITP_TARGET("avx2")
+inline size_t bitp_search_anchored_avx2_(const bitp_pattern_t *pattern,
+                                         const char *buf,
+                                         size_t from,
+                                         size_t last) {
+    size_t n_bytes = (last + pattern->n_bits + CHAR_BIT - 1) / CHAR_BIT;
+    size_t k_end = last / CHAR_BIT + 2;
+    size_t k = from / CHAR_BIT;
+    int pairs = bitp_search_pairs_(pattern);
+
+    __m256i anchors[CHAR_BIT];
+    __m256i anchors_next[CHAR_BIT];
+    for (unsigned p = 0; p < CHAR_BIT; ++p) {
+        anchors[p] = _mm256_set1_epi8((char)pattern->anchors[p]);
+        anchors_next[p] = _mm256_set1_epi8((char)pattern->anchors_next[p]);
+    }
+
+    for (; k + sizeof(__m256i) <= k_end && k + sizeof(__m256i) < n_bytes; k += sizeof(__m256i)) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(buf + k));
+        __m256i eq = _mm256_setzero_si256();
+        if (pairs) {
+            __m256i v_next = _mm256_loadu_si256((const __m256i *)(buf + k + 1));
+            for (unsigned p = 0; p < CHAR_BIT; ++p) {
+                eq = _mm256_or_si256(eq, _mm256_and_si256(_mm256_cmpeq_epi8(v, anchors[p]),
+                                                          _mm256_cmpeq_epi8(v_next, anchors_next[p])));
+            }
+        }
+        else {
+            for (unsigned p = 0; p < CHAR_BIT; ++p) {
+                eq = _mm256_or_si256(eq, _mm256_cmpeq_epi8(v, anchors[p]));
+            }
+        }
+        uint64_t bits = (uint32_t)_mm256_movemask_epi8(eq);
+        BITP_SEARCH_CANDIDATES_(pattern, buf, n_bytes, k, bits, from, last);
+    }
+
+    return bitp_search_anchored_scalar_(pattern, buf, k, from, last);
+}
+
+BITP_TARGET("avx512f,avx512bw")
+inline size_t bitp_search_anchored_avx512_(const bitp_pattern_t *pattern,
+                                           const char *buf,
+                                           size_t from,
+                                           size_t last) {
+    size_t n_bytes = (last + pattern->n_bits + CHAR_BIT - 1) / CHAR_BIT;
+    size_t k_end = last / CHAR_BIT + 2;
+    size_t k = from / CHAR_BIT;
+    int pairs = bitp_search_pairs_(pattern);
+
+    __m512i anchors[CHAR_BIT];
+    __m512i anchors_next[CHAR_BIT];
+    for (unsigned p = 0; p < CHAR_BIT; ++p) {
+        anchors[p] = _mm512_set1_epi8((char)pattern->anchors[p]);
+        anchors_next[p] = _mm512_set1_epi8((char)pattern->anchors_next[p]);
+    }
+
+    for (; k + sizeof(__m512i) <= k_end && k + sizeof(__m512i) < n_bytes; k += sizeof(__m512i)) {
+        __m512i v = _mm512_loadu_si512((const void *)(buf + k));
+        uint64_t bits = 0;
+        if (pairs) {
+            __m512i v_next = _mm512_loadu_si512((const void *)(buf + k + 1));
+            for (unsigned p = 0; p < CHAR_BIT; ++p) {
+                bits |= _mm512_mask_cmpeq_epi8_mask(_mm512_cmpeq_epi8_mask(v, anchors[p]),
+                                                    v_next, anchors_next[p]);
+            }
+        }
+        else {
+            for (unsigned p = 0; p < CHAR_BIT; ++p) {
+                bits |= _mm512_cmpeq_epi8_mask(v, anchors[p]);
+            }
+        }
+        BITP_SEARCH_CANDIDATES_(pattern, buf, n_bytes, k, bits, from, last);
+    }
+
+    return bitp_search_anchored_scalar_(pattern, buf, k, from, last);
+}
+
+BITP_TARGET("avx2")
+inline unsigned bitp_search_phases_avx2_(const bitp_pattern_t *pattern, uint64_t w0, uint64_t w1) {
+    const __m256i sh_lo = _mm256_set_epi64x(3, 2, 1, 0);
+    const __m256i sh_hi = _mm256_set_epi64x(7, 6, 5, 4);
+    const __m256i rsh_lo = _mm256_set_epi64x(61, 62, 63, 64);
+    const __m256i rsh_hi = _mm256_set_epi64x(57, 58, 59, 60);
+    const __m256i value = _mm256_set1_epi64x((long long)pattern->value);
+    const __m256i mask = _mm256_set1_epi64x((long long)pattern->mask);
+    const __m256i w0v = _mm256_set1_epi64x((long long)w0);
+    const __m256i w1v = _mm256_set1_epi64x((long long)w1);
+
+    // a shift by 64 yields zero, so phase 0 needs no special case
+    __m256i d_lo = _mm256_or_si256(_mm256_sllv_epi64(w0v, sh_lo), _mm256_srlv_epi64(w1v, rsh_lo));
+    __m256i d_hi = _mm256_or_si256(_mm256_sllv_epi64(w0v, sh_hi), _mm256_srlv_epi64(w1v, rsh_hi));
+    d_lo = _mm256_and_si256(_mm256_xor_si256(d_lo, value), mask);
+    d_hi = _mm256_and_si256(_mm256_xor_si256(d_hi, value), mask);
+
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i ok_lo, ok_hi;
+    if (pattern->max_errors == 0) {
+        ok_lo = _mm256_cmpeq_epi64(d_lo, zero);
+        ok_hi = _mm256_cmpeq_epi64(d_hi, zero);
+    }
+    else {
+        const __m256i lut = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                             0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const __m256i nibble = _mm256_set1_epi8(0x0F);
+        const __m256i limit = _mm256_set1_epi64x((long long)pattern->max_errors + 1);
+        __m256i c_lo = _mm256_add_epi8(
+            _mm256_shuffle_epi8(lut, _mm256_and_si256(d_lo, nibble)),
+            _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(d_lo, 4), nibble)));
+        __m256i c_hi = _mm256_add_epi8(
+            _mm256_shuffle_epi8(lut, _mm256_and_si256(d_hi, nibble)),
+            _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(d_hi, 4), nibble)));
+        ok_lo = _mm256_cmpgt_epi64(limit, _mm256_sad_epu8(c_lo, zero));
+        ok_hi = _mm256_cmpgt_epi64(limit, _mm256_sad_epu8(c_hi, zero));
+    }
+
+    return (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(ok_lo)) |
+           ((unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(ok_hi)) << 4);
+}
+
+BITP_TARGET("avx2")
+inline size_t bitp_search_generic_avx2_(const bitp_pattern_t *pattern,
+                                        const char *buf,
+                                        size_t from,
+                                        size_t last) {
+    size_t n_bytes = (last + pattern->n_bits + CHAR_BIT - 1) / CHAR_BIT;
+    size_t b = from / CHAR_BIT;
+
+    for (; b + 2 * sizeof(uint64_t) <= n_bytes && b * CHAR_BIT <= last; ++b) {
+        uint64_t w0 = bitp_load_be_64(buf + b);
+        uint64_t w1 = bitp_load_be_64(buf + b + sizeof(uint64_t));
+        size_t pos = bitp_search_hit_(bitp_search_phases_avx2_(pattern, w0, w1), b, from, last);
+        if (pos != BITP_SEARCH_NPOS - 1) {
+            return pos;
+        }
+    }
+
+    return bitp_search_generic_scalar_(pattern, buf, b, from, last);
+}
+
+BITP_TARGET("avx512f,avx512bw")
+inline size_t bitp_search_generic_avx512_(const bitp_pattern_t *pattern,
+                                          const char *buf,
+                                          size_t from,
+                                          size_t last) {
+    size_t n_bytes = (last + pattern->n_bits + CHAR_BIT - 1) / CHAR_BIT;
+    size_t b = from / CHAR_BIT;
+
+    const __m512i sh = _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0);
+    const __m512i rsh = _mm512_set_epi64(57, 58, 59, 60, 61, 62, 63, 64);
+    const __m512i value = _mm512_set1_epi64((long long)pattern->value);
+    const __m512i mask = _mm512_set1_epi64((long long)pattern->mask);
+    const __m512i zero = _mm512_setzero_si512();
+    // maskz forms: the plain ones pass an undefined vector GCC warns about
+    const __m512i lut = _mm512_maskz_broadcast_i32x4(
+        (__mmask16)-1, _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4));
+    const __m512i nibble = _mm512_set1_epi8(0x0F);
+    const __m512i limit = _mm512_set1_epi64((long long)pattern->max_errors + 1);
+
+    for (; b + 2 * sizeof(uint64_t) <= n_bytes && b * CHAR_BIT <= last; ++b) {
+        __m512i w0v = _mm512_set1_epi64((long long)bitp_load_be_64(buf + b));
+        __m512i w1v = _mm512_set1_epi64((long long)bitp_load_be_64(buf + b + sizeof(uint64_t)));
+        // all 8 bit phases in one vector, a shift by 64 yields zero
+        __m512i d = _mm512_or_si512(_mm512_maskz_sllv_epi64((__mmask8)-1, w0v, sh),
+                                    _mm512_maskz_srlv_epi64((__mmask8)-1, w1v, rsh));
+        d = _mm512_and_si512(_mm512_xor_si512(d, value), mask);
+
+        unsigned hits;
+        if (pattern->max_errors == 0) {
+            hits = _mm512_cmpeq_epi64_mask(d, zero);
+        }
+        else {
+            __m512i c = _mm512_add_epi8(
+                _mm512_shuffle_epi8(lut, _mm512_and_si512(d, nibble)),
+                _mm512_shuffle_epi8(lut, _mm512_and_si512(_mm512_srli_epi16(d, 4), nibble)));
+            hits = _mm512_cmplt_epu64_mask(_mm512_sad_epu8(c, zero), limit);
+        }
+
+        size_t pos = bitp_search_hit_(hits, b, from, last);
+        if (pos != BITP_SEARCH_NPOS - 1) {
+            return pos;
+        }
+    }
+
+    return bitp_search_generic_scalar_(pattern, buf, b, from, last);
+}
+
+#endif    // BITP_X86_64
+
+inline size_t bitp_search_(const bitp_pattern_t *pattern,
+                           const char *buf,
+                           size_t from,
+                           size_t last,
+                           bitp_isa_t isa) {
+    if (pattern->max_errors == 0 && pattern->n_bits >= 2 * CHAR_BIT - 1) {
+        switch (isa) {
+#if BITP_X86_64
+        case BITP_ISA_AVX512:
+            return bitp_search_anchored_avx512_(pattern, buf, from, last);
+        case BITP_ISA_AVX2:
+            return bitp_search_anchored_avx2_(pattern, buf, from, last);
+        case BITP_ISA_SSE2:
+            return bitp_search_anchored_sse2_(pattern, buf, from, last);
+#endif
+        default:
+            return bitp_search_anchored_scalar_(pattern, buf, from / CHAR_BIT, from, last);
+        }
+    }
+
+    switch (isa) {
+#if BITP_X86_64
+    case BITP_ISA_AVX512:
+        return bitp_search_generic_avx512_(pattern, buf, from, last);
+    case BITP_ISA_AVX2:
+        return bitp_search_generic_avx2_(pattern, buf, from, last);
+#endif
+    default:
+        return bitp_search_generic_scalar_(pattern, buf, from / CHAR_BIT, from, last);
+    }
+}
+
+inline bitp_status_t bitp_parser_find_isa(bitp_parser_t *inst, const bitp_pattern_t *pattern, bitp_isa_t isa) {
+    if (inst->iter > inst->capacity || inst->capacity - inst->iter < pattern->n_bits) {
+        return BITP_EFULL;
+    }
+
+    size_t last = inst->capacity - pattern->n_bits;
+    size_t pos = bitp_search_(pattern, inst->buf, inst->iter, last, isa);
+
+    if (pos == BITP_SEARCH_NPOS) {
+        // nothing left to examine, the tail is shorter than the pattern
+        inst->iter = last + 1;
+        return BITP_EFULL;
+    }
+
+    inst->iter = pos;
+    return BITP_OK;
+}
+
+inline bitp_status_t bitp_parser_find(bitp_parser_t *inst, const bitp_pattern_t *pattern) {
+    return bitp_parser_find_isa(inst, pattern, BITP_ISA_NATIVE);
+}
+
+inline size_t bitp_parser_find_all(const bitp_parser_t *inst,
+                                   const bitp_pattern_t *pattern,
+                                   bitp_parser_t *matches,
+                                   size_t max_matches) {
+    bitp_parser_t cursor = *inst;
+    size_t n_matches = 0;
+
+    while (n_matches < max_matches && bitp_parser_find(&cursor, pattern) == BITP_OK) {
+        matches[n_matches++] = cursor;
+        cursor.iter++;
+    }
+
+    return n_matches;
+}
+
+#endif /* INCLUDE_BITP_SEARCH_H_ */
@@ -0,0 +1,75 @@
+/*
+ * shm.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#ifndef INCLUDE_BITP_SHM_H_
+#define INCLUDE_BITP_SHM_H_
+
+#include "packer.h"
+#include "parser.h"
+
+/*
+ * Ring of packed messages in POSIX shared memory between processes, Linux only, compiled bitp_shm
+ * library. A producer packs straight into a slot of the ring and the consumer parses it in place,
+ * nothing is copied. Every message is a record with a header whose sequence word is stored last
+ * on commit, so the consumer sees whole messages only, in reservation order. Producers take
+ * space with the reserve counter, the consumer gives it back with the head counter, each on a
+ * cache line of its own. The consumer frees a batch of messages with one store and zeroes it
+ * first, for the headers and for the packer; a producer reads the head again only when the ring
+ * looks full.
+ */
+
+/* bytes past the data of the ring the parser may read */
+#define BITP_SHM_PADDING 64
+
+typedef enum bitp_shm_mode_tag {
+    // one producer, the reserve counter is a plain store
+    BITP_SHM_SPSC = 0,
+    // several producers, in one or several processes, reserve with compare-and-swap
+    BITP_SHM_MPSC,
+} bitp_shm_mode_t;
+
+/* a mapping of the ring in this process, used by one thread */
+typedef struct bitp_shm_tag bitp_shm_t;
+
+/*
+ * Creates the shared memory object name ("/name") with a ring of capacity bytes, a power of 2
+ * from 4096 to 2^28, and maps it. BITP_EINVALID_ARG if the capacity is out of range or the object
+ * can't be created or mapped, errno tells why (EEXIST if the name is taken).
+ */
+bitp_status_t bitp_shm_create(bitp_shm_t **res, const char *name, size_t capacity, bitp_shm_mode_t mode);
+
+/* maps a ring created by bitp_shm_create, in this or another process; BITP_EINVALID_ARG as above */
+bitp_status_t bitp_shm_open(bitp_shm_t **res, const char *name);
+
+/* unmaps the ring, the object stays until bitp_shm_unlink */
+void bitp_shm_close(bitp_shm_t *inst);
+
+bitp_status_t bitp_shm_unlink(const char *name);
+
+/* the longest message in bits */
+size_t bitp_shm_max_bits(const bitp_shm_t *inst);
+
+/*
+ * Reserves a slot for up to n_bits and points res at it, zeroed for bitp_packer_add_*. BITP_EFULL
+ * if the ring has no room until the consumer frees some, BITP_EINVALID_ARG if n_bits is over
+ * bitp_shm_max_bits. Slots reserved and not committed hold back the messages after them.
+ */
+bitp_status_t bitp_shm_reserve(bitp_shm_t *inst, size_t n_bits, bitp_packer_t *res);
+
+/* publishes the message of a reserved slot, res->iter bits long */
+void bitp_shm_commit(bitp_shm_t *inst, const bitp_packer_t *res);
+
+/*
+ * The next committed message for the consumer, res covers it with BITP_SHM_PADDING bytes readable
+ * past it. BITP_EAGAIN if there's none yet. The messages stay valid until bitp_shm_release.
+ */
+bitp_status_t bitp_shm_next(bitp_shm_t *inst, bitp_parser_t *res);
+
+/* frees the slots of every message returned by bitp_shm_next so far */
+void bitp_shm_release(bitp_shm_t *inst);
+
+#endif /* INCLUDE_BITP_SHM_H_ */
@@ -0,0 +1,118 @@
+/*
+ * stream.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#ifndef INCLUDE_BITP_STREAM_H_
+#define INCLUDE_BITP_STREAM_H_
+
+#include "parser.h"
+
+/* bytes past the appended data the parser may read (two aligned 64-bit words) */
+#define BITP_STREAM_PADDING 16
+
+/*
+ * Incremental parsing of a byte stream. Data is appended as it arrives, a decode routine reads it
+ * with the usual bitp_parser_* calls on inst->parser and is a resumable state machine:
+ *
+ *     bitp_status_t decode(bitp_stream_t *s, msg_t *msg) {
+ *         BITP_STREAM_BEGIN(s);
+ *         BITP_STREAM_NEED(s, 8);
+ *         bitp_parser_extract_u8(&s->parser, &msg->len, 8);
+ *         BITP_STREAM_NEED(s, msg->len * 8);
+ *         ...
+ *         BITP_STREAM_END(s);
+ *     }
+ *
+ * BITP_STREAM_NEED returns BITP_EAGAIN if fewer bits are available, the next call after
+ * bitp_stream_append continues from that point, so decoded bits are never parsed again. Local
+ * variables don't survive the return, keep the state in the output or the stream context.
+ * At most one BITP_STREAM_NEED per source line.
+ */
+typedef struct bitp_stream_tag {
+    // capacity is the appended data, iter the first bit not consumed
+    bitp_parser_t parser;
+    char *buf;
+    size_t size;
+    // resume point of the decode routine, 0 to start a message
+    int state;
+} bitp_stream_t;
+
+void bitp_stream_init(bitp_stream_t *inst, char *buf, size_t size);
+
+bitp_status_t bitp_stream_append(bitp_stream_t *inst, const void *data, size_t n_bytes);
+
+size_t bitp_stream_available(const bitp_stream_t *inst);
+
+#if (defined(__GNUC__) && __GNUC__ >= 7) || defined(__clang__)
+#define BITP_FALLTHROUGH_ __attribute__((fallthrough))
+#else
+#define BITP_FALLTHROUGH_
+#endif
+
+#define BITP_STREAM_BEGIN(inst_) \
+    switch ((inst_)->state) {    \
+    case 0:
+
+#define BITP_STREAM_NEED(inst_, n_bits_)                     \
+    do {                                                     \
+        (inst_)->state = __LINE__;                           \
+        BITP_FALLTHROUGH_;                                   \
+    case __LINE__:                                           \
+        if (bitp_stream_available(inst_) < (size_t)(n_bits_)) \
+            return BITP_EAGAIN;                              \
+    } while (0)
+
+/* returns BITP_OK, the next call starts a new message */
+#define BITP_STREAM_END(inst_) \
+    }                          \
+    (inst_)->state = 0;        \
+    return BITP_OK
+
+/* returns an error, the next call starts a new message */
+#define BITP_STREAM_FAIL(inst_, status_) \
+    do {                                 \
+        (inst_)->state = 0;              \
+        return (status_);                \
+    } while (0)
+
+/*
+ **************************************************************************************************
+  Realization
+ **************************************************************************************************
+ */
+
+inline void bitp_stream_init(bitp_stream_t *inst, char *buf, size_t size) {
+    bitp_parser_init(&inst->parser, buf, 0);
+    inst->buf = buf;
+    inst->size = size;
+    inst->state = 0;
+}
+
+inline size_t bitp_stream_available(const bitp_stream_t *inst) {
+    return inst->parser.capacity - inst->parser.iter;
+}
+
+/* consumed whole bytes are dropped when the data doesn't fit otherwise */
+inline bitp_status_t bitp_stream_append(bitp_stream_t *inst, const void *data, size_t n_bytes) {
+    size_t len = inst->parser.capacity / CHAR_BIT;
+    size_t room = inst->size < BITP_STREAM_PADDING ? 0 : inst->size - BITP_STREAM_PADDING;
+
+    if (room - len < n_bytes) {
+        size_t consumed = inst->parser.iter / CHAR_BIT;
+        if (room - len + consumed < n_bytes) {
+            return BITP_EFULL;
+        }
+        memmove(inst->buf, inst->buf + consumed, len - consumed);
+        len -= consumed;
+        inst->parser.iter -= consumed * CHAR_BIT;
+    }
+
+    memcpy(inst->buf + len, data, n_bytes);
+    inst->parser.capacity = (len + n_bytes) * CHAR_BIT;
+    return BITP_OK;
+}
+
+#endif /* INCLUDE_BITP_STREAM_H_ */
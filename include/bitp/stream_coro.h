@@ -0,0 +1,115 @@
+/*
+ * stream_coro.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#ifndef INCLUDE_BITP_STREAM_CORO_H_
+#define INCLUDE_BITP_STREAM_CORO_H_
+
+/*
+ * C++20 coroutine form of bitp/stream.h, locals survive the suspension:
+ *
+ *     bitp_stream_task decode(bitp_stream_t *s, msg_t *msg) {
+ *         co_await bitp_stream_need(s, 8);
+ *         uint8_t len;
+ *         bitp_parser_extract_u8(&s->parser, &len, 8);
+ *         co_await bitp_stream_need(s, len * 8);
+ *         ...
+ *         co_return BITP_OK;
+ *     }
+ *
+ *     bitp_stream_task task = decode(&stream, &msg);
+ *     while (task.status() == BITP_EAGAIN) {
+ *         bitp_stream_append(&stream, ...);
+ *         task.resume();
+ *     }
+ *
+ * The coroutine runs until the first missing input right away. Include outside extern "C".
+ */
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define BITP_STREAM_CORO 1
+
+#include <coroutine>
+#include <exception>
+
+#include "stream.h"
+
+class bitp_stream_task {
+  public:
+    struct promise_type {
+        bitp_status_t status = BITP_EAGAIN;
+        const bitp_stream_t *stream = nullptr;
+        size_t need = 0;
+
+        bitp_stream_task get_return_object() {
+            return bitp_stream_task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_never initial_suspend() noexcept {
+            return {};
+        }
+        std::suspend_always final_suspend() noexcept {
+            return {};
+        }
+        void return_value(bitp_status_t res) {
+            status = res;
+        }
+        void unhandled_exception() {
+            std::terminate();
+        }
+    };
+
+    explicit bitp_stream_task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+    bitp_stream_task(bitp_stream_task &&other) noexcept : handle_(other.handle_) {
+        other.handle_ = nullptr;
+    }
+    bitp_stream_task(const bitp_stream_task &) = delete;
+    bitp_stream_task &operator=(const bitp_stream_task &) = delete;
+    ~bitp_stream_task() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    /* BITP_EAGAIN while the coroutine waits for input, then the value of co_return */
+    bitp_status_t status() const {
+        return handle_.promise().status;
+    }
+
+    /* continues if the awaited bits are available, returns status() */
+    bitp_status_t resume() {
+        promise_type &p = handle_.promise();
+        if (!handle_.done() && bitp_stream_available(p.stream) >= p.need) {
+            handle_.resume();
+        }
+        return p.status;
+    }
+
+  private:
+    std::coroutine_handle<promise_type> handle_;
+};
+
+/* co_await bitp_stream_need(s, n_bits) suspends until n_bits are available */
+struct bitp_stream_need {
+    const bitp_stream_t *stream;
+    size_t n_bits;
+
+    bitp_stream_need(const bitp_stream_t *s, size_t n) : stream(s), n_bits(n) {}
+
+    bool await_ready() const noexcept {
+        return bitp_stream_available(stream) >= n_bits;
+    }
+    void await_suspend(std::coroutine_handle<bitp_stream_task::promise_type> handle) const noexcept {
+        handle.promise().stream = stream;
+        handle.promise().need = n_bits;
+    }
+    void await_resume() const noexcept {}
+};
+
+#endif
+#endif
+
+#endif /* INCLUDE_BITP_STREAM_CORO_H_ */
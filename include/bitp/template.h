@@ -0,0 +1,101 @@
+/*
+ * template.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#ifndef INCLUDE_BITP_TEMPLATE_H_
+#define INCLUDE_BITP_TEMPLATE_H_
+
+#include "packer.h"
+
+#define BITP_TEMPLATE_MAX_FIELDS 32
+
+typedef struct bitp_template_tag {
+    // packs the template, the message size is packer.iter
+    bitp_packer_t packer;
+    size_t offsets[BITP_TEMPLATE_MAX_FIELDS];
+    uint8_t widths[BITP_TEMPLATE_MAX_FIELDS];
+    unsigned n_fields;
+} bitp_template_t;
+
+void bitp_template_init(bitp_template_t *inst, char *buf, size_t buf_len_bits);
+
+bitp_status_t bitp_template_add_var(bitp_template_t *inst, uint64_t val, size_t n_bits, unsigned *field);
+
+size_t bitp_template_size(const bitp_template_t *inst);
+
+bitp_status_t bitp_template_set(const bitp_template_t *inst, char *msg, unsigned field, uint64_t val);
+
+bitp_status_t bitp_template_instance(const bitp_template_t *inst, char *msg, const uint64_t *vals);
+
+/*
+ **************************************************************************************************
+  Realization
+ **************************************************************************************************
+ */
+
+inline void bitp_template_init(bitp_template_t *inst, char *buf, size_t buf_len_bits) {
+    bitp_packer_init(&inst->packer, buf, buf_len_bits, 1);
+    inst->n_fields = 0;
+}
+
+inline bitp_status_t bitp_template_add_var(bitp_template_t *inst, uint64_t val, size_t n_bits, unsigned *field) {
+    if (inst->n_fields == BITP_TEMPLATE_MAX_FIELDS || n_bits == 0 || n_bits > 64) {
+        return BITP_EINVALID_ARG;
+    }
+
+    size_t offset = inst->packer.iter;
+    bitp_status_t status = bitp_packer_add_u64(&inst->packer, val, n_bits);
+    if (status != BITP_OK) {
+        return status;
+    }
+
+    inst->offsets[inst->n_fields] = offset;
+    inst->widths[inst->n_fields] = (uint8_t)n_bits;
+    if (field) {
+        *field = inst->n_fields;
+    }
+    inst->n_fields++;
+
+    return BITP_OK;
+}
+
+/* bytes of a message */
+inline size_t bitp_template_size(const bitp_template_t *inst) {
+    return (inst->packer.iter + CHAR_BIT - 1) / CHAR_BIT;
+}
+
+inline bitp_status_t bitp_template_set(const bitp_template_t *inst, char *msg, unsigned field, uint64_t val) {
+#if BITP_CHECK_PARAM
+    if (field >= inst->n_fields) {
+        return BITP_EINVALID_ARG;
+    }
+#endif
+    unsigned n_bits = inst->widths[field];
+    BITP_CHECK_PARAM_RANGE(val, n_bits, 0);
+
+    bitp_write_bits_64(msg, inst->packer.iter, inst->offsets[field], val << (64 - n_bits), n_bits);
+
+    return BITP_OK;
+}
+
+/* copies the template into msg and sets all variable fields, vals[i] goes to field i */
+inline bitp_status_t bitp_template_instance(const bitp_template_t *inst, char *msg, const uint64_t *vals) {
+#if BITP_CHECK_RANGE
+    for (unsigned i = 0; i < inst->n_fields; ++i) {
+        BITP_CHECK_PARAM_RANGE(vals[i], inst->widths[i], 0);
+    }
+#endif
+
+    memcpy(msg, inst->packer.buf, bitp_template_size(inst));
+    for (unsigned i = 0; i < inst->n_fields; ++i) {
+        unsigned n_bits = inst->widths[i];
+        bitp_write_bits_64(msg, inst->packer.iter, inst->offsets[i], vals[i] << (64 - n_bits), n_bits);
+    }
+
+    return BITP_OK;
+}
+
+#endif /* INCLUDE_BITP_TEMPLATE_H_ */
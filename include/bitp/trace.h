@@ -0,0 +1,64 @@
+/*
+ * trace.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#ifndef INCLUDE_BITP_TRACE_H_
+#define INCLUDE_BITP_TRACE_H_
+
+#include <stdio.h>
+
+#include "types.h"
+
+/*
+ * Opt-in tracing of decoders, compiled bitp_trace library. A decoder tags regions of a message,
+ * a message type and the fields in it, nested:
+ *
+ *     BITP_TRACE_BEGIN(&parser, "SIB2");
+ *     BITP_TRACE_FIELD(&parser, "ac-BarringInfo", s = decode_barring(&parser, &sib->barring));
+ *     ...
+ *     BITP_TRACE_END(&parser, "SIB2");
+ *
+ * With BITP_TRACE defined, a tag records the time stamp counter, the parser's position and the
+ * name into a ring of the calling thread, without locks; the oldest events are overwritten.
+ * bitp_trace_dump writes the events for bitp_tracereport, which prints latency histograms per
+ * message type (the outermost regions) and the cost of every field in them. Without BITP_TRACE
+ * the tags are compiled out, their arguments aren't evaluated. name must be a string literal or
+ * live until the dump; names are told apart by content, not address.
+ */
+
+#ifdef BITP_TRACE
+#define BITP_TRACE_BEGIN(parser, name) bitp_trace_record((name), (parser)->iter, 0)
+#define BITP_TRACE_END(parser, name) bitp_trace_record((name), (parser)->iter, 1)
+#else
+#define BITP_TRACE_BEGIN(parser, name) ((void)0)
+#define BITP_TRACE_END(parser, name) ((void)0)
+#endif
+
+/* stmt in a region of its own */
+#define BITP_TRACE_FIELD(parser, name, stmt) \
+    do {                                     \
+        BITP_TRACE_BEGIN(parser, name);      \
+        stmt;                                \
+        BITP_TRACE_END(parser, name);        \
+    } while (0)
+
+/*
+ * Ring size in events, rounded up to a power of 2 (65536 by default), for the threads that record
+ * after the call. A dump has the last size - 1 events of a thread, the oldest slot may be being
+ * written over.
+ */
+void bitp_trace_init(size_t events_per_thread);
+
+/* a region of name begins (end 0) or ends (end 1) at bit_off */
+void bitp_trace_record(const char *name, size_t bit_off, int end);
+
+/* writes the events of every thread to f, text; BITP_EINVALID_ARG if the write fails */
+bitp_status_t bitp_trace_dump(FILE *f);
+
+/* drops the events recorded so far, the threads may go on recording */
+void bitp_trace_clear(void);
+
+#endif /* INCLUDE_BITP_TRACE_H_ */
@@ -8,6 +8,7 @@
 #ifndef INCLUDE_BITP_TYPES_H_
 #define INCLUDE_BITP_TYPES_H_
 
+#include <assert.h>
 #include <string.h>
 #include <limits.h>
 #include <stdint.h>
@@ -88,6 +89,134 @@
 
 #endif    // __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
 
+#if defined(__GNUC__) || defined(__clang__)
+
+#define bitp_popcount_64(x) ((unsigned)__builtin_popcountll(x))
+#define bitp_ctz_64(x) ((unsigned)__builtin_ctzll(x))
+#define bitp_clz_64(x) ((unsigned)__builtin_clzll(x))
+
+#else
+
+inline unsigned bitp_popcount_64(uint64_t x) {
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (unsigned)((x * 0x0101010101010101ULL) >> 56);
+}
+
+inline unsigned bitp_ctz_64(uint64_t x) {
+    unsigned n = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        n++;
+    }
+    return n;
+}
+
+inline unsigned bitp_clz_64(uint64_t x) {
+    unsigned n = 0;
+    while (!(x & 0x8000000000000000ULL)) {
+        x <<= 1;
+        n++;
+    }
+    return n;
+}
+
+#endif
+
+/* unaligned big-endian load, MSB of the first byte becomes MSB of the result */
+inline uint64_t bitp_load_be_64(const char *p) {
+    uint64_t res;
+    memcpy(&res, p, sizeof(res));
+    return bitp_ntoh_64(res);
+}
+
+inline void bitp_store_be_64(char *p, uint64_t val) {
+    val = bitp_ntoh_64(val);
+    memcpy(p, &val, sizeof(val));
+}
+
+/* 64 bits starting at bit_off, MSB-aligned; bits past buf_len_bits rounded up to bytes read as zeros */
+inline uint64_t bitp_read_bits_64(const char *buf, size_t buf_len_bits, size_t bit_off) {
+    size_t n_bytes = (buf_len_bits + CHAR_BIT - 1) / CHAR_BIT;
+    size_t b = bit_off / CHAR_BIT;
+    unsigned p = bit_off % CHAR_BIT;
+    char tmp[sizeof(uint64_t) + 1] = {0};
+
+    if (b + sizeof(tmp) > n_bytes) {
+        memcpy(tmp, buf + b, n_bytes - b);
+        buf = tmp;
+        b = 0;
+    }
+
+    uint64_t res = bitp_load_be_64(buf + b);
+    if (p) {
+        res = (res << p) | ((uint8_t)buf[b + sizeof(uint64_t)] >> (CHAR_BIT - p));
+    }
+    return res;
+}
+
+/* ORs n_bits most significant bits of val (the rest must be zero) into buf at bit_off */
+inline void bitp_or_bits_64(char *buf, size_t buf_len_bits, size_t bit_off, uint64_t val, unsigned n_bits) {
+    size_t n_bytes = (buf_len_bits + CHAR_BIT - 1) / CHAR_BIT;
+    size_t b = bit_off / CHAR_BIT;
+    unsigned p = bit_off % CHAR_BIT;
+
+    if (n_bits == 0) {
+        return;
+    }
+    if (b + sizeof(uint64_t) + 1 <= n_bytes) {
+        bitp_store_be_64(buf + b, bitp_load_be_64(buf + b) | (val >> p));
+        if (p) {
+            buf[b + sizeof(uint64_t)] |= (char)(uint8_t)(val << (CHAR_BIT - p));
+        }
+        return;
+    }
+
+    size_t end = b + (p + n_bits + CHAR_BIT - 1) / CHAR_BIT;
+    buf[b++] |= (char)(uint8_t)(val >> (56 + p));
+    val <<= CHAR_BIT - p;
+    for (; b < end; ++b) {
+        buf[b] |= (char)(uint8_t)(val >> 56);
+        val <<= CHAR_BIT;
+    }
+}
+
+/* overwrites n_bits at bit_off with the most significant bits of val, the rest of buf is kept */
+inline void bitp_write_bits_64(char *buf, size_t buf_len_bits, size_t bit_off, uint64_t val, unsigned n_bits) {
+    size_t n_bytes = (buf_len_bits + CHAR_BIT - 1) / CHAR_BIT;
+    size_t b = bit_off / CHAR_BIT;
+    unsigned p = bit_off % CHAR_BIT;
+
+    if (n_bits == 0) {
+        return;
+    }
+    uint64_t mask = 0xFFFFFFFFFFFFFFFFULL << (64 - n_bits);
+    val &= mask;
+
+    if (b + sizeof(uint64_t) + 1 <= n_bytes) {
+        bitp_store_be_64(buf + b, (bitp_load_be_64(buf + b) & ~(mask >> p)) | (val >> p));
+        if (p) {
+            uint8_t m = (uint8_t)(mask << (CHAR_BIT - p));
+            buf[b + sizeof(uint64_t)] = (char)(((uint8_t)buf[b + sizeof(uint64_t)] & ~m) |
+                                               (uint8_t)(val << (CHAR_BIT - p)));
+        }
+        return;
+    }
+
+    size_t end = b + (p + n_bits + CHAR_BIT - 1) / CHAR_BIT;
+    uint8_t m = (uint8_t)(mask >> (56 + p));
+    buf[b] = (char)(((uint8_t)buf[b] & ~m) | (uint8_t)(val >> (56 + p)));
+    mask <<= CHAR_BIT - p;
+    val <<= CHAR_BIT - p;
+    for (++b; b < end; ++b) {
+        m = (uint8_t)(mask >> 56);
+        buf[b] = (char)(((uint8_t)buf[b] & ~m) | (uint8_t)(val >> 56));
+        mask <<= CHAR_BIT;
+        val <<= CHAR_BIT;
+    }
+}
+
 #ifdef BITP_CHECK_ALL
 #define BITP_CHECK_BUFFER_BOUNDARY 1
 #define BITP_CHECK_PARAM 1
@@ -106,7 +235,8 @@
 #define BITP_CHECK_RANGE 0
 #endif
 
-typedef enum bin_parser_status_tag { BITP_OK = 0, BITP_EFULL, BITP_EINVALID_ARG } bitp_status_t;
+/* BITP_EAGAIN: a resumable decode (bitp/stream.h) needs more input */
+typedef enum bin_parser_status_tag { BITP_OK = 0, BITP_EFULL, BITP_EINVALID_ARG, BITP_EAGAIN } bitp_status_t;
 
 #if CHAR_BIT != 8
 #error "unsupported char size"
@@ -153,4 +283,20 @@ typedef enum bin_parser_status_tag { BITP_OK = 0, BITP_EFULL, BITP_EINVALID_ARG
     } while (0)
 #endif
 
+/* 1 if val fits into n_bits, val of a signed type is passed sign-extended */
+inline int bitp_in_range_(uint64_t val, size_t n_bits, int is_signed) {
+    if (n_bits >= 64) {
+        return 1;
+    }
+    if (is_signed) {
+        uint64_t high = (uint64_t)((int64_t)val >> (n_bits - 1));
+        return high == 0 || high == 0xFFFFFFFFFFFFFFFFULL;
+    }
+    return (val >> n_bits) == 0;
+}
+
+/* the reserved API isn't checked at runtime, misuse is caught by assert in debug builds */
+#define BITP_ASSERT_RESERVED(end_, iter_, n_bits_, type_) \
+    assert((n_bits_) <= 8 * sizeof(type_) && (end_) - (iter_) >= (n_bits_))
+
 #endif /* INCLUDE_BITP_TYPES_H_ */
@@ -0,0 +1,109 @@
+/*
+ * view.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#ifndef INCLUDE_BITP_VIEW_H_
+#define INCLUDE_BITP_VIEW_H_
+
+#include "parser.h"
+
+/*
+ * Immutable bit range of a shared buffer. A view is never written, so any number of threads may
+ * slice it and read it at once; each reader gets its own cursor, a parser positioned inside the
+ * view. Views keep the pointer of the whole buffer and slice by bit offsets, which is O(1) and
+ * keeps the parser's reads past a range inside the buffer and its padding.
+ */
+
+typedef struct bitp_view_tag {
+    const char *buf;
+    // bit range [begin, end) of buf
+    size_t begin;
+    size_t end;
+} bitp_view_t;
+
+void bitp_view_init(bitp_view_t *inst, const char *buf, size_t buf_len_bits);
+
+size_t bitp_view_len(const bitp_view_t *inst);
+
+/* n_bits from offset within the view, BITP_EFULL if they aren't all inside it */
+bitp_status_t bitp_view_slice(const bitp_view_t *inst, size_t offset, size_t n_bits, bitp_view_t *res);
+
+/*
+ * Part i of n of a view of whole records of record_bits, the records are shared out as evenly
+ * as possible, for decoding one buffer on n threads. BITP_EINVALID_ARG if i >= n or record_bits
+ * is 0; trailing bits that don't make a record go to no part.
+ */
+bitp_status_t bitp_view_split(const bitp_view_t *inst, size_t record_bits, size_t n, size_t i, bitp_view_t *res);
+
+/* a cursor over the view: a parser that starts at its first bit and ends at its last */
+void bitp_view_cursor(const bitp_view_t *inst, bitp_parser_t *res);
+
+/* the next n_bits of a cursor as a view, the cursor is moved past them; BITP_EFULL if too few */
+bitp_status_t bitp_parser_take_view(bitp_parser_t *inst, size_t n_bits, bitp_view_t *res);
+
+/*
+ **************************************************************************************************
+  Realization
+ **************************************************************************************************
+ */
+
+inline void bitp_view_init(bitp_view_t *inst, const char *buf, size_t buf_len_bits) {
+    inst->buf = buf;
+    inst->begin = 0;
+    inst->end = buf_len_bits;
+}
+
+inline size_t bitp_view_len(const bitp_view_t *inst) {
+    return inst->end - inst->begin;
+}
+
+inline bitp_status_t bitp_view_slice(const bitp_view_t *inst, size_t offset, size_t n_bits, bitp_view_t *res) {
+    size_t len = inst->end - inst->begin;
+
+    if (offset > len || len - offset < n_bits) {
+        return BITP_EFULL;
+    }
+    res->buf = inst->buf;
+    res->begin = inst->begin + offset;
+    res->end = res->begin + n_bits;
+    return BITP_OK;
+}
+
+inline bitp_status_t bitp_view_split(const bitp_view_t *inst, size_t record_bits, size_t n, size_t i, bitp_view_t *res) {
+    if (record_bits == 0 || i >= n) {
+        return BITP_EINVALID_ARG;
+    }
+    size_t n_records = (inst->end - inst->begin) / record_bits;
+    // the first n_records % n parts get one record more
+    size_t per_part = n_records / n;
+    size_t extra = n_records % n;
+    size_t first = i * per_part + (i < extra ? i : extra);
+    size_t count = per_part + (i < extra);
+
+    res->buf = inst->buf;
+    res->begin = inst->begin + first * record_bits;
+    res->end = res->begin + count * record_bits;
+    return BITP_OK;
+}
+
+inline void bitp_view_cursor(const bitp_view_t *inst, bitp_parser_t *res) {
+    res->buf = inst->buf;
+    res->capacity = inst->end;
+    res->iter = inst->begin;
+}
+
+inline bitp_status_t bitp_parser_take_view(bitp_parser_t *inst, size_t n_bits, bitp_view_t *res) {
+    if (inst->iter > inst->capacity || inst->capacity - inst->iter < n_bits) {
+        return BITP_EFULL;
+    }
+    res->buf = inst->buf;
+    res->begin = inst->iter;
+    res->end = inst->iter + n_bits;
+    inst->iter += n_bits;
+    return BITP_OK;
+}
+
+#endif /* INCLUDE_BITP_VIEW_H_ */
@@ -0,0 +1,188 @@
+/*
+ * batch.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include "bitp/batch.h"
+}
+
+// fewer messages per thread aren't worth a thread
+static const size_t bitp_batch_min_chunk_ = 256;
+
+namespace {
+
+struct bitp_batch_job_ {
+    const bitp_batch_t *batch;
+    const char *msgs;
+    size_t msg_stride;
+    // messages of chunk c are [first[c], first[c + 1]), its bits start at base[c]
+    std::vector<size_t> first;
+    std::vector<size_t> base;
+    size_t *offsets;
+    bitp_packer_t dst;
+    std::atomic<int> status;
+
+    void fail(bitp_status_t s) {
+        int expected = BITP_OK;
+        status.compare_exchange_strong(expected, (int)s);
+    }
+
+    const void *msg(size_t i) const {
+        return msgs + i * msg_stride;
+    }
+
+    // bit length of chunk c into base[c + 1], message lengths into offsets[i + 1]
+    void measure(size_t c) {
+        std::vector<char> scratch;
+        if (!batch->size) {
+            scratch.resize((batch->max_msg_bits + CHAR_BIT - 1) / CHAR_BIT);
+        }
+
+        size_t total = 0;
+        for (size_t i = first[c]; i < first[c + 1]; ++i) {
+            size_t n_bits;
+            if (batch->size) {
+                n_bits = batch->size(msg(i), batch->ctx);
+            }
+            else {
+                bitp_packer_t dry;
+                bitp_packer_init(&dry, scratch.data(), batch->max_msg_bits, 1);
+                bitp_status_t s = batch->pack(&dry, msg(i), batch->ctx);
+                if (s != BITP_OK) {
+                    fail(s);
+                    return;
+                }
+                n_bits = dry.iter;
+            }
+            if (offsets) {
+                offsets[i + 1] = n_bits;
+            }
+            total += n_bits;
+        }
+        base[c + 1] = total;
+    }
+
+    void pack(size_t c) {
+        // the packer can't go past the chunk into the bytes of a concurrent one
+        bitp_packer_t packer = dst;
+        packer.iter = base[c];
+        packer.capacity = base[c + 1];
+
+        for (size_t i = first[c]; i < first[c + 1]; ++i) {
+            size_t start = packer.iter;
+            bitp_status_t s = batch->pack(&packer, msg(i), batch->ctx);
+            if (s != BITP_OK) {
+                fail(s);
+                return;
+            }
+            if (offsets && packer.iter - start != offsets[i + 1] - offsets[i]) {
+                fail(BITP_EINVALID_ARG);
+                return;
+            }
+        }
+        if (packer.iter != base[c + 1]) {
+            fail(BITP_EINVALID_ARG);
+        }
+    }
+};
+
+// chunks first, first + step, ... below end, spread over n_threads with the caller as one of them
+template <typename Fn>
+void bitp_batch_run_(size_t n_threads, size_t first, size_t step, size_t end, Fn fn) {
+    size_t n = first < end ? (end - first + step - 1) / step : 0;
+    size_t n_workers = n < n_threads ? n : n_threads;
+    auto work = [&](size_t w) {
+        for (size_t k = w; k < n; k += n_workers) {
+            fn(first + k * step);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t w = 1; w < n_workers; ++w) {
+        threads.emplace_back(work, w);
+    }
+    if (n_workers) {
+        work(0);
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+}
+
+}    // namespace
+
+bitp_status_t bitp_batch_pack(const bitp_batch_t *batch,
+                              bitp_packer_t *inst,
+                              const void *msgs,
+                              size_t msg_stride,
+                              size_t n_msgs,
+                              size_t *offsets) {
+    if (!batch->pack || (!batch->size && !batch->max_msg_bits)) {
+        return BITP_EINVALID_ARG;
+    }
+
+    size_t n_threads = batch->n_threads ? batch->n_threads : std::thread::hardware_concurrency();
+    if (n_threads == 0) {
+        n_threads = 1;
+    }
+    // two chunks per thread: the even ones are packed first, then the odd ones, so neighbours
+    // sharing a byte never run at the same time
+    size_t n_chunks = n_msgs / bitp_batch_min_chunk_;
+    if (n_chunks > 2 * n_threads) {
+        n_chunks = 2 * n_threads;
+    }
+    if (n_chunks == 0) {
+        n_chunks = 1;
+    }
+
+    bitp_batch_job_ job;
+    job.batch = batch;
+    job.msgs = (const char *)msgs;
+    job.msg_stride = msg_stride;
+    job.offsets = offsets;
+    job.dst = *inst;
+    job.status = BITP_OK;
+    job.first.resize(n_chunks + 1);
+    job.base.resize(n_chunks + 1);
+    for (size_t c = 0; c <= n_chunks; ++c) {
+        job.first[c] = n_msgs * c / n_chunks;
+    }
+
+    // sizes, then the prefix sum of the chunks and of the messages
+    bitp_batch_run_(n_threads, 0, 1, n_chunks, [&job](size_t c) { job.measure(c); });
+    if (job.status != BITP_OK) {
+        return (bitp_status_t)job.status.load();
+    }
+
+    size_t total = 0;
+    job.base[0] = inst->iter;
+    for (size_t c = 0; c < n_chunks; ++c) {
+        total += job.base[c + 1];
+        job.base[c + 1] = inst->iter + total;
+    }
+    if (inst->iter > inst->capacity || total > inst->capacity - inst->iter) {
+        return BITP_EFULL;
+    }
+    if (offsets) {
+        offsets[0] = inst->iter;
+        for (size_t i = 0; i < n_msgs; ++i) {
+            offsets[i + 1] += offsets[i];
+        }
+    }
+
+    bitp_batch_run_(n_threads, 0, 2, n_chunks, [&job](size_t c) { job.pack(c); });
+    bitp_batch_run_(n_threads, 1, 2, n_chunks, [&job](size_t c) { job.pack(c); });
+    if (job.status != BITP_OK) {
+        return (bitp_status_t)job.status.load();
+    }
+
+    inst->iter += total;
+    return BITP_OK;
+}
@@ -0,0 +1,224 @@
+/*
+ * cache.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+extern "C" {
+#include "bitp/cache.h"
+#include "bitp/hash.h"
+#include "bitp/kernels.h"
+}
+
+static const uint32_t bitp_cache_nil_ = 0xFFFFFFFFu;
+
+namespace {
+
+struct bitp_cache_entry_ {
+    uint64_t hash;
+    size_t n_bits;
+    // LRU list, most recently used first
+    uint32_t prev;
+    uint32_t next;
+    // next entry of the same bucket
+    uint32_t chain;
+};
+
+struct bitp_cache_shard_ {
+    std::mutex lock;
+    std::vector<bitp_cache_entry_> entries;
+    // first entry of every bucket, buckets.size() is a power of 2
+    std::vector<uint32_t> buckets;
+    std::vector<char> values;
+    uint32_t head = bitp_cache_nil_;
+    uint32_t tail = bitp_cache_nil_;
+    uint32_t size = 0;
+    bitp_cache_stats_t stats = {};
+
+    uint32_t &bucket(uint64_t hash) {
+        return buckets[hash & (buckets.size() - 1)];
+    }
+
+    uint32_t find(uint64_t hash, size_t n_bits) const {
+        uint32_t i = buckets[hash & (buckets.size() - 1)];
+        while (i != bitp_cache_nil_ && (entries[i].hash != hash || entries[i].n_bits != n_bits)) {
+            i = entries[i].chain;
+        }
+        return i;
+    }
+
+    void unlink(uint32_t i) {
+        bitp_cache_entry_ &e = entries[i];
+        (e.prev == bitp_cache_nil_ ? head : entries[e.prev].next) = e.next;
+        (e.next == bitp_cache_nil_ ? tail : entries[e.next].prev) = e.prev;
+    }
+
+    void push_front(uint32_t i) {
+        entries[i].prev = bitp_cache_nil_;
+        entries[i].next = head;
+        (head == bitp_cache_nil_ ? tail : entries[head].prev) = i;
+        head = i;
+    }
+
+    void unchain(uint32_t i) {
+        uint32_t *p = &bucket(entries[i].hash);
+        while (*p != i) {
+            p = &entries[*p].chain;
+        }
+        *p = entries[i].chain;
+    }
+
+    void clear() {
+        std::fill(buckets.begin(), buckets.end(), bitp_cache_nil_);
+        head = tail = bitp_cache_nil_;
+        size = 0;
+        stats = bitp_cache_stats_t{};
+    }
+};
+
+}  // namespace
+
+struct bitp_cache_tag {
+    size_t value_size;
+    unsigned shard_mask;
+    std::unique_ptr<bitp_cache_shard_[]> shards;
+
+    bitp_cache_shard_ &shard(uint64_t hash) {
+        // the bucket takes the low bits
+        return shards[(hash >> 40) & shard_mask];
+    }
+};
+
+bitp_cache_t *bitp_cache_create(size_t capacity, size_t value_size, unsigned n_shards) {
+    if (!n_shards) {
+        n_shards = 16;
+    }
+    if ((n_shards & (n_shards - 1)) || n_shards > (1u << 24) || capacity < n_shards || value_size == 0 ||
+        capacity / n_shards >= bitp_cache_nil_) {
+        return NULL;
+    }
+    try {
+        std::unique_ptr<bitp_cache_t> inst(new bitp_cache_t);
+        inst->value_size = value_size;
+        inst->shard_mask = n_shards - 1;
+        inst->shards.reset(new bitp_cache_shard_[n_shards]);
+        size_t per_shard = (capacity + n_shards - 1) / n_shards;
+        size_t n_buckets = 1;
+        while (n_buckets < 2 * per_shard) {
+            n_buckets *= 2;
+        }
+        for (unsigned s = 0; s < n_shards; ++s) {
+            bitp_cache_shard_ &shard = inst->shards[s];
+            shard.entries.resize(per_shard);
+            shard.buckets.assign(n_buckets, bitp_cache_nil_);
+            shard.values.resize(per_shard * value_size);
+        }
+        return inst.release();
+    }
+    catch (const std::bad_alloc &) {
+        return NULL;
+    }
+}
+
+void bitp_cache_destroy(bitp_cache_t *inst) {
+    delete inst;
+}
+
+int bitp_cache_get(bitp_cache_t *inst, uint64_t hash, size_t n_bits, void *res) {
+    bitp_cache_shard_ &shard = inst->shard(hash);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    uint32_t i = shard.find(hash, n_bits);
+    if (i == bitp_cache_nil_) {
+        shard.stats.misses++;
+        return 0;
+    }
+    shard.stats.hits++;
+    if (shard.head != i) {
+        shard.unlink(i);
+        shard.push_front(i);
+    }
+    memcpy(res, &shard.values[i * inst->value_size], inst->value_size);
+    return 1;
+}
+
+void bitp_cache_put(bitp_cache_t *inst, uint64_t hash, size_t n_bits, const void *value) {
+    bitp_cache_shard_ &shard = inst->shard(hash);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    uint32_t i = shard.find(hash, n_bits);
+    if (i != bitp_cache_nil_) {
+        // another thread decoded the same payload first
+        shard.unlink(i);
+    }
+    else {
+        if (shard.size < shard.entries.size()) {
+            i = shard.size++;
+        }
+        else {
+            i = shard.tail;
+            shard.unlink(i);
+            shard.unchain(i);
+            shard.stats.evictions++;
+        }
+        shard.entries[i].hash = hash;
+        shard.entries[i].n_bits = n_bits;
+        shard.entries[i].chain = shard.bucket(hash);
+        shard.bucket(hash) = i;
+        shard.stats.inserts++;
+    }
+    shard.push_front(i);
+    memcpy(&shard.values[i * inst->value_size], value, inst->value_size);
+}
+
+bitp_status_t bitp_cache_decode(bitp_cache_t *inst,
+                                bitp_parser_t *parser,
+                                size_t n_bits,
+                                bitp_cache_decode_fn_t decode,
+                                void *ctx,
+                                void *res) {
+    if (parser->iter > parser->capacity || parser->capacity - parser->iter < n_bits) {
+        return BITP_EFULL;
+    }
+    uint64_t hash = bitp_hash_bits_isa(parser->buf, parser->iter, n_bits, bitp_kernels_isa());
+    if (bitp_cache_get(inst, hash, n_bits, res)) {
+        parser->iter += n_bits;
+        return BITP_OK;
+    }
+
+    bitp_parser_t msg = *parser;
+    msg.capacity = parser->iter + n_bits;
+    bitp_status_t status = decode(&msg, res, ctx);
+    if (status != BITP_OK) {
+        return status;
+    }
+    bitp_cache_put(inst, hash, n_bits, res);
+    parser->iter += n_bits;
+    return BITP_OK;
+}
+
+void bitp_cache_stats(bitp_cache_t *inst, bitp_cache_stats_t *res) {
+    *res = bitp_cache_stats_t{};
+    for (unsigned s = 0; s <= inst->shard_mask; ++s) {
+        bitp_cache_shard_ &shard = inst->shards[s];
+        std::lock_guard<std::mutex> guard(shard.lock);
+        res->hits += shard.stats.hits;
+        res->misses += shard.stats.misses;
+        res->inserts += shard.stats.inserts;
+        res->evictions += shard.stats.evictions;
+    }
+}
+
+void bitp_cache_clear(bitp_cache_t *inst) {
+    for (unsigned s = 0; s <= inst->shard_mask; ++s) {
+        bitp_cache_shard_ &shard = inst->shards[s];
+        std::lock_guard<std::mutex> guard(shard.lock);
+        shard.clear();
+    }
+}
@@ -0,0 +1,459 @@
+/*
+ * ingest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <vector>
+
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define BITP_INGEST_HAVE_URING_ 1
+#endif
+#endif
+
+#ifndef BITP_INGEST_HAVE_URING_
+#define BITP_INGEST_HAVE_URING_ 0
+#endif
+
+extern "C" {
+#include "bitp/ingest.h"
+}
+
+static const size_t bitp_ingest_page_ = 4096;
+
+namespace {
+
+enum bitp_ingest_slot_state_ { SLOT_FREE, SLOT_READING, SLOT_DONE, SLOT_HELD };
+
+struct bitp_ingest_slot_ {
+    bitp_ingest_slot_state_ state;
+    uint64_t offset;
+    // bytes read so far and bytes expected before the end of the file
+    size_t got;
+    size_t want;
+    int error;
+};
+
+#if BITP_INGEST_HAVE_URING_
+/* the kernel ABI without liburing, the rings are shared with the kernel */
+struct bitp_ingest_ring_ {
+    int fd = -1;
+    void *sq_ptr = MAP_FAILED;
+    size_t sq_size = 0;
+    void *cq_ptr = MAP_FAILED;
+    size_t cq_size = 0;
+    io_uring_sqe *sqes = (io_uring_sqe *)MAP_FAILED;
+    size_t sqes_size = 0;
+
+    unsigned *sq_tail;
+    unsigned *sq_mask;
+    unsigned *sq_array;
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned *cq_mask;
+    io_uring_cqe *cqes;
+
+    unsigned local_tail = 0;
+    unsigned to_submit = 0;
+    bool fixed = false;
+
+    ~bitp_ingest_ring_() {
+        if (sqes != MAP_FAILED) {
+            munmap(sqes, sqes_size);
+        }
+        if (cq_ptr != MAP_FAILED && cq_ptr != sq_ptr) {
+            munmap(cq_ptr, cq_size);
+        }
+        if (sq_ptr != MAP_FAILED) {
+            munmap(sq_ptr, sq_size);
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    // 0 or errno
+    int setup(unsigned entries) {
+        io_uring_params params = {};
+        fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+        if (fd < 0) {
+            return errno;
+        }
+
+        sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            sq_size = cq_size = sq_size > cq_size ? sq_size : cq_size;
+        }
+        sq_ptr = mmap(NULL, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (sq_ptr == MAP_FAILED) {
+            return errno;
+        }
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            cq_ptr = sq_ptr;
+        }
+        else {
+            cq_ptr = mmap(NULL, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+            if (cq_ptr == MAP_FAILED) {
+                return errno;
+            }
+        }
+        sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = (io_uring_sqe *)mmap(NULL, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                                    IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            return errno;
+        }
+
+        char *sq = (char *)sq_ptr;
+        char *cq = (char *)cq_ptr;
+        sq_tail = (unsigned *)(sq + params.sq_off.tail);
+        sq_mask = (unsigned *)(sq + params.sq_off.ring_mask);
+        sq_array = (unsigned *)(sq + params.sq_off.array);
+        cq_head = (unsigned *)(cq + params.cq_off.head);
+        cq_tail = (unsigned *)(cq + params.cq_off.tail);
+        cq_mask = (unsigned *)(cq + params.cq_off.ring_mask);
+        cqes = (io_uring_cqe *)(cq + params.cq_off.cqes);
+        local_tail = *sq_tail;
+        return 0;
+    }
+
+    // pinned once, so reads don't map the pages on every call; fails under a low RLIMIT_MEMLOCK
+    void register_buffers(const std::vector<iovec> &iov) {
+        fixed = syscall(__NR_io_uring_register, fd, IORING_REGISTER_BUFFERS, iov.data(), (unsigned)iov.size()) == 0;
+    }
+
+    void read(int file, unsigned slot, char *buf, size_t len, uint64_t offset) {
+        io_uring_sqe *sqe = &sqes[local_tail & *sq_mask];
+        *sqe = io_uring_sqe();
+        sqe->opcode = fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+        sqe->fd = file;
+        sqe->addr = (uint64_t)(uintptr_t)buf;
+        sqe->len = (unsigned)len;
+        sqe->off = offset;
+        sqe->buf_index = fixed ? (uint16_t)slot : 0;
+        sqe->user_data = slot;
+        sq_array[local_tail & *sq_mask] = local_tail & *sq_mask;
+        local_tail++;
+        to_submit++;
+    }
+
+    // submits the queued reads and waits for min_complete completions, 0 or errno
+    int enter(unsigned min_complete) {
+        __atomic_store_n(sq_tail, local_tail, __ATOMIC_RELEASE);
+        while (to_submit || min_complete) {
+            int n = (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete,
+                                 min_complete ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return errno;
+            }
+            to_submit -= (unsigned)n;
+            if (min_complete) {
+                break;
+            }
+        }
+        return 0;
+    }
+
+    template <typename Fn>
+    void reap(Fn &&fn) {
+        unsigned head = *cq_head;
+        unsigned tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            const io_uring_cqe &cqe = cqes[head & *cq_mask];
+            fn((unsigned)cqe.user_data, cqe.res);
+        }
+        __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+    }
+};
+#else
+struct bitp_ingest_ring_ {};
+#endif
+
+}    // namespace
+
+struct bitp_ingest_tag {
+    int fd;
+    bitp_ingest_backend_t backend;
+    size_t block_size;
+    size_t stride;
+    char *pool;
+    std::vector<bitp_ingest_slot_> slots;
+    uint64_t file_size;
+    // offset of the next read to start and of the next block to hand out
+    uint64_t next_read;
+    uint64_t next_block;
+    unsigned in_flight;
+    int error;
+    bitp_ingest_ring_ ring;
+
+    char *buf(unsigned slot) {
+        return pool + slot * stride;
+    }
+
+    // starts reads into the free slots up to the end of the file
+    void start_reads() {
+#if BITP_INGEST_HAVE_URING_
+        for (unsigned i = 0; i < slots.size() && next_read < file_size; ++i) {
+            bitp_ingest_slot_ &s = slots[i];
+            if (s.state != SLOT_FREE) {
+                continue;
+            }
+            s.state = SLOT_READING;
+            s.offset = next_read;
+            s.got = 0;
+            s.want = file_size - next_read < block_size ? file_size - next_read : block_size;
+            s.error = 0;
+            // whole blocks, so O_DIRECT reads stay aligned at the end of the file
+            ring.read(fd, i, buf(i), block_size, s.offset);
+            in_flight++;
+            next_read += block_size;
+        }
+#endif
+    }
+
+    void complete(unsigned slot, int res) {
+#if BITP_INGEST_HAVE_URING_
+        bitp_ingest_slot_ &s = slots[slot];
+        in_flight--;
+        if (res == -EAGAIN || res == -EINTR) {
+            ring.read(fd, slot, buf(slot) + s.got, block_size - s.got, s.offset + s.got);
+            in_flight++;
+            return;
+        }
+        if (res < 0) {
+            s.error = -res;
+        }
+        else {
+            s.got += (size_t)res;
+            // short read before the end of the file, the file may also have been truncated
+            if (res > 0 && s.got < s.want) {
+                ring.read(fd, slot, buf(slot) + s.got, block_size - s.got, s.offset + s.got);
+                in_flight++;
+                return;
+            }
+        }
+        s.state = SLOT_DONE;
+#else
+        (void)slot;
+        (void)res;
+#endif
+    }
+
+    bitp_status_t next_from_ring(unsigned *res) {
+#if BITP_INGEST_HAVE_URING_
+        for (;;) {
+            start_reads();
+            int err = ring.enter(0);
+            if (err) {
+                error = err;
+                return BITP_EINVALID_ARG;
+            }
+            ring.reap([this](unsigned slot, int r) { complete(slot, r); });
+
+            for (unsigned i = 0; i < slots.size(); ++i) {
+                if (slots[i].offset == next_block && slots[i].state == SLOT_DONE) {
+                    *res = i;
+                    return BITP_OK;
+                }
+            }
+            if (!in_flight) {
+                // every buffer is held by the caller
+                return BITP_EINVALID_ARG;
+            }
+            err = ring.enter(1);
+            if (err) {
+                error = err;
+                return BITP_EINVALID_ARG;
+            }
+        }
+#else
+        (void)res;
+        return BITP_EINVALID_ARG;
+#endif
+    }
+
+    bitp_status_t next_from_pread(unsigned *res) {
+        for (unsigned i = 0; i < slots.size(); ++i) {
+            bitp_ingest_slot_ &s = slots[i];
+            if (s.state != SLOT_FREE) {
+                continue;
+            }
+            s.offset = next_block;
+            s.want = file_size - next_block < block_size ? file_size - next_block : block_size;
+            s.got = 0;
+            s.error = 0;
+            while (s.got < s.want) {
+                ssize_t n = pread(fd, buf(i) + s.got, block_size - s.got, (off_t)(s.offset + s.got));
+                if (n < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (n < 0) {
+                    s.error = errno;
+                }
+                if (n <= 0) {
+                    break;
+                }
+                s.got += (size_t)n;
+            }
+            s.state = SLOT_DONE;
+            *res = i;
+            return BITP_OK;
+        }
+        return BITP_EINVALID_ARG;
+    }
+};
+
+extern "C" {
+
+bitp_status_t bitp_ingest_open(bitp_ingest_t **res, int fd, const bitp_ingest_config_t *config) {
+    bitp_ingest_config_t cfg = {};
+    struct stat st;
+
+    if (config) {
+        cfg = *config;
+    }
+    if (!cfg.block_size) {
+        cfg.block_size = 1 << 20;
+    }
+    if (!cfg.n_blocks) {
+        cfg.n_blocks = 8;
+    }
+    // the read length of io_uring is 32-bit, the slot is a 16-bit buffer index
+    if (cfg.block_size > (1u << 30) || cfg.n_blocks > (1u << 15) || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        return BITP_EINVALID_ARG;
+    }
+
+    bitp_ingest_t *inst = new bitp_ingest_t();
+    inst->fd = fd;
+    inst->block_size = cfg.block_size;
+    inst->stride = (cfg.block_size + BITP_INGEST_PADDING + bitp_ingest_page_ - 1) / bitp_ingest_page_ * bitp_ingest_page_;
+    inst->slots.assign(cfg.n_blocks, bitp_ingest_slot_());
+    inst->file_size = (uint64_t)st.st_size;
+    inst->backend = BITP_INGEST_READ;
+
+    void *pool = NULL;
+    if (posix_memalign(&pool, bitp_ingest_page_, inst->stride * cfg.n_blocks) != 0) {
+        delete inst;
+        return BITP_EINVALID_ARG;
+    }
+    inst->pool = (char *)pool;
+    memset(inst->pool, 0, inst->stride * cfg.n_blocks);
+
+#if BITP_INGEST_HAVE_URING_
+    if (cfg.backend != BITP_INGEST_READ) {
+        unsigned entries = 1;
+        while (entries < cfg.n_blocks) {
+            entries *= 2;
+        }
+        int err = inst->ring.setup(entries);
+        if (!err) {
+            std::vector<iovec> iov(cfg.n_blocks);
+            for (unsigned i = 0; i < cfg.n_blocks; ++i) {
+                iov[i].iov_base = inst->buf(i);
+                iov[i].iov_len = cfg.block_size;
+            }
+            inst->ring.register_buffers(iov);
+            inst->backend = BITP_INGEST_URING;
+            inst->start_reads();
+            err = inst->ring.enter(0);
+        }
+        // seccomp filters and kernel.io_uring_disabled refuse the setup
+        if (err && cfg.backend == BITP_INGEST_URING) {
+            inst->error = err;
+            bitp_ingest_close(inst);
+            return BITP_EINVALID_ARG;
+        }
+        if (err) {
+            bitp_ingest_close(inst);
+            cfg.backend = BITP_INGEST_READ;
+            return bitp_ingest_open(res, fd, &cfg);
+        }
+    }
+#else
+    if (cfg.backend == BITP_INGEST_URING) {
+        bitp_ingest_close(inst);
+        return BITP_EINVALID_ARG;
+    }
+#endif
+
+    *res = inst;
+    return BITP_OK;
+}
+
+bitp_ingest_backend_t bitp_ingest_backend(const bitp_ingest_t *inst) {
+    return inst->backend;
+}
+
+bitp_status_t bitp_ingest_next(bitp_ingest_t *inst, bitp_ingest_block_t *block) {
+    unsigned slot = 0;
+
+    if (inst->error) {
+        return BITP_EINVALID_ARG;
+    }
+    if (inst->next_block >= inst->file_size) {
+        return BITP_EFULL;
+    }
+    bitp_status_t s = inst->backend == BITP_INGEST_URING ? inst->next_from_ring(&slot) : inst->next_from_pread(&slot);
+    if (s != BITP_OK) {
+        return s;
+    }
+
+    bitp_ingest_slot_ &sl = inst->slots[slot];
+    if (sl.error) {
+        inst->error = sl.error;
+        sl.state = SLOT_FREE;
+        return BITP_EINVALID_ARG;
+    }
+    // the file got shorter since open
+    if (sl.got == 0) {
+        inst->file_size = inst->next_block;
+        sl.state = SLOT_FREE;
+        return BITP_EFULL;
+    }
+    if (sl.got < sl.want) {
+        inst->file_size = sl.offset + sl.got;
+    }
+    sl.state = SLOT_HELD;
+    inst->next_block += inst->block_size;
+
+    bitp_parser_init(&block->parser, inst->buf(slot), sl.got * CHAR_BIT);
+    block->offset = sl.offset;
+    block->slot_ = slot;
+    return BITP_OK;
+}
+
+void bitp_ingest_release(bitp_ingest_t *inst, const bitp_ingest_block_t *block) {
+    inst->slots[block->slot_].state = SLOT_FREE;
+}
+
+int bitp_ingest_error(const bitp_ingest_t *inst) {
+    return inst->error;
+}
+
+void bitp_ingest_close(bitp_ingest_t *inst) {
+#if BITP_INGEST_HAVE_URING_
+    // the kernel may still write into the pool until the reads in flight complete
+    while (inst->in_flight && inst->ring.enter(1) == 0) {
+        inst->ring.reap([inst](unsigned, int) { inst->in_flight--; });
+    }
+#endif
+    free(inst->pool);
+    delete inst;
+}
+
+}    // extern "C"
@@ -0,0 +1,266 @@
+/*
+ * kernels.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <atomic>
+#include <cstdlib>
+
+extern "C" {
+#include "bitp/kernels.h"
+}
+
+// BITP_KERNELS=scalar|sse2|avx2|avx512 lowers the startup choice
+static bitp_isa_t bitp_kernels_env_isa_(bitp_isa_t isa) {
+    static const char *const names[] = {"scalar", "sse2", "avx2", "avx512"};
+    const char *env = std::getenv("BITP_KERNELS");
+
+    if (env) {
+        for (int i = 0; i < (int)(sizeof(names) / sizeof(names[0])); ++i) {
+            if (strcmp(env, names[i]) == 0 && i < (int)isa) {
+                return (bitp_isa_t)i;
+            }
+        }
+    }
+    return isa;
+}
+
+// chosen once during static initialization, callers running before it see the scalar tier
+static const unsigned bitp_kernels_features_ = bitp_cpu_features();
+static std::atomic<int> bitp_kernels_isa_(bitp_kernels_env_isa_(bitp_cpu_isa(bitp_kernels_features_)));
+
+static bitp_isa_t bitp_kernels_load_isa_() {
+    return (bitp_isa_t)bitp_kernels_isa_.load(std::memory_order_relaxed);
+}
+
+// PEXT/PDEP are used from the AVX2 tier on, where BMI2 comes with every CPU we know of
+static int bitp_kernels_use_pdep_(const bitp_fields_t *fields) {
+    return BITP_FIELDS_PDEP && fields->use_pdep && bitp_kernels_load_isa_() >= BITP_ISA_AVX2 &&
+           (bitp_kernels_features_ & BITP_CPU_FAST_PDEP);
+}
+
+static bitp_status_t bitp_kernels_check_(size_t capacity, size_t iter, const bitp_fields_t *fields, size_t n_groups) {
+    if (iter > capacity) {
+        return BITP_EFULL;
+    }
+    if (fields->n_bits && n_groups > (capacity - iter) / fields->n_bits) {
+        return BITP_EFULL;
+    }
+    return BITP_OK;
+}
+
+bitp_isa_t bitp_kernels_isa(void) {
+    return bitp_kernels_load_isa_();
+}
+
+bitp_status_t bitp_kernels_force(bitp_isa_t isa) {
+    if (isa < BITP_ISA_SCALAR || isa > bitp_cpu_isa(bitp_cpu_features())) {
+        return BITP_EINVALID_ARG;
+    }
+    bitp_kernels_isa_.store(isa, std::memory_order_relaxed);
+    return BITP_OK;
+}
+
+bitp_status_t bitp_kernels_parser_find(bitp_parser_t *inst, const bitp_pattern_t *pattern) {
+    return bitp_parser_find_isa(inst, pattern, bitp_kernels_load_isa_());
+}
+
+size_t bitp_kernels_parser_find_all(const bitp_parser_t *inst,
+                                    const bitp_pattern_t *pattern,
+                                    bitp_parser_t *matches,
+                                    size_t max_matches) {
+    bitp_isa_t isa = bitp_kernels_load_isa_();
+    bitp_parser_t cursor = *inst;
+    size_t n_matches = 0;
+
+    while (n_matches < max_matches && bitp_parser_find_isa(&cursor, pattern, isa) == BITP_OK) {
+        matches[n_matches++] = cursor;
+        cursor.iter++;
+    }
+
+    return n_matches;
+}
+
+#if BITP_FIELDS_PDEP
+// one function per lane size, so the lane reversal and the strides are constants
+#define BITP_KERNELS_PDEP_FUNCS_(lane_bits_)                                                             \
+    BITP_TARGET("bmi2,popcnt")                                                                          \
+    static void bitp_kernels_split_pdep_##lane_bits_##_(const bitp_fields_t *fields,                     \
+                                                        const bitp_parser_t *inst,                       \
+                                                        char *res,                                       \
+                                                        size_t n_groups) {                               \
+        size_t stride = BITP_FIELDS_ARRAY_SIZE(fields->n_fields, lane_bits_) * lane_bits_ / CHAR_BIT;    \
+        size_t iter = inst->iter;                                                                        \
+        for (size_t g = 0; g < n_groups; ++g, iter += fields->n_bits, res += stride) {                   \
+            uint64_t window = bitp_read_bits_64(inst->buf, inst->capacity, iter);                        \
+            bitp_fields_split_pdep_(fields, window, res, lane_bits_);                                    \
+        }                                                                                                \
+    }                                                                                                    \
+                                                                                                         \
+    BITP_TARGET("bmi2,popcnt")                                                                          \
+    static void bitp_kernels_join_pdep_##lane_bits_##_(const bitp_fields_t *fields,                      \
+                                                       bitp_packer_t *inst,                              \
+                                                       const char *vals,                                 \
+                                                       size_t n_groups) {                                \
+        size_t stride = BITP_FIELDS_ARRAY_SIZE(fields->n_fields, lane_bits_) * lane_bits_ / CHAR_BIT;    \
+        size_t iter = inst->iter;                                                                        \
+        for (size_t g = 0; g < n_groups; ++g, iter += fields->n_bits, vals += stride) {                  \
+            uint64_t window = bitp_fields_join_pdep_(fields, vals, lane_bits_);                          \
+            bitp_or_bits_64(inst->buf, inst->capacity, iter, window, fields->n_bits);                    \
+        }                                                                                                \
+    }
+
+BITP_KERNELS_PDEP_FUNCS_(8)
+BITP_KERNELS_PDEP_FUNCS_(16)
+BITP_KERNELS_PDEP_FUNCS_(32)
+BITP_KERNELS_PDEP_FUNCS_(64)
+#endif
+
+#define BITP_KERNELS_SPLIT_(fields_, inst_, res_, n_groups_, type_)                      \
+    do {                                                                                  \
+        size_t stride_ = BITP_FIELDS_ARRAY_SIZE((fields_)->n_fields, CHAR_BIT * sizeof(type_)); \
+        size_t iter_ = (inst_)->iter;                                                     \
+        type_ *out_ = (type_ *)(res_);                                                    \
+        for (size_t g_ = 0; g_ < (n_groups_); ++g_, iter_ += (fields_)->n_bits, out_ += stride_) { \
+            uint64_t window_ = bitp_read_bits_64((inst_)->buf, (inst_)->capacity, iter_); \
+            BITP_FIELDS_SPLIT_(fields_, window_, out_, type_);                            \
+        }                                                                                 \
+    } while (0)
+
+#define BITP_KERNELS_JOIN_(fields_, inst_, vals_, n_groups_, type_)                      \
+    do {                                                                                  \
+        size_t stride_ = BITP_FIELDS_ARRAY_SIZE((fields_)->n_fields, CHAR_BIT * sizeof(type_)); \
+        size_t iter_ = (inst_)->iter;                                                     \
+        const type_ *in_ = (const type_ *)(vals_);                                        \
+        for (size_t g_ = 0; g_ < (n_groups_); ++g_, iter_ += (fields_)->n_bits, in_ += stride_) { \
+            uint64_t window_ = 0;                                                         \
+            BITP_FIELDS_JOIN_(fields_, in_, window_);                                     \
+            bitp_or_bits_64((inst_)->buf, (inst_)->capacity, iter_, window_, (fields_)->n_bits); \
+        }                                                                                 \
+    } while (0)
+
+#define BITP_KERNELS_CHECK_RANGE_(fields_, vals_, n_groups_, type_)                     \
+    do {                                                                                  \
+        size_t stride_ = BITP_FIELDS_ARRAY_SIZE((fields_)->n_fields, CHAR_BIT * sizeof(type_)); \
+        const type_ *in_ = (const type_ *)(vals_);                                        \
+        for (size_t g_ = 0; g_ < (n_groups_); ++g_, in_ += stride_) {                     \
+            for (unsigned i_ = 0; i_ < (fields_)->n_fields; ++i_) {                       \
+                if ((uint64_t)in_[i_] > (fields_)->masks[i_]) {                           \
+                    return BITP_EINVALID_ARG;                                             \
+                }                                                                         \
+            }                                                                             \
+        }                                                                                 \
+    } while (0)
+
+bitp_status_t bitp_kernels_extract_fields(bitp_parser_t *inst,
+                                          const bitp_fields_t *fields,
+                                          void *res,
+                                          size_t n_groups) {
+    bitp_status_t status = bitp_kernels_check_(inst->capacity, inst->iter, fields, n_groups);
+    if (status != BITP_OK) {
+        return status;
+    }
+
+#if BITP_FIELDS_PDEP
+    if (bitp_kernels_use_pdep_(fields)) {
+        switch (fields->lane_bits) {
+        case 8:
+            bitp_kernels_split_pdep_8_(fields, inst, (char *)res, n_groups);
+            break;
+        case 16:
+            bitp_kernels_split_pdep_16_(fields, inst, (char *)res, n_groups);
+            break;
+        case 32:
+            bitp_kernels_split_pdep_32_(fields, inst, (char *)res, n_groups);
+            break;
+        default:
+            bitp_kernels_split_pdep_64_(fields, inst, (char *)res, n_groups);
+            break;
+        }
+        inst->iter += n_groups * fields->n_bits;
+        return BITP_OK;
+    }
+#endif
+
+    switch (fields->lane_bits) {
+    case 8:
+        BITP_KERNELS_SPLIT_(fields, inst, res, n_groups, uint8_t);
+        break;
+    case 16:
+        BITP_KERNELS_SPLIT_(fields, inst, res, n_groups, uint16_t);
+        break;
+    case 32:
+        BITP_KERNELS_SPLIT_(fields, inst, res, n_groups, uint32_t);
+        break;
+    default:
+        BITP_KERNELS_SPLIT_(fields, inst, res, n_groups, uint64_t);
+        break;
+    }
+    inst->iter += n_groups * fields->n_bits;
+    return BITP_OK;
+}
+
+bitp_status_t bitp_kernels_add_fields(bitp_packer_t *inst,
+                                      const bitp_fields_t *fields,
+                                      const void *vals,
+                                      size_t n_groups) {
+    bitp_status_t status = bitp_kernels_check_(inst->capacity, inst->iter, fields, n_groups);
+    if (status != BITP_OK) {
+        return status;
+    }
+
+    switch (fields->lane_bits) {
+    case 8:
+        BITP_KERNELS_CHECK_RANGE_(fields, vals, n_groups, uint8_t);
+        break;
+    case 16:
+        BITP_KERNELS_CHECK_RANGE_(fields, vals, n_groups, uint16_t);
+        break;
+    case 32:
+        BITP_KERNELS_CHECK_RANGE_(fields, vals, n_groups, uint32_t);
+        break;
+    default:
+        BITP_KERNELS_CHECK_RANGE_(fields, vals, n_groups, uint64_t);
+        break;
+    }
+
+#if BITP_FIELDS_PDEP
+    if (bitp_kernels_use_pdep_(fields)) {
+        switch (fields->lane_bits) {
+        case 8:
+            bitp_kernels_join_pdep_8_(fields, inst, (const char *)vals, n_groups);
+            break;
+        case 16:
+            bitp_kernels_join_pdep_16_(fields, inst, (const char *)vals, n_groups);
+            break;
+        case 32:
+            bitp_kernels_join_pdep_32_(fields, inst, (const char *)vals, n_groups);
+            break;
+        default:
+            bitp_kernels_join_pdep_64_(fields, inst, (const char *)vals, n_groups);
+            break;
+        }
+        inst->iter += n_groups * fields->n_bits;
+        return BITP_OK;
+    }
+#endif
+
+    switch (fields->lane_bits) {
+    case 8:
+        BITP_KERNELS_JOIN_(fields, inst, vals, n_groups, uint8_t);
+        break;
+    case 16:
+        BITP_KERNELS_JOIN_(fields, inst, vals, n_groups, uint16_t);
+        break;
+    case 32:
+        BITP_KERNELS_JOIN_(fields, inst, vals, n_groups, uint32_t);
+        break;
+    default:
+        BITP_KERNELS_JOIN_(fields, inst, vals, n_groups, uint64_t);
+        break;
+    }
+    inst->iter += n_groups * fields->n_bits;
+    return BITP_OK;
+}
@@ -0,0 +1,266 @@
+/*
+ * shm.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstring>
+#include <new>
+
+extern "C" {
+#include "bitp/shm.h"
+}
+
+static const uint64_t bitp_shm_magic_ = 0x6269747073686d31ULL;  // "bitpshm1"
+static const size_t bitp_shm_line_ = 64;
+// the data starts after the control block
+static const size_t bitp_shm_data_off_ = 4 * bitp_shm_line_;
+// records start at multiples of their header size, so that a header always fits before the end
+static const size_t bitp_shm_align_ = 16;
+static const uint32_t bitp_shm_skip_ = 0xFFFFFFFFu;
+
+namespace {
+
+/* at the start of the shared memory object */
+struct bitp_shm_control_ {
+    uint64_t magic;
+    uint64_t capacity;
+    uint32_t mode;
+    // bytes taken by producers and given back by the consumer since the creation
+    alignas(bitp_shm_line_) std::atomic<uint64_t> reserve;
+    alignas(bitp_shm_line_) std::atomic<uint64_t> head;
+};
+
+static_assert(sizeof(bitp_shm_control_) <= bitp_shm_data_off_, "control block too large");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "the counters must be lock-free to be shared");
+
+/*
+ * seq is the position of the record plus 1 while reserved and plus 2 once committed; the
+ * consumer zeroes what it frees, a header not yet written in this lap reads as 0
+ */
+struct bitp_shm_record_ {
+    std::atomic<uint64_t> seq;
+    uint32_t size;
+    uint32_t n_bits;
+};
+
+static_assert(sizeof(bitp_shm_record_) == bitp_shm_align_, "record header size");
+
+}  // namespace
+
+struct bitp_shm_tag {
+    int fd = -1;
+    void *map = MAP_FAILED;
+    size_t map_size = 0;
+    bitp_shm_control_ *ctl = nullptr;
+    char *data = nullptr;
+    uint64_t capacity = 0;
+    bool mpsc = false;
+    // producer: the head seen last, the ring looks full against it
+    uint64_t head_seen = 0;
+    // consumer: the next record to read and the end of the bytes given back
+    uint64_t read_pos = 0;
+    uint64_t released = 0;
+
+    bitp_shm_record_ *record(uint64_t pos) {
+        return (bitp_shm_record_ *)(data + (pos & (capacity - 1)));
+    }
+
+    bitp_status_t map_fd(size_t size) {
+        map_size = size;
+        map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (map == MAP_FAILED) {
+            return BITP_EINVALID_ARG;
+        }
+        ctl = (bitp_shm_control_ *)map;
+        data = (char *)map + bitp_shm_data_off_;
+        return BITP_OK;
+    }
+};
+
+static size_t bitp_shm_map_size_(uint64_t capacity) {
+    return bitp_shm_data_off_ + capacity + BITP_SHM_PADDING;
+}
+
+static bitp_status_t bitp_shm_fail_(bitp_shm_t *inst, bitp_shm_t **res) {
+    int err = errno;
+    bitp_shm_close(inst);
+    *res = NULL;
+    errno = err;
+    return BITP_EINVALID_ARG;
+}
+
+bitp_status_t bitp_shm_create(bitp_shm_t **res, const char *name, size_t capacity, bitp_shm_mode_t mode) {
+    *res = NULL;
+    if (capacity < 4096 || capacity > (1u << 28) || (capacity & (capacity - 1)) || (mode != BITP_SHM_SPSC && mode != BITP_SHM_MPSC)) {
+        errno = EINVAL;
+        return BITP_EINVALID_ARG;
+    }
+
+    bitp_shm_t *inst = new bitp_shm_t();
+    inst->fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (inst->fd < 0 || ftruncate(inst->fd, (off_t)bitp_shm_map_size_(capacity)) != 0 ||
+        inst->map_fd(bitp_shm_map_size_(capacity)) != BITP_OK) {
+        int err = errno;
+        if (inst->fd >= 0) {
+            shm_unlink(name);
+        }
+        errno = err;
+        return bitp_shm_fail_(inst, res);
+    }
+
+    // the object comes zeroed: every record header is of no lap yet
+    bitp_shm_control_ *ctl = new (inst->map) bitp_shm_control_();
+    ctl->capacity = capacity;
+    ctl->mode = (uint32_t)mode;
+    ctl->reserve.store(0, std::memory_order_relaxed);
+    ctl->head.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    ctl->magic = bitp_shm_magic_;
+
+    inst->capacity = capacity;
+    inst->mpsc = mode == BITP_SHM_MPSC;
+    *res = inst;
+    return BITP_OK;
+}
+
+bitp_status_t bitp_shm_open(bitp_shm_t **res, const char *name) {
+    *res = NULL;
+    bitp_shm_t *inst = new bitp_shm_t();
+    struct stat st;
+    inst->fd = shm_open(name, O_RDWR, 0);
+    if (inst->fd < 0 || fstat(inst->fd, &st) != 0) {
+        return bitp_shm_fail_(inst, res);
+    }
+    if ((size_t)st.st_size < bitp_shm_data_off_) {
+        errno = EINVAL;
+        return bitp_shm_fail_(inst, res);
+    }
+    if (inst->map_fd((size_t)st.st_size) != BITP_OK) {
+        return bitp_shm_fail_(inst, res);
+    }
+    bitp_shm_control_ *ctl = inst->ctl;
+    if (ctl->magic != bitp_shm_magic_ || bitp_shm_map_size_(ctl->capacity) != (size_t)st.st_size) {
+        errno = EINVAL;
+        return bitp_shm_fail_(inst, res);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    inst->capacity = ctl->capacity;
+    inst->mpsc = ctl->mode == BITP_SHM_MPSC;
+    inst->head_seen = ctl->head.load(std::memory_order_acquire);
+    inst->read_pos = inst->head_seen;
+    inst->released = inst->head_seen;
+    *res = inst;
+    return BITP_OK;
+}
+
+void bitp_shm_close(bitp_shm_t *inst) {
+    if (inst->map != MAP_FAILED) {
+        munmap(inst->map, inst->map_size);
+    }
+    if (inst->fd >= 0) {
+        close(inst->fd);
+    }
+    delete inst;
+}
+
+bitp_status_t bitp_shm_unlink(const char *name) {
+    return shm_unlink(name) == 0 ? BITP_OK : BITP_EINVALID_ARG;
+}
+
+size_t bitp_shm_max_bits(const bitp_shm_t *inst) {
+    // a record and the skip before it fit into an empty ring
+    return (inst->capacity / 2 - sizeof(bitp_shm_record_)) * CHAR_BIT;
+}
+
+bitp_status_t bitp_shm_reserve(bitp_shm_t *inst, size_t n_bits, bitp_packer_t *res) {
+    if (n_bits > bitp_shm_max_bits(inst)) {
+        return BITP_EINVALID_ARG;
+    }
+    bitp_shm_control_ *ctl = inst->ctl;
+    uint64_t size = (sizeof(bitp_shm_record_) + (n_bits + CHAR_BIT - 1) / CHAR_BIT + bitp_shm_align_ - 1) &
+                    ~(uint64_t)(bitp_shm_align_ - 1);
+    uint64_t pos = ctl->reserve.load(std::memory_order_relaxed);
+    uint64_t skip;
+    for (;;) {
+        // a record doesn't wrap, the rest of the ring is skipped instead
+        uint64_t left = inst->capacity - (pos & (inst->capacity - 1));
+        skip = left < size ? left : 0;
+        if ((int64_t)(pos - inst->head_seen) < 0) {
+            // another producer went on since pos was read
+            pos = ctl->reserve.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (pos + skip + size - inst->head_seen > inst->capacity) {
+            // the consumer is done with the bytes before head
+            inst->head_seen = ctl->head.load(std::memory_order_acquire);
+            if (pos + skip + size - inst->head_seen > inst->capacity) {
+                return BITP_EFULL;
+            }
+        }
+        if (!inst->mpsc) {
+            ctl->reserve.store(pos + skip + size, std::memory_order_relaxed);
+            break;
+        }
+        if (ctl->reserve.compare_exchange_weak(pos, pos + skip + size, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    if (skip) {
+        bitp_shm_record_ *r = inst->record(pos);
+        r->size = (uint32_t)skip;
+        r->n_bits = bitp_shm_skip_;
+        r->seq.store(pos + 2, std::memory_order_release);
+        pos += skip;
+    }
+    bitp_shm_record_ *r = inst->record(pos);
+    r->size = (uint32_t)size;
+    r->n_bits = (uint32_t)n_bits;
+    r->seq.store(pos + 1, std::memory_order_relaxed);
+    // zeroed by the consumer
+    bitp_packer_init(res, (char *)(r + 1), n_bits, 0);
+    return BITP_OK;
+}
+
+void bitp_shm_commit(bitp_shm_t *inst, const bitp_packer_t *res) {
+    (void)inst;
+    bitp_shm_record_ *r = (bitp_shm_record_ *)res->buf - 1;
+    r->n_bits = (uint32_t)res->iter;
+    r->seq.store(r->seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+bitp_status_t bitp_shm_next(bitp_shm_t *inst, bitp_parser_t *res) {
+    for (;;) {
+        bitp_shm_record_ *r = inst->record(inst->read_pos);
+        if (r->seq.load(std::memory_order_acquire) != inst->read_pos + 2) {
+            return BITP_EAGAIN;
+        }
+        inst->read_pos += r->size;
+        if (r->n_bits != bitp_shm_skip_) {
+            bitp_parser_init(res, (const char *)(r + 1), r->n_bits);
+            return BITP_OK;
+        }
+    }
+}
+
+void bitp_shm_release(bitp_shm_t *inst) {
+    // zeroed before they're given back: a header not written in this lap reads as 0, a slot is
+    // ready for the packer
+    uint64_t from = inst->released & (inst->capacity - 1);
+    uint64_t n = inst->read_pos - inst->released;
+    uint64_t first = n < inst->capacity - from ? n : inst->capacity - from;
+    memset(inst->data + from, 0, first);
+    memset(inst->data, 0, n - first);
+    inst->released = inst->read_pos;
+    inst->ctl->head.store(inst->read_pos, std::memory_order_release);
+}
@@ -0,0 +1,201 @@
+/*
+ * trace.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "bitp/cpu.h"
+#include "bitp/trace.h"
+}
+
+#if BITP_X86_64 && defined(_MSC_VER)
+#include <intrin.h>
+#elif BITP_X86_64
+#include <x86intrin.h>
+#endif
+
+static const size_t bitp_trace_default_events_ = 1 << 16;
+
+namespace {
+
+/* relaxed atomics, plain stores on the recording side; the dump reads them while they're written */
+struct bitp_trace_event_ {
+    std::atomic<uint64_t> ticks;
+    std::atomic<uintptr_t> name;
+    // bit_off << 1 | end
+    std::atomic<uint64_t> pos;
+};
+
+/* written by its thread only, head is published after the event */
+struct bitp_trace_ring_ {
+    std::unique_ptr<bitp_trace_event_[]> events;
+    size_t mask;
+    std::atomic<uint64_t> head{0};
+    // events before it were dropped by bitp_trace_clear
+    std::atomic<uint64_t> start{0};
+};
+
+struct bitp_trace_registry_ {
+    std::mutex lock;
+    // rings of the threads that recorded, kept until exit for the dump
+    std::vector<std::unique_ptr<bitp_trace_ring_>> rings;
+    size_t events_per_thread = bitp_trace_default_events_;
+    // a clock reading to measure the ticks against at the dump
+    uint64_t ticks0 = 0;
+    std::chrono::steady_clock::time_point time0;
+};
+
+}  // namespace
+
+static bitp_trace_registry_ &bitp_trace_get_registry_() {
+    static bitp_trace_registry_ registry;
+    return registry;
+}
+
+static thread_local bitp_trace_ring_ *bitp_trace_tls_ring_ = nullptr;
+
+static inline uint64_t bitp_trace_ticks_() {
+#if BITP_X86_64
+    return __rdtsc();
+#else
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
+static bitp_trace_ring_ *bitp_trace_register_() {
+    bitp_trace_registry_ &registry = bitp_trace_get_registry_();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    if (registry.rings.empty()) {
+        registry.ticks0 = bitp_trace_ticks_();
+        registry.time0 = std::chrono::steady_clock::now();
+    }
+    std::unique_ptr<bitp_trace_ring_> ring(new bitp_trace_ring_());
+    ring->events.reset(new bitp_trace_event_[registry.events_per_thread]());
+    ring->mask = registry.events_per_thread - 1;
+    bitp_trace_tls_ring_ = ring.get();
+    registry.rings.push_back(std::move(ring));
+    return bitp_trace_tls_ring_;
+}
+
+static double bitp_trace_ticks_per_second_(const bitp_trace_registry_ &registry) {
+#if BITP_X86_64
+    // long enough for the two readings to agree to a few parts per million
+    std::chrono::duration<double> elapsed;
+    uint64_t ticks;
+    do {
+        ticks = bitp_trace_ticks_();
+        elapsed = std::chrono::steady_clock::now() - registry.time0;
+    } while (elapsed.count() < 0.01);
+    return (double)(ticks - registry.ticks0) / elapsed.count();
+#else
+    (void)registry;
+    return 1e9;
+#endif
+}
+
+void bitp_trace_init(size_t events_per_thread) {
+    size_t n = 2;
+    while (n < events_per_thread) {
+        n <<= 1;
+    }
+    bitp_trace_registry_ &registry = bitp_trace_get_registry_();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    registry.events_per_thread = n;
+}
+
+void bitp_trace_record(const char *name, size_t bit_off, int end) {
+    bitp_trace_ring_ *ring = bitp_trace_tls_ring_;
+    if (!ring) {
+        ring = bitp_trace_register_();
+    }
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    bitp_trace_event_ &e = ring->events[head & ring->mask];
+    e.ticks.store(bitp_trace_ticks_(), std::memory_order_relaxed);
+    e.name.store((uintptr_t)name, std::memory_order_relaxed);
+    e.pos.store((uint64_t)bit_off << 1 | (end ? 1 : 0), std::memory_order_relaxed);
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+bitp_status_t bitp_trace_dump(FILE *f) {
+    bitp_trace_registry_ &registry = bitp_trace_get_registry_();
+    std::lock_guard<std::mutex> guard(registry.lock);
+
+    struct copy {
+        uint64_t ticks;
+        uintptr_t name;
+        uint64_t pos;
+    };
+    std::vector<std::vector<copy>> threads;
+    // ids by content: the same name may be at different addresses (literals not merged, in
+    // different translation units, or copies)
+    std::map<uintptr_t, size_t> names;
+    std::map<std::string, size_t> ids;
+    std::vector<const char *> id_names;
+    for (const auto &ring : registry.rings) {
+        size_t capacity = ring->mask + 1;
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t from = ring->start.load(std::memory_order_relaxed);
+        if (head - from > capacity) {
+            from = head - capacity;
+        }
+        std::vector<copy> events;
+        for (uint64_t i = from; i < head; ++i) {
+            const bitp_trace_event_ &e = ring->events[i & ring->mask];
+            events.push_back({e.ticks.load(std::memory_order_relaxed), e.name.load(std::memory_order_relaxed),
+                              e.pos.load(std::memory_order_relaxed)});
+        }
+        // the events the thread may have written over meanwhile are dropped, the one being written too
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t now = ring->head.load(std::memory_order_relaxed);
+        if (now - from >= capacity) {
+            size_t lost = (size_t)(now - from - capacity + 1);
+            events.erase(events.begin(), events.begin() + (lost < events.size() ? lost : events.size()));
+        }
+        for (const copy &e : events) {
+            if (names.count(e.name)) {
+                continue;
+            }
+            auto id = ids.emplace((const char *)e.name, ids.size());
+            if (id.second) {
+                id_names.push_back((const char *)e.name);
+            }
+            names[e.name] = id.first->second;
+        }
+        threads.push_back(std::move(events));
+    }
+
+    fprintf(f, "bitp_trace 1\n");
+    fprintf(f, "ticks_per_second %.0f\n", threads.empty() ? 1e9 : bitp_trace_ticks_per_second_(registry));
+    fprintf(f, "names %zu\n", id_names.size());
+    for (size_t i = 0; i < id_names.size(); ++i) {
+        fprintf(f, "%zu %s\n", i, id_names[i]);
+    }
+    for (size_t t = 0; t < threads.size(); ++t) {
+        fprintf(f, "thread %zu %zu\n", t, threads[t].size());
+        for (const copy &e : threads[t]) {
+            fprintf(f, "%llu %zu %llu %c\n", (unsigned long long)e.ticks, names[e.name],
+                    (unsigned long long)(e.pos >> 1), e.pos & 1 ? 'e' : 'b');
+        }
+    }
+    return ferror(f) || fflush(f) != 0 ? BITP_EINVALID_ARG : BITP_OK;
+}
+
+void bitp_trace_clear(void) {
+    bitp_trace_registry_ &registry = bitp_trace_get_registry_();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    for (const auto &ring : registry.rings) {
+        ring->start.store(ring->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,8 @@
+# runs bitp_asn1gen on INPUT and expects it to fail with a message matching ERROR
+execute_process(COMMAND ${TOOL} -o ${OUTPUT} ${INPUT} RESULT_VARIABLE result ERROR_VARIABLE error)
+if(NOT result)
+  message(FATAL_ERROR "${TOOL} accepted ${INPUT}")
+endif()
+if(NOT error MATCHES "${ERROR}")
+  message(FATAL_ERROR "unexpected error for ${INPUT}: ${error}")
+endif()
@@ -0,0 +1,351 @@
+/*
+ * asn1gen_tests_with_checkers.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#define BITP_CHECK_ALL
+// generated by bitp_asn1gen from asn1/rrc_nb.asn
+#include "rrc_nb.h"
+}
+
+// the expected encodings are derived by hand from X.691 (unaligned PER), bit by bit
+
+// room for the aligned 64-bit words read by bitp_parser_extract_u64
+static std::vector<uint8_t> padded(std::vector<uint8_t> bytes) {
+    bytes.resize((bytes.size() + 15) / 8 * 8);
+    return bytes;
+}
+
+template <typename T>
+static std::vector<uint8_t> encode(bitp_status_t (*fn)(bitp_packer_t *, const T *), const T &v, size_t n_bits) {
+    std::vector<uint8_t> buf(64);
+    bitp_packer_t packer;
+    bitp_packer_init(&packer, (char *)buf.data(), buf.size() * CHAR_BIT, 1);
+    EXPECT_EQ(fn(&packer, &v), BITP_OK);
+    EXPECT_EQ(packer.iter, n_bits);
+    buf.resize((n_bits + 7) / 8);
+    return buf;
+}
+
+TEST(asn1gen_tests, mib_nb) {
+    // the message of example/example.cpp
+    const std::vector<uint8_t> bytes = {0x00, 0x92, 0xC0, 0x00, 0x00};
+    std::vector<uint8_t> buf = padded(bytes);
+
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, (char *)buf.data(), 34);
+    rrc_BCCH_BCH_Message_NB_t msg;
+    ASSERT_EQ(rrc_BCCH_BCH_Message_NB_decode(&parser, &msg), BITP_OK);
+    ASSERT_EQ(parser.iter, 34u);
+
+    const rrc_MasterInformationBlock_NB_t &mib = msg.message;
+    ASSERT_EQ(mib.systemFrameNumber_MSB_r13, 0);
+    ASSERT_EQ(mib.hyperSFN_LSB_r13, 0);
+    ASSERT_EQ(mib.schedulingInfoSIB1_r13, 2);
+    ASSERT_EQ(mib.systemInfoValueTag_r13, 9);
+    ASSERT_EQ(mib.ab_Enabled_r13, 0);
+    ASSERT_EQ(mib.operationModeInfo_r13.choice, rrc_MasterInformationBlock_NB_operationModeInfo_r13_standalone_r13);
+    ASSERT_EQ(mib.operationModeInfo_r13.u.standalone_r13.spare, 0);
+    ASSERT_EQ(mib.additionalTransmissionSIB1_r15, 0);
+    ASSERT_EQ(mib.spare, 0);
+
+    ASSERT_EQ(encode(rrc_BCCH_BCH_Message_NB_encode, msg, 34), bytes);
+
+    // one bit short
+    bitp_parser_init(&parser, (char *)buf.data(), 33);
+    ASSERT_EQ(rrc_BCCH_BCH_Message_NB_decode(&parser, &msg), BITP_EFULL);
+    ASSERT_EQ(parser.iter, 0u);
+}
+
+TEST(asn1gen_tests, mib_nb_inband) {
+    // 1010 01 0101 10001 1 | 01 1 10 00 | 1 0000000000
+    const std::vector<uint8_t> bytes = {0xA5, 0x63, 0x71, 0x00, 0x00};
+
+    rrc_MasterInformationBlock_NB_t mib = {};
+    mib.systemFrameNumber_MSB_r13 = 0xA;
+    mib.hyperSFN_LSB_r13 = 1;
+    mib.schedulingInfoSIB1_r13 = 5;
+    mib.systemInfoValueTag_r13 = 17;
+    mib.ab_Enabled_r13 = 1;
+    mib.operationModeInfo_r13.choice = rrc_MasterInformationBlock_NB_operationModeInfo_r13_inband_DifferentPCI_r13;
+    mib.operationModeInfo_r13.u.inband_DifferentPCI_r13.eutra_NumCRS_Ports_r13 =
+        rrc_Inband_DifferentPCI_NB_r13_eutra_NumCRS_Ports_r13_four;
+    mib.operationModeInfo_r13.u.inband_DifferentPCI_r13.rasterOffset_r13 = rrc_ChannelRasterOffset_NB_r13_khz2dot5;
+    mib.additionalTransmissionSIB1_r15 = 1;
+    ASSERT_EQ(encode(rrc_MasterInformationBlock_NB_encode, mib, 34), bytes);
+
+    std::vector<uint8_t> buf = padded(bytes);
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, (char *)buf.data(), 34);
+    rrc_MasterInformationBlock_NB_t res;
+    ASSERT_EQ(rrc_MasterInformationBlock_NB_decode(&parser, &res), BITP_OK);
+    ASSERT_EQ(res.systemInfoValueTag_r13, 17);
+    ASSERT_EQ(res.operationModeInfo_r13.choice, mib.operationModeInfo_r13.choice);
+    ASSERT_EQ(res.operationModeInfo_r13.u.inband_DifferentPCI_r13.eutra_NumCRS_Ports_r13, 1);
+    ASSERT_EQ(res.operationModeInfo_r13.u.inband_DifferentPCI_r13.rasterOffset_r13, 2);
+    ASSERT_EQ(res.additionalTransmissionSIB1_r15, 1);
+
+    // out of range values are rejected before they reach the buffer
+    mib.schedulingInfoSIB1_r13 = 16;
+    std::vector<uint8_t> out(8);
+    bitp_packer_t packer;
+    bitp_packer_init(&packer, (char *)out.data(), 64, 1);
+    ASSERT_EQ(rrc_MasterInformationBlock_NB_encode(&packer, &mib), BITP_EINVALID_ARG);
+    ASSERT_EQ(out, std::vector<uint8_t>(8));
+}
+
+TEST(asn1gen_tests, optional_and_default) {
+    // offset present, barred absent | cellId 503 | offset -15
+    const std::vector<uint8_t> bytes = {0xBE, 0xE0};
+
+    rrc_Neighbour_t n = {};
+    n.cellId = 503;
+    n.offset = -15;
+    n.offset_present = 1;
+    n.barred = 1;
+    ASSERT_EQ(encode(rrc_Neighbour_encode, n, 16), bytes);
+
+    std::vector<uint8_t> buf = padded(bytes);
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, (char *)buf.data(), 16);
+    rrc_Neighbour_t res;
+    ASSERT_EQ(rrc_Neighbour_decode(&parser, &res), BITP_OK);
+    ASSERT_EQ(res.cellId, 503);
+    ASSERT_EQ(res.offset_present, 1);
+    ASSERT_EQ(res.offset, -15);
+    ASSERT_EQ(res.barred_present, 0);
+
+    // absent DEFAULT component gets its default value
+    buf = padded({0x00, 0x20});
+    bitp_parser_init(&parser, (char *)buf.data(), 11);
+    res.offset = 7;
+    ASSERT_EQ(rrc_Neighbour_decode(&parser, &res), BITP_OK);
+    ASSERT_EQ(res.cellId, 1);
+    ASSERT_EQ(res.offset, 0);
+
+    // cellId 510 is out of 0..503
+    buf = padded({0x3F, 0xC0});
+    bitp_parser_init(&parser, (char *)buf.data(), 11);
+    ASSERT_EQ(rrc_Neighbour_decode(&parser, &res), BITP_EINVALID_ARG);
+}
+
+static rrc_Report_t sample_report() {
+    rrc_Report_t r = {};
+    r.rsrp = -100;
+    r.mode = rrc_Report_mode_connected;
+    r.neighbours_count = 2;
+    r.neighbours[0].cellId = 1;
+    r.neighbours[1].cellId = 2;
+    r.neighbours[1].barred_present = 1;
+    r.neighbours[1].barred = 1;
+    r.payload_len = 2;
+    r.payload[0] = 0xDE;
+    r.payload[1] = 0xAD;
+    r.mask_len = 3;
+    r.mask = 5;
+    for (int i = 0; i < 8; ++i) {
+        r.signature[i] = (uint8_t)(i + 1);
+    }
+    r.signature[8] = 0xCC;
+    r.event_present = 1;
+    r.event.choice = rrc_Report_event_failure;
+    r.event.u.failure.cause = rrc_Report_event_failure_cause_timer;
+    r.event.u.failure.retries = 3;
+    return r;
+}
+
+TEST(asn1gen_tests, report) {
+    // ext 0 | event 1 | rsrp 40: 0101000 | ext 0, connected 01 | 2 neighbours 010
+    // 0 0 000000001 | 0 1 000000010 1
+    // payload length 001, DE AD | mask length 00010, 101
+    // signature 01 02 .. 08 110011 | ext 0, failure 10 | timer 1, ext 0, retries 10
+    const std::vector<uint8_t> bytes = {0x54, 0x14, 0x00, 0x50, 0x14, 0xEF, 0x56, 0x8A, 0x80,
+                                        0x81, 0x01, 0x82, 0x02, 0x83, 0x03, 0x84, 0x66, 0xA8};
+    const rrc_Report_t report = sample_report();
+    ASSERT_EQ(encode(rrc_Report_encode, report, 142), bytes);
+
+    std::vector<uint8_t> buf = padded(bytes);
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, (char *)buf.data(), 142);
+    rrc_Report_t res;
+    ASSERT_EQ(rrc_Report_decode(&parser, &res), BITP_OK);
+    ASSERT_EQ(parser.iter, 142u);
+    ASSERT_EQ(res.rsrp, -100);
+    ASSERT_EQ(res.mode, rrc_Report_mode_connected);
+    ASSERT_EQ(res.neighbours_count, 2);
+    ASSERT_EQ(res.neighbours[0].cellId, 1);
+    ASSERT_EQ(res.neighbours[0].barred_present, 0);
+    ASSERT_EQ(res.neighbours[1].cellId, 2);
+    ASSERT_EQ(res.neighbours[1].barred_present, 1);
+    ASSERT_EQ(res.neighbours[1].barred, 1);
+    ASSERT_EQ(res.payload_len, 2);
+    ASSERT_EQ(res.payload[0], 0xDE);
+    ASSERT_EQ(res.payload[1], 0xAD);
+    ASSERT_EQ(res.mask_len, 3);
+    ASSERT_EQ(res.mask, 5u);
+    ASSERT_EQ(memcmp(res.signature, report.signature, sizeof(res.signature)), 0);
+    ASSERT_EQ(res.event_present, 1);
+    ASSERT_EQ(res.event.choice, rrc_Report_event_failure);
+    ASSERT_EQ(res.event.u.failure.cause, 1);
+    ASSERT_EQ(res.event.u.failure.retries, 3);
+
+    // truncated inside the payload
+    bitp_parser_init(&parser, (char *)buf.data(), 60);
+    ASSERT_EQ(rrc_Report_decode(&parser, &res), BITP_EFULL);
+
+    // extensions aren't supported
+    std::vector<uint8_t> ext = buf;
+    ext[0] |= 0x80;
+    bitp_parser_init(&parser, (char *)ext.data(), 142);
+    ASSERT_EQ(rrc_Report_decode(&parser, &res), BITP_EINVALID_ARG);
+
+    // event choice index 3 of 3 alternatives
+    ext = buf;
+    ext[17] |= 0x18;
+    bitp_parser_init(&parser, (char *)ext.data(), 142);
+    ASSERT_EQ(rrc_Report_decode(&parser, &res), BITP_EINVALID_ARG);
+}
+
+TEST(asn1gen_tests, report_errors) {
+    std::vector<uint8_t> buf(64);
+    bitp_packer_t packer;
+
+    rrc_Report_t r = sample_report();
+    r.neighbours_count = 5;
+    bitp_packer_init(&packer, (char *)buf.data(), buf.size() * CHAR_BIT, 1);
+    ASSERT_EQ(rrc_Report_encode(&packer, &r), BITP_EINVALID_ARG);
+
+    r = sample_report();
+    r.payload_len = 0;
+    bitp_packer_init(&packer, (char *)buf.data(), buf.size() * CHAR_BIT, 1);
+    ASSERT_EQ(rrc_Report_encode(&packer, &r), BITP_EINVALID_ARG);
+
+    r = sample_report();
+    r.mask = 8;
+    bitp_packer_init(&packer, (char *)buf.data(), buf.size() * CHAR_BIT, 1);
+    ASSERT_EQ(rrc_Report_encode(&packer, &r), BITP_EINVALID_ARG);
+
+    r = sample_report();
+    r.rsrp = -43;
+    bitp_packer_init(&packer, (char *)buf.data(), buf.size() * CHAR_BIT, 1);
+    ASSERT_EQ(rrc_Report_encode(&packer, &r), BITP_EINVALID_ARG);
+
+    r = sample_report();
+    bitp_packer_init(&packer, (char *)buf.data(), 141, 1);
+    ASSERT_EQ(rrc_Report_encode(&packer, &r), BITP_EFULL);
+
+    // values past the first reserved block, in a SEQUENCE OF and a CHOICE, are rejected before
+    // anything is written too
+    r = sample_report();
+    r.neighbours[1].cellId = 504;
+    std::fill(buf.begin(), buf.end(), 0);
+    bitp_packer_init(&packer, (char *)buf.data(), buf.size() * CHAR_BIT, 1);
+    packer.iter = 5;
+    ASSERT_EQ(rrc_Report_encode(&packer, &r), BITP_EINVALID_ARG);
+    ASSERT_EQ(packer.iter, 5u);
+    ASSERT_EQ(buf, std::vector<uint8_t>(64));
+
+    r = sample_report();
+    r.event.u.failure.retries = 4;
+    bitp_packer_init(&packer, (char *)buf.data(), buf.size() * CHAR_BIT, 1);
+    ASSERT_EQ(rrc_Report_encode(&packer, &r), BITP_EINVALID_ARG);
+    ASSERT_EQ(packer.iter, 0u);
+    ASSERT_EQ(buf, std::vector<uint8_t>(64));
+}
+
+TEST(asn1gen_tests, report_random_roundtrip) {
+    std::mt19937_64 rng(31);
+
+    for (int round = 0; round < 500; ++round) {
+        rrc_Report_t r = {};
+        r.rsrp = (int16_t)(-140 + (int)(rng() % 97));
+        r.mode = (uint8_t)(rng() % 3);
+        r.neighbours_count = (uint8_t)(rng() % 5);
+        for (unsigned i = 0; i < r.neighbours_count; ++i) {
+            r.neighbours[i].cellId = (uint16_t)(rng() % 504);
+            r.neighbours[i].offset_present = rng() & 1;
+            r.neighbours[i].offset = r.neighbours[i].offset_present ? (int8_t)(-15 + (int)(rng() % 31)) : 0;
+            r.neighbours[i].barred_present = rng() & 1;
+            r.neighbours[i].barred = r.neighbours[i].barred_present ? (uint8_t)(rng() & 1) : 0;
+        }
+        r.payload_len = (uint8_t)(1 + rng() % 8);
+        for (unsigned i = 0; i < r.payload_len; ++i) {
+            r.payload[i] = (uint8_t)rng();
+        }
+        r.mask_len = (uint8_t)(1 + rng() % 24);
+        r.mask = (uint32_t)(rng() & ((1u << r.mask_len) - 1));
+        for (unsigned i = 0; i < 9; ++i) {
+            r.signature[i] = (uint8_t)rng();
+        }
+        r.signature[8] &= 0xFC;
+        r.event_present = rng() & 1;
+        if (r.event_present) {
+            r.event.choice = (uint8_t)(rng() % 3);
+            if (r.event.choice == rrc_Report_event_handover) {
+                r.event.u.handover = (uint16_t)rng();
+            }
+            else if (r.event.choice == rrc_Report_event_failure) {
+                r.event.u.failure.cause = (uint8_t)(rng() & 1);
+                r.event.u.failure.retries = (uint8_t)(1 + rng() % 3);
+            }
+        }
+
+        std::vector<uint8_t> buf(64);
+        bitp_packer_t packer;
+        bitp_packer_init(&packer, (char *)buf.data(), 48 * CHAR_BIT, 1);
+        ASSERT_EQ(rrc_Report_encode(&packer, &r), BITP_OK);
+
+        bitp_parser_t parser;
+        bitp_parser_init(&parser, (char *)buf.data(), packer.iter);
+        rrc_Report_t res = {};
+        ASSERT_EQ(rrc_Report_decode(&parser, &res), BITP_OK);
+        ASSERT_EQ(parser.iter, packer.iter);
+
+        std::vector<uint8_t> again(64);
+        bitp_packer_init(&packer, (char *)again.data(), 48 * CHAR_BIT, 1);
+        ASSERT_EQ(rrc_Report_encode(&packer, &res), BITP_OK);
+        ASSERT_EQ(again, buf);
+    }
+}
+
+TEST(asn1gen_tests, wide_integers) {
+    // offsets from lb past INT64_MAX
+    rrc_Wide_t w = {INT64_MAX, 4611686018427387904LL, INT64_MAX};
+    std::vector<uint8_t> buf = padded(encode(rrc_Wide_encode, w, 192));
+    std::vector<uint8_t> expected = padded({0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x80, 0x00, 0x00, 0x00,
+                                            0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00});
+    ASSERT_EQ(buf, expected);
+
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, (char *)buf.data(), 192);
+    rrc_Wide_t res = {};
+    ASSERT_EQ(rrc_Wide_decode(&parser, &res), BITP_OK);
+    ASSERT_EQ(res.full, INT64_MAX);
+    ASSERT_EQ(res.half, 4611686018427387904LL);
+    ASSERT_EQ(res.upper, INT64_MAX);
+
+    w = {INT64_MIN, -4611686018427387904LL, -1};
+    buf = padded(encode(rrc_Wide_encode, w, 192));
+    ASSERT_EQ(buf, padded(std::vector<uint8_t>(24)));
+    bitp_parser_init(&parser, (char *)buf.data(), 192);
+    ASSERT_EQ(rrc_Wide_decode(&parser, &res), BITP_OK);
+    ASSERT_EQ(res.full, INT64_MIN);
+    ASSERT_EQ(res.half, -4611686018427387904LL);
+    ASSERT_EQ(res.upper, -1);
+
+    // 2^63 + 1 values in 64 bits, the raw value past the range is rejected
+    buf[8] = 0x80;
+    buf[15] = 0x01;
+    bitp_parser_init(&parser, (char *)buf.data(), 192);
+    ASSERT_EQ(rrc_Wide_decode(&parser, &res), BITP_EINVALID_ARG);
+}
@@ -0,0 +1,139 @@
+/*
+ * batch_tests_with_checkers.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <atomic>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#define BITP_CHECK_ALL
+#include "bitp/batch.h"
+}
+
+namespace {
+
+// 3-bit field count, then per field a 6-bit width - 1 and the value
+struct message {
+    unsigned n_fields;
+    unsigned widths[8];
+    uint64_t vals[8];
+};
+
+}
+
+static bitp_status_t pack(bitp_packer_t *packer, const void *msg, void *ctx) {
+    const message *m = (const message *)msg;
+    if (ctx) {
+        (*(std::atomic<int> *)ctx)++;
+    }
+    bitp_status_t s = bitp_packer_add_u8(packer, (uint8_t)m->n_fields, 3);
+    for (unsigned i = 0; i < m->n_fields && s == BITP_OK; ++i) {
+        s = bitp_packer_add_u8(packer, (uint8_t)(m->widths[i] - 1), 6);
+        if (s == BITP_OK) {
+            s = bitp_packer_add_u64(packer, m->vals[i], m->widths[i]);
+        }
+    }
+    return s;
+}
+
+static size_t size(const void *msg, void *) {
+    const message *m = (const message *)msg;
+    size_t n_bits = 3;
+    for (unsigned i = 0; i < m->n_fields; ++i) {
+        n_bits += 6 + m->widths[i];
+    }
+    return n_bits;
+}
+
+static std::vector<message> random_messages(size_t n, std::mt19937_64 &rng) {
+    std::vector<message> res(n);
+    for (message &m : res) {
+        m.n_fields = rng() % 8;
+        for (unsigned i = 0; i < m.n_fields; ++i) {
+            m.widths[i] = 1 + rng() % 64;
+            m.vals[i] = rng() & (~0ULL >> (64 - m.widths[i]));
+        }
+    }
+    return res;
+}
+
+TEST(batch_tests, matches_serial) {
+    std::mt19937_64 rng(33);
+    for (size_t n_msgs : {0, 1, 255, 256, 1000, 5000}) {
+        std::vector<message> msgs = random_messages(n_msgs, rng);
+        size_t start = rng() % 13;
+
+        std::vector<char> expected(n_msgs * 70 + 16);
+        bitp_packer_t serial;
+        bitp_packer_init(&serial, expected.data(), expected.size() * CHAR_BIT, 1);
+        serial.iter = start;
+        std::vector<size_t> expected_offsets = {start};
+        for (const message &m : msgs) {
+            ASSERT_EQ(pack(&serial, &m, NULL), BITP_OK);
+            expected_offsets.push_back(serial.iter);
+        }
+
+        for (unsigned n_threads : {1, 2, 3, 8}) {
+            for (int dry_run = 0; dry_run < 2; ++dry_run) {
+                bitp_batch_t batch = {pack, dry_run ? NULL : size, 3 + 8 * 70, NULL, n_threads};
+
+                std::vector<char> out(expected.size());
+                bitp_packer_t packer;
+                bitp_packer_init(&packer, out.data(), out.size() * CHAR_BIT, 1);
+                packer.iter = start;
+                std::vector<size_t> offsets(n_msgs + 1);
+                ASSERT_EQ(bitp_batch_pack(&batch, &packer, msgs.data(), sizeof(message), n_msgs, offsets.data()),
+                          BITP_OK);
+                ASSERT_EQ(packer.iter, serial.iter);
+                ASSERT_EQ(offsets, expected_offsets);
+                ASSERT_EQ(out, expected) << n_msgs << " messages, " << n_threads << " threads";
+            }
+        }
+    }
+}
+
+TEST(batch_tests, errors) {
+    std::mt19937_64 rng(1);
+    std::vector<message> msgs = random_messages(1000, rng);
+    size_t total = 0;
+    for (const message &m : msgs) {
+        total += size(&m, NULL);
+    }
+
+    std::vector<char> out((total + 7) / 8 + 8);
+    bitp_packer_t packer;
+    std::atomic<int> calls(0);
+    bitp_batch_t batch = {pack, size, 0, &calls, 4};
+
+    // one bit short: nothing is packed
+    bitp_packer_init(&packer, out.data(), total - 1, 1);
+    ASSERT_EQ(bitp_batch_pack(&batch, &packer, msgs.data(), sizeof(message), msgs.size(), NULL), BITP_EFULL);
+    ASSERT_EQ(calls, 0);
+    ASSERT_EQ(packer.iter, 0u);
+
+    bitp_packer_init(&packer, out.data(), total, 1);
+    ASSERT_EQ(bitp_batch_pack(&batch, &packer, msgs.data(), sizeof(message), msgs.size(), NULL), BITP_OK);
+    ASSERT_EQ(packer.iter, total);
+
+    // the size function disagrees with pack
+    msgs[700].widths[0] = 0;
+    msgs[700].n_fields = 1;
+    bitp_packer_init(&packer, out.data(), out.size() * CHAR_BIT, 1);
+    ASSERT_EQ(bitp_batch_pack(&batch, &packer, msgs.data(), sizeof(message), msgs.size(), NULL),
+              BITP_EINVALID_ARG);
+    ASSERT_EQ(packer.iter, 0u);
+
+    // the dry run needs a scratch size
+    batch.size = NULL;
+    ASSERT_EQ(bitp_batch_pack(&batch, &packer, msgs.data(), sizeof(message), msgs.size(), NULL),
+              BITP_EINVALID_ARG);
+    // and reports pack errors
+    batch.max_msg_bits = 64;
+    ASSERT_EQ(bitp_batch_pack(&batch, &packer, msgs.data(), sizeof(message), msgs.size(), NULL), BITP_EFULL);
+}
@@ -0,0 +1,152 @@
+/*
+ * bitmap_tests_with_checkers.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#define BITP_CHECK_ALL
+#include "bitp/bitmap.h"
+}
+
+static int get_bit(const std::vector<char> &buf, size_t pos) {
+    return ((uint8_t)buf[pos / 8] >> (7 - pos % 8)) & 1;
+}
+
+static void set_bit(std::vector<char> &buf, size_t pos, int val) {
+    uint8_t m = (uint8_t)(0x80 >> (pos % 8));
+    buf[pos / 8] = (char)(val ? (uint8_t)buf[pos / 8] | m : (uint8_t)buf[pos / 8] & ~m);
+}
+
+// random bits, sparse or dense in places, so that the scans skip long runs
+static std::vector<char> random_bitmap(std::mt19937_64 &rng, size_t n_bytes) {
+    std::vector<char> buf(n_bytes);
+    int density = (int)(rng() % 4);
+    for (size_t i = 0; i < n_bytes * 8; ++i) {
+        int bit;
+        switch (density) {
+        case 0:
+            bit = rng() % 300 == 0;
+            break;
+        case 1:
+            bit = rng() % 300 != 0;
+            break;
+        default:
+            bit = (int)(rng() & 1);
+        }
+        set_bit(buf, i, bit);
+    }
+    return buf;
+}
+
+TEST(bitmap_tests, popcount_and_find) {
+    std::mt19937_64 rng(43);
+    for (int round = 0; round < 400; ++round) {
+        size_t n_bytes = 1 + rng() % 600;
+        std::vector<char> buf = random_bitmap(rng, n_bytes);
+        size_t begin = rng() % (n_bytes * 8);
+        size_t end = begin + rng() % (n_bytes * 8 - begin + 1);
+        bitp_view_t view = {buf.data(), begin, end};
+
+        size_t count = 0;
+        for (size_t i = begin; i < end; ++i) {
+            count += get_bit(buf, i);
+        }
+        for (int isa = BITP_ISA_SCALAR; isa <= bitp_cpu_isa(bitp_cpu_features()); ++isa) {
+            ASSERT_EQ(count, bitp_bitmap_popcount_isa(&view, (bitp_isa_t)isa)) << "isa " << isa;
+
+            for (int k = 0; k < 20; ++k) {
+                size_t from = rng() % (end - begin + 2);
+                size_t next_set = BITP_BITMAP_NPOS;
+                size_t next_clear = BITP_BITMAP_NPOS;
+                for (size_t i = begin + from; i < end; ++i) {
+                    if (get_bit(buf, i) && next_set == BITP_BITMAP_NPOS) {
+                        next_set = i - begin;
+                    }
+                    if (!get_bit(buf, i) && next_clear == BITP_BITMAP_NPOS) {
+                        next_clear = i - begin;
+                    }
+                }
+                ASSERT_EQ(next_set, bitp_bitmap_find_set_isa(&view, from, (bitp_isa_t)isa)) << "isa " << isa;
+                ASSERT_EQ(next_clear, bitp_bitmap_find_clear_isa(&view, from, (bitp_isa_t)isa)) << "isa " << isa;
+            }
+        }
+
+        std::vector<size_t> expected;
+        for (size_t i = begin; i < end; ++i) {
+            if (get_bit(buf, i)) {
+                expected.push_back(i - begin);
+            }
+        }
+        std::vector<size_t> got;
+        bitp_bitmap_iter_t it;
+        size_t pos;
+        bitp_bitmap_iter_init(&it, &view);
+        while (bitp_bitmap_iter_next(&it, &pos)) {
+            got.push_back(pos);
+        }
+        ASSERT_EQ(expected, got);
+        ASSERT_EQ(0, bitp_bitmap_iter_next(&it, &pos));
+    }
+}
+
+TEST(bitmap_tests, apply) {
+    std::mt19937_64 rng(44);
+    for (int round = 0; round < 1000; ++round) {
+        size_t n_bytes = 1 + rng() % 300;
+        std::vector<char> src = random_bitmap(rng, n_bytes);
+        std::vector<char> dst0 = random_bitmap(rng, n_bytes);
+        size_t s = rng() % (n_bytes * 8);
+        size_t d = rng() % (n_bytes * 8);
+        size_t n_bits = rng() % (n_bytes * 8 - (s > d ? s : d) + 1);
+        size_t src_cap = s + n_bits + rng() % (n_bytes * 8 - s - n_bits + 1);
+        size_t dst_cap = d + n_bits + rng() % (n_bytes * 8 - d - n_bits + 1);
+        bitp_bitmap_op_t op = (bitp_bitmap_op_t)(rng() % 4);
+
+        std::vector<char> expected(dst0);
+        for (size_t i = 0; i < n_bits; ++i) {
+            int a = get_bit(dst0, d + i);
+            int b = get_bit(src, s + i);
+            int r = op == BITP_BITMAP_AND ? a & b : op == BITP_BITMAP_OR ? a | b : op == BITP_BITMAP_XOR ? a ^ b : a & !b;
+            set_bit(expected, d + i, r);
+        }
+
+        for (int isa = BITP_ISA_SCALAR; isa <= bitp_cpu_isa(bitp_cpu_features()); ++isa) {
+            std::vector<char> dst(dst0);
+            bitp_packer_t packer = {dst.data(), dst_cap, d};
+            bitp_parser_t parser = {src.data(), src_cap, s};
+            ASSERT_EQ(BITP_OK, bitp_bitmap_apply_isa(&packer, &parser, n_bits, op, (bitp_isa_t)isa));
+            ASSERT_EQ(expected, dst) << "isa " << isa << " op " << op << " s " << s << " d " << d << " n " << n_bits;
+            ASSERT_EQ(d + n_bits, packer.iter);
+            ASSERT_EQ(s + n_bits, parser.iter);
+        }
+    }
+}
+
+TEST(bitmap_tests, errors) {
+    char a[4] = {1, 2, 3, 4};
+    char b[4] = {5, 6, 7, 8};
+    bitp_packer_t packer = {a, 32, 8};
+    bitp_parser_t parser = {b, 20, 0};
+    EXPECT_EQ(BITP_EFULL, bitp_bitmap_apply(&packer, &parser, 25, BITP_BITMAP_OR));
+    EXPECT_EQ(BITP_EFULL, bitp_bitmap_apply(&packer, &parser, 21, BITP_BITMAP_OR));
+    EXPECT_EQ(8u, packer.iter);
+    EXPECT_EQ(0u, parser.iter);
+    EXPECT_EQ(1, a[0]);
+    EXPECT_EQ(2, a[1]);
+
+    bitp_view_t empty = {b, 9, 9};
+    EXPECT_EQ(0u, bitp_bitmap_popcount(&empty));
+    EXPECT_EQ(BITP_BITMAP_NPOS, bitp_bitmap_find_set(&empty, 0));
+    EXPECT_EQ(BITP_BITMAP_NPOS, bitp_bitmap_find_clear(&empty, 0));
+    bitp_bitmap_iter_t it;
+    size_t pos;
+    bitp_bitmap_iter_init(&it, &empty);
+    EXPECT_EQ(0, bitp_bitmap_iter_next(&it, &pos));
+}
@@ -0,0 +1,171 @@
+/*
+ * bitops_tests_with_checkers.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#define BITP_CHECK_ALL
+#include "bitp/bitops.h"
+}
+
+static int get_bit(const std::vector<char> &buf, size_t i) {
+    return ((uint8_t)buf[i / CHAR_BIT] >> (CHAR_BIT - 1 - i % CHAR_BIT)) & 1;
+}
+
+static std::vector<char> random_buf(size_t n_bytes, std::mt19937_64 &rng) {
+    std::vector<char> buf(n_bytes);
+    for (char &c : buf) {
+        c = (char)rng();
+    }
+    return buf;
+}
+
+TEST(bitops, words) {
+    std::mt19937_64 rng(1);
+    for (int round = 0; round < 1000; ++round) {
+        uint64_t x = rng();
+        uint64_t r = bitp_reverse_64(x);
+        uint64_t t = bitp_transpose_8x8(x);
+        for (unsigned i = 0; i < 64; ++i) {
+            ASSERT_EQ((x >> (63 - i)) & 1, r >> i & 1);
+            // bit (row i / 8, column i % 8), row 0 in the top byte, MSB first
+            unsigned row = i / 8, col = i % 8;
+            ASSERT_EQ((x >> (63 - i)) & 1, (t >> (63 - (col * 8 + row))) & 1);
+        }
+        EXPECT_EQ(x, bitp_transpose_8x8(t));
+    }
+
+    for (int isa = BITP_ISA_SCALAR; isa <= bitp_cpu_isa(bitp_cpu_features()); ++isa) {
+        uint64_t m[64], t[64];
+        for (auto &row : m) {
+            row = rng();
+        }
+        memcpy(t, m, sizeof(m));
+        bitp_transpose_64x64_isa(t, (bitp_isa_t)isa);
+        for (unsigned i = 0; i < 64; ++i) {
+            for (unsigned j = 0; j < 64; ++j) {
+                ASSERT_EQ((m[i] >> (63 - j)) & 1, (t[j] >> (63 - i)) & 1) << "isa " << isa;
+            }
+        }
+    }
+}
+
+TEST(bitops, copy_and_reverse) {
+    std::mt19937_64 rng(2);
+    for (int round = 0; round < 500; ++round) {
+        size_t n_bits = round < 8 ? round : rng() % 3000;
+        // byte-aligned ends now and then, for the byte path
+        size_t src_off = rng() % 4 ? rng() % 64 : 8 * (rng() % 8);
+        size_t dst_off = rng() % 4 ? rng() % 64 : 8 * (rng() % 8);
+        if (rng() % 2) {
+            n_bits -= (src_off + n_bits) % 8 && n_bits > 8 ? (src_off + n_bits) % 8 : 0;
+        }
+        std::vector<char> src = random_buf((src_off + n_bits) / CHAR_BIT + 1, rng);
+
+        for (int isa = BITP_ISA_SCALAR; isa <= bitp_cpu_isa(bitp_cpu_features()); ++isa) {
+            for (int op = 0; op < 2; ++op) {
+                std::vector<char> dst((dst_off + n_bits) / CHAR_BIT + 1, 0);
+                bitp_parser_t parser;
+                bitp_parser_init(&parser, src.data(), src_off + n_bits);
+                parser.iter = src_off;
+                bitp_packer_t packer;
+                bitp_packer_init(&packer, dst.data(), dst_off + n_bits, 1);
+                packer.iter = dst_off;
+                ASSERT_EQ(BITP_OK, op ? bitp_bits_reverse_isa(&packer, &parser, n_bits, (bitp_isa_t)isa)
+                                      : bitp_bits_copy(&packer, &parser, n_bits));
+                EXPECT_EQ(src_off + n_bits, parser.iter);
+                EXPECT_EQ(dst_off + n_bits, packer.iter);
+                for (size_t i = 0; i < dst.size() * CHAR_BIT; ++i) {
+                    int expected = 0;
+                    if (i >= dst_off && i < dst_off + n_bits) {
+                        size_t k = i - dst_off;
+                        expected = get_bit(src, src_off + (op ? n_bits - 1 - k : k));
+                    }
+                    ASSERT_EQ(expected, get_bit(dst, i)) << "op " << op << " isa " << isa << " n_bits " << n_bits
+                                                         << " src_off " << src_off << " dst_off " << dst_off;
+                }
+            }
+        }
+    }
+}
+
+TEST(bitops, transpose) {
+    std::mt19937_64 rng(3);
+    const size_t sizes[][2] = {{1, 1}, {3, 5}, {8, 8}, {64, 64}, {32, 3}, {3, 32}, {65, 129}, {200, 70}, {13, 300}};
+    for (auto size : sizes) {
+        size_t n_rows = size[0], n_cols = size[1], n_bits = n_rows * n_cols;
+        size_t src_off = rng() % 8, dst_off = rng() % 8;
+        std::vector<char> src = random_buf((src_off + n_bits) / CHAR_BIT + 1, rng);
+        for (int isa = BITP_ISA_SCALAR; isa <= bitp_cpu_isa(bitp_cpu_features()); ++isa) {
+            std::vector<char> dst((dst_off + n_bits) / CHAR_BIT + 1, 0);
+            bitp_parser_t parser;
+            bitp_parser_init(&parser, src.data(), src_off + n_bits);
+            parser.iter = src_off;
+            bitp_packer_t packer;
+            bitp_packer_init(&packer, dst.data(), dst_off + n_bits, 1);
+            packer.iter = dst_off;
+            ASSERT_EQ(BITP_OK, bitp_bits_transpose_isa(&packer, &parser, n_rows, n_cols, (bitp_isa_t)isa));
+            for (size_t r = 0; r < n_rows; ++r) {
+                for (size_t c = 0; c < n_cols; ++c) {
+                    ASSERT_EQ(get_bit(src, src_off + r * n_cols + c), get_bit(dst, dst_off + c * n_rows + r))
+                        << n_rows << "x" << n_cols << " isa " << isa;
+                }
+            }
+            for (size_t i = 0; i < dst_off; ++i) {
+                ASSERT_EQ(0, get_bit(dst, i));
+            }
+            for (size_t i = dst_off + n_bits; i < dst.size() * CHAR_BIT; ++i) {
+                ASSERT_EQ(0, get_bit(dst, i));
+            }
+
+            // and back
+            std::vector<char> back(src.size(), 0);
+            bitp_parser_init(&parser, dst.data(), dst_off + n_bits);
+            parser.iter = dst_off;
+            bitp_packer_init(&packer, back.data(), src_off + n_bits, 1);
+            packer.iter = src_off;
+            ASSERT_EQ(BITP_OK, bitp_bits_transpose_isa(&packer, &parser, n_cols, n_rows, (bitp_isa_t)isa));
+            for (size_t i = src_off; i < src_off + n_bits; ++i) {
+                ASSERT_EQ(get_bit(src, i), get_bit(back, i));
+            }
+        }
+    }
+}
+
+TEST(bitops, interleave_streams) {
+    // 3 streams of 5 bits: a0 b0 c0 a1 b1 c1 ...
+    const char data[8] = {(char)0xF8, 0x00, 0x00};
+    std::vector<char> out(8, 0);
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, data, 15);
+    bitp_packer_t packer;
+    bitp_packer_init(&packer, out.data(), 15, 1);
+    ASSERT_EQ(BITP_OK, bitp_bits_transpose(&packer, &parser, 3, 5));
+    // stream a is all ones
+    EXPECT_EQ((char)0x92, out[0]);
+    EXPECT_EQ((char)0x48, out[1]);
+}
+
+TEST(bitops, errors) {
+    std::vector<char> buf(16, 0), out(16, 0);
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, buf.data(), 100);
+    bitp_packer_t packer;
+    bitp_packer_init(&packer, out.data(), 90, 1);
+    EXPECT_EQ(BITP_EFULL, bitp_bits_copy(&packer, &parser, 91));
+    EXPECT_EQ(BITP_EFULL, bitp_bits_reverse(&packer, &parser, 91));
+    EXPECT_EQ(BITP_EFULL, bitp_bits_transpose(&packer, &parser, 7, 13));
+    EXPECT_EQ(BITP_EFULL, bitp_bits_transpose(&packer, &parser, (size_t)1 << 40, (size_t)1 << 40));
+    EXPECT_EQ(0u, parser.iter);
+    EXPECT_EQ(0u, packer.iter);
+    EXPECT_EQ(BITP_OK, bitp_bits_transpose(&packer, &parser, 9, 10));
+    EXPECT_EQ(BITP_EFULL, bitp_bits_copy(&packer, &parser, 11));
+    EXPECT_EQ(BITP_OK, bitp_bits_copy(&packer, &parser, 0));
+}
@@ -0,0 +1,272 @@
+/*
+ * cache_tests_with_checkers.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#define BITP_CHECK_ALL
+#include "bitp/cache.h"
+#include "bitp/hash.h"
+#include "bitp/packer.h"
+}
+
+// copies n_bits of src from bit src_off to bit dst_off of a zeroed dst
+static void copy_bits(std::vector<char> &dst, size_t dst_off, const std::vector<char> &src, size_t src_off, size_t n_bits) {
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, src.data(), src.size() * CHAR_BIT);
+    bitp_parser_skip(&parser, src_off);
+    bitp_packer_t packer;
+    bitp_packer_init(&packer, dst.data(), dst.size() * CHAR_BIT, 1);
+    packer.iter = dst_off;
+    for (size_t done = 0; done < n_bits; done += 64) {
+        unsigned n = (unsigned)std::min<size_t>(64, n_bits - done);
+        uint64_t v = 0;
+        ASSERT_EQ(BITP_OK, bitp_parser_extract_u64(&parser, &v, n));
+        ASSERT_EQ(BITP_OK, bitp_packer_add_u64(&packer, v, n));
+    }
+}
+
+TEST(cache_tests, hash) {
+    std::mt19937_64 rng(44);
+    for (int round = 0; round < 2000; ++round) {
+        size_t n_bits = round < 1000 ? rng() % 600 : rng() % 20000;
+        // padded for the word loads of the parser and packer
+        std::vector<char> src(n_bits / CHAR_BIT + 1 + sizeof(uint64_t));
+        for (auto &b : src) {
+            b = (char)rng();
+        }
+        uint64_t h = bitp_hash_bits_isa(src.data(), 0, n_bits, BITP_ISA_SCALAR);
+
+        // the same bits at another offset, with other bits around them
+        size_t off = rng() % 16;
+        std::vector<char> dst(src.size() + 2);
+        copy_bits(dst, off, src, 0, n_bits);
+        dst.front() ^= (char)(off ? 0x80 : 0);
+        dst.back() = (char)rng();
+        for (int isa = BITP_ISA_SCALAR; isa <= bitp_cpu_isa(bitp_cpu_features()); ++isa) {
+            ASSERT_EQ(h, bitp_hash_bits_isa(dst.data(), off, n_bits, (bitp_isa_t)isa)) << "isa " << isa << " n_bits " << n_bits;
+            ASSERT_EQ(h, bitp_hash_bits_isa(src.data(), 0, n_bits, (bitp_isa_t)isa)) << "isa " << isa << " n_bits " << n_bits;
+        }
+
+        // one bit flipped, or a bit less
+        if (n_bits) {
+            size_t bit = rng() % n_bits;
+            src[bit / CHAR_BIT] ^= (char)(0x80 >> bit % CHAR_BIT);
+            ASSERT_NE(h, bitp_hash_bits(src.data(), 0, n_bits)) << n_bits << " " << bit;
+            src[bit / CHAR_BIT] ^= (char)(0x80 >> bit % CHAR_BIT);
+            ASSERT_NE(h, bitp_hash_bits(src.data(), 0, n_bits - 1)) << n_bits;
+        }
+    }
+
+    // the zero padding of the last stripe isn't taken for data
+    char zeros[64] = {};
+    EXPECT_NE(bitp_hash_bits(zeros, 0, 100), bitp_hash_bits(zeros, 0, 128));
+
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, zeros, 100);
+    bitp_parser_skip(&parser, 4);
+    uint64_t h = 0;
+    EXPECT_EQ(BITP_OK, bitp_parser_hash(&parser, 96, &h));
+    EXPECT_EQ(bitp_hash_bits(zeros, 0, 96), h);
+    EXPECT_EQ(BITP_EFULL, bitp_parser_hash(&parser, 97, &h));
+    EXPECT_EQ(4u, parser.iter);
+}
+
+TEST(cache_tests, lru) {
+    EXPECT_EQ(nullptr, bitp_cache_create(3, 8, 4));
+    EXPECT_EQ(nullptr, bitp_cache_create(16, 8, 3));
+    EXPECT_EQ(nullptr, bitp_cache_create(16, 0, 1));
+
+    bitp_cache_t *cache = bitp_cache_create(4, sizeof(uint64_t), 1);
+    ASSERT_NE(nullptr, cache);
+    for (uint64_t k = 1; k <= 4; ++k) {
+        uint64_t v = k * 100;
+        bitp_cache_put(cache, k, 10, &v);
+    }
+    uint64_t v = 0;
+    EXPECT_EQ(1, bitp_cache_get(cache, 1, 10, &v));
+    EXPECT_EQ(100u, v);
+    // same hash, other length
+    EXPECT_EQ(0, bitp_cache_get(cache, 1, 11, &v));
+
+    // 2 is the least recently used now
+    v = 500;
+    bitp_cache_put(cache, 5, 10, &v);
+    EXPECT_EQ(0, bitp_cache_get(cache, 2, 10, &v));
+    for (uint64_t k : {1, 3, 4, 5}) {
+        EXPECT_EQ(1, bitp_cache_get(cache, k, 10, &v)) << k;
+        EXPECT_EQ(k * 100, v);
+    }
+    // replaced in place
+    v = 42;
+    bitp_cache_put(cache, 3, 10, &v);
+    EXPECT_EQ(1, bitp_cache_get(cache, 3, 10, &v));
+    EXPECT_EQ(42u, v);
+
+    bitp_cache_stats_t stats;
+    bitp_cache_stats(cache, &stats);
+    EXPECT_EQ(6u, stats.hits);
+    EXPECT_EQ(2u, stats.misses);
+    EXPECT_EQ(5u, stats.inserts);
+    EXPECT_EQ(1u, stats.evictions);
+
+    bitp_cache_clear(cache);
+    EXPECT_EQ(0, bitp_cache_get(cache, 3, 10, &v));
+    bitp_cache_stats(cache, &stats);
+    EXPECT_EQ(0u, stats.hits);
+    EXPECT_EQ(1u, stats.misses);
+    bitp_cache_destroy(cache);
+}
+
+// a message is a 4-bit count and count 12-bit values, their sum is the result
+struct decoded {
+    uint64_t sum;
+    unsigned n_values;
+};
+
+static bitp_status_t decode(bitp_parser_t *parser, void *res, void *ctx) {
+    decoded *d = (decoded *)res;
+    uint8_t n;
+    bitp_status_t s = bitp_parser_extract_u8(parser, &n, 4);
+    if (s != BITP_OK) {
+        return s;
+    }
+    d->sum = 0;
+    d->n_values = n;
+    for (unsigned i = 0; i < n; ++i) {
+        uint16_t v;
+        s = bitp_parser_extract_u16(parser, &v, 12);
+        if (s != BITP_OK) {
+            return s;
+        }
+        d->sum += v;
+    }
+    (*(std::atomic<int> *)ctx)++;
+    return BITP_OK;
+}
+
+static uint16_t message_value(uint64_t seed, unsigned i) {
+    return (uint16_t)((seed + i * 977) & 0xFFF);
+}
+
+static size_t pack_message(bitp_packer_t *packer, unsigned n, uint64_t seed) {
+    size_t start = packer->iter;
+    bitp_packer_add_u8(packer, (uint8_t)n, 4);
+    for (unsigned i = 0; i < n; ++i) {
+        bitp_packer_add_u16(packer, message_value(seed, i), 12);
+    }
+    return packer->iter - start;
+}
+
+TEST(cache_tests, decode) {
+    std::atomic<int> n_decoded(0);
+    bitp_cache_t *cache = bitp_cache_create(64, sizeof(decoded), 4);
+    ASSERT_NE(nullptr, cache);
+
+    // a stream of 3 messages repeated, every copy at another bit phase
+    char buf[256] = {};
+    bitp_packer_t packer;
+    bitp_packer_init(&packer, buf, sizeof(buf) * CHAR_BIT, 1);
+    std::vector<size_t> lens;
+    for (int rep = 0; rep < 4; ++rep) {
+        for (unsigned m = 0; m < 3; ++m) {
+            lens.push_back(pack_message(&packer, 3 + m, m));
+        }
+        bitp_packer_add_u8(&packer, 0, 1);
+    }
+
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, buf, packer.iter);
+    for (size_t i = 0; i < lens.size(); ++i) {
+        decoded d = {};
+        ASSERT_EQ(BITP_OK, bitp_cache_decode(cache, &parser, lens[i], decode, &n_decoded, &d));
+        uint64_t sum = 0;
+        for (unsigned k = 0; k < 3 + i % 3; ++k) {
+            sum += message_value(i % 3, k);
+        }
+        EXPECT_EQ(3 + i % 3, d.n_values);
+        EXPECT_EQ(sum, d.sum);
+        if (i % 3 == 2) {
+            bitp_parser_skip(&parser, 1);
+        }
+    }
+    EXPECT_EQ(packer.iter, parser.iter);
+    EXPECT_EQ(3, n_decoded.load());
+    bitp_cache_stats_t stats;
+    bitp_cache_stats(cache, &stats);
+    EXPECT_EQ(9u, stats.hits);
+    EXPECT_EQ(3u, stats.misses);
+
+    // a decode error isn't stored and leaves the parser
+    decoded d;
+    bitp_parser_init(&parser, buf, packer.iter);
+    EXPECT_EQ(BITP_EFULL, bitp_cache_decode(cache, &parser, lens[0] - 1, decode, &n_decoded, &d));
+    EXPECT_EQ(0u, parser.iter);
+    EXPECT_EQ(BITP_EFULL, bitp_cache_decode(cache, &parser, lens[0] - 1, decode, &n_decoded, &d));
+    bitp_cache_stats(cache, &stats);
+    EXPECT_EQ(5u, stats.misses);
+    EXPECT_EQ(3u, stats.inserts);
+    EXPECT_EQ(BITP_EFULL, bitp_cache_decode(cache, &parser, packer.iter + 1, decode, &n_decoded, &d));
+    bitp_cache_destroy(cache);
+}
+
+TEST(cache_tests, threads) {
+    // more distinct messages than fit, so that the threads evict each other's entries
+    const unsigned n_distinct = 200;
+    std::vector<char> buf(n_distinct * 16);
+    std::vector<size_t> offs;
+    bitp_packer_t packer;
+    bitp_packer_init(&packer, buf.data(), buf.size() * CHAR_BIT, 1);
+    for (unsigned m = 0; m < n_distinct; ++m) {
+        offs.push_back(packer.iter);
+        pack_message(&packer, 1 + m % 8, m);
+    }
+    offs.push_back(packer.iter);
+
+    std::atomic<int> n_decoded(0);
+    bitp_cache_t *cache = bitp_cache_create(128, sizeof(decoded), 8);
+    ASSERT_NE(nullptr, cache);
+    const int n_threads = 4;
+    const int n_calls = 20000;
+    std::atomic<int> n_wrong(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < n_threads; ++t) {
+        threads.emplace_back([&, t] {
+            std::mt19937 rng(t);
+            for (int i = 0; i < n_calls; ++i) {
+                // a few messages far more often than the rest
+                unsigned m = rng() % 4 ? rng() % 16 : rng() % n_distinct;
+                bitp_parser_t parser;
+                bitp_parser_init(&parser, buf.data(), packer.iter);
+                bitp_parser_skip(&parser, offs[m]);
+                decoded d = {};
+                if (bitp_cache_decode(cache, &parser, offs[m + 1] - offs[m], decode, &n_decoded, &d) != BITP_OK ||
+                    d.n_values != 1 + m % 8) {
+                    n_wrong++;
+                }
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(0, n_wrong.load());
+
+    bitp_cache_stats_t stats;
+    bitp_cache_stats(cache, &stats);
+    EXPECT_EQ((uint64_t)n_threads * n_calls, stats.hits + stats.misses);
+    EXPECT_EQ((uint64_t)n_decoded.load(), stats.misses);
+    EXPECT_GT(stats.hits, stats.misses);
+    EXPECT_LE(stats.inserts - stats.evictions, 128u);
+    bitp_cache_destroy(cache);
+}
@@ -0,0 +1,172 @@
+/*
+ * codec_tests_with_checkers.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#define BITP_CHECK_ALL
+#include "bitp/codec.h"
+}
+
+static std::vector<char> encode(const std::vector<uint32_t> &vals, bitp_codec_mode_t mode, size_t *n_bits) {
+    // the parser reads whole words, keep the tail padded
+    std::vector<char> buf(bitp_codec_max_bits(vals.size()) / CHAR_BIT + 16, 0);
+    bitp_packer_t packer;
+    bitp_packer_init(&packer, buf.data(), bitp_codec_max_bits(vals.size()), 1);
+    EXPECT_EQ(BITP_OK, bitp_codec_encode_u32(&packer, vals.data(), vals.size(), mode));
+    *n_bits = packer.iter;
+    return buf;
+}
+
+static void check_roundtrip(const std::vector<uint32_t> &vals, bitp_codec_mode_t mode) {
+    size_t n_bits;
+    std::vector<char> buf = encode(vals, mode, &n_bits);
+    EXPECT_LE(n_bits, bitp_codec_max_bits(vals.size()));
+
+    for (int isa = BITP_ISA_SCALAR; isa <= bitp_cpu_isa(bitp_cpu_features()); ++isa) {
+        std::vector<uint32_t> res(vals.size() + 1, 0xDEADBEEF);
+        bitp_parser_t parser;
+        bitp_parser_init(&parser, buf.data(), n_bits);
+        ASSERT_EQ(BITP_OK, bitp_codec_decode_u32_isa(&parser, res.data(), vals.size(), mode, (bitp_isa_t)isa));
+        EXPECT_EQ(n_bits, parser.iter);
+        EXPECT_EQ(0xDEADBEEF, res[vals.size()]);
+        res.pop_back();
+        ASSERT_EQ(vals, res) << "isa " << isa;
+    }
+}
+
+TEST(codec, widths) {
+    std::mt19937 rng(7);
+    for (unsigned width = 0; width <= 32; ++width) {
+        for (size_t n : {1, 7, 8, 100, 128, 129, 1000}) {
+            std::vector<uint32_t> vals(n);
+            for (auto &v : vals) {
+                v = width ? 1000 + (rng() >> (32 - width)) : 1000;
+            }
+            check_roundtrip(vals, BITP_CODEC_FOR);
+            check_roundtrip(vals, BITP_CODEC_DELTA);
+        }
+    }
+    check_roundtrip({}, BITP_CODEC_FOR);
+}
+
+TEST(codec, exceptions) {
+    std::mt19937 rng(11);
+    std::vector<uint32_t> vals(1000);
+    for (auto &v : vals) {
+        v = rng() % 16;
+    }
+    for (size_t i = 3; i < vals.size(); i += 97) {
+        vals[i] = rng();
+    }
+    vals[127] = 0xFFFFFFFF;
+    vals[128] = 0xFFFFFFFF;
+    check_roundtrip(vals, BITP_CODEC_FOR);
+
+    // 3-bit values with an outlier: the width stays 3, the outlier is patched with 7 + 17 bits
+    size_t n_bits;
+    std::vector<uint32_t> block(128);
+    for (size_t i = 0; i < block.size(); ++i) {
+        block[i] = 5 + i % 8;
+    }
+    block[60] = 1u << 20;
+    encode(block, BITP_CODEC_FOR, &n_bits);
+    EXPECT_EQ(48u + 8 + 128 * 3 + 24, n_bits);
+    check_roundtrip(block, BITP_CODEC_FOR);
+}
+
+TEST(codec, delta) {
+    // microsecond timestamps with jitter, and a counter that wraps
+    std::mt19937 rng(3);
+    std::vector<uint32_t> ts(5000);
+    uint32_t t = 0xFFFF0000;
+    for (auto &v : ts) {
+        t += 1000 + rng() % 64;
+        v = t;
+    }
+    check_roundtrip(ts, BITP_CODEC_DELTA);
+
+    size_t for_bits, delta_bits;
+    encode(ts, BITP_CODEC_FOR, &for_bits);
+    encode(ts, BITP_CODEC_DELTA, &delta_bits);
+    EXPECT_LT(delta_bits * 2, for_bits);
+
+    std::vector<uint32_t> down(300);
+    for (size_t i = 0; i < down.size(); ++i) {
+        down[i] = 1000000 - (uint32_t)i * 3;
+    }
+    check_roundtrip(down, BITP_CODEC_DELTA);
+}
+
+TEST(codec, unaligned) {
+    std::vector<uint32_t> vals = {1, 2, 3, 400, 5};
+    std::vector<char> buf(64, 0);
+    bitp_packer_t packer;
+    bitp_packer_init(&packer, buf.data(), 256, 1);
+    ASSERT_EQ(BITP_OK, bitp_packer_add_u8(&packer, 5, 3));
+    ASSERT_EQ(BITP_OK, bitp_codec_encode_u32(&packer, vals.data(), vals.size(), BITP_CODEC_FOR));
+    size_t end = packer.iter;
+    EXPECT_EQ(0, end % CHAR_BIT);
+    ASSERT_EQ(BITP_OK, bitp_packer_add_u8(&packer, 6, 3));
+
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, buf.data(), end + 3);
+    uint8_t head = 0, tail = 0;
+    std::vector<uint32_t> res(vals.size());
+    ASSERT_EQ(BITP_OK, bitp_parser_extract_u8(&parser, &head, 3));
+    ASSERT_EQ(BITP_OK, bitp_codec_decode_u32(&parser, res.data(), res.size(), BITP_CODEC_FOR));
+    ASSERT_EQ(BITP_OK, bitp_parser_extract_u8(&parser, &tail, 3));
+    EXPECT_EQ(5, head);
+    EXPECT_EQ(vals, res);
+    EXPECT_EQ(6, tail);
+}
+
+TEST(codec, errors) {
+    std::vector<uint32_t> vals(100);
+    for (size_t i = 0; i < vals.size(); ++i) {
+        vals[i] = (uint32_t)(i * i);
+    }
+    vals[10] = 1u << 30;
+    size_t n_bits;
+    std::vector<char> buf = encode(vals, BITP_CODEC_FOR, &n_bits);
+    std::vector<uint32_t> res(vals.size());
+
+    // not enough room to encode
+    std::vector<char> small(64, 0);
+    bitp_packer_t packer;
+    bitp_packer_init(&packer, small.data(), 64 * CHAR_BIT, 1);
+    EXPECT_EQ(BITP_EFULL, bitp_codec_encode_u32(&packer, vals.data(), vals.size(), BITP_CODEC_FOR));
+
+    // truncated
+    bitp_parser_t parser;
+    for (size_t cut : {size_t(0), size_t(40), n_bits / 2, n_bits - 8}) {
+        bitp_parser_init(&parser, buf.data(), cut);
+        EXPECT_EQ(BITP_EFULL, bitp_codec_decode_u32(&parser, res.data(), res.size(), BITP_CODEC_FOR));
+        EXPECT_EQ(0u, parser.iter);
+    }
+
+    // width past 32, exception width past 32 - width, exception index past the block
+    std::vector<char> bad = buf;
+    bad[0] = 33;
+    bitp_parser_init(&parser, bad.data(), n_bits);
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_codec_decode_u32(&parser, res.data(), res.size(), BITP_CODEC_FOR));
+
+    ASSERT_NE(0, buf[1]);
+    bad = buf;
+    bad[6] = (char)(33 - bad[0]);
+    bitp_parser_init(&parser, bad.data(), n_bits);
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_codec_decode_u32(&parser, res.data(), res.size(), BITP_CODEC_FOR));
+
+    bad = buf;
+    size_t exc = 7 + (100 * (uint8_t)bad[0] + 7) / 8;
+    bad[exc] = (char)0xFF;
+    bitp_parser_init(&parser, bad.data(), n_bits);
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_codec_decode_u32(&parser, res.data(), res.size(), BITP_CODEC_FOR));
+}
@@ -0,0 +1,137 @@
+/*
+ * constexpr_tests_with_checkers.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#define BITP_CHECK_ALL
+#include "bitp/packer.h"
+}
+
+#include "bitp/constexpr.h"
+
+#if BITP_CONSTEXPR
+
+// MIB-NB as in the parser tests: 34 bits, then the spare bits of the 5-byte block
+static constexpr std::array<uint8_t, 5> make_mib() {
+    bitp_cx_packer<5> p;
+    p.add_u64(0xA, 4);  // systemFrameNumber-MSB
+    p.add_u64(2, 2);    // hyperSFN-LSB
+    p.add_u64(11, 4);   // schedulingInfoSIB1
+    p.add_u64(17, 5);   // systemInfoValueTag
+    p.add_u64(1, 1);    // ab-Enabled
+    p.add_u64(3, 2);    // standalone
+    p.skip(5);
+    p.add_u64(1, 1);  // additionalTransmissionSIB1
+    p.skip(10);
+    return p.bytes();
+}
+
+static constexpr auto mib = make_mib();
+static_assert(mib[0] == 0xAA && mib[1] == 0xE3 && mib[2] == 0xC1 && mib[3] == 0x00 && mib[4] == 0x00, "MIB-NB bytes");
+static_assert(bitp_cx_read(mib, 0, 4) == 0xA, "systemFrameNumber-MSB");
+static_assert(bitp_cx_read(mib, 10, 5) == 17, "systemInfoValueTag");
+static_assert(bitp_cx_read(mib, 16, 2) == 3, "operationModeInfo");
+static_assert(bitp_cx_read(mib, 30, 11) == 0, "past the end");
+
+static constexpr bitp_cx_packer<2> make_overflow() {
+    bitp_cx_packer<2> p;
+    p.add_u64(1, 10);
+    p.add_i64(-1, 7);
+    p.add_u64(1, 1);
+    return p;
+}
+static_assert(make_overflow().status() == BITP_EFULL, "the first error stays");
+static_assert(make_overflow().iter() == 10, "nothing written after it");
+
+static constexpr int64_t decode_signed() {
+    bitp_cx_packer<9> p;
+    p.add_i64(-5, 4);
+    p.add_i64(INT64_MIN, 64);
+    bitp_cx_parser parser(p.bytes(), p.iter());
+    int64_t a = 0, b = 0;
+    parser.extract_i64(&a, 4);
+    parser.extract_i64(&b, 60);
+    return parser.left() == 4 ? a * 1000 + (b >> 56) : 0;
+}
+static_assert(decode_signed() == -5000 - 8, "sign extension");
+
+TEST(constexpr_tests, matches_packer) {
+    std::mt19937_64 rng(45);
+    for (int round = 0; round < 2000; ++round) {
+        bitp_cx_packer<64> cx;
+        char buf[64] = {};
+        bitp_packer_t packer;
+        bitp_packer_init(&packer, buf, 64 * CHAR_BIT, 1);
+
+        std::vector<std::pair<size_t, uint64_t>> fields;
+        for (;;) {
+            size_t n_bits = rng() % 3 ? 1 + rng() % 16 : 1 + rng() % 64;
+            uint64_t val = rng();
+            if (n_bits < 64) {
+                val &= (1ULL << n_bits) - 1;
+            }
+            bitp_status_t expected = bitp_packer_add_u64(&packer, val, n_bits);
+            ASSERT_EQ(expected, cx.add_u64(val, n_bits));
+            if (expected != BITP_OK) {
+                break;
+            }
+            fields.emplace_back(n_bits, val);
+            if (rng() % 8 == 0) {
+                int64_t s = (int64_t)(rng() % 200) - 100;
+                expected = bitp_packer_add_i64(&packer, s, 9);
+                ASSERT_EQ(expected, cx.add_i64(s, 9));
+                if (expected != BITP_OK) {
+                    break;
+                }
+                fields.emplace_back(9, (uint64_t)s & 0x1FF);
+            }
+        }
+        ASSERT_EQ(packer.iter, cx.iter());
+        ASSERT_EQ(0, memcmp(buf, cx.bytes().data(), sizeof(buf)));
+
+        bitp_cx_parser parser(cx.bytes(), cx.iter());
+        for (const auto &f : fields) {
+            uint64_t v = 0;
+            ASSERT_EQ(BITP_OK, parser.extract_u64(&v, f.first));
+            ASSERT_EQ(f.second, v);
+        }
+        ASSERT_EQ(0u, parser.left());
+    }
+}
+
+TEST(constexpr_tests, errors) {
+    bitp_cx_packer<4> p;
+    EXPECT_EQ(BITP_EINVALID_ARG, p.add_u64(4, 2));
+    EXPECT_EQ(BITP_EINVALID_ARG, p.add_u64(0, 10));
+    EXPECT_EQ(0u, p.iter());
+
+    bitp_cx_packer<16> q(20);
+    EXPECT_EQ(BITP_EINVALID_ARG, q.add_u64(0, 65));
+    bitp_cx_packer<16> r(20);
+    EXPECT_EQ(BITP_EINVALID_ARG, r.add_i64(8, 4));
+    bitp_cx_packer<16> s(20);
+    EXPECT_EQ(BITP_OK, s.add_i64(-8, 4));
+    EXPECT_EQ(BITP_OK, s.skip(16));
+    EXPECT_EQ(BITP_EFULL, s.add_u64(0, 1));
+    EXPECT_EQ(BITP_EFULL, s.status());
+
+    bitp_cx_parser parser(s.bytes(), 20);
+    uint64_t v = 0;
+    EXPECT_EQ(BITP_EINVALID_ARG, parser.extract_u64(&v, 65));
+    EXPECT_EQ(BITP_EFULL, parser.extract_u64(&v, 21));
+    EXPECT_EQ(0u, parser.iter());
+    EXPECT_EQ(BITP_OK, parser.extract_u64(&v, 4));
+    EXPECT_EQ(8u, v);
+    EXPECT_EQ(BITP_EFULL, parser.skip(17));
+    EXPECT_EQ(BITP_OK, parser.skip(16));
+}
+
+#endif
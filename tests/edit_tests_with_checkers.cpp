@@ -0,0 +1,142 @@
+/*
+ * edit_tests_with_checkers.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#define BITP_CHECK_ALL
+#include "bitp/edit.h"
+}
+
+static std::vector<int> to_bits(const std::vector<char> &buf, size_t n_bits) {
+    std::vector<int> res(n_bits);
+    for (size_t i = 0; i < n_bits; ++i) {
+        res[i] = ((uint8_t)buf[i / 8] >> (7 - i % 8)) & 1;
+    }
+    return res;
+}
+
+// the message as bits, and the edits applied to it one bit at a time
+static std::vector<int> apply_model(const std::vector<int> &msg, const std::vector<bitp_edit_t> &edits) {
+    std::vector<int> res;
+    size_t pos = 0;
+    for (const auto &e : edits) {
+        res.insert(res.end(), msg.begin() + pos, msg.begin() + e.bit_off);
+        for (size_t i = 0; i < e.ins_bits; ++i) {
+            size_t b = e.src_off + i;
+            res.push_back(e.src ? ((uint8_t)e.src[b / 8] >> (7 - b % 8)) & 1 : 0);
+        }
+        pos = e.bit_off + e.del_bits;
+    }
+    res.insert(res.end(), msg.begin() + pos, msg.end());
+    return res;
+}
+
+TEST(edit_tests, apply_matches_model) {
+    std::mt19937_64 rng(47);
+    std::vector<char> src(512);
+    for (auto &b : src) {
+        b = (char)rng();
+    }
+    for (int isa = BITP_ISA_SCALAR; isa <= bitp_cpu_isa(bitp_cpu_features()); ++isa) {
+        for (int round = 0; round < 3000; ++round) {
+            size_t cap = 8 + rng() % 3000;
+            size_t len = rng() % (cap + 1);
+            std::vector<char> buf((cap + 7) / 8);
+            for (auto &b : buf) {
+                b = (char)rng();
+            }
+            // zeros past the message, as a packer leaves them
+            for (size_t i = len; i < buf.size() * 8; ++i) {
+                buf[i / 8] &= (char)~(0x80 >> (i % 8));
+            }
+            std::vector<int> before = to_bits(buf, len);
+
+            std::vector<bitp_edit_t> edits;
+            size_t n_edits = rng() % 5;
+            size_t pos = 0;
+            for (size_t k = 0; k < n_edits && pos <= len; ++k) {
+                bitp_edit_t e;
+                e.bit_off = pos + rng() % (len - pos + 1);
+                size_t room = len - e.bit_off;
+                e.del_bits = rng() % 2 ? rng() % (room < 600 ? room + 1 : 600) : 0;
+                e.ins_bits = rng() % 3 ? rng() % 600 : 0;
+                e.src = rng() % 4 ? src.data() : NULL;
+                e.src_off = rng() % 64;
+                edits.push_back(e);
+                pos = e.bit_off + e.del_bits;
+            }
+            std::vector<int> expected = apply_model(before, edits);
+
+            bitp_packer_t msg = {buf.data(), cap, len};
+            bitp_status_t s = bitp_edit_apply_isa(&msg, edits.data(), edits.size(), (bitp_isa_t)isa);
+            if (expected.size() > cap) {
+                ASSERT_EQ(BITP_EFULL, s);
+                ASSERT_EQ(before, to_bits(buf, len));
+                continue;
+            }
+            ASSERT_EQ(BITP_OK, s) << isa << " " << round;
+            ASSERT_EQ(expected.size(), msg.iter);
+            ASSERT_EQ(expected, to_bits(buf, msg.iter)) << isa << " " << round;
+            std::vector<int> rest = to_bits(buf, buf.size() * 8);
+            for (size_t i = msg.iter; i < rest.size(); ++i) {
+                ASSERT_EQ(0, rest[i]) << "past the message " << isa << " " << round;
+            }
+        }
+    }
+}
+
+TEST(edit_tests, fields) {
+    // three fields, 5, 7 and 4 bits, then the middle one widened and the last one dropped
+    char buf[8] = {};
+    bitp_packer_t msg;
+    bitp_packer_init(&msg, buf, 64, 1);
+    bitp_packer_add_u8(&msg, 0x15, 5);
+    bitp_packer_add_u8(&msg, 0x41, 7);
+    bitp_packer_add_u8(&msg, 0x9, 4);
+    EXPECT_EQ(BITP_OK, bitp_edit_replace(&msg, 5, 7, 0x3C1, 10));
+    EXPECT_EQ(19u, msg.iter);
+    EXPECT_EQ(BITP_OK, bitp_edit_delete(&msg, 15, 4));
+    EXPECT_EQ(BITP_OK, bitp_edit_insert(&msg, 0, 1, 1));
+    EXPECT_EQ(16u, msg.iter);
+    // 1 10101 1111000001
+    EXPECT_EQ((char)0xD7, buf[0]);
+    EXPECT_EQ((char)0xC1, buf[1]);
+    EXPECT_EQ(0, buf[2]);
+
+    // the packer goes on after the edits
+    EXPECT_EQ(BITP_OK, bitp_packer_add_u8(&msg, 0x3, 2));
+    EXPECT_EQ((char)0xC0, buf[2]);
+}
+
+TEST(edit_tests, errors) {
+    char buf[4] = {};
+    bitp_packer_t msg;
+    bitp_packer_init(&msg, buf, 32, 1);
+    bitp_packer_add_u16(&msg, 0xABCD, 16);
+
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_edit_insert(&msg, 0, 4, 2));
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_edit_insert(&msg, 0, 0, 65));
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_edit_insert(&msg, 17, 0, 1));
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_edit_delete(&msg, 10, 7));
+    EXPECT_EQ(BITP_EFULL, bitp_edit_insert(&msg, 8, 0, 17));
+    EXPECT_EQ(BITP_OK, bitp_edit_insert(&msg, 16, 0, 16));
+
+    bitp_edit_t overlap[2] = {{0, 8, NULL, 0, 0}, {4, 1, NULL, 0, 0}};
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_edit_apply(&msg, overlap, 2));
+    bitp_edit_t order[2] = {{8, 0, NULL, 0, 1}, {4, 0, NULL, 0, 1}};
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_edit_apply(&msg, order, 2));
+    bitp_edit_t huge[2] = {{0, 0, NULL, 0, (size_t)-1}, {0, 0, NULL, 0, 2}};
+    EXPECT_EQ(BITP_EFULL, bitp_edit_apply(&msg, huge, 2));
+
+    EXPECT_EQ(32u, msg.iter);
+    EXPECT_EQ((char)0xAB, buf[0]);
+    EXPECT_EQ((char)0xCD, buf[1]);
+}
@@ -0,0 +1,175 @@
+/*
+ * emit_tests_with_checkers.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#define BITP_CHECK_ALL
+#include "bitp/emit.h"
+#include "bitp/packer.h"
+}
+
+static std::string emit_all(const bitp_emit_t &emit, const std::vector<char> &buf, size_t n_bits) {
+    std::vector<char> out(1 << 16);
+    size_t len = 0;
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, buf.data(), n_bits);
+    EXPECT_EQ(BITP_OK, bitp_emit_header(&emit, out.data(), out.size(), &len));
+    while (bitp_emit_record(&emit, &parser, out.data(), out.size(), &len) == BITP_OK) {
+    }
+    EXPECT_EQ(n_bits, parser.iter);
+    return std::string(out.data(), len);
+}
+
+TEST(emit, decimal) {
+    // digit count boundaries in every width
+    std::vector<uint64_t> vals = {0, 1, 0xFFFFFFFFFFFFFFFFULL, 0x8000000000000000ULL, 0x7FFFFFFFFFFFFFFFULL};
+    for (uint64_t p = 1; p <= 1000000000000000000ULL; p *= 10) {
+        vals.push_back(p - 1);
+        vals.push_back(p);
+        vals.push_back(p * 10 - 1);
+    }
+    vals.push_back(10000000000000000000ULL);
+    vals.push_back(9999999999999999999ULL);
+
+    const bitp_emit_field_t fields[] = {{"u", 64, BITP_EMIT_UNSIGNED}, {"i", 64, BITP_EMIT_SIGNED}};
+    bitp_emit_t emit;
+    ASSERT_EQ(BITP_OK, bitp_emit_init(&emit, fields, 2, BITP_EMIT_CSV));
+
+    std::vector<char> buf(vals.size() * 16 + 16, 0);
+    bitp_packer_t packer;
+    bitp_packer_init(&packer, buf.data(), vals.size() * 128, 1);
+    std::string expected = "u,i\n";
+    for (uint64_t v : vals) {
+        ASSERT_EQ(BITP_OK, bitp_packer_add_u64(&packer, v, 64));
+        ASSERT_EQ(BITP_OK, bitp_packer_add_u64(&packer, v, 64));
+        expected += std::to_string(v) + "," + std::to_string((int64_t)v) + "\n";
+    }
+    EXPECT_EQ(expected, emit_all(emit, buf, packer.iter));
+}
+
+TEST(emit, random_layout) {
+    std::mt19937_64 rng(5);
+    for (int round = 0; round < 50; ++round) {
+        std::vector<bitp_emit_field_t> fields;
+        std::vector<std::string> names;
+        unsigned n_fields = 1 + rng() % 12;
+        names.reserve(n_fields);
+        for (unsigned i = 0; i < n_fields; ++i) {
+            names.push_back("f" + std::to_string(i));
+            bitp_emit_kind_t kind = (bitp_emit_kind_t)(rng() % 4);
+            unsigned n_bits = kind == BITP_EMIT_HEX ? 1 + rng() % 200 : 1 + rng() % 64;
+            fields.push_back({names.back().c_str(), n_bits, kind});
+        }
+
+        for (bitp_emit_format_t format : {BITP_EMIT_CSV, BITP_EMIT_JSON}) {
+            bitp_emit_t emit;
+            ASSERT_EQ(BITP_OK, bitp_emit_init(&emit, fields.data(), n_fields, format));
+            std::vector<char> buf(4096, 0);
+            bitp_packer_t packer;
+            bitp_packer_init(&packer, buf.data(), (buf.size() - 64) * CHAR_BIT, 1);
+            std::string expected;
+            if (format == BITP_EMIT_CSV) {
+                for (unsigned i = 0, n = 0; i < n_fields; ++i) {
+                    if (fields[i].kind != BITP_EMIT_SKIP) {
+                        expected += (n++ ? "," : "") + names[i];
+                    }
+                }
+                expected += "\n";
+            }
+
+            for (int rec = 0; rec < 5; ++rec) {
+                std::string line;
+                unsigned n = 0;
+                for (unsigned i = 0; i < n_fields; ++i) {
+                    const bitp_emit_field_t &f = fields[i];
+                    std::string text;
+                    if (f.kind == BITP_EMIT_HEX) {
+                        static const char digits[] = "0123456789abcdef";
+                        std::vector<int> bits;
+                        for (unsigned b = 0; b < f.n_bits; ++b) {
+                            bits.push_back((int)(rng() & 1));
+                            ASSERT_EQ(BITP_OK, bitp_packer_add_u8(&packer, (uint8_t)bits.back(), 1));
+                        }
+                        while (bits.size() % 4) {
+                            bits.push_back(0);
+                        }
+                        for (size_t b = 0; b < bits.size(); b += 4) {
+                            text += digits[bits[b] * 8 + bits[b + 1] * 4 + bits[b + 2] * 2 + bits[b + 3]];
+                        }
+                        if (format == BITP_EMIT_JSON) {
+                            text = "\"" + text + "\"";
+                        }
+                    }
+                    else {
+                        uint64_t v = rng() >> (64 - f.n_bits);
+                        ASSERT_EQ(BITP_OK, bitp_packer_add_u64(&packer, v, f.n_bits));
+                        if (f.kind == BITP_EMIT_SIGNED) {
+                            int64_t s = (int64_t)(v << (64 - f.n_bits)) >> (64 - f.n_bits);
+                            text = std::to_string(s);
+                        }
+                        else {
+                            text = std::to_string(v);
+                        }
+                    }
+                    if (f.kind == BITP_EMIT_SKIP) {
+                        continue;
+                    }
+                    if (format == BITP_EMIT_JSON) {
+                        line += std::string(n++ ? "," : "{") + "\"" + names[i] + "\":" + text;
+                    }
+                    else {
+                        line += (n++ ? "," : "") + text;
+                    }
+                }
+                if (format == BITP_EMIT_JSON) {
+                    line += n ? "}" : "{}";
+                }
+                expected += line + "\n";
+            }
+            ASSERT_EQ(expected, emit_all(emit, buf, packer.iter)) << "round " << round;
+        }
+    }
+}
+
+TEST(emit, errors) {
+    bitp_emit_t emit;
+    bitp_emit_field_t fields[] = {{"a", 65, BITP_EMIT_UNSIGNED}};
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_emit_init(&emit, fields, 1, BITP_EMIT_CSV));
+    fields[0] = {"a", 0, BITP_EMIT_HEX};
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_emit_init(&emit, fields, 1, BITP_EMIT_CSV));
+    std::string long_name(BITP_EMIT_TEXT_SIZE, 'x');
+    fields[0] = {long_name.c_str(), 8, BITP_EMIT_UNSIGNED};
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_emit_init(&emit, fields, 1, BITP_EMIT_JSON));
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_emit_init(&emit, fields, BITP_EMIT_MAX + 1, BITP_EMIT_JSON));
+
+    fields[0] = {"a", 12, BITP_EMIT_UNSIGNED};
+    ASSERT_EQ(BITP_OK, bitp_emit_init(&emit, fields, 1, BITP_EMIT_JSON));
+    const char data[16] = {(char)0xAB, (char)0xC0};
+    char out[64];
+    size_t len = 0;
+
+    // output room is checked against the longest line
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, data, 12);
+    EXPECT_EQ(BITP_EFULL, bitp_emit_record(&emit, &parser, out, emit.max_line - 1, &len));
+    EXPECT_EQ(0u, len);
+    EXPECT_EQ(0u, parser.iter);
+    ASSERT_EQ(BITP_OK, bitp_emit_record(&emit, &parser, out, emit.max_line, &len));
+    EXPECT_EQ("{\"a\":2748}\n", std::string(out, len));
+
+    // a partial record isn't emitted
+    bitp_parser_init(&parser, data, 11);
+    len = 0;
+    EXPECT_EQ(BITP_EFULL, bitp_emit_record(&emit, &parser, out, sizeof(out), &len));
+    EXPECT_EQ(0u, len);
+    EXPECT_EQ(0u, parser.iter);
+}
@@ -0,0 +1,225 @@
+/*
+ * fields_tests_with_checkers.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#define BITP_CHECK_ALL
+#include "bitp/fields.h"
+}
+
+// runs a test body with the shift/mask path and, if the CPU has it, with the PDEP path
+static std::vector<int> available_paths() {
+    std::vector<int> paths = {0};
+    if (bitp_cpu_features() & BITP_CPU_BMI2) {
+        paths.push_back(1);
+    }
+    return paths;
+}
+
+TEST(fields_tests, init) {
+    bitp_fields_t fields;
+    const unsigned mib[] = {4, 2, 4, 5, 1};
+
+    ASSERT_EQ(bitp_fields_init(&fields, mib, 5, 8), BITP_OK);
+    ASSERT_EQ(fields.n_fields, 5u);
+    ASSERT_EQ(fields.n_bits, 16u);
+    ASSERT_EQ(fields.keep_mask, 0xFFFF000000000000ULL);
+
+    ASSERT_EQ(bitp_fields_init(&fields, mib, 5, 4), BITP_EINVALID_ARG);
+
+    const unsigned wide[] = {4, 9};
+    ASSERT_EQ(bitp_fields_init(&fields, wide, 2, 8), BITP_EINVALID_ARG);
+    ASSERT_EQ(bitp_fields_init(&fields, wide, 2, 16), BITP_OK);
+
+    const unsigned too_long[] = {32, 32, 1};
+    ASSERT_EQ(bitp_fields_init(&fields, too_long, 3, 32), BITP_EINVALID_ARG);
+
+    const unsigned skip[] = {4, BITP_FIELD_SKIP(10), 2};
+    ASSERT_EQ(bitp_fields_init(&fields, skip, 3, 8), BITP_OK);
+    ASSERT_EQ(fields.n_fields, 2u);
+    ASSERT_EQ(fields.n_bits, 16u);
+    ASSERT_EQ(fields.keep_mask, 0xF003000000000000ULL);
+}
+
+TEST(fields_tests, mib_nb) {
+    uint8_t buf[] = {0x00, 0x92, 0xC0, 0x00, 0x00};
+    const unsigned mib[] = {4, 2, 4, 5, 1};
+
+    for (int path : available_paths()) {
+        bitp_fields_t fields;
+        bitp_fields_init(&fields, mib, 5, 8);
+        fields.use_pdep = path;
+
+        bitp_parser_t parser;
+        bitp_parser_init(&parser, (char *)buf, sizeof(buf) * CHAR_BIT);
+
+        uint8_t res[BITP_FIELDS_ARRAY_SIZE(5, 8)];
+        ASSERT_EQ(bitp_parser_extract_fields_u8(&parser, &fields, res), BITP_OK);
+        ASSERT_EQ(parser.iter, 16u);
+        ASSERT_EQ(res[0], 0);
+        ASSERT_EQ(res[1], 0);
+        ASSERT_EQ(res[2], 2);
+        ASSERT_EQ(res[3], 9);
+        ASSERT_EQ(res[4], 0);
+
+        uint16_t res16[BITP_FIELDS_MAX];
+        ASSERT_EQ(bitp_parser_extract_fields_u16(&parser, &fields, res16), BITP_EINVALID_ARG);
+
+        ASSERT_EQ(bitp_parser_extract_fields_u8(&parser, &fields, res), BITP_OK);
+        ASSERT_EQ(res[0], 0xC);
+        ASSERT_EQ(bitp_parser_extract_fields_u8(&parser, &fields, res), BITP_EFULL);
+    }
+}
+
+TEST(fields_tests, pack_skip_and_range) {
+    const unsigned widths[] = {3, BITP_FIELD_SKIP(2), 12, 1};
+
+    for (int path : available_paths()) {
+        bitp_fields_t fields;
+        bitp_fields_init(&fields, widths, 4, 16);
+        fields.use_pdep = path;
+
+        uint8_t buf[3];
+        bitp_packer_t packer;
+        bitp_packer_init(&packer, (char *)buf, 20, 1);
+
+        const uint16_t bad[BITP_FIELDS_ARRAY_SIZE(3, 16)] = {8, 0xABC, 1};
+        ASSERT_EQ(bitp_packer_add_fields_u16(&packer, &fields, bad), BITP_EINVALID_ARG);
+
+        const uint16_t vals[BITP_FIELDS_ARRAY_SIZE(3, 16)] = {5, 0xABC, 1};
+        ASSERT_EQ(bitp_packer_add_fields_u16(&packer, &fields, vals), BITP_OK);
+        ASSERT_EQ(packer.iter, 18u);
+        ASSERT_EQ(bitp_packer_add_fields_u16(&packer, &fields, vals), BITP_EFULL);
+
+        // 101 00 101010111100 1
+        ASSERT_EQ(buf[0], 0xA5);
+        ASSERT_EQ(buf[1], 0x5E);
+        ASSERT_EQ(buf[2], 0x40);
+
+        bitp_parser_t parser;
+        bitp_parser_init(&parser, (char *)buf, 20);
+        uint16_t res[BITP_FIELDS_ARRAY_SIZE(3, 16)];
+        ASSERT_EQ(bitp_parser_extract_fields_u16(&parser, &fields, res), BITP_OK);
+        ASSERT_EQ(res[0], 5);
+        ASSERT_EQ(res[1], 0xABC);
+        ASSERT_EQ(res[2], 1);
+    }
+}
+
+static bitp_status_t add_fields(bitp_packer_t *packer, const bitp_fields_t *fields, const uint8_t *vals) {
+    return bitp_packer_add_fields_u8(packer, fields, vals);
+}
+
+static bitp_status_t add_fields(bitp_packer_t *packer, const bitp_fields_t *fields, const uint16_t *vals) {
+    return bitp_packer_add_fields_u16(packer, fields, vals);
+}
+
+static bitp_status_t add_fields(bitp_packer_t *packer, const bitp_fields_t *fields, const uint32_t *vals) {
+    return bitp_packer_add_fields_u32(packer, fields, vals);
+}
+
+static bitp_status_t add_fields(bitp_packer_t *packer, const bitp_fields_t *fields, const uint64_t *vals) {
+    return bitp_packer_add_fields_u64(packer, fields, vals);
+}
+
+static bitp_status_t extract_fields(bitp_parser_t *parser, const bitp_fields_t *fields, uint8_t *res) {
+    return bitp_parser_extract_fields_u8(parser, fields, res);
+}
+
+static bitp_status_t extract_fields(bitp_parser_t *parser, const bitp_fields_t *fields, uint16_t *res) {
+    return bitp_parser_extract_fields_u16(parser, fields, res);
+}
+
+static bitp_status_t extract_fields(bitp_parser_t *parser, const bitp_fields_t *fields, uint32_t *res) {
+    return bitp_parser_extract_fields_u32(parser, fields, res);
+}
+
+static bitp_status_t extract_fields(bitp_parser_t *parser, const bitp_fields_t *fields, uint64_t *res) {
+    return bitp_parser_extract_fields_u64(parser, fields, res);
+}
+
+template <typename T>
+static void roundtrip_random(unsigned lane_bits, std::mt19937_64 &rng) {
+    for (int round = 0; round < 200; ++round) {
+        std::vector<unsigned> widths;
+        unsigned total = 0;
+        unsigned n_fields = 0;
+        while (n_fields < BITP_FIELDS_MAX) {
+            unsigned w = 1 + rng() % lane_bits;
+            if (total + w > 64) {
+                break;
+            }
+            total += w;
+            if (rng() % 5 == 0) {
+                widths.push_back(BITP_FIELD_SKIP(w));
+            }
+            else {
+                widths.push_back(w);
+                n_fields++;
+            }
+        }
+
+        bitp_fields_t fields;
+        ASSERT_EQ(bitp_fields_init(&fields, widths.data(), widths.size(), lane_bits), BITP_OK);
+
+        std::vector<T> vals(BITP_FIELDS_ARRAY_SIZE(n_fields, lane_bits));
+        for (unsigned i = 0; i < n_fields; ++i) {
+            vals[i] = (T)(rng() & fields.masks[i]);
+        }
+
+        size_t offset = rng() % 16;
+        for (int path : available_paths()) {
+            fields.use_pdep = path;
+
+            // room for the aligned 64-bit words read by bitp_parser_extract_u64
+            std::vector<uint8_t> buf(24);
+            bitp_packer_t packer;
+            bitp_packer_init(&packer, (char *)buf.data(), offset + total, 1);
+            packer.iter = offset;
+
+            bitp_status_t status = add_fields(&packer, &fields, vals.data());
+            ASSERT_EQ(status, BITP_OK);
+
+            // cross-check with the single field API
+            bitp_parser_t parser;
+            bitp_parser_init(&parser, (char *)buf.data(), offset + total);
+            parser.iter = offset;
+            unsigned field = 0;
+            for (unsigned w : widths) {
+                uint64_t v;
+                ASSERT_EQ(bitp_parser_extract_u64(&parser, &v, w & 0xFF), BITP_OK);
+                if (w & BITP_FIELD_SKIP(0)) {
+                    ASSERT_EQ(v, 0u);
+                }
+                else {
+                    ASSERT_EQ(v, (uint64_t)vals[field++]);
+                }
+            }
+
+            std::vector<T> res(vals.size(), 1);
+            bitp_parser_init(&parser, (char *)buf.data(), offset + total);
+            parser.iter = offset;
+            status = extract_fields(&parser, &fields, res.data());
+            ASSERT_EQ(status, BITP_OK);
+            ASSERT_EQ(parser.iter, offset + total);
+            res.resize(n_fields);
+            ASSERT_EQ(res, std::vector<T>(vals.begin(), vals.begin() + n_fields));
+        }
+    }
+}
+
+TEST(fields_tests, random_roundtrip) {
+    std::mt19937_64 rng(27);
+    roundtrip_random<uint8_t>(8, rng);
+    roundtrip_random<uint16_t>(16, rng);
+    roundtrip_random<uint32_t>(32, rng);
+    roundtrip_random<uint64_t>(64, rng);
+}
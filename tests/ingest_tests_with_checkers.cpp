@@ -0,0 +1,144 @@
+/*
+ * ingest_tests_with_checkers.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#define BITP_CHECK_ALL
+#include "bitp/ingest.h"
+}
+
+// a temporary file of 32-bit big-endian counters, the last one cut to the size
+class ingest_file {
+public:
+    explicit ingest_file(size_t size) {
+        char path[] = "/tmp/bitp_ingest_XXXXXX";
+        fd_ = mkstemp(path);
+        unlink(path);
+        std::vector<char> data(size);
+        for (size_t i = 0; i < size; ++i) {
+            data[i] = (char)(uint8_t)((i / 4) >> (8 * (3 - i % 4)));
+        }
+        EXPECT_EQ((ssize_t)size, write(fd_, data.data(), size));
+    }
+
+    ~ingest_file() {
+        close(fd_);
+    }
+
+    int fd() const {
+        return fd_;
+    }
+
+private:
+    int fd_;
+};
+
+static void check_file(size_t size, const bitp_ingest_config_t &config, bitp_ingest_backend_t expected) {
+    ingest_file file(size);
+    bitp_ingest_t *ingest;
+    ASSERT_EQ(BITP_OK, bitp_ingest_open(&ingest, file.fd(), &config));
+    if (expected != BITP_INGEST_AUTO) {
+        EXPECT_EQ(expected, bitp_ingest_backend(ingest));
+    }
+
+    bitp_ingest_block_t block;
+    uint64_t offset = 0;
+    while (bitp_ingest_next(ingest, &block) == BITP_OK) {
+        ASSERT_EQ(offset, block.offset);
+        ASSERT_EQ(0u, block.offset % 4);
+        size_t n_bytes = block.parser.capacity / CHAR_BIT;
+        EXPECT_EQ(size - offset < config.block_size ? size - offset : config.block_size, n_bytes);
+        for (size_t i = 0; i + 4 <= n_bytes; i += 4) {
+            uint32_t v = 0;
+            ASSERT_EQ(BITP_OK, bitp_parser_extract_u32(&block.parser, &v, 32));
+            ASSERT_EQ((offset + i) / 4, v);
+        }
+        offset += n_bytes;
+        bitp_ingest_release(ingest, &block);
+    }
+    EXPECT_EQ(size, offset);
+    EXPECT_EQ(BITP_EFULL, bitp_ingest_next(ingest, &block));
+    EXPECT_EQ(0, bitp_ingest_error(ingest));
+    bitp_ingest_close(ingest);
+}
+
+TEST(ingest, backends) {
+    for (bitp_ingest_backend_t backend : {BITP_INGEST_AUTO, BITP_INGEST_READ}) {
+        for (size_t size : {0, 1, 4096, 4097, 3 * 65536 + 100, 40 * 4096}) {
+            check_file(size, {4096, 4, backend}, backend);
+            check_file(size, {65536, 3, backend}, backend);
+        }
+    }
+
+    // io_uring may be refused in containers, the explicit backend then fails to open
+    ingest_file file(100);
+    bitp_ingest_t *ingest;
+    bitp_ingest_config_t uring = {4096, 2, BITP_INGEST_URING};
+    if (bitp_ingest_open(&ingest, file.fd(), &uring) == BITP_OK) {
+        EXPECT_EQ(BITP_INGEST_URING, bitp_ingest_backend(ingest));
+        bitp_ingest_close(ingest);
+        check_file(5 * 4096 + 7, uring, BITP_INGEST_URING);
+    }
+}
+
+TEST(ingest, held_blocks) {
+    ingest_file file(10 * 4096);
+    bitp_ingest_config_t config = {4096, 3, BITP_INGEST_AUTO};
+    bitp_ingest_t *ingest;
+    ASSERT_EQ(BITP_OK, bitp_ingest_open(&ingest, file.fd(), &config));
+
+    // every buffer held, then released out of order
+    bitp_ingest_block_t blocks[4];
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_EQ(BITP_OK, bitp_ingest_next(ingest, &blocks[i]));
+        EXPECT_EQ(i * 4096u, blocks[i].offset);
+    }
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_ingest_next(ingest, &blocks[3]));
+    bitp_ingest_release(ingest, &blocks[1]);
+    ASSERT_EQ(BITP_OK, bitp_ingest_next(ingest, &blocks[3]));
+    EXPECT_EQ(3 * 4096u, blocks[3].offset);
+
+    uint32_t v = 0;
+    ASSERT_EQ(BITP_OK, bitp_parser_extract_u32(&blocks[0].parser, &v, 32));
+    EXPECT_EQ(0u, v);
+    ASSERT_EQ(BITP_OK, bitp_parser_extract_u32(&blocks[3].parser, &v, 32));
+    EXPECT_EQ(3 * 1024u, v);
+    bitp_ingest_close(ingest);
+}
+
+TEST(ingest, errors) {
+    bitp_ingest_t *ingest;
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_ingest_open(&ingest, -1, NULL));
+
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_ingest_open(&ingest, fds[0], NULL));
+    close(fds[0]);
+    close(fds[1]);
+
+    // the file shrinks after open
+    ingest_file file(5 * 4096);
+    bitp_ingest_config_t config = {4096, 2, BITP_INGEST_READ};
+    ASSERT_EQ(BITP_OK, bitp_ingest_open(&ingest, file.fd(), &config));
+    ASSERT_EQ(0, ftruncate(file.fd(), 4096 + 10));
+    bitp_ingest_block_t block;
+    ASSERT_EQ(BITP_OK, bitp_ingest_next(ingest, &block));
+    bitp_ingest_release(ingest, &block);
+    ASSERT_EQ(BITP_OK, bitp_ingest_next(ingest, &block));
+    EXPECT_EQ(10 * CHAR_BIT, block.parser.capacity);
+    bitp_ingest_release(ingest, &block);
+    EXPECT_EQ(BITP_EFULL, bitp_ingest_next(ingest, &block));
+    bitp_ingest_close(ingest);
+}
@@ -0,0 +1,162 @@
+/*
+ * kernels_tests_with_checkers.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#define BITP_CHECK_ALL
+#include "bitp/kernels.h"
+}
+
+// every tier the CPU can run, the startup choice is restored at the end of each test
+static std::vector<bitp_isa_t> available_tiers() {
+    std::vector<bitp_isa_t> tiers;
+    for (int isa = BITP_ISA_SCALAR; isa <= bitp_cpu_isa(bitp_cpu_features()); ++isa) {
+        tiers.push_back((bitp_isa_t)isa);
+    }
+    return tiers;
+}
+
+TEST(kernels_tests, force) {
+    bitp_isa_t startup = bitp_kernels_isa();
+    bitp_isa_t best = bitp_cpu_isa(bitp_cpu_features());
+
+    ASSERT_LE(startup, best);
+    for (bitp_isa_t isa : available_tiers()) {
+        ASSERT_EQ(bitp_kernels_force(isa), BITP_OK);
+        ASSERT_EQ(bitp_kernels_isa(), isa);
+    }
+    if (best != BITP_ISA_AVX512) {
+        ASSERT_EQ(bitp_kernels_force((bitp_isa_t)(best + 1)), BITP_EINVALID_ARG);
+    }
+    ASSERT_EQ(bitp_kernels_force((bitp_isa_t)(BITP_ISA_AVX512 + 1)), BITP_EINVALID_ARG);
+    ASSERT_EQ(bitp_kernels_isa(), best);
+
+    ASSERT_EQ(bitp_kernels_force(startup), BITP_OK);
+}
+
+TEST(kernels_tests, find_all_tiers) {
+    bitp_isa_t startup = bitp_kernels_isa();
+    std::mt19937_64 rng(28);
+    std::vector<uint8_t> buf(777);
+    for (auto &b : buf) {
+        b = (uint8_t)(rng() & rng());
+    }
+
+    const struct {
+        unsigned n_bits;
+        unsigned max_errors;
+    } cases[] = {{7, 0}, {16, 0}, {24, 0}, {32, 0}, {64, 0}, {12, 1}, {32, 3}};
+
+    for (const auto &c : cases) {
+        uint64_t value = rng() >> (64 - c.n_bits);
+        bitp_pattern_t pattern = {};
+        ASSERT_EQ(bitp_pattern_init(&pattern, value, c.n_bits, c.max_errors), BITP_OK);
+
+        // plant a few copies at arbitrary bit offsets
+        bitp_packer_t packer;
+        for (int i = 0; i < 5; ++i) {
+            bitp_packer_init(&packer, (char *)buf.data(), buf.size() * CHAR_BIT, 0);
+            packer.iter = rng() % (buf.size() * CHAR_BIT - c.n_bits);
+            for (unsigned b = 0; b < c.n_bits; ++b) {
+                size_t bit = packer.iter + b;
+                uint8_t m = (uint8_t)(0x80 >> (bit % 8));
+                buf[bit / 8] = (value >> (c.n_bits - 1 - b)) & 1 ? buf[bit / 8] | m : buf[bit / 8] & (uint8_t)~m;
+            }
+        }
+
+        bitp_parser_t parser;
+        bitp_parser_init(&parser, (const char *)buf.data(), buf.size() * CHAR_BIT - 3);
+        parser.iter = 5;
+
+        std::vector<bitp_parser_t> expected(buf.size() * CHAR_BIT);
+        expected.resize(bitp_parser_find_all(&parser, &pattern, expected.data(), expected.size()));
+        ASSERT_GE(expected.size(), 1u);
+
+        for (bitp_isa_t isa : available_tiers()) {
+            ASSERT_EQ(bitp_kernels_force(isa), BITP_OK);
+            std::vector<bitp_parser_t> matches(buf.size() * CHAR_BIT);
+            matches.resize(bitp_kernels_parser_find_all(&parser, &pattern, matches.data(), matches.size()));
+            ASSERT_EQ(matches.size(), expected.size()) << "isa " << isa << " n_bits " << c.n_bits;
+            for (size_t i = 0; i < matches.size(); ++i) {
+                ASSERT_EQ(matches[i].iter, expected[i].iter);
+            }
+
+            bitp_parser_t cursor = parser;
+            ASSERT_EQ(bitp_kernels_parser_find(&cursor, &pattern), BITP_OK);
+            ASSERT_EQ(cursor.iter, expected[0].iter);
+        }
+    }
+
+    ASSERT_EQ(bitp_kernels_force(startup), BITP_OK);
+}
+
+TEST(kernels_tests, fields_tiers) {
+    bitp_isa_t startup = bitp_kernels_isa();
+    const unsigned widths[] = {4, 2, BITP_FIELD_SKIP(3), 4, 5, 1, 7, 3, 2, 6};
+    const unsigned n_widths = sizeof(widths) / sizeof(widths[0]);
+    const size_t n_groups = 100;
+
+    bitp_fields_t fields;
+    ASSERT_EQ(bitp_fields_init(&fields, widths, n_widths, 16), BITP_OK);
+    const size_t stride = BITP_FIELDS_ARRAY_SIZE(fields.n_fields, 16);
+
+    std::mt19937_64 rng(28);
+    std::vector<uint16_t> vals(n_groups * stride);
+    for (size_t g = 0; g < n_groups; ++g) {
+        for (unsigned i = 0; i < fields.n_fields; ++i) {
+            vals[g * stride + i] = (uint16_t)(rng() & fields.masks[i]);
+        }
+    }
+
+    // reference encoding with the header, one group at a time
+    size_t n_bits = 3 + n_groups * fields.n_bits;
+    std::vector<uint8_t> expected(n_bits / CHAR_BIT + 16);
+    bitp_packer_t packer;
+    bitp_packer_init(&packer, (char *)expected.data(), n_bits, 1);
+    packer.iter = 3;
+    for (size_t g = 0; g < n_groups; ++g) {
+        ASSERT_EQ(bitp_packer_add_fields_u16(&packer, &fields, &vals[g * stride]), BITP_OK);
+    }
+
+    for (bitp_isa_t isa : available_tiers()) {
+        ASSERT_EQ(bitp_kernels_force(isa), BITP_OK);
+
+        std::vector<uint8_t> buf(expected.size());
+        bitp_packer_init(&packer, (char *)buf.data(), n_bits, 1);
+        packer.iter = 3;
+        ASSERT_EQ(bitp_kernels_add_fields(&packer, &fields, vals.data(), n_groups), BITP_OK);
+        ASSERT_EQ(packer.iter, n_bits);
+        ASSERT_EQ(buf, expected);
+        ASSERT_EQ(bitp_kernels_add_fields(&packer, &fields, vals.data(), 1), BITP_EFULL);
+
+        bitp_parser_t parser;
+        bitp_parser_init(&parser, (const char *)buf.data(), n_bits);
+        parser.iter = 3;
+        std::vector<uint16_t> res(vals.size(), 0xFFFF);
+        ASSERT_EQ(bitp_kernels_extract_fields(&parser, &fields, res.data(), n_groups + 1), BITP_EFULL);
+        ASSERT_EQ(parser.iter, 3u);
+        ASSERT_EQ(bitp_kernels_extract_fields(&parser, &fields, res.data(), n_groups), BITP_OK);
+        ASSERT_EQ(parser.iter, n_bits);
+        for (size_t g = 0; g < n_groups; ++g) {
+            for (unsigned i = 0; i < fields.n_fields; ++i) {
+                ASSERT_EQ(res[g * stride + i], vals[g * stride + i]);
+            }
+        }
+
+        std::vector<uint16_t> bad(vals);
+        bad[5 * stride + 1] = 4;
+        bitp_packer_init(&packer, (char *)buf.data(), n_bits, 1);
+        ASSERT_EQ(bitp_kernels_add_fields(&packer, &fields, bad.data(), n_groups), BITP_EINVALID_ARG);
+        ASSERT_EQ(packer.iter, 0u);
+    }
+
+    ASSERT_EQ(bitp_kernels_force(startup), BITP_OK);
+}
@@ -0,0 +1,230 @@
+/*
+ * numeric_tests_with_checkers.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#define BITP_CHECK_ALL
+#include "bitp/numeric.h"
+}
+
+static float bits_float(uint32_t bits) {
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+// packs vals at bit offset `phase` with every tier, checks the tiers write the same bits and read
+// back the same floats as one field at a time
+static void check_array(const bitp_numeric_t &num, const std::vector<float> &vals, unsigned phase) {
+    size_t n_bits = phase + vals.size() * num.n_bits;
+    std::vector<char> ref(n_bits / CHAR_BIT + 16, 0);
+    bitp_packer_t packer;
+    bitp_packer_init(&packer, ref.data(), n_bits, 1);
+    packer.iter = phase;
+    for (float v : vals) {
+        ASSERT_EQ(BITP_OK, bitp_packer_add_numeric(&packer, &num, v));
+    }
+    std::vector<float> expected(vals.size());
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, ref.data(), n_bits);
+    parser.iter = phase;
+    for (float &v : expected) {
+        ASSERT_EQ(BITP_OK, bitp_parser_extract_numeric(&parser, &num, &v));
+    }
+
+    for (int isa = BITP_ISA_SCALAR; isa <= bitp_cpu_isa(bitp_cpu_features()); ++isa) {
+        std::vector<char> buf(ref.size(), 0);
+        bitp_packer_init(&packer, buf.data(), n_bits, 1);
+        packer.iter = phase;
+        ASSERT_EQ(BITP_OK, bitp_packer_add_numeric_array_isa(&packer, &num, vals.data(), vals.size(), (bitp_isa_t)isa));
+        EXPECT_EQ(n_bits, packer.iter);
+        ASSERT_EQ(ref, buf) << "isa " << isa << " n_bits " << num.n_bits << " phase " << phase;
+
+        std::vector<float> res(vals.size());
+        bitp_parser_init(&parser, buf.data(), n_bits);
+        parser.iter = phase;
+        ASSERT_EQ(BITP_OK, bitp_parser_extract_numeric_array_isa(&parser, &num, res.data(), res.size(), (bitp_isa_t)isa));
+        EXPECT_EQ(n_bits, parser.iter);
+        for (size_t i = 0; i < res.size(); ++i) {
+            if (std::isnan(expected[i])) {
+                ASSERT_TRUE(std::isnan(res[i]));
+            }
+            else if (std::isinf(expected[i])) {
+                ASSERT_EQ(expected[i], res[i]);
+            }
+            else {
+                // a multiply-add may be fused in one of them
+                ASSERT_NEAR(expected[i], res[i], std::fabs(expected[i]) * 1e-6f + 1e-6f)
+                    << "isa " << isa << " n_bits " << num.n_bits << " phase " << phase << " i " << i;
+            }
+        }
+    }
+}
+
+TEST(numeric, f16) {
+    bitp_numeric_t num;
+    bitp_numeric_init_f16(&num);
+
+    // every half survives the round trip, NaNs stay NaNs
+    std::vector<char> buf(4, 0);
+    for (uint32_t h = 0; h < 0x10000; ++h) {
+        buf[0] = (char)(h >> 8);
+        buf[1] = (char)h;
+        bitp_parser_t parser;
+        bitp_parser_init(&parser, buf.data(), 16);
+        float f = 0;
+        ASSERT_EQ(BITP_OK, bitp_parser_extract_f16(&parser, &f));
+        bool nan = (h & 0x7C00) == 0x7C00 && (h & 0x3FF);
+        ASSERT_EQ(nan, std::isnan(f)) << h;
+        if (!nan) {
+            ASSERT_EQ(h, bitp_numeric_float_to_f16_(f)) << h;
+        }
+    }
+
+    EXPECT_EQ(1.0f, bitp_numeric_f16_to_float_(0x3C00));
+    EXPECT_EQ(-2.0f, bitp_numeric_f16_to_float_(0xC000));
+    EXPECT_EQ(65504.0f, bitp_numeric_f16_to_float_(0x7BFF));
+    EXPECT_EQ(0x7BFFu, bitp_numeric_float_to_f16_(65519.0f));
+    EXPECT_EQ(0x7C00u, bitp_numeric_float_to_f16_(65520.0f));
+    EXPECT_EQ(0xFC00u, bitp_numeric_float_to_f16_(-1e10f));
+    // ties to even, at 1 + 2^-11 and 1 + 3 * 2^-11
+    EXPECT_EQ(0x3C00u, bitp_numeric_float_to_f16_(1.00048828125f));
+    EXPECT_EQ(0x3C02u, bitp_numeric_float_to_f16_(1.00146484375f));
+    // subnormals and underflow
+    EXPECT_EQ(0x0001u, bitp_numeric_float_to_f16_(5.9604644775390625e-8f));
+    EXPECT_EQ(0x0000u, bitp_numeric_float_to_f16_(2.98023223876953125e-8f));
+    EXPECT_EQ(0x8001u, bitp_numeric_float_to_f16_(-4.5e-8f));
+
+    // random floats of every magnitude, the tiers round the same way
+    std::mt19937 rng(11);
+    std::vector<float> vals(1000);
+    for (float &v : vals) {
+        v = bits_float(rng());
+    }
+    for (unsigned phase = 0; phase < 8; ++phase) {
+        check_array(num, vals, phase);
+    }
+}
+
+TEST(numeric, bf16) {
+    bitp_numeric_t num;
+    bitp_numeric_init_bf16(&num);
+
+    for (uint32_t h = 0; h < 0x10000; ++h) {
+        float f = bitp_numeric_bf16_to_float_(h);
+        if (!std::isnan(f)) {
+            ASSERT_EQ(h, bitp_numeric_float_to_bf16_(f)) << h;
+        }
+    }
+    EXPECT_EQ(0x3F80u, bitp_numeric_float_to_bf16_(1.0f));
+    // ties to even
+    EXPECT_EQ(0x3F80u, bitp_numeric_float_to_bf16_(bits_float(0x3F808000)));
+    EXPECT_EQ(0x3F82u, bitp_numeric_float_to_bf16_(bits_float(0x3F818000)));
+    EXPECT_EQ(0x3F81u, bitp_numeric_float_to_bf16_(bits_float(0x3F808001)));
+    // signaling NaN doesn't round into infinity
+    EXPECT_EQ(0x7FC0u, bitp_numeric_float_to_bf16_(bits_float(0x7F800001)));
+
+    std::vector<char> buf(8, 0);
+    bitp_packer_t packer;
+    bitp_packer_init(&packer, buf.data(), 32, 1);
+    ASSERT_EQ(BITP_OK, bitp_packer_add_bf16(&packer, -3.5f));
+    ASSERT_EQ(BITP_OK, bitp_packer_add_f16(&packer, -3.5f));
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, buf.data(), 32);
+    float a = 0, b = 0;
+    ASSERT_EQ(BITP_OK, bitp_parser_extract_bf16(&parser, &a));
+    ASSERT_EQ(BITP_OK, bitp_parser_extract_f16(&parser, &b));
+    EXPECT_EQ(-3.5f, a);
+    EXPECT_EQ(-3.5f, b);
+
+    std::mt19937 rng(12);
+    std::vector<float> vals(1000);
+    for (float &v : vals) {
+        v = bits_float(rng());
+    }
+    for (unsigned phase = 0; phase < 8; ++phase) {
+        check_array(num, vals, phase);
+    }
+}
+
+TEST(numeric, scaled) {
+    // RSRP: 7 bits, 1 dB steps from -140 dBm
+    bitp_numeric_t rsrp;
+    ASSERT_EQ(BITP_OK, bitp_numeric_init_scaled(&rsrp, 7, 0, 1.0f, -140.0f));
+    std::vector<char> buf(16, 0);
+    bitp_packer_t packer;
+    bitp_packer_init(&packer, buf.data(), 5 * 7, 1);
+    for (float v : {-140.0f, -97.4f, -96.5f, -13.0f, 10.0f}) {
+        ASSERT_EQ(BITP_OK, bitp_packer_add_numeric(&packer, &rsrp, v));
+    }
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, buf.data(), 5 * 7);
+    std::vector<float> res(5);
+    ASSERT_EQ(BITP_OK, bitp_parser_extract_numeric_array(&parser, &rsrp, res.data(), 5));
+    // rounded to nearest even and saturated at the top
+    EXPECT_EQ((std::vector<float>{-140.0f, -97.0f, -96.0f, -13.0f, -13.0f}), res);
+
+    // Q1.15
+    bitp_numeric_t q15;
+    ASSERT_EQ(BITP_OK, bitp_numeric_init_q(&q15, 16, 1, 15));
+    EXPECT_EQ(0x4000u, bitp_numeric_from_float_(&q15, 0.5f));
+    EXPECT_EQ(0x8000u, bitp_numeric_from_float_(&q15, -1.0f));
+    EXPECT_EQ(0x8000u, bitp_numeric_from_float_(&q15, -2.0f));
+    EXPECT_EQ(0x7FFFu, bitp_numeric_from_float_(&q15, 1.0f));
+    EXPECT_EQ(0u, bitp_numeric_from_float_(&q15, NAN));
+    EXPECT_EQ(-0.25f, bitp_numeric_to_float_(&q15, 0xE000));
+
+    // every width and phase, values in and past the range, through every tier
+    std::mt19937 rng(13);
+    for (unsigned n_bits = 1; n_bits <= 32; ++n_bits) {
+        for (int is_signed = 0; is_signed <= 1; ++is_signed) {
+            bitp_numeric_t num;
+            float scale = n_bits > 20 ? 0.001f : 0.25f;
+            ASSERT_EQ(BITP_OK, bitp_numeric_init_scaled(&num, n_bits, is_signed, scale, is_signed ? 3.0f : -7.5f));
+            std::vector<float> vals(77);
+            for (float &v : vals) {
+                float span = (float)(num.max - num.min) * scale;
+                v = num.offset + (float)num.min * scale + span * std::uniform_real_distribution<float>(-0.1f, 1.1f)(rng);
+            }
+            vals[0] = NAN;
+            vals[1] = INFINITY;
+            vals[2] = -INFINITY;
+            check_array(num, vals, rng() % 8);
+        }
+    }
+}
+
+TEST(numeric, errors) {
+    bitp_numeric_t num;
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_numeric_init_scaled(&num, 0, 0, 1.0f, 0.0f));
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_numeric_init_scaled(&num, 33, 0, 1.0f, 0.0f));
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_numeric_init_scaled(&num, 8, 0, 0.0f, 0.0f));
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_numeric_init_q(&num, 8, 1, 9));
+
+    bitp_numeric_init_f16(&num);
+    std::vector<char> buf(16, 0);
+    float vals[4] = {1, 2, 3, 4};
+    bitp_packer_t packer;
+    bitp_packer_init(&packer, buf.data(), 63, 1);
+    EXPECT_EQ(BITP_EFULL, bitp_packer_add_numeric_array(&packer, &num, vals, 4));
+    EXPECT_EQ(0u, packer.iter);
+    EXPECT_EQ(BITP_OK, bitp_packer_add_numeric_array(&packer, &num, vals, 3));
+
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, buf.data(), 63);
+    EXPECT_EQ(BITP_EFULL, bitp_parser_extract_numeric_array(&parser, &num, vals, 4));
+    EXPECT_EQ(0u, parser.iter);
+    EXPECT_EQ(BITP_OK, bitp_parser_extract_numeric_array(&parser, &num, vals, 3));
+    EXPECT_EQ(3.0f, vals[2]);
+    EXPECT_EQ(BITP_EFULL, bitp_parser_extract_numeric(&parser, &num, vals));
+}
@@ -297,3 +297,76 @@ TEST(packer_tests, f64) {
         ASSERT_EQ(buf[i], expected[i]);
     }
 }
+
+TEST(packer_tests, reserved) {
+    uint8_t expected[12];
+    uint8_t buf[12];
+
+    bitp_packer_t packer;
+    bitp_packer_init(&packer, (char *)expected, 91, 1);
+    packer.iter = 5;
+    ASSERT_EQ(bitp_packer_add_u8(&packer, 5, 3), BITP_OK);
+    ASSERT_EQ(bitp_packer_add_i8(&packer, -3, 8), BITP_OK);
+    ASSERT_EQ(bitp_packer_add_u16(&packer, 0x1ABC, 13), BITP_OK);
+    ASSERT_EQ(bitp_packer_add_i16(&packer, -300, 11), BITP_OK);
+    ASSERT_EQ(bitp_packer_add_u32(&packer, 0x12345, 17), BITP_OK);
+    ASSERT_EQ(bitp_packer_add_i32(&packer, -2, 2), BITP_OK);
+    ASSERT_EQ(bitp_packer_add_float(&packer, 3.5f), BITP_OK);
+
+    bitp_packer_init(&packer, (char *)buf, 91, 1);
+    packer.iter = 5;
+
+    bitp_packer_reserved_t reserved;
+    ASSERT_EQ(bitp_packer_reserve(&packer, 87, &reserved), BITP_EFULL);
+    ASSERT_EQ(bitp_packer_reserve(&packer, 86, &reserved), BITP_OK);
+    bitp_packer_reserved_add_u8(&reserved, 5, 3);
+    bitp_packer_reserved_add_i8(&reserved, -3, 8);
+    bitp_packer_reserved_add_u16(&reserved, 0x1ABC, 13);
+    bitp_packer_reserved_add_i16(&reserved, -300, 11);
+    bitp_packer_reserved_add_u32(&reserved, 0x12345, 17);
+    bitp_packer_reserved_add_i32(&reserved, -2, 2);
+    bitp_packer_reserved_add_float(&reserved, 3.5f);
+    ASSERT_EQ(packer.iter, 5u + 3 + 8 + 13 + 11 + 17 + 2 + 32);
+
+    for (size_t i = 0; i < sizeof(buf); ++i) {
+        ASSERT_EQ(buf[i], expected[i]);
+    }
+}
+
+#if !defined(NDEBUG) && GTEST_HAS_DEATH_TEST
+TEST(packer_tests, reserved_overrun) {
+    uint8_t buf[8];
+
+    bitp_packer_t packer;
+    bitp_packer_init(&packer, (char *)buf, 64, 1);
+
+    bitp_packer_reserved_t reserved;
+    ASSERT_EQ(bitp_packer_reserve(&packer, 12, &reserved), BITP_OK);
+    bitp_packer_reserved_add_u8(&reserved, 1, 8);
+    ASSERT_DEATH(bitp_packer_reserved_add_u8(&reserved, 1, 5), "");
+    ASSERT_DEATH(bitp_packer_reserved_add_u8(&reserved, 16, 4), "");
+    ASSERT_DEATH(bitp_packer_reserved_add_i64(&reserved, -9, 4), "");
+}
+#endif
+
+TEST(packer_tests, set_u64) {
+    uint8_t buf[3] = {0xFF, 0xFF, 0xFF};
+    bitp_packer_t packer;
+    bitp_packer_init(&packer, (char *)buf, 20, 0);
+    packer.iter = 7;
+
+    ASSERT_EQ(bitp_packer_set_u64(&packer, 3, 0x2A, 7), BITP_OK);
+    ASSERT_EQ(packer.iter, 7u);
+    // 111 0101010 1111111111 1111
+    ASSERT_EQ(buf[0], 0xEA);
+    ASSERT_EQ(buf[1], 0xBF);
+    ASSERT_EQ(buf[2], 0xFF);
+
+    ASSERT_EQ(bitp_packer_set_u64(&packer, 15, 0, 5), BITP_OK);
+    ASSERT_EQ(buf[1], 0xBE);
+    ASSERT_EQ(buf[2], 0x0F);
+
+    ASSERT_EQ(bitp_packer_set_u64(&packer, 15, 0, 6), BITP_EFULL);
+    ASSERT_EQ(bitp_packer_set_u64(&packer, 0, 8, 3), BITP_EINVALID_ARG);
+    ASSERT_EQ(bitp_packer_set_u64(&packer, 0, 0, 0), BITP_OK);
+}
@@ -279,3 +279,55 @@ TEST(parser_tests, f64) {
     status = bitp_parser_extract_double(&parser, &res);
     ASSERT_EQ(status, BITP_EFULL);
 }
+
+TEST(parser_tests, reserved) {
+    // 3 bits 110, 8 bits 0xF5 (i8 -11), 13 bits 0x15AD, 32 bits float 3.5, 8 bits skipped, 8 bits 0xAB
+    uint8_t buf[] = {0xDE, 0xB5, 0xAD, 64, 96, 0, 0, 0xFF, 0xAB, 0, 0, 0, 0, 0, 0, 0};
+
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, (char *)buf, 9 * CHAR_BIT);
+    parser.iter = 3;
+
+    bitp_parser_reserved_t reserved;
+    ASSERT_EQ(bitp_parser_reserve(&parser, 9 * CHAR_BIT - 2, &reserved), BITP_EFULL);
+    ASSERT_EQ(bitp_parser_reserve(&parser, 9 * CHAR_BIT - 3, &reserved), BITP_OK);
+
+    int8_t i8;
+    bitp_parser_reserved_extract_i8(&reserved, &i8, 8);
+    ASSERT_EQ(i8, -11);
+
+    uint16_t u16;
+    bitp_parser_reserved_extract_u16(&reserved, &u16, 13);
+    ASSERT_EQ(u16, 0x15AD);
+
+    float f;
+    bitp_parser_reserved_extract_float(&reserved, &f);
+    ASSERT_EQ(f, 3.5f);
+
+    bitp_parser_reserved_skip(&reserved, 8);
+
+    uint64_t u64;
+    bitp_parser_reserved_extract_u64(&reserved, &u64, 8);
+    ASSERT_EQ(u64, 0xABu);
+    ASSERT_EQ(parser.iter, 9u * CHAR_BIT);
+
+    parser.iter = 10 * CHAR_BIT;
+    ASSERT_EQ(bitp_parser_reserve(&parser, 0, &reserved), BITP_EFULL);
+}
+
+#if !defined(NDEBUG) && GTEST_HAS_DEATH_TEST
+TEST(parser_tests, reserved_overrun) {
+    uint8_t buf[16] = {0};
+
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, (char *)buf, 8 * CHAR_BIT);
+
+    bitp_parser_reserved_t reserved;
+    ASSERT_EQ(bitp_parser_reserve(&parser, 12, &reserved), BITP_OK);
+
+    uint8_t res;
+    bitp_parser_reserved_extract_u8(&reserved, &res, 8);
+    ASSERT_DEATH(bitp_parser_reserved_extract_u8(&reserved, &res, 5), "");
+    ASSERT_DEATH(bitp_parser_reserved_extract_u8(&reserved, &res, 9), "");
+}
+#endif
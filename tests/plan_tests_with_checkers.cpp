@@ -0,0 +1,220 @@
+/*
+ * plan_tests_with_checkers.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#define BITP_CHECK_ALL
+#include "bitp/packer.h"
+#include "bitp/plan.h"
+}
+
+// the generic loop the plan replaces: one extract per descriptor entry
+static void decode_reference(const std::vector<bitp_plan_field_t> &fields, bitp_parser_t *parser, std::vector<uint64_t> &res) {
+    for (const auto &f : fields) {
+        if (f.kind == BITP_PLAN_SKIP) {
+            ASSERT_EQ(BITP_OK, bitp_parser_skip(parser, f.n_bits));
+            continue;
+        }
+        uint64_t v = 0;
+        ASSERT_EQ(BITP_OK, bitp_parser_extract_u64(parser, &v, f.n_bits));
+        if (f.kind == BITP_PLAN_SIGNED && f.n_bits < 64 && (v >> (f.n_bits - 1)) & 1) {
+            v |= ~0ULL << f.n_bits;
+        }
+        res.push_back(v);
+    }
+}
+
+TEST(plan_tests, random_layouts) {
+    std::mt19937_64 rng(41);
+    for (int round = 0; round < 2000; ++round) {
+        std::vector<bitp_plan_field_t> fields(1 + rng() % 24);
+        for (auto &f : fields) {
+            f.name = NULL;
+            f.kind = (bitp_plan_kind_t)(rng() % 3);
+            // mostly narrow fields, some that need the ninth byte
+            f.n_bits = (unsigned)(rng() % 4 ? 1 + rng() % 20 : 1 + rng() % 64);
+            if (f.kind == BITP_PLAN_SKIP && rng() % 8 == 0) {
+                f.n_bits = 100 + (unsigned)(rng() % 200);
+            }
+        }
+        bitp_plan_t plan;
+        ASSERT_EQ(BITP_OK, bitp_plan_compile(&plan, fields.data(), (unsigned)fields.size()));
+
+        size_t n_records = 1 + rng() % 8;
+        size_t lead = rng() % 16;
+        size_t n_bits = lead + n_records * plan.record_bits;
+        std::vector<char> buf((n_bits + 7) / 8 + sizeof(uint64_t));
+        for (auto &b : buf) {
+            b = (char)rng();
+        }
+
+        bitp_parser_t parser;
+        bitp_parser_init(&parser, buf.data(), n_bits);
+        bitp_parser_skip(&parser, lead);
+        std::vector<uint64_t> expected;
+        for (size_t r = 0; r < n_records; ++r) {
+            decode_reference(fields, &parser, expected);
+        }
+
+        bitp_parser_init(&parser, buf.data(), n_bits);
+        bitp_parser_skip(&parser, lead);
+        std::vector<uint64_t> res(n_records * plan.n_out + 1, 0xA5);
+        ASSERT_EQ(BITP_OK, bitp_plan_run(&plan, &parser, res.data(), n_records));
+        ASSERT_EQ(n_bits, parser.iter);
+        ASSERT_EQ(0xA5u, res.back());
+        res.pop_back();
+        ASSERT_EQ(expected, res);
+    }
+}
+
+TEST(plan_tests, windows) {
+    // three fields in one window, the 60-bit one on its own
+    const bitp_plan_field_t fields[] = {
+        {"a", 20, BITP_PLAN_UNSIGNED}, {"b", 20, BITP_PLAN_SIGNED}, {"", 3, BITP_PLAN_SKIP},
+        {"c", 14, BITP_PLAN_UNSIGNED}, {"d", 60, BITP_PLAN_UNSIGNED}, {"e", 1, BITP_PLAN_SIGNED},
+    };
+    bitp_plan_t plan;
+    ASSERT_EQ(BITP_OK, bitp_plan_compile(&plan, fields, 6));
+    EXPECT_EQ(5u, plan.n_out);
+    EXPECT_EQ(3u, plan.n_windows);
+    EXPECT_EQ(118u, plan.record_bits);
+
+    char buf[16 + sizeof(uint64_t)] = {};
+    bitp_packer_t packer;
+    bitp_packer_init(&packer, buf, 118, 1);
+    bitp_packer_add_u64(&packer, 0xABCDE, 20);
+    bitp_packer_add_u64(&packer, 0xFFFFE, 20);
+    bitp_packer_add_u64(&packer, 7, 3);
+    bitp_packer_add_u64(&packer, 0x2345, 14);
+    bitp_packer_add_u64(&packer, 0xFEDCBA987654321ULL, 60);
+    bitp_packer_add_u64(&packer, 1, 1);
+
+    uint64_t res[5];
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, buf, 118);
+    ASSERT_EQ(BITP_OK, bitp_plan_run(&plan, &parser, res, 1));
+    EXPECT_EQ(0xABCDEu, res[0]);
+    EXPECT_EQ(-2, (int64_t)res[1]);
+    EXPECT_EQ(0x2345u, res[2]);
+    EXPECT_EQ(0xFEDCBA987654321ULL, res[3]);
+    EXPECT_EQ(-1, (int64_t)res[4]);
+}
+
+TEST(plan_tests, load) {
+    const std::string text =
+        "# vendor trace record\n"
+        "sfn        u10\n"
+        "\n"
+        "spare      x2   # reserved\n"
+        "  rsrp_dbm i8\n"
+        "timestamp  u40\r\n";
+    bitp_plan_t plan;
+    size_t line = 99;
+    ASSERT_EQ(BITP_OK, bitp_plan_load(&plan, text.data(), text.size(), &line));
+    EXPECT_EQ(0u, line);
+    EXPECT_EQ(3u, plan.n_out);
+    EXPECT_EQ(60u, plan.record_bits);
+    EXPECT_EQ(0, bitp_plan_find(&plan, "sfn"));
+    EXPECT_EQ(1, bitp_plan_find(&plan, "rsrp_dbm"));
+    EXPECT_EQ(2, bitp_plan_find(&plan, "timestamp"));
+    EXPECT_EQ(-1, bitp_plan_find(&plan, "spare"));
+
+    char buf[8 + sizeof(uint64_t)] = {};
+    bitp_packer_t packer;
+    bitp_packer_init(&packer, buf, 60, 1);
+    bitp_packer_add_u64(&packer, 1023, 10);
+    bitp_packer_add_u64(&packer, 0, 2);
+    bitp_packer_add_u64(&packer, 0x85, 8);
+    bitp_packer_add_u64(&packer, 123456789, 40);
+    uint64_t res[3];
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, buf, 60);
+    ASSERT_EQ(BITP_OK, bitp_plan_run(&plan, &parser, res, 1));
+    EXPECT_EQ(1023u, res[0]);
+    EXPECT_EQ(-123, (int64_t)res[1]);
+    EXPECT_EQ(123456789u, res[2]);
+}
+
+TEST(plan_tests, errors) {
+    bitp_plan_t plan;
+    size_t line = 0;
+    const char *bad[] = {"a u10\nb q3\n", "a u10\nb u65\n", "a u10\n\nb u0\n", "a u10\nb\n", "a u1 x\n", "a u1x\n"};
+    const size_t bad_line[] = {2, 2, 3, 2, 1, 1};
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); ++i) {
+        EXPECT_EQ(BITP_EINVALID_ARG, bitp_plan_load(&plan, bad[i], strlen(bad[i]), &line)) << bad[i];
+        EXPECT_EQ(bad_line[i], line) << bad[i];
+    }
+
+    std::vector<bitp_plan_field_t> fields(BITP_PLAN_MAX + 1, bitp_plan_field_t{"f", 1, BITP_PLAN_UNSIGNED});
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_plan_compile(&plan, fields.data(), BITP_PLAN_MAX + 1));
+    ASSERT_EQ(BITP_OK, bitp_plan_compile(&plan, fields.data(), BITP_PLAN_MAX));
+    EXPECT_EQ(64u, plan.record_bits);
+
+    // short input: nothing decoded, the parser stays
+    char buf[8 + sizeof(uint64_t)] = {};
+    uint64_t res[2 * BITP_PLAN_MAX] = {};
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, buf, 127);
+    EXPECT_EQ(BITP_EFULL, bitp_plan_run(&plan, &parser, res, 2));
+    EXPECT_EQ(0u, parser.iter);
+    EXPECT_EQ(BITP_OK, bitp_plan_run(&plan, &parser, res, 1));
+    EXPECT_EQ(BITP_EFULL, bitp_plan_run(&plan, &parser, res, 1));
+    EXPECT_EQ(64u, parser.iter);
+}
+
+TEST(plan_tests, lanes) {
+    std::mt19937_64 rng(42);
+    for (int round = 0; round < 300; ++round) {
+        std::vector<bitp_plan_field_t> fields(1 + rng() % 12);
+        for (auto &f : fields) {
+            f.name = NULL;
+            f.kind = (bitp_plan_kind_t)(rng() % 3);
+            f.n_bits = (unsigned)(rng() % 4 ? 1 + rng() % 12 : 1 + rng() % 64);
+        }
+        bitp_plan_t plan;
+        ASSERT_EQ(BITP_OK, bitp_plan_compile(&plan, fields.data(), (unsigned)fields.size()));
+
+        // messages at random unaligned places of one buffer
+        size_t n_msgs = rng() % 50;
+        size_t msg_bytes = (plan.record_bits + 7) / 8 + sizeof(uint64_t);
+        std::vector<char> buf(n_msgs * (msg_bytes + 7) + 1);
+        for (auto &b : buf) {
+            b = (char)rng();
+        }
+        std::vector<const char *> msgs(n_msgs);
+        for (size_t i = 0; i < n_msgs; ++i) {
+            msgs[i] = buf.data() + i * (msg_bytes + 7) + rng() % 8;
+        }
+
+        std::vector<uint64_t> expected(plan.n_out * n_msgs);
+        for (size_t i = 0; i < n_msgs; ++i) {
+            bitp_parser_t parser;
+            bitp_parser_init(&parser, msgs[i], plan.record_bits);
+            ASSERT_EQ(BITP_OK, bitp_plan_run(&plan, &parser, expected.data() + i * plan.n_out, 1));
+        }
+
+        for (int isa = BITP_ISA_SCALAR; isa <= bitp_cpu_isa(bitp_cpu_features()); ++isa) {
+            std::vector<std::vector<uint64_t>> lanes(plan.n_out, std::vector<uint64_t>(n_msgs + 1, 0xA5));
+            std::vector<uint64_t *> res(plan.n_out);
+            for (unsigned k = 0; k < plan.n_out; ++k) {
+                res[k] = lanes[k].data();
+            }
+            bitp_plan_run_lanes_isa(&plan, msgs.data(), n_msgs, res.data(), (bitp_isa_t)isa);
+            for (unsigned k = 0; k < plan.n_out; ++k) {
+                ASSERT_EQ(0xA5u, lanes[k][n_msgs]) << "isa " << isa;
+                for (size_t i = 0; i < n_msgs; ++i) {
+                    ASSERT_EQ(expected[i * plan.n_out + k], lanes[k][i]) << "isa " << isa << " msg " << i << " field " << k;
+                }
+            }
+        }
+    }
+}
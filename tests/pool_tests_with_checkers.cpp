@@ -0,0 +1,110 @@
+/*
+ * pool_tests_with_checkers.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <random>
+#include <set>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#define BITP_CHECK_ALL
+#include "bitp/pool.h"
+}
+
+TEST(pool, alloc_free) {
+    std::vector<char> arena(1024);
+    std::vector<bitp_cursor_t> slots(16);
+    bitp_pool_t pool;
+    ASSERT_EQ(BITP_OK, bitp_pool_init(&pool, arena.data(), 1000 * CHAR_BIT, slots.data(), 16));
+    EXPECT_EQ(8u, sizeof(bitp_cursor_t));
+
+    std::set<uint32_t> used;
+    uint32_t h = 0;
+    for (uint32_t i = 0; i < 16; ++i) {
+        ASSERT_EQ(BITP_OK, bitp_pool_alloc(&pool, i * 64, 64, &h));
+        EXPECT_EQ(i, h);
+        used.insert(h);
+    }
+    EXPECT_EQ(BITP_EFULL, bitp_pool_alloc(&pool, 0, 64, &h));
+    EXPECT_EQ(BITP_POOL_NONE, h);
+    EXPECT_EQ(16u, pool.n_used);
+
+    // released slots are reused, most recent first
+    bitp_pool_free(&pool, 3);
+    bitp_pool_free(&pool, 11);
+    EXPECT_EQ(14u, pool.n_used);
+    ASSERT_EQ(BITP_OK, bitp_pool_alloc(&pool, 100, 8, &h));
+    EXPECT_EQ(11u, h);
+    EXPECT_EQ(100u, bitp_pool_get(&pool, h)->iter);
+    EXPECT_EQ(108u, bitp_pool_get(&pool, h)->capacity);
+    ASSERT_EQ(BITP_OK, bitp_pool_alloc(&pool, 0, 8000, &h));
+    EXPECT_EQ(3u, h);
+
+    // the range has to be inside the arena
+    bitp_pool_free(&pool, 3);
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_pool_alloc(&pool, 0, 8001, &h));
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_pool_alloc(&pool, 8001, 0, &h));
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_pool_alloc(&pool, 8000, 0xFFFFFFFFu, &h));
+    EXPECT_EQ(BITP_OK, bitp_pool_alloc(&pool, 8000, 0, &h));
+
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_pool_init(&pool, arena.data(), (size_t)1 << 32, slots.data(), 16));
+    EXPECT_EQ(BITP_OK, bitp_pool_init(&pool, arena.data(), 0, slots.data(), 0));
+    EXPECT_EQ(BITP_EFULL, bitp_pool_alloc(&pool, 0, 0, &h));
+}
+
+TEST(pool, interleaved_streams) {
+    // 64 flows each pack a sequence of 13-bit values in their part of the arena, in random turns,
+    // then parse it back in random turns
+    const uint32_t n_flows = 64, flow_bits = 13 * 50;
+    std::vector<char> arena(n_flows * flow_bits / CHAR_BIT + 64, 0);
+    std::vector<bitp_cursor_t> slots(n_flows);
+    bitp_pool_t pool;
+    ASSERT_EQ(BITP_OK, bitp_pool_init(&pool, arena.data(), n_flows * flow_bits, slots.data(), n_flows));
+    std::vector<uint32_t> handles(n_flows);
+    for (uint32_t f = 0; f < n_flows; ++f) {
+        ASSERT_EQ(BITP_OK, bitp_pool_alloc(&pool, f * flow_bits, flow_bits, &handles[f]));
+    }
+
+    std::mt19937 rng(3);
+    std::vector<unsigned> count(n_flows, 0);
+    for (unsigned remaining = n_flows * 50; remaining;) {
+        uint32_t f = rng() % n_flows;
+        bitp_packer_t packer;
+        bitp_pool_load_packer(&pool, handles[f], &packer);
+        if (count[f] == 50) {
+            // the flow's range is full
+            ASSERT_EQ(BITP_EFULL, bitp_packer_add_u8(&packer, 0, 1));
+            continue;
+        }
+        ASSERT_EQ(BITP_OK, bitp_packer_add_u16(&packer, (uint16_t)((f * 131 + count[f]) & 0x1FFF), 13));
+        bitp_pool_store_packer(&pool, handles[f], &packer);
+        count[f]++;
+        remaining--;
+    }
+
+    for (uint32_t f = 0; f < n_flows; ++f) {
+        bitp_pool_free(&pool, handles[f]);
+        ASSERT_EQ(BITP_OK, bitp_pool_alloc(&pool, f * flow_bits, flow_bits, &handles[f]));
+        count[f] = 0;
+    }
+    for (unsigned remaining = n_flows * 50; remaining;) {
+        uint32_t f = rng() % n_flows;
+        bitp_parser_t parser;
+        uint16_t v = 0;
+        bitp_pool_load_parser(&pool, handles[f], &parser);
+        if (count[f] == 50) {
+            ASSERT_EQ(BITP_EFULL, bitp_parser_extract_u16(&parser, &v, 1));
+            continue;
+        }
+        ASSERT_EQ(BITP_OK, bitp_parser_extract_u16(&parser, &v, 13));
+        ASSERT_EQ((f * 131 + count[f]) & 0x1FFF, v);
+        bitp_pool_store_parser(&pool, handles[f], &parser);
+        count[f]++;
+        remaining--;
+    }
+}
@@ -0,0 +1,189 @@
+/*
+ * search_tests_with_checkers.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#define BITP_CHECK_ALL
+#include "bitp/search.h"
+}
+
+static size_t reference_find(const std::vector<uint8_t> &buf,
+                             size_t capacity,
+                             size_t from,
+                             uint64_t pattern,
+                             unsigned n_bits,
+                             unsigned max_errors) {
+    for (size_t pos = from; pos + n_bits <= capacity; ++pos) {
+        unsigned errors = 0;
+        for (unsigned i = 0; i < n_bits; ++i) {
+            size_t bit = pos + i;
+            unsigned stream_bit = (buf[bit / 8] >> (7 - bit % 8)) & 1;
+            unsigned pattern_bit = (pattern >> (n_bits - 1 - i)) & 1;
+            errors += stream_bit != pattern_bit;
+        }
+        if (errors <= max_errors) {
+            return pos;
+        }
+    }
+    return BITP_SEARCH_NPOS;
+}
+
+static void write_bits(std::vector<uint8_t> &buf, size_t pos, uint64_t val, unsigned n_bits) {
+    for (unsigned i = 0; i < n_bits; ++i) {
+        size_t bit = pos + i;
+        uint8_t m = (uint8_t)(0x80 >> (bit % 8));
+        if ((val >> (n_bits - 1 - i)) & 1) {
+            buf[bit / 8] |= m;
+        }
+        else {
+            buf[bit / 8] &= (uint8_t)~m;
+        }
+    }
+}
+
+TEST(search_tests, init) {
+    bitp_pattern_t pattern = {};
+
+    ASSERT_EQ(bitp_pattern_init(&pattern, 0x1ACFFC1D, 32, 0), BITP_OK);
+    ASSERT_EQ(pattern.value, 0x1ACFFC1D00000000ULL);
+    ASSERT_EQ(pattern.mask, 0xFFFFFFFF00000000ULL);
+    ASSERT_EQ(pattern.anchors[0], 0x1A);
+    ASSERT_EQ(pattern.anchors[4], 0xAC);
+
+    ASSERT_EQ(bitp_pattern_init(&pattern, 1, 0, 0), BITP_EINVALID_ARG);
+    ASSERT_EQ(bitp_pattern_init(&pattern, 1, 65, 0), BITP_EINVALID_ARG);
+    ASSERT_EQ(bitp_pattern_init(&pattern, 0x1F, 4, 0), BITP_EINVALID_ARG);
+    ASSERT_EQ(bitp_pattern_init(&pattern, 0xFFFFFFFFFFFFFFFFULL, 64, 0), BITP_OK);
+}
+
+TEST(search_tests, every_phase) {
+    const uint64_t sync = 0x1ACFFC1D;
+
+    for (size_t offset = 0; offset < 200; ++offset) {
+        std::vector<uint8_t> buf(64, 0);
+        write_bits(buf, offset, sync, 32);
+
+        bitp_pattern_t pattern = {};
+        ASSERT_EQ(bitp_pattern_init(&pattern, sync, 32, 0), BITP_OK);
+
+        bitp_parser_t parser;
+        bitp_parser_init(&parser, (char *)buf.data(), buf.size() * CHAR_BIT);
+
+        ASSERT_EQ(bitp_parser_find(&parser, &pattern), BITP_OK);
+        ASSERT_EQ(parser.iter, offset);
+
+        uint32_t res;
+        ASSERT_EQ(bitp_parser_extract_u32(&parser, &res, 32), BITP_OK);
+        ASSERT_EQ(res, sync);
+    }
+}
+
+TEST(search_tests, not_found) {
+    uint8_t buf[] = {0xDE, 0xAD, 0xBE, 0xEF};
+
+    bitp_pattern_t pattern = {};
+    bitp_pattern_init(&pattern, 0xBEEF, 16, 0);
+
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, (char *)buf, 31);
+
+    // the match would end past the capacity
+    ASSERT_EQ(bitp_parser_find(&parser, &pattern), BITP_EFULL);
+    ASSERT_EQ(parser.iter, 16u);
+
+    bitp_parser_init(&parser, (char *)buf, sizeof(buf) * CHAR_BIT);
+    ASSERT_EQ(bitp_parser_find(&parser, &pattern), BITP_OK);
+    ASSERT_EQ(parser.iter, 16u);
+
+    parser.iter++;
+    ASSERT_EQ(bitp_parser_find(&parser, &pattern), BITP_EFULL);
+}
+
+TEST(search_tests, bit_errors) {
+    uint8_t buf[] = {0x00, 0x1A, 0xCF, 0xFC, 0x1D, 0x00};
+    // two flipped bits in the sync word
+    buf[2] ^= 0x41;
+
+    bitp_pattern_t pattern = {};
+    bitp_parser_t parser;
+
+    bitp_pattern_init(&pattern, 0x1ACFFC1D, 32, 1);
+    bitp_parser_init(&parser, (char *)buf, sizeof(buf) * CHAR_BIT);
+    ASSERT_EQ(bitp_parser_find(&parser, &pattern), BITP_EFULL);
+
+    bitp_pattern_init(&pattern, 0x1ACFFC1D, 32, 2);
+    bitp_parser_init(&parser, (char *)buf, sizeof(buf) * CHAR_BIT);
+    ASSERT_EQ(bitp_parser_find(&parser, &pattern), BITP_OK);
+    ASSERT_EQ(parser.iter, 8u);
+}
+
+TEST(search_tests, find_all) {
+    std::vector<uint8_t> buf(256, 0);
+    const size_t offsets[] = {3, 97, 500, 1013, 2000};
+    for (size_t offset : offsets) {
+        write_bits(buf, offset, 0x5A5, 12);
+    }
+
+    bitp_pattern_t pattern = {};
+    bitp_pattern_init(&pattern, 0x5A5, 12, 0);
+
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, (char *)buf.data(), buf.size() * CHAR_BIT);
+
+    bitp_parser_t matches[8];
+    ASSERT_EQ(bitp_parser_find_all(&parser, &pattern, matches, 8), 5u);
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_EQ(matches[i].iter, offsets[i]);
+        ASSERT_EQ(matches[i].capacity, parser.capacity);
+    }
+
+    ASSERT_EQ(bitp_parser_find_all(&parser, &pattern, matches, 2), 2u);
+    ASSERT_EQ(parser.iter, 0u);
+}
+
+TEST(search_tests, random_against_reference) {
+    std::mt19937_64 rng(26);
+
+    for (int round = 0; round < 300; ++round) {
+        unsigned n_bits = 1 + rng() % 64;
+        unsigned max_errors = (round % 3 == 0) ? rng() % 4 : 0;
+        size_t size = 1 + rng() % 96;
+        std::vector<uint8_t> buf(size);
+        for (auto &b : buf) {
+            // sparse bits make random short patterns less likely to hit at once
+            b = (uint8_t)(rng() & rng() & rng());
+        }
+        uint64_t value = n_bits == 64 ? rng() : rng() & ((1ULL << n_bits) - 1);
+        size_t capacity = size * CHAR_BIT - rng() % 8;
+        if (capacity >= n_bits && rng() % 2) {
+            write_bits(buf, rng() % (capacity - n_bits + 1), value, n_bits);
+        }
+
+        bitp_pattern_t pattern = {};
+        ASSERT_EQ(bitp_pattern_init(&pattern, value, n_bits, max_errors), BITP_OK);
+
+        bitp_parser_t parser;
+        bitp_parser_init(&parser, (char *)buf.data(), capacity);
+        parser.iter = rng() % 16;
+
+        while (true) {
+            size_t expected = reference_find(buf, capacity, parser.iter, value, n_bits, max_errors);
+            bitp_status_t status = bitp_parser_find(&parser, &pattern);
+            if (expected == BITP_SEARCH_NPOS) {
+                ASSERT_EQ(status, BITP_EFULL);
+                break;
+            }
+            ASSERT_EQ(status, BITP_OK);
+            ASSERT_EQ(parser.iter, expected);
+            parser.iter++;
+        }
+    }
+}
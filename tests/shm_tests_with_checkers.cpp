@@ -0,0 +1,262 @@
+/*
+ * shm_tests_with_checkers.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <errno.h>
+#include <sched.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <deque>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#define BITP_CHECK_ALL
+#include "bitp/shm.h"
+}
+
+// a ring name of its own for every test, unlinked at the end
+class shm_name {
+public:
+    explicit shm_name(const char *test) : name_(std::string("/bitp_") + test + "_" + std::to_string(getpid())) {
+        bitp_shm_unlink(name_.c_str());
+    }
+
+    ~shm_name() {
+        bitp_shm_unlink(name_.c_str());
+    }
+
+    const char *c_str() const {
+        return name_.c_str();
+    }
+
+private:
+    std::string name_;
+};
+
+// a 32-bit id, then bytes of id + i, then 1 in the bits left
+static void pack_message(bitp_packer_t *packer, uint32_t id, size_t n_bits) {
+    ASSERT_EQ(BITP_OK, bitp_packer_add_u32(packer, id, 32));
+    for (size_t i = 0; packer->iter + 8 <= n_bits; ++i) {
+        ASSERT_EQ(BITP_OK, bitp_packer_add_u8(packer, (uint8_t)(id + i), 8));
+    }
+    if (packer->iter < n_bits) {
+        ASSERT_EQ(BITP_OK, bitp_packer_add_u8(packer, 1, n_bits - packer->iter));
+    }
+}
+
+static void check_message(bitp_parser_t *parser, uint32_t id, size_t n_bits) {
+    ASSERT_EQ(n_bits, parser->capacity);
+    uint32_t got = 0;
+    ASSERT_EQ(BITP_OK, bitp_parser_extract_u32(parser, &got, 32));
+    ASSERT_EQ(id, got);
+    for (size_t i = 0; parser->iter + 8 <= n_bits; ++i) {
+        uint8_t v = 0;
+        ASSERT_EQ(BITP_OK, bitp_parser_extract_u8(parser, &v, 8));
+        ASSERT_EQ((uint8_t)(id + i), v) << id << " " << i;
+    }
+    if (parser->iter < n_bits) {
+        uint8_t last = 0;
+        ASSERT_EQ(BITP_OK, bitp_parser_extract_u8(parser, &last, n_bits - parser->iter));
+        ASSERT_EQ(1, last);
+    }
+}
+
+TEST(shm_tests, spsc_laps) {
+    shm_name name("spsc_laps");
+    bitp_shm_t *prod, *cons;
+    ASSERT_EQ(BITP_OK, bitp_shm_create(&prod, name.c_str(), 4096, BITP_SHM_SPSC));
+    ASSERT_EQ(BITP_OK, bitp_shm_open(&cons, name.c_str()));
+    EXPECT_EQ((2048u - 16) * 8, bitp_shm_max_bits(prod));
+
+    std::mt19937 rng(46);
+    std::deque<std::pair<uint32_t, size_t>> in_flight;
+    uint32_t next_id = 0;
+    size_t n_full = 0;
+    while (next_id < 20000) {
+        // a burst of messages until the ring is full, then a batch of them consumed
+        for (int i = 0; i < 1 + (int)(rng() % 16); ++i) {
+            size_t n_bits = 33 + (rng() % 8 ? rng() % 300 : rng() % 4000);
+            bitp_packer_t packer;
+            bitp_status_t s = bitp_shm_reserve(prod, n_bits, &packer);
+            if (s == BITP_EFULL) {
+                n_full++;
+                break;
+            }
+            ASSERT_EQ(BITP_OK, s);
+            ASSERT_EQ(n_bits, packer.capacity);
+            pack_message(&packer, next_id, n_bits);
+            bitp_shm_commit(prod, &packer);
+            in_flight.emplace_back(next_id++, n_bits);
+        }
+        for (int i = (int)(rng() % 12); i > 0 && !in_flight.empty(); --i) {
+            bitp_parser_t parser;
+            ASSERT_EQ(BITP_OK, bitp_shm_next(cons, &parser));
+            check_message(&parser, in_flight.front().first, in_flight.front().second);
+            in_flight.pop_front();
+        }
+        bitp_shm_release(cons);
+    }
+    while (!in_flight.empty()) {
+        bitp_parser_t parser;
+        ASSERT_EQ(BITP_OK, bitp_shm_next(cons, &parser));
+        check_message(&parser, in_flight.front().first, in_flight.front().second);
+        in_flight.pop_front();
+    }
+    bitp_parser_t parser;
+    EXPECT_EQ(BITP_EAGAIN, bitp_shm_next(cons, &parser));
+    EXPECT_GT(n_full, 0u);
+
+    bitp_shm_close(cons);
+    bitp_shm_close(prod);
+}
+
+TEST(shm_tests, errors) {
+    shm_name name("errors");
+    bitp_shm_t *ring, *other;
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_shm_create(&ring, name.c_str(), 3000, BITP_SHM_SPSC));
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_shm_create(&ring, name.c_str(), 2048, BITP_SHM_SPSC));
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_shm_open(&ring, name.c_str()));
+    EXPECT_EQ(nullptr, ring);
+    ASSERT_EQ(BITP_OK, bitp_shm_create(&ring, name.c_str(), 8192, BITP_SHM_MPSC));
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_shm_create(&other, name.c_str(), 8192, BITP_SHM_MPSC));
+    EXPECT_EQ(EEXIST, errno);
+
+    bitp_packer_t a, b, c;
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_shm_reserve(ring, bitp_shm_max_bits(ring) + 1, &a));
+    ASSERT_EQ(BITP_OK, bitp_shm_reserve(ring, 16, &a));
+    ASSERT_EQ(BITP_OK, bitp_shm_reserve(ring, bitp_shm_max_bits(ring), &b));
+    EXPECT_EQ(BITP_EFULL, bitp_shm_reserve(ring, bitp_shm_max_bits(ring), &c));
+
+    // b is committed first but waits for a; a is committed shorter than reserved
+    bitp_parser_t parser;
+    bitp_packer_add_u8(&b, 0xB, 4);
+    bitp_shm_commit(ring, &b);
+    EXPECT_EQ(BITP_EAGAIN, bitp_shm_next(ring, &parser));
+    bitp_packer_add_u8(&a, 0xA, 4);
+    bitp_shm_commit(ring, &a);
+    uint8_t v = 0;
+    ASSERT_EQ(BITP_OK, bitp_shm_next(ring, &parser));
+    EXPECT_EQ(4u, parser.capacity);
+    bitp_parser_extract_u8(&parser, &v, 4);
+    EXPECT_EQ(0xA, v);
+    ASSERT_EQ(BITP_OK, bitp_shm_next(ring, &parser));
+    bitp_parser_extract_u8(&parser, &v, 4);
+    EXPECT_EQ(0xB, v);
+    EXPECT_EQ(BITP_EAGAIN, bitp_shm_next(ring, &parser));
+
+    // the space comes back with the release only
+    EXPECT_EQ(BITP_EFULL, bitp_shm_reserve(ring, bitp_shm_max_bits(ring), &c));
+    bitp_shm_release(ring);
+    ASSERT_EQ(BITP_OK, bitp_shm_reserve(ring, bitp_shm_max_bits(ring), &c));
+    // zeroed again for the packer
+    for (size_t i = 0; i < bitp_shm_max_bits(ring) / 8; ++i) {
+        ASSERT_EQ(0, c.buf[i]) << i;
+    }
+    bitp_shm_close(ring);
+}
+
+TEST(shm_tests, mpsc_threads) {
+    shm_name name("mpsc_threads");
+    bitp_shm_t *cons;
+    ASSERT_EQ(BITP_OK, bitp_shm_create(&cons, name.c_str(), 1 << 14, BITP_SHM_MPSC));
+
+    const uint32_t n_producers = 3;
+    const uint32_t n_msgs = 20000;
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0; p < n_producers; ++p) {
+        producers.emplace_back([&, p] {
+            bitp_shm_t *prod;
+            ASSERT_EQ(BITP_OK, bitp_shm_open(&prod, name.c_str()));
+            std::mt19937 rng(p);
+            for (uint32_t i = 0; i < n_msgs; ++i) {
+                size_t n_bits = 33 + rng() % 500;
+                bitp_packer_t packer;
+                while (bitp_shm_reserve(prod, n_bits, &packer) == BITP_EFULL) {
+                    sched_yield();
+                }
+                pack_message(&packer, p << 24 | i, n_bits);
+                bitp_shm_commit(prod, &packer);
+            }
+            bitp_shm_close(prod);
+        });
+    }
+
+    std::vector<uint32_t> next(n_producers, 0);
+    for (uint32_t got = 0; got < n_producers * n_msgs;) {
+        bitp_parser_t parser;
+        if (bitp_shm_next(cons, &parser) != BITP_OK) {
+            bitp_shm_release(cons);
+            sched_yield();
+            continue;
+        }
+        uint32_t id = 0;
+        bitp_parser_t copy = parser;
+        bitp_parser_extract_u32(&copy, &id, 32);
+        ASSERT_LT(id >> 24, n_producers);
+        ASSERT_EQ(next[id >> 24], id & 0xFFFFFF);
+        next[id >> 24]++;
+        check_message(&parser, id, parser.capacity);
+        if (++got % 16 == 0) {
+            bitp_shm_release(cons);
+        }
+    }
+    for (auto &t : producers) {
+        t.join();
+    }
+    bitp_shm_close(cons);
+}
+
+TEST(shm_tests, two_processes) {
+    shm_name name("two_processes");
+    bitp_shm_t *cons;
+    ASSERT_EQ(BITP_OK, bitp_shm_create(&cons, name.c_str(), 1 << 13, BITP_SHM_SPSC));
+    const uint32_t n_msgs = 50000;
+
+    pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        bitp_shm_t *prod;
+        if (bitp_shm_open(&prod, name.c_str()) != BITP_OK) {
+            _exit(1);
+        }
+        for (uint32_t i = 0; i < n_msgs; ++i) {
+            bitp_packer_t packer;
+            while (bitp_shm_reserve(prod, 32 + i % 200, &packer) == BITP_EFULL) {
+                sched_yield();
+            }
+            bitp_packer_add_u32(&packer, i, 32);
+            packer.iter = packer.capacity;
+            bitp_shm_commit(prod, &packer);
+        }
+        bitp_shm_close(prod);
+        _exit(0);
+    }
+
+    for (uint32_t i = 0; i < n_msgs;) {
+        bitp_parser_t parser;
+        if (bitp_shm_next(cons, &parser) != BITP_OK) {
+            bitp_shm_release(cons);
+            sched_yield();
+            continue;
+        }
+        uint32_t v = 0;
+        ASSERT_EQ(32 + i % 200, parser.capacity);
+        bitp_parser_extract_u32(&parser, &v, 32);
+        ASSERT_EQ(i, v);
+        ++i;
+    }
+    bitp_shm_release(cons);
+    int status = 0;
+    ASSERT_EQ(child, waitpid(child, &status, 0));
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    bitp_shm_close(cons);
+}
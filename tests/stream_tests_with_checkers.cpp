@@ -0,0 +1,183 @@
+/*
+ * stream_tests_with_checkers.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#define BITP_CHECK_ALL
+#include "bitp/stream.h"
+}
+
+#include "bitp/stream_coro.h"
+
+#if defined(BITP_TEST_STREAM_CORO) && !BITP_STREAM_CORO
+#error "the C++20 test build doesn't get the coroutine form"
+#endif
+
+// 4-bit type, 12-bit length, length bytes of payload
+struct message {
+    uint8_t type;
+    uint16_t len;
+    uint16_t n_read;
+    uint8_t payload[64];
+    // extract calls, to see that nothing is parsed twice
+    unsigned n_extracts;
+};
+
+static bitp_status_t decode(bitp_stream_t *s, message *m) {
+    BITP_STREAM_BEGIN(s);
+    m->n_extracts = 0;
+    BITP_STREAM_NEED(s, 16);
+    bitp_parser_extract_u8(&s->parser, &m->type, 4);
+    bitp_parser_extract_u16(&s->parser, &m->len, 12);
+    m->n_extracts += 2;
+    if (m->len > sizeof(m->payload)) {
+        BITP_STREAM_FAIL(s, BITP_EINVALID_ARG);
+    }
+    // the payload as far as it has arrived
+    for (m->n_read = 0; m->n_read < m->len; m->n_read++) {
+        BITP_STREAM_NEED(s, 8);
+        bitp_parser_extract_u8(&s->parser, &m->payload[m->n_read], 8);
+        m->n_extracts++;
+    }
+    BITP_STREAM_END(s);
+}
+
+static std::vector<uint8_t> frame(uint8_t type, const std::vector<uint8_t> &payload) {
+    std::vector<uint8_t> res(2 + payload.size());
+    res[0] = (uint8_t)(type << 4 | payload.size() >> 8);
+    res[1] = (uint8_t)payload.size();
+    std::copy(payload.begin(), payload.end(), res.begin() + 2);
+    return res;
+}
+
+TEST(stream_tests, byte_by_byte) {
+    std::vector<uint8_t> data = frame(3, {1, 2, 3, 4, 5});
+    std::vector<uint8_t> second = frame(0xA, {});
+    std::vector<uint8_t> third = frame(7, std::vector<uint8_t>(40, 0x5A));
+    data.insert(data.end(), second.begin(), second.end());
+    data.insert(data.end(), third.begin(), third.end());
+
+    // the buffer is smaller than the data, consumed bytes are dropped on the way
+    char buf[64 + BITP_STREAM_PADDING];
+    bitp_stream_t stream;
+    bitp_stream_init(&stream, buf, sizeof(buf));
+
+    std::vector<message> decoded;
+    message m;
+    for (uint8_t byte : data) {
+        ASSERT_EQ(bitp_stream_append(&stream, &byte, 1), BITP_OK);
+        bitp_status_t status;
+        while ((status = decode(&stream, &m)) == BITP_OK) {
+            decoded.push_back(m);
+        }
+        ASSERT_EQ(status, BITP_EAGAIN);
+    }
+
+    ASSERT_EQ(decoded.size(), 3u);
+    ASSERT_EQ(decoded[0].type, 3);
+    ASSERT_EQ(decoded[0].len, 5);
+    ASSERT_EQ(decoded[0].payload[4], 5);
+    ASSERT_EQ(decoded[0].n_extracts, 2u + 5);
+    ASSERT_EQ(decoded[1].type, 0xA);
+    ASSERT_EQ(decoded[1].len, 0);
+    ASSERT_EQ(decoded[1].n_extracts, 2u);
+    ASSERT_EQ(decoded[2].type, 7);
+    ASSERT_EQ(decoded[2].len, 40);
+    ASSERT_EQ(decoded[2].payload[39], 0x5A);
+    ASSERT_EQ(decoded[2].n_extracts, 2u + 40);
+    ASSERT_EQ(bitp_stream_available(&stream), 0u);
+}
+
+TEST(stream_tests, unaligned_and_errors) {
+    char buf[8 + BITP_STREAM_PADDING];
+    bitp_stream_t stream;
+    bitp_stream_init(&stream, buf, sizeof(buf));
+
+    // 4 bits of garbage first
+    const uint8_t data[] = {0xF0, 0x00, 0x21, 0x20, 0x00};
+    ASSERT_EQ(bitp_stream_append(&stream, data, 3), BITP_OK);
+    ASSERT_EQ(bitp_parser_skip(&stream.parser, 4), BITP_OK);
+
+    message m;
+    ASSERT_EQ(decode(&stream, &m), BITP_EAGAIN);
+    ASSERT_EQ(m.n_extracts, 2u);
+    ASSERT_EQ(m.type, 0);
+    ASSERT_EQ(m.len, 2);
+    ASSERT_EQ(decode(&stream, &m), BITP_EAGAIN);
+    ASSERT_EQ(bitp_stream_append(&stream, data + 3, 2), BITP_OK);
+    ASSERT_EQ(decode(&stream, &m), BITP_OK);
+    ASSERT_EQ(m.payload[0], 0x12);
+    ASSERT_EQ(m.payload[1], 0x00);
+    ASSERT_EQ(stream.parser.iter, 36u);
+
+    // no room even after dropping the consumed bytes
+    const uint8_t big[8] = {};
+    ASSERT_EQ(bitp_stream_append(&stream, big, 8), BITP_EFULL);
+    ASSERT_EQ(bitp_stream_append(&stream, big, 7), BITP_OK);
+    ASSERT_EQ(stream.parser.iter, 4u);
+    ASSERT_EQ(bitp_stream_available(&stream), 60u);
+
+    // a failed message restarts
+    bitp_stream_init(&stream, buf, sizeof(buf));
+    const uint8_t too_long[] = {0x0F, 0xFF};
+    ASSERT_EQ(bitp_stream_append(&stream, too_long, 2), BITP_OK);
+    ASSERT_EQ(decode(&stream, &m), BITP_EINVALID_ARG);
+    ASSERT_EQ(stream.state, 0);
+}
+
+#if BITP_STREAM_CORO
+
+static bitp_stream_task decode_coro(bitp_stream_t *s, message *m) {
+    co_await bitp_stream_need(s, 16);
+    uint8_t type;
+    uint16_t len;
+    bitp_parser_extract_u8(&s->parser, &type, 4);
+    bitp_parser_extract_u16(&s->parser, &len, 12);
+    if (len > sizeof(m->payload)) {
+        co_return BITP_EINVALID_ARG;
+    }
+    for (uint16_t i = 0; i < len; ++i) {
+        co_await bitp_stream_need(s, 8);
+        bitp_parser_extract_u8(&s->parser, &m->payload[i], 8);
+    }
+    m->type = type;
+    m->len = len;
+    co_return BITP_OK;
+}
+
+TEST(stream_tests, coroutine) {
+    std::vector<uint8_t> data = frame(5, {9, 8, 7});
+
+    char buf[16 + BITP_STREAM_PADDING];
+    bitp_stream_t stream;
+    bitp_stream_init(&stream, buf, sizeof(buf));
+
+    message m = {};
+    bitp_stream_task task = decode_coro(&stream, &m);
+    ASSERT_EQ(task.status(), BITP_EAGAIN);
+    for (size_t i = 0; i < data.size(); ++i) {
+        ASSERT_EQ(task.status(), BITP_EAGAIN);
+        ASSERT_EQ(bitp_stream_append(&stream, &data[i], 1), BITP_OK);
+        task.resume();
+    }
+    ASSERT_EQ(task.status(), BITP_OK);
+    ASSERT_EQ(m.type, 5);
+    ASSERT_EQ(m.len, 3);
+    ASSERT_EQ(m.payload[2], 7);
+    ASSERT_EQ(task.resume(), BITP_OK);
+
+    // a complete message in the buffer is decoded by the call itself
+    bitp_stream_append(&stream, data.data(), data.size());
+    bitp_stream_task again = decode_coro(&stream, &m);
+    ASSERT_EQ(again.status(), BITP_OK);
+}
+
+#endif
@@ -0,0 +1,124 @@
+/*
+ * template_tests_with_checkers.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#define BITP_CHECK_ALL
+#include "bitp/template.h"
+}
+
+static void write_bits_reference(std::vector<uint8_t> &buf, size_t pos, uint64_t val, unsigned n_bits) {
+    for (unsigned i = 0; i < n_bits; ++i) {
+        size_t bit = pos + i;
+        uint8_t m = (uint8_t)(0x80 >> (bit % 8));
+        if ((val >> (n_bits - 1 - i)) & 1) {
+            buf[bit / 8] |= m;
+        }
+        else {
+            buf[bit / 8] &= (uint8_t)~m;
+        }
+    }
+}
+
+TEST(template_tests, write_bits) {
+    std::mt19937_64 rng(30);
+    for (int round = 0; round < 5000; ++round) {
+        size_t n_bytes = 1 + rng() % 20;
+        std::vector<uint8_t> buf(n_bytes);
+        for (auto &b : buf) {
+            b = (uint8_t)rng();
+        }
+        std::vector<uint8_t> expected(buf);
+
+        size_t capacity = n_bytes * CHAR_BIT - rng() % CHAR_BIT;
+        unsigned n_bits = 1 + rng() % (capacity < 64 ? capacity : 64);
+        size_t pos = rng() % (capacity - n_bits + 1);
+        uint64_t val = rng() >> (64 - n_bits);
+
+        write_bits_reference(expected, pos, val, n_bits);
+        bitp_write_bits_64((char *)buf.data(), capacity, pos, val << (64 - n_bits), n_bits);
+        ASSERT_EQ(buf, expected) << "pos " << pos << " n_bits " << n_bits;
+    }
+}
+
+// keep-alive: fixed header, 12-bit sequence number, 5 spare bits, 41-bit timestamp, 3-bit flags
+static void pack_keep_alive(bitp_packer_t *packer, uint64_t seq, uint64_t ts) {
+    bitp_packer_add_u8(packer, 0x5, 3);
+    bitp_packer_add_u16(packer, 0x2A7, 11);
+    bitp_packer_add_u16(packer, (uint16_t)seq, 12);
+    bitp_packer_add_u8(packer, 0, 5);
+    bitp_packer_add_u64(packer, ts, 41);
+    bitp_packer_add_u8(packer, 0x6, 3);
+}
+
+TEST(template_tests, instance) {
+    uint8_t tmpl_buf[16];
+    bitp_template_t tmpl;
+    bitp_template_init(&tmpl, (char *)tmpl_buf, sizeof(tmpl_buf) * CHAR_BIT);
+
+    unsigned seq, ts;
+    ASSERT_EQ(bitp_packer_add_u8(&tmpl.packer, 0x5, 3), BITP_OK);
+    ASSERT_EQ(bitp_packer_add_u16(&tmpl.packer, 0x2A7, 11), BITP_OK);
+    ASSERT_EQ(bitp_template_add_var(&tmpl, 0xFFF, 12, &seq), BITP_OK);
+    ASSERT_EQ(bitp_packer_add_u8(&tmpl.packer, 0, 5), BITP_OK);
+    ASSERT_EQ(bitp_template_add_var(&tmpl, 0, 41, &ts), BITP_OK);
+    ASSERT_EQ(bitp_packer_add_u8(&tmpl.packer, 0x6, 3), BITP_OK);
+    ASSERT_EQ(seq, 0u);
+    ASSERT_EQ(ts, 1u);
+    ASSERT_EQ(bitp_template_size(&tmpl), 10u);
+
+    std::mt19937_64 rng(30);
+    for (int i = 0; i < 100; ++i) {
+        uint64_t vals[] = {rng() & 0xFFF, rng() >> 23};
+
+        uint8_t expected[10];
+        bitp_packer_t packer;
+        bitp_packer_init(&packer, (char *)expected, 75, 1);
+        pack_keep_alive(&packer, vals[0], vals[1]);
+
+        uint8_t msg[10];
+        memset(msg, 0xCC, sizeof(msg));
+        ASSERT_EQ(bitp_template_instance(&tmpl, (char *)msg, vals), BITP_OK);
+        ASSERT_EQ(memcmp(msg, expected, sizeof(msg)), 0);
+
+        // the next sequence number, written over the previous one
+        uint64_t next = (vals[0] + 1) & 0xFFF;
+        ASSERT_EQ(bitp_template_set(&tmpl, (char *)msg, seq, next), BITP_OK);
+        bitp_packer_init(&packer, (char *)expected, 75, 1);
+        pack_keep_alive(&packer, next, vals[1]);
+        ASSERT_EQ(memcmp(msg, expected, sizeof(msg)), 0);
+    }
+
+    uint8_t msg[10];
+    ASSERT_EQ(bitp_template_set(&tmpl, (char *)msg, 2, 0), BITP_EINVALID_ARG);
+    ASSERT_EQ(bitp_template_set(&tmpl, (char *)msg, seq, 0x1000), BITP_EINVALID_ARG);
+    const uint64_t bad[] = {1, 1ULL << 41};
+    ASSERT_EQ(bitp_template_instance(&tmpl, (char *)msg, bad), BITP_EINVALID_ARG);
+}
+
+TEST(template_tests, add_var_errors) {
+    uint8_t buf[64];
+    bitp_template_t tmpl;
+    bitp_template_init(&tmpl, (char *)buf, 70);
+
+    ASSERT_EQ(bitp_template_add_var(&tmpl, 0, 0, NULL), BITP_EINVALID_ARG);
+    ASSERT_EQ(bitp_template_add_var(&tmpl, 0, 65, NULL), BITP_EINVALID_ARG);
+    ASSERT_EQ(bitp_template_add_var(&tmpl, 4, 2, NULL), BITP_EINVALID_ARG);
+    ASSERT_EQ(bitp_template_add_var(&tmpl, 0, 64, NULL), BITP_OK);
+    ASSERT_EQ(bitp_template_add_var(&tmpl, 0, 7, NULL), BITP_EFULL);
+    ASSERT_EQ(tmpl.n_fields, 1u);
+
+    bitp_template_init(&tmpl, (char *)buf, sizeof(buf) * CHAR_BIT);
+    for (unsigned i = 0; i < BITP_TEMPLATE_MAX_FIELDS; ++i) {
+        ASSERT_EQ(bitp_template_add_var(&tmpl, 1, 1, NULL), BITP_OK);
+    }
+    ASSERT_EQ(bitp_template_add_var(&tmpl, 1, 1, NULL), BITP_EINVALID_ARG);
+}
@@ -0,0 +1,9 @@
+# runs bitp_tracereport on DUMP and compares its output with EXPECTED
+execute_process(COMMAND ${TOOL} ${DUMP} RESULT_VARIABLE result OUTPUT_VARIABLE output)
+if(result)
+  message(FATAL_ERROR "${TOOL} ${DUMP} failed: ${result}")
+endif()
+file(READ ${EXPECTED} expected)
+if(NOT output STREQUAL expected)
+  message(FATAL_ERROR "unexpected report of ${DUMP}:\n${output}")
+endif()
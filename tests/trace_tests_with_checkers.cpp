@@ -0,0 +1,208 @@
+/*
+ * trace_tests_with_checkers.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#define BITP_CHECK_ALL
+#define BITP_TRACE
+#include "bitp/parser.h"
+#include "bitp/trace.h"
+}
+
+struct dumped_event {
+    unsigned long long ticks;
+    std::string name;
+    unsigned long long bit_off;
+    char kind;
+};
+
+// the dump read back, the events of every thread, and the name table
+static std::vector<std::vector<dumped_event>> dump(std::vector<std::string> *name_table = NULL) {
+    FILE *f = tmpfile();
+    EXPECT_EQ(BITP_OK, bitp_trace_dump(f));
+    std::string text(ftell(f), '\0');
+    rewind(f);
+    EXPECT_EQ(text.size(), fread(&text[0], 1, text.size(), f));
+    fclose(f);
+
+    std::istringstream in(text);
+    std::string word;
+    int version = 0;
+    double ticks_per_second = 0;
+    size_t n_names = 0;
+    in >> word >> version;
+    EXPECT_EQ("bitp_trace", word);
+    in >> word >> ticks_per_second;
+    EXPECT_EQ("ticks_per_second", word);
+    EXPECT_GT(ticks_per_second, 1e6);
+    in >> word >> n_names;
+    EXPECT_EQ("names", word);
+    std::vector<std::string> names(n_names);
+    for (size_t i = 0; i < n_names; ++i) {
+        size_t id = 0;
+        in >> id;
+        in.get();
+        std::getline(in, names.at(id));
+    }
+    if (name_table) {
+        *name_table = names;
+    }
+    std::vector<std::vector<dumped_event>> res;
+    while (in >> word) {
+        EXPECT_EQ("thread", word);
+        size_t index = 0, n = 0, id = 0;
+        in >> index >> n;
+        EXPECT_EQ(res.size(), index);
+        res.emplace_back(n);
+        for (auto &e : res.back()) {
+            in >> e.ticks >> id >> e.bit_off >> e.kind;
+            e.name = names.at(id);
+        }
+    }
+    return res;
+}
+
+TEST(trace_tests, nested_regions) {
+    char buf[16] = {};
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, buf, 128);
+    uint8_t v = 0;
+    bitp_status_t s = BITP_OK;
+
+    bitp_trace_clear();
+    BITP_TRACE_BEGIN(&parser, "MIB");
+    BITP_TRACE_FIELD(&parser, "sfn", s = bitp_parser_extract_u8(&parser, &v, 4));
+    BITP_TRACE_BEGIN(&parser, "sched");
+    BITP_TRACE_FIELD(&parser, "sib1", s = bitp_parser_extract_u8(&parser, &v, 4));
+    BITP_TRACE_END(&parser, "sched");
+    BITP_TRACE_END(&parser, "MIB");
+    EXPECT_EQ(BITP_OK, s);
+
+    std::vector<std::vector<dumped_event>> threads = dump();
+    std::vector<dumped_event> events;
+    for (const auto &t : threads) {
+        events.insert(events.end(), t.begin(), t.end());
+    }
+    const dumped_event expected[] = {{0, "MIB", 0, 'b'},  {0, "sfn", 0, 'b'},   {0, "sfn", 4, 'e'},
+                                     {0, "sched", 4, 'b'}, {0, "sib1", 4, 'b'},  {0, "sib1", 8, 'e'},
+                                     {0, "sched", 8, 'e'}, {0, "MIB", 8, 'e'}};
+    ASSERT_EQ(8u, events.size());
+    for (size_t i = 0; i < events.size(); ++i) {
+        EXPECT_EQ(expected[i].name, events[i].name) << i;
+        EXPECT_EQ(expected[i].bit_off, events[i].bit_off) << i;
+        EXPECT_EQ(expected[i].kind, events[i].kind) << i;
+        if (i) {
+            EXPECT_LE(events[i - 1].ticks, events[i].ticks);
+        }
+    }
+
+    bitp_trace_clear();
+    for (const auto &t : dump()) {
+        EXPECT_TRUE(t.empty());
+    }
+}
+
+TEST(trace_tests, names_by_content) {
+    // the same name at two addresses, as with literals that aren't merged
+    char begin_name[] = "SIB2";
+    char end_name[] = "SIB2";
+    char field_name[] = "barring";
+    char buf[16] = {};
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, buf, 128);
+    uint8_t v = 0;
+
+    bitp_trace_clear();
+    BITP_TRACE_BEGIN(&parser, begin_name);
+    BITP_TRACE_FIELD(&parser, field_name, bitp_parser_extract_u8(&parser, &v, 3));
+    BITP_TRACE_END(&parser, end_name);
+
+    std::vector<std::string> names;
+    std::vector<std::vector<dumped_event>> threads = dump(&names);
+    ASSERT_EQ(2u, names.size());
+    EXPECT_EQ("SIB2", names[0]);
+    EXPECT_EQ("barring", names[1]);
+    size_t n_events = 0;
+    for (const auto &t : threads) {
+        n_events += t.size();
+    }
+    EXPECT_EQ(4u, n_events);
+    bitp_trace_clear();
+}
+
+TEST(trace_tests, ring_per_thread) {
+    bitp_trace_clear();
+    bitp_trace_init(60);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([] {
+            for (size_t i = 0; i < 1000; ++i) {
+                bitp_trace_record("ring_per_thread", i, 0);
+                bitp_trace_record("ring_per_thread", i, 1);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    bitp_trace_init(1 << 16);
+
+    // the last 63 events of every thread, the slot of the 64th may be being written
+    size_t n_threads = 0;
+    for (const auto &t : dump()) {
+        if (t.empty() || t[0].name != "ring_per_thread") {
+            continue;
+        }
+        n_threads++;
+        ASSERT_EQ(63u, t.size());
+        for (size_t i = 0; i < t.size(); ++i) {
+            EXPECT_EQ(968 + (i + 1) / 2, t[i].bit_off);
+            EXPECT_EQ(i % 2 ? 'b' : 'e', t[i].kind);
+        }
+    }
+    EXPECT_EQ(4u, n_threads);
+}
+
+TEST(trace_tests, dump_while_recording) {
+    bitp_trace_clear();
+    bitp_trace_init(256);
+    std::atomic<bool> stop(false), started(false);
+    std::thread writer([&] {
+        for (size_t i = 0; !stop.load(std::memory_order_relaxed); ++i) {
+            bitp_trace_record("dump_while_recording", i, 0);
+            started.store(true, std::memory_order_relaxed);
+        }
+    });
+    while (!started.load()) {
+        std::this_thread::yield();
+    }
+    bitp_trace_init(1 << 16);
+
+    // whatever the dump catches of the writer is a run of consecutive events
+    for (int round = 0; round < 50; ++round) {
+        for (const auto &t : dump()) {
+            if (t.empty() || t[0].name != "dump_while_recording") {
+                continue;
+            }
+            EXPECT_LT(t.size(), 256u);
+            for (size_t i = 1; i < t.size(); ++i) {
+                ASSERT_EQ(t[i - 1].bit_off + 1, t[i].bit_off) << round;
+                ASSERT_EQ("dump_while_recording", t[i].name);
+            }
+        }
+        std::this_thread::yield();
+    }
+    stop = true;
+    writer.join();
+}
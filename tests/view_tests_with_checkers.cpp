@@ -0,0 +1,156 @@
+/*
+ * view_tests_with_checkers.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ */
+
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#define BITP_CHECK_ALL
+#include "bitp/packer.h"
+#include "bitp/view.h"
+}
+
+TEST(view, slice_and_cursor) {
+    std::mt19937_64 rng(9);
+    std::vector<char> buf(256 + 16);
+    for (size_t i = 0; i < 256; ++i) {
+        buf[i] = (char)rng();
+    }
+    bitp_view_t root;
+    bitp_view_init(&root, buf.data(), 256 * CHAR_BIT);
+    EXPECT_EQ(2048u, bitp_view_len(&root));
+
+    for (int round = 0; round < 1000; ++round) {
+        size_t offset = rng() % 1024;
+        size_t len = 64 + rng() % 512;
+        bitp_view_t v, sub;
+        ASSERT_EQ(BITP_OK, bitp_view_slice(&root, offset, len, &v));
+        size_t sub_offset = rng() % 32;
+        ASSERT_EQ(BITP_OK, bitp_view_slice(&v, sub_offset, len - sub_offset, &sub));
+        EXPECT_EQ(offset + sub_offset, sub.begin);
+        EXPECT_EQ(offset + len, sub.end);
+
+        // the cursor reads what a parser of the whole buffer reads at that offset
+        bitp_parser_t cursor, whole;
+        bitp_view_cursor(&sub, &cursor);
+        bitp_parser_init(&whole, buf.data(), 256 * CHAR_BIT);
+        whole.iter = sub.begin;
+        unsigned n_bits = 1 + rng() % 32;
+        uint64_t a = 0, b = 0;
+        ASSERT_EQ(BITP_OK, bitp_parser_extract_u64(&cursor, &a, n_bits));
+        ASSERT_EQ(BITP_OK, bitp_parser_extract_u64(&whole, &b, n_bits));
+        EXPECT_EQ(b, a);
+
+        // and stops at the end of the view
+        ASSERT_EQ(BITP_OK, bitp_parser_skip(&cursor, bitp_view_len(&sub) - n_bits));
+        EXPECT_EQ(BITP_EFULL, bitp_parser_extract_u8(&cursor, (uint8_t *)&a, 1));
+    }
+
+    bitp_view_t v;
+    EXPECT_EQ(BITP_OK, bitp_view_slice(&root, 2048, 0, &v));
+    EXPECT_EQ(BITP_EFULL, bitp_view_slice(&root, 2048, 1, &v));
+    EXPECT_EQ(BITP_EFULL, bitp_view_slice(&root, 2049, 0, &v));
+    EXPECT_EQ(BITP_EFULL, bitp_view_slice(&root, 1, (size_t)-1, &v));
+}
+
+TEST(view, take_view) {
+    // length-prefixed messages: 8-bit length, then the body
+    std::vector<char> buf(64, 0);
+    bitp_packer_t packer;
+    bitp_packer_init(&packer, buf.data(), 48 * CHAR_BIT, 1);
+    const unsigned lens[] = {5, 0, 17, 64};
+    for (unsigned len : lens) {
+        ASSERT_EQ(BITP_OK, bitp_packer_add_u8(&packer, (uint8_t)len, 8));
+        packer.iter += len;
+    }
+
+    bitp_parser_t parser;
+    bitp_parser_init(&parser, buf.data(), packer.iter);
+    size_t start = 0;
+    for (unsigned len : lens) {
+        uint8_t n = 0;
+        bitp_view_t body;
+        ASSERT_EQ(BITP_OK, bitp_parser_extract_u8(&parser, &n, 8));
+        ASSERT_EQ(BITP_OK, bitp_parser_take_view(&parser, n, &body));
+        EXPECT_EQ(len, bitp_view_len(&body));
+        EXPECT_EQ(start + 8, body.begin);
+        start = body.end;
+    }
+    bitp_view_t rest;
+    EXPECT_EQ(BITP_OK, bitp_parser_take_view(&parser, 0, &rest));
+    EXPECT_EQ(BITP_EFULL, bitp_parser_take_view(&parser, 1, &rest));
+}
+
+TEST(view, split) {
+    std::vector<char> buf(16);
+    bitp_view_t root, part;
+    bitp_view_init(&root, buf.data(), 103);
+    bitp_view_t offset_root;
+    ASSERT_EQ(BITP_OK, bitp_view_slice(&root, 3, 100, &offset_root));
+
+    // 10 records of 10 bits on 1..12 parts
+    for (size_t n = 1; n <= 12; ++n) {
+        size_t next = 3;
+        for (size_t i = 0; i < n; ++i) {
+            ASSERT_EQ(BITP_OK, bitp_view_split(&offset_root, 10, n, i, &part));
+            EXPECT_EQ(next, part.begin);
+            EXPECT_EQ(0u, bitp_view_len(&part) % 10);
+            size_t count = bitp_view_len(&part) / 10;
+            EXPECT_TRUE(count == 10 / n || count == 10 / n + 1);
+            next = part.end;
+        }
+        EXPECT_EQ(103u, next);
+    }
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_view_split(&root, 10, 4, 4, &part));
+    EXPECT_EQ(BITP_EINVALID_ARG, bitp_view_split(&root, 0, 4, 0, &part));
+}
+
+TEST(view, concurrent_readers) {
+    // records of a 13-bit counter and a 7-bit checksum, decoded on 4 threads from one view
+    const size_t n_records = 10000;
+    std::vector<char> buf(n_records * 20 / CHAR_BIT + 16, 0);
+    bitp_packer_t packer;
+    bitp_packer_init(&packer, buf.data(), n_records * 20, 1);
+    for (size_t r = 0; r < n_records; ++r) {
+        ASSERT_EQ(BITP_OK, bitp_packer_add_u16(&packer, (uint16_t)(r & 0x1FFF), 13));
+        ASSERT_EQ(BITP_OK, bitp_packer_add_u8(&packer, (uint8_t)(r % 127), 7));
+    }
+
+    bitp_view_t root;
+    bitp_view_init(&root, buf.data(), n_records * 20);
+    const size_t n_threads = 4;
+    std::vector<size_t> bad(n_threads, 0), seen(n_threads, 0);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < n_threads; ++t) {
+        threads.emplace_back([&, t] {
+            bitp_view_t part = {};
+            bitp_parser_t cursor;
+            EXPECT_EQ(BITP_OK, bitp_view_split(&root, 20, n_threads, t, &part));
+            bitp_view_cursor(&part, &cursor);
+            for (size_t r = part.begin / 20; r < part.end / 20; ++r) {
+                uint16_t counter = 0;
+                uint8_t check = 0;
+                bitp_parser_extract_u16(&cursor, &counter, 13);
+                bitp_parser_extract_u8(&cursor, &check, 7);
+                bad[t] += counter != (r & 0x1FFF) || check != r % 127;
+                seen[t]++;
+            }
+        });
+    }
+    for (auto &th : threads) {
+        th.join();
+    }
+    size_t total = 0;
+    for (size_t t = 0; t < n_threads; ++t) {
+        EXPECT_EQ(0u, bad[t]);
+        total += seen[t];
+    }
+    EXPECT_EQ(n_records, total);
+}
@@ -0,0 +1,1498 @@
+/*
+ * asn1gen.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ *
+ * Generates UPER decoders/encoders on top of bitp_parser_t/bitp_packer_t from ASN.1 type
+ * definitions. Supported: BOOLEAN, NULL, constrained INTEGER, ENUMERATED, BIT STRING and
+ * OCTET STRING with SIZE constraints, SEQUENCE with OPTIONAL/DEFAULT components, CHOICE,
+ * SEQUENCE (SIZE ...) OF, type references and integer value assignments. Extension markers
+ * are encoded as "no extensions", a set extension bit is rejected by the decoder.
+ *
+ * usage: bitp_asn1gen [-p prefix] -o out.h in.asn...
+ */
+
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <regex>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+/*
+ **************************************************************************************************
+  Lexer
+ **************************************************************************************************
+ */
+
+struct token {
+    std::string text;
+    int line;
+};
+
+std::vector<token> tokenize(const std::string &src) {
+    std::vector<token> res;
+    int line = 1;
+    size_t i = 0;
+
+    while (i < src.size()) {
+        char c = src[i];
+        if (c == '\n') {
+            line++;
+            i++;
+        }
+        else if (isspace((unsigned char)c)) {
+            i++;
+        }
+        else if (src.compare(i, 2, "--") == 0) {
+            // a comment ends with the line or with another "--"
+            i += 2;
+            while (i < src.size() && src[i] != '\n' && src.compare(i, 2, "--") != 0) {
+                i++;
+            }
+            if (i < src.size() && src[i] != '\n') {
+                i += 2;
+            }
+        }
+        else if (src.compare(i, 2, "/*") == 0) {
+            size_t end = src.find("*/", i + 2);
+            end = end == std::string::npos ? src.size() : end + 2;
+            for (; i < end; ++i) {
+                line += src[i] == '\n';
+            }
+        }
+        else if (isalpha((unsigned char)c)) {
+            size_t start = i;
+            while (i < src.size() && (isalnum((unsigned char)src[i]) || src[i] == '_' ||
+                                      (src[i] == '-' && i + 1 < src.size() && isalnum((unsigned char)src[i + 1])))) {
+                i++;
+            }
+            res.push_back({src.substr(start, i - start), line});
+        }
+        else if (isdigit((unsigned char)c) || (c == '-' && i + 1 < src.size() && isdigit((unsigned char)src[i + 1]))) {
+            size_t start = i++;
+            while (i < src.size() && isdigit((unsigned char)src[i])) {
+                i++;
+            }
+            res.push_back({src.substr(start, i - start), line});
+        }
+        else {
+            static const char *const puncts[] = {"::=", "...", "..", "[[", "]]"};
+            std::string text(1, c);
+            for (const char *p : puncts) {
+                if (src.compare(i, strlen(p), p) == 0) {
+                    text = p;
+                    break;
+                }
+            }
+            i += text.size();
+            res.push_back({text, line});
+        }
+    }
+
+    res.push_back({"", line});
+    return res;
+}
+
+/*
+ **************************************************************************************************
+  Syntax tree
+ **************************************************************************************************
+ */
+
+struct type;
+typedef std::shared_ptr<type> type_ptr;
+
+struct component {
+    std::string name;
+    type_ptr type;
+    bool optional;
+    std::string default_value;
+};
+
+struct type {
+    enum kind_t { BOOLEAN, NULL_, INTEGER, ENUMERATED, BIT_STRING, OCTET_STRING, SEQUENCE, CHOICE, SEQUENCE_OF, REFERENCE };
+
+    kind_t kind;
+    // value range of INTEGER, SIZE of strings and SEQUENCE OF
+    int64_t lb = 0;
+    int64_t ub = -1;
+    bool constrained = false;
+    bool extensible = false;
+    std::vector<std::string> items;
+    std::vector<component> components;
+    type_ptr element;
+    std::string reference;
+    // C type name without the "_t" suffix, set for typedef'd and nested constructed types
+    std::string c_name;
+    int line = 0;
+};
+
+struct module {
+    std::vector<std::pair<std::string, type_ptr>> types;
+    std::map<std::string, type_ptr> type_map;
+    std::map<std::string, int64_t> values;
+};
+
+class syntax_error : public std::runtime_error {
+  public:
+    syntax_error(const token &tok, const std::string &msg)
+        : std::runtime_error("line " + std::to_string(tok.line) + ": " + msg +
+                             (tok.text.empty() ? " at end of input" : " near '" + tok.text + "'")) {}
+};
+
+class parser {
+  public:
+    parser(const std::vector<token> &tokens, module &mod) : tokens_(tokens), mod_(mod) {}
+
+    void parse() {
+        // optional module header up to BEGIN, IMPORTS up to ';'
+        for (size_t i = 0; i + 1 < tokens_.size(); ++i) {
+            if (tokens_[i].text == "DEFINITIONS") {
+                while (!peek("BEGIN")) {
+                    next();
+                }
+                next();
+                break;
+            }
+        }
+        while (!peek("")) {
+            if (accept("END")) {
+                continue;
+            }
+            if (accept("IMPORTS") || accept("EXPORTS")) {
+                while (!accept(";")) {
+                    next();
+                }
+                continue;
+            }
+            parse_assignment();
+        }
+    }
+
+  private:
+    const token &peek_tok(size_t ahead = 0) const {
+        size_t i = pos_ + ahead < tokens_.size() ? pos_ + ahead : tokens_.size() - 1;
+        return tokens_[i];
+    }
+
+    bool peek(const std::string &text, size_t ahead = 0) const {
+        return peek_tok(ahead).text == text;
+    }
+
+    const token &next() {
+        const token &tok = peek_tok();
+        if (tok.text.empty()) {
+            throw syntax_error(tok, "unexpected end");
+        }
+        pos_++;
+        return tok;
+    }
+
+    bool accept(const std::string &text) {
+        if (peek(text)) {
+            pos_++;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(const std::string &text) {
+        if (!accept(text)) {
+            throw syntax_error(peek_tok(), "expected '" + text + "'");
+        }
+    }
+
+    std::string identifier() {
+        const token &tok = next();
+        if (!isalpha((unsigned char)tok.text[0])) {
+            throw syntax_error(tok, "expected identifier");
+        }
+        return tok.text;
+    }
+
+    int64_t value() {
+        const token &tok = next();
+        if (isdigit((unsigned char)tok.text[0]) || tok.text[0] == '-') {
+            return std::stoll(tok.text);
+        }
+        auto it = mod_.values.find(tok.text);
+        if (it == mod_.values.end()) {
+            throw syntax_error(tok, "unknown value");
+        }
+        return it->second;
+    }
+
+    void parse_assignment() {
+        const token &name = peek_tok();
+        std::string id = identifier();
+        if (islower((unsigned char)id[0])) {
+            // integer value assignment: name INTEGER ::= value
+            expect("INTEGER");
+            expect("::=");
+            mod_.values[id] = value();
+            return;
+        }
+        expect("::=");
+        type_ptr t = parse_type();
+        if (mod_.type_map.count(id)) {
+            throw syntax_error(name, "type redefined");
+        }
+        mod_.types.push_back(std::make_pair(id, t));
+        mod_.type_map[id] = t;
+    }
+
+    // ( lb..ub [, ...] ), ( n ) or ( SIZE (...) ), returns false if there is no constraint
+    bool parse_range(type &t, bool size) {
+        if (!accept("(")) {
+            return false;
+        }
+        if (size) {
+            parse_size(t);
+        }
+        else {
+            parse_bounds(t);
+        }
+        if (accept(",")) {
+            expect("...");
+            t.extensible = true;
+        }
+        expect(")");
+        return true;
+    }
+
+    // SIZE (lb..ub [, ...])
+    void parse_size(type &t) {
+        expect("SIZE");
+        expect("(");
+        parse_bounds(t);
+        if (t.ub >= 65536) {
+            // X.691 encodes such lengths with the general length determinant
+            throw syntax_error(peek_tok(), "SIZE upper bound of 64K or more isn't supported");
+        }
+        if (accept(",")) {
+            expect("...");
+            t.extensible = true;
+        }
+        expect(")");
+    }
+
+    void parse_bounds(type &t) {
+        t.constrained = true;
+        t.lb = value();
+        t.ub = accept("..") ? value() : t.lb;
+        if (t.ub < t.lb) {
+            throw syntax_error(peek_tok(), "empty range");
+        }
+    }
+
+    void parse_components(type &t, bool choice) {
+        expect("{");
+        int extension = 0;
+        while (!accept("}")) {
+            if (accept("...")) {
+                t.extensible = true;
+                extension ^= 1;
+            }
+            else if (accept("[[")) {
+                // extension addition groups aren't decoded
+                while (!accept("]]")) {
+                    next();
+                }
+            }
+            else {
+                component c;
+                c.name = identifier();
+                c.type = parse_type();
+                c.optional = false;
+                if (!choice && accept("OPTIONAL")) {
+                    c.optional = true;
+                }
+                else if (!choice && accept("DEFAULT")) {
+                    c.optional = true;
+                    c.default_value = next().text;
+                }
+                if (!extension) {
+                    t.components.push_back(c);
+                }
+            }
+            if (!accept(",")) {
+                expect("}");
+                break;
+            }
+        }
+    }
+
+    type_ptr parse_type() {
+        type_ptr t = std::make_shared<type>();
+        t->line = peek_tok().line;
+
+        // tags don't affect PER
+        while (accept("[")) {
+            while (!accept("]")) {
+                next();
+            }
+        }
+
+        if (accept("BOOLEAN")) {
+            t->kind = type::BOOLEAN;
+        }
+        else if (accept("NULL")) {
+            t->kind = type::NULL_;
+        }
+        else if (accept("INTEGER")) {
+            t->kind = type::INTEGER;
+            if (!parse_range(*t, false)) {
+                throw syntax_error(peek_tok(), "unconstrained INTEGER isn't supported");
+            }
+        }
+        else if (accept("ENUMERATED")) {
+            t->kind = type::ENUMERATED;
+            expect("{");
+            bool extension = false;
+            while (true) {
+                if (accept("...")) {
+                    t->extensible = true;
+                    extension = true;
+                }
+                else {
+                    std::string item = identifier();
+                    if (accept("(")) {
+                        value();
+                        expect(")");
+                    }
+                    if (!extension) {
+                        t->items.push_back(item);
+                    }
+                }
+                if (!accept(",")) {
+                    expect("}");
+                    break;
+                }
+            }
+        }
+        else if (accept("BIT") || accept("OCTET")) {
+            t->kind = tokens_[pos_ - 1].text == "BIT" ? type::BIT_STRING : type::OCTET_STRING;
+            expect("STRING");
+            if (t->kind == type::BIT_STRING && peek("{")) {
+                // named bits
+                while (!accept("}")) {
+                    next();
+                }
+            }
+            if (!parse_range(*t, true)) {
+                throw syntax_error(peek_tok(), "string without SIZE constraint isn't supported");
+            }
+        }
+        else if (accept("SEQUENCE") || accept("SET")) {
+            if (peek("{")) {
+                t->kind = type::SEQUENCE;
+                parse_components(*t, false);
+            }
+            else {
+                t->kind = type::SEQUENCE_OF;
+                // SEQUENCE (SIZE (...)) OF or SEQUENCE SIZE (...) OF
+                bool sized = parse_range(*t, true);
+                if (!sized && peek("SIZE")) {
+                    parse_size(*t);
+                    sized = true;
+                }
+                if (!sized) {
+                    throw syntax_error(peek_tok(), "SEQUENCE OF without SIZE constraint isn't supported");
+                }
+                expect("OF");
+                t->element = parse_type();
+            }
+        }
+        else if (accept("CHOICE")) {
+            t->kind = type::CHOICE;
+            parse_components(*t, true);
+        }
+        else {
+            t->kind = type::REFERENCE;
+            t->reference = identifier();
+            if (peek("(")) {
+                // constraints of references are ignored
+                int depth = 0;
+                do {
+                    depth += peek("(") - peek(")");
+                    next();
+                } while (depth);
+            }
+        }
+
+        return t;
+    }
+
+    const std::vector<token> &tokens_;
+    module &mod_;
+    size_t pos_ = 0;
+};
+
+/*
+ **************************************************************************************************
+  Code generation
+ **************************************************************************************************
+ */
+
+class gen_error : public std::runtime_error {
+  public:
+    gen_error(const type &t, const std::string &msg)
+        : std::runtime_error("line " + std::to_string(t.line) + ": " + msg) {}
+};
+
+unsigned bits_for_range(uint64_t range) {
+    unsigned n = 0;
+    while (n < 64 && (range - 1) >> n) {
+        n++;
+    }
+    return n;
+}
+
+std::string c_identifier(const std::string &name) {
+    static const std::set<std::string> keywords = {
+        "auto", "break", "case", "char", "const", "continue", "default", "do", "double", "else", "enum",
+        "extern", "float", "for", "goto", "if", "inline", "int", "long", "register", "return", "short",
+        "signed", "sizeof", "static", "struct", "switch", "typedef", "union", "unsigned", "void",
+        "volatile", "while", "class", "new", "delete", "private", "public", "template", "this", "bool"};
+    std::string res = name;
+    for (char &c : res) {
+        if (c == '-') {
+            c = '_';
+        }
+    }
+    return keywords.count(res) ? res + "_" : res;
+}
+
+std::string uint_type(uint64_t max) {
+    if (max <= 0xFF) {
+        return "uint8_t";
+    }
+    if (max <= 0xFFFF) {
+        return "uint16_t";
+    }
+    if (max <= 0xFFFFFFFFULL) {
+        return "uint32_t";
+    }
+    return "uint64_t";
+}
+
+std::string int_type(int64_t lb, int64_t ub) {
+    if (lb >= 0) {
+        return uint_type((uint64_t)ub);
+    }
+    if (lb >= INT8_MIN && ub <= INT8_MAX) {
+        return "int8_t";
+    }
+    if (lb >= INT16_MIN && ub <= INT16_MAX) {
+        return "int16_t";
+    }
+    if (lb >= INT32_MIN && ub <= INT32_MAX) {
+        return "int32_t";
+    }
+    return "int64_t";
+}
+
+std::string literal(int64_t v) {
+    if (v == INT64_MIN) {
+        return "INT64_MIN";
+    }
+    return std::to_string(v) + "LL";
+}
+
+std::string hex(uint64_t v) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "0x%llXULL", (unsigned long long)v);
+    return buf;
+}
+
+std::string member(const std::string &lv, const std::string &name) {
+    return lv == "(*v)" ? "v->" + name : lv + "." + name;
+}
+
+// one step of a decode/encode plan
+struct op {
+    enum kind_t { BITS, IF, SWITCH, LOOP, VAR_BITS };
+
+    kind_t kind;
+    unsigned width = 0;
+    // BITS: decode statements with '$' standing for the raw value, always-on decode validation
+    std::string dec;
+    std::string dec_check;
+    // BITS: raw value expression, always-on guard and BITP_CHECK_RANGE check of the encoder
+    std::string enc;
+    std::string enc_guard;
+    std::string enc_check;
+    // IF condition, SWITCH selector, LOOP count or VAR_BITS length; LOOP/VAR_BITS lvalue
+    std::string expr;
+    std::string lvalue;
+    std::string loop_var;
+    std::string dec_else;
+    int64_t count = -1;
+    std::vector<std::vector<op>> subs;
+};
+
+typedef std::vector<op> plan;
+
+int64_t plan_size(const plan &ops);
+
+int64_t op_size(const op &o) {
+    switch (o.kind) {
+    case op::BITS:
+        return o.width;
+    case op::SWITCH: {
+        int64_t size = -1;
+        for (size_t i = 0; i < o.subs.size(); ++i) {
+            int64_t s = plan_size(o.subs[i]);
+            if (s < 0 || (i && s != size)) {
+                return -1;
+            }
+            size = s;
+        }
+        return size < 0 ? 0 : size;
+    }
+    case op::LOOP: {
+        int64_t s = plan_size(o.subs[0]);
+        return o.count < 0 || s < 0 ? -1 : o.count * s;
+    }
+    default:
+        return -1;
+    }
+}
+
+int64_t plan_size(const plan &ops) {
+    int64_t size = 0;
+    for (const op &o : ops) {
+        int64_t s = op_size(o);
+        if (s < 0) {
+            return -1;
+        }
+        size += s;
+    }
+    return size;
+}
+
+op bits_op(unsigned width, const std::string &dec, const std::string &enc) {
+    op o;
+    o.kind = op::BITS;
+    o.width = width;
+    o.dec = dec;
+    o.enc = enc;
+    return o;
+}
+
+op extension_bit_op() {
+    op o = bits_op(1, "", "0");
+    o.dec_check = "$";
+    return o;
+}
+
+class generator {
+  public:
+    generator(const module &mod, const std::string &prefix) : mod_(mod), prefix_(prefix) {}
+
+    std::string run(const std::string &guard, const std::string &sources) {
+        for (const auto &a : mod_.types) {
+            a.second->c_name = prefix_ + "_" + c_identifier(a.first);
+        }
+        for (const auto &a : mod_.types) {
+            declare(*a.second);
+        }
+
+        std::ostringstream out;
+        out << "/*\n * Generated by bitp_asn1gen from " << sources << ", do not edit.\n */\n\n";
+        out << "#ifndef " << guard << "\n#define " << guard << "\n\n";
+        out << "#include \"bitp/packer.h\"\n#include \"bitp/parser.h\"\n\n";
+        out << decls_.str();
+        for (const auto &a : mod_.types) {
+            std::string name = a.second->c_name;
+            out << "bitp_status_t " << name << "_decode(bitp_parser_t *p, " << name << "_t *v);\n\n";
+            out << "bitp_status_t " << name << "_encode(bitp_packer_t *p, const " << name << "_t *v);\n\n";
+        }
+        out << "/*\n"
+               " **************************************************************************************************\n"
+               "  Realization\n"
+               " **************************************************************************************************\n"
+               " */\n";
+        for (const auto &a : mod_.types) {
+            define(*a.second);
+            out << defs_.str();
+            defs_.str("");
+        }
+        out << "\n#endif /* " << guard << " */\n";
+        return out.str();
+    }
+
+  private:
+    const type &resolve(const type &t) const {
+        const type *cur = &t;
+        for (int depth = 0; cur->kind == type::REFERENCE; ++depth) {
+            auto it = mod_.type_map.find(cur->reference);
+            if (it == mod_.type_map.end()) {
+                throw gen_error(*cur, "unknown type " + cur->reference);
+            }
+            if (depth > 64) {
+                throw gen_error(t, "circular reference");
+            }
+            cur = it->second.get();
+        }
+        return *cur;
+    }
+
+    // a primitive held in one C variable
+    bool scalar(const type &t) const {
+        const type &r = resolve(t);
+        switch (r.kind) {
+        case type::BOOLEAN:
+        case type::INTEGER:
+        case type::ENUMERATED:
+            return true;
+        case type::BIT_STRING:
+            return r.lb == r.ub && r.ub <= 64;
+        default:
+            return false;
+        }
+    }
+
+    std::string scalar_type(const type &r) const {
+        switch (r.kind) {
+        case type::BOOLEAN:
+            return "uint8_t";
+        case type::INTEGER:
+            return int_type(r.lb, r.ub);
+        case type::ENUMERATED:
+            return uint_type(r.items.size() - 1);
+        default:
+            return r.ub == 64 ? "uint64_t" : uint_type((1ULL << r.ub) - 1);
+        }
+    }
+
+    // C type of a member, declares nested types on the way
+    std::string c_type(const type &t, const std::string &nested_name) {
+        if (t.kind == type::REFERENCE) {
+            resolve(t);
+            for (const auto &a : mod_.types) {
+                if (a.first == t.reference) {
+                    if (declaring_.count(a.second.get())) {
+                        // a C struct can't contain itself
+                        throw gen_error(t, "recursive type " + t.reference + " isn't supported");
+                    }
+                    declare(*a.second);
+                    return a.second->c_name + "_t";
+                }
+            }
+        }
+        if (t.kind == type::SEQUENCE || t.kind == type::CHOICE || t.kind == type::ENUMERATED) {
+            type &nested = const_cast<type &>(t);
+            if (nested.c_name.empty()) {
+                nested.c_name = nested_name;
+            }
+            declare(nested);
+            // enumerations get constants but no typedef
+            return t.kind == type::ENUMERATED ? scalar_type(t) : nested.c_name + "_t";
+        }
+        if (scalar(t)) {
+            return scalar_type(t);
+        }
+        throw gen_error(t, "type can't be an element of SEQUENCE OF");
+    }
+
+    void members(const type &t, const std::string &name, const std::string &nested_name, std::ostream &out,
+                 const std::string &indent) {
+        std::string id = c_identifier(name);
+        switch (t.kind) {
+        case type::NULL_:
+            return;
+        case type::BIT_STRING:
+        case type::OCTET_STRING: {
+            uint64_t bits = t.kind == type::BIT_STRING ? (uint64_t)t.ub : (uint64_t)t.ub * 8;
+            if (t.kind == type::BIT_STRING && t.ub <= 64) {
+                out << indent << (t.ub == 64 ? "uint64_t" : uint_type((1ULL << t.ub) - 1)) << " " << id << ";\n";
+            }
+            else {
+                out << indent << "uint8_t " << id << "[" << (bits + 7) / 8 << "];\n";
+            }
+            if (t.lb != t.ub) {
+                out << indent << uint_type((uint64_t)t.ub) << " " << id << "_len;\n";
+            }
+            return;
+        }
+        case type::SEQUENCE_OF:
+            out << indent << c_type(*t.element, nested_name + "_item") << " " << id << "[" << t.ub << "];\n";
+            if (t.lb != t.ub) {
+                out << indent << uint_type((uint64_t)t.ub) << " " << id << "_count;\n";
+            }
+            return;
+        default:
+            out << indent << c_type(t, nested_name) << " " << id << ";\n";
+        }
+    }
+
+    void declare(const type &t) {
+        if (declared_.count(&t)) {
+            return;
+        }
+        declared_.insert(&t);
+        if (t.kind == type::REFERENCE) {
+            resolve(t);
+        }
+        declaring_.insert(&t);
+        declare_body(t);
+        declaring_.erase(&t);
+    }
+
+    void declare_body(const type &t) {
+
+        std::ostringstream body;
+        const std::string &name = t.c_name;
+        switch (t.kind) {
+        case type::SEQUENCE: {
+            for (const component &c : t.components) {
+                members(*c.type, c.name, name + "_" + c_identifier(c.name), body, "    ");
+            }
+            for (const component &c : t.components) {
+                if (c.optional) {
+                    body << "    uint8_t " << c_identifier(c.name) << "_present;\n";
+                }
+            }
+            if (body.str().empty()) {
+                body << "    uint8_t unused_;\n";
+            }
+            decls_ << "typedef struct " << name << "_tag {\n" << body.str() << "} " << name << "_t;\n\n";
+            return;
+        }
+        case type::CHOICE: {
+            std::ostringstream alts;
+            for (size_t i = 0; i < t.components.size(); ++i) {
+                const component &c = t.components[i];
+                members(*c.type, c.name, name + "_" + c_identifier(c.name), alts, "        ");
+            }
+            decls_ << "enum {\n";
+            for (size_t i = 0; i < t.components.size(); ++i) {
+                decls_ << "    " << name << "_" << c_identifier(t.components[i].name) << " = " << i << ",\n";
+            }
+            decls_ << "};\n\n";
+            decls_ << "typedef struct " << name << "_tag {\n    uint8_t choice;\n";
+            if (!alts.str().empty()) {
+                decls_ << "    union {\n" << alts.str() << "    } u;\n";
+            }
+            decls_ << "} " << name << "_t;\n\n";
+            return;
+        }
+        case type::ENUMERATED:
+            decls_ << "enum {\n";
+            for (size_t i = 0; i < t.items.size(); ++i) {
+                decls_ << "    " << name << "_" << c_identifier(t.items[i]) << " = " << i << ",\n";
+            }
+            decls_ << "};\n\n";
+            if (!is_assignment(t)) {
+                return;
+            }
+            break;
+        default:
+            break;
+        }
+
+        // assignments of other types
+        if (!is_assignment(t)) {
+            return;
+        }
+        if (t.kind == type::REFERENCE) {
+            std::string target = c_type(t, name);
+            decls_ << "typedef " << target << " " << name << "_t;\n\n";
+        }
+        else if (scalar(t)) {
+            decls_ << "typedef " << scalar_type(t) << " " << name << "_t;\n\n";
+        }
+        else {
+            members(t, "value", name + "_value", body, "    ");
+            if (body.str().empty()) {
+                body << "    uint8_t unused_;\n";
+            }
+            decls_ << "typedef struct " << name << "_tag {\n" << body.str() << "} " << name << "_t;\n\n";
+        }
+    }
+
+    bool is_assignment(const type &t) const {
+        for (const auto &a : mod_.types) {
+            if (a.second.get() == &t) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::string new_var(const char *base) {
+        return base + std::to_string(vars_++);
+    }
+
+    void build(const type &t, const std::string &lv, plan &ops) {
+        if (t.kind == type::REFERENCE) {
+            const type &target = *mod_.type_map.at(t.reference);
+            if (building_.count(&target)) {
+                throw gen_error(t, "recursive type " + t.reference + " isn't supported");
+            }
+            // assigned non-scalar primitives are wrapped into a struct with one "value" member
+            bool wrapped = target.kind != type::REFERENCE && target.kind != type::SEQUENCE &&
+                           target.kind != type::CHOICE && !scalar(target);
+            building_.insert(&target);
+            build(target, wrapped ? member(lv, "value") : lv, ops);
+            building_.erase(&target);
+            return;
+        }
+
+        switch (t.kind) {
+        case type::BOOLEAN:
+            ops.push_back(bits_op(1, lv + " = (uint8_t)$;", lv + " != 0"));
+            break;
+
+        case type::NULL_:
+            break;
+
+        case type::INTEGER: {
+            if (t.extensible) {
+                ops.push_back(extension_bit_op());
+            }
+            uint64_t range = (uint64_t)t.ub - (uint64_t)t.lb;
+            unsigned width = bits_for_range(range + 1);
+            std::string ctype = int_type(t.lb, t.ub);
+            // the offset from lb in uint64_t, wide ranges would overflow int64_t
+            std::string dec = t.lb == 0 ? lv + " = (" + ctype + ")$;"
+                                        : lv + " = (" + ctype + ")($ + (uint64_t)" + literal(t.lb) + ");";
+            std::string enc = t.lb == 0 ? "(uint64_t)" + lv
+                                        : "((uint64_t)" + lv + " - (uint64_t)" + literal(t.lb) + ")";
+            op o = bits_op(width, dec, enc);
+            if (range != (width ? ~0ULL >> (64 - width) : 0)) {
+                o.dec_check = "$ > " + hex(range);
+            }
+            // comparisons the C type makes always false would trip -Wtype-limits
+            unsigned type_bits = ctype[0] == 'u' ? std::stoi(ctype.substr(4)) : std::stoi(ctype.substr(3));
+            int64_t type_min = ctype[0] == 'u' ? 0 : (int64_t)(~0ULL << (type_bits - 1));
+            uint64_t type_max = ctype[0] == 'u' ? ~0ULL >> (64 - type_bits) : ~0ULL >> (65 - type_bits);
+            std::string checks;
+            if (t.lb != type_min) {
+                checks = lv + " < " + literal(t.lb);
+            }
+            if ((uint64_t)t.ub != type_max) {
+                checks += (checks.empty() ? "" : " || ") + lv + " > " + literal(t.ub);
+            }
+            o.enc_check = checks;
+            ops.push_back(o);
+            break;
+        }
+
+        case type::ENUMERATED: {
+            if (t.extensible) {
+                ops.push_back(extension_bit_op());
+            }
+            uint64_t n = t.items.size();
+            unsigned width = bits_for_range(n);
+            std::string ctype = uint_type(n - 1);
+            op o = bits_op(width, lv + " = (" + ctype + ")$;", "(uint64_t)" + lv);
+            if (n != 1ULL << width) {
+                o.dec_check = "$ >= " + std::to_string(n);
+                o.enc_check = lv + " >= " + std::to_string(n);
+            }
+            ops.push_back(o);
+            break;
+        }
+
+        case type::BIT_STRING:
+        case type::OCTET_STRING: {
+            bool bits = t.kind == type::BIT_STRING;
+            if (t.extensible) {
+                ops.push_back(extension_bit_op());
+            }
+            std::string len = lv + "_len";
+            if (t.lb != t.ub) {
+                // the length as a constrained whole number
+                std::string ltype = uint_type((uint64_t)t.ub);
+                uint64_t range = (uint64_t)(t.ub - t.lb);
+                unsigned width = bits_for_range(range + 1);
+                std::string dec = t.lb ? len + " = (" + ltype + ")($ + " + std::to_string(t.lb) + ");"
+                                       : len + " = (" + ltype + ")$;";
+                op o = bits_op(width, dec, t.lb ? "(uint64_t)(" + len + " - " + std::to_string(t.lb) + ")"
+                                                : "(uint64_t)" + len);
+                if (width < 64 && range + 1 != 1ULL << width) {
+                    o.dec_check = "$ > " + std::to_string(range);
+                }
+                o.enc_guard = (t.lb ? len + " < " + std::to_string(t.lb) + " || " : "") + len + " > " +
+                              std::to_string(t.ub);
+                ops.push_back(o);
+            }
+            if (bits && t.ub <= 64) {
+                if (t.lb == t.ub) {
+                    op o = bits_op((unsigned)t.ub, lv + " = (" + scalar_type(t) + ")$;", "(uint64_t)" + lv);
+                    if (t.ub < 64) {
+                        o.enc_check = "(uint64_t)" + lv + " >> " + std::to_string(t.ub);
+                    }
+                    ops.push_back(o);
+                }
+                else {
+                    op o;
+                    o.kind = op::VAR_BITS;
+                    o.expr = len;
+                    o.lvalue = lv;
+                    ops.push_back(o);
+                }
+                break;
+            }
+            if (bits && t.lb != t.ub) {
+                throw gen_error(t, "variable size BIT STRING longer than 64 bits isn't supported");
+            }
+            // whole bytes in a loop, the last bits of a BIT STRING MSB-aligned in the last byte
+            int64_t n_bits = bits ? t.ub : t.ub * 8;
+            op loop;
+            loop.kind = op::LOOP;
+            loop.loop_var = "i" + std::to_string(loops_++);
+            loop.count = t.lb == t.ub ? n_bits / 8 : -1;
+            loop.expr = t.lb == t.ub ? std::to_string(n_bits / 8) : len;
+            std::string byte = lv + "[" + loop.loop_var + "]";
+            loop.subs.resize(1);
+            loop.subs[0].push_back(bits_op(8, byte + " = (uint8_t)$;", "(uint64_t)" + byte));
+            ops.push_back(loop);
+            if (n_bits % 8) {
+                unsigned rem = (unsigned)(n_bits % 8);
+                std::string last = lv + "[" + std::to_string(n_bits / 8) + "]";
+                ops.push_back(bits_op(rem, last + " = (uint8_t)($ << " + std::to_string(8 - rem) + ");",
+                                      "(uint64_t)(" + last + " >> " + std::to_string(8 - rem) + ")"));
+            }
+            break;
+        }
+
+        case type::SEQUENCE: {
+            if (t.extensible) {
+                ops.push_back(extension_bit_op());
+            }
+            for (const component &c : t.components) {
+                if (c.optional) {
+                    std::string present = member(lv, c_identifier(c.name) + "_present");
+                    ops.push_back(bits_op(1, present + " = (uint8_t)$;", present + " != 0"));
+                }
+            }
+            for (const component &c : t.components) {
+                std::string clv = member(lv, c_identifier(c.name));
+                if (!c.optional) {
+                    build(*c.type, clv, ops);
+                    continue;
+                }
+                op o;
+                o.kind = op::IF;
+                o.expr = member(lv, c_identifier(c.name) + "_present");
+                o.subs.resize(1);
+                build(*c.type, clv, o.subs[0]);
+                o.dec_else = default_value(c, clv);
+                ops.push_back(o);
+            }
+            break;
+        }
+
+        case type::CHOICE: {
+            if (t.extensible) {
+                ops.push_back(extension_bit_op());
+            }
+            uint64_t n = t.components.size();
+            unsigned width = bits_for_range(n);
+            std::string sel = member(lv, "choice");
+            op index = bits_op(width, sel + " = (uint8_t)$;", "(uint64_t)" + sel);
+            if (n != 1ULL << width) {
+                index.dec_check = "$ >= " + std::to_string(n);
+            }
+            index.enc_guard = sel + " >= " + std::to_string(n);
+            ops.push_back(index);
+
+            op sw;
+            sw.kind = op::SWITCH;
+            sw.expr = sel;
+            sw.subs.resize(n);
+            for (size_t i = 0; i < n; ++i) {
+                const component &c = t.components[i];
+                build(*c.type, member(lv, "u." + c_identifier(c.name)), sw.subs[i]);
+            }
+            ops.push_back(sw);
+            break;
+        }
+
+        case type::SEQUENCE_OF: {
+            if (t.extensible) {
+                ops.push_back(extension_bit_op());
+            }
+            std::string count = lv + "_count";
+            op loop;
+            loop.kind = op::LOOP;
+            loop.loop_var = "i" + std::to_string(loops_++);
+            if (t.lb != t.ub) {
+                std::string ctype = uint_type((uint64_t)t.ub);
+                uint64_t range = (uint64_t)(t.ub - t.lb);
+                unsigned width = bits_for_range(range + 1);
+                op o = bits_op(width,
+                               t.lb ? count + " = (" + ctype + ")($ + " + std::to_string(t.lb) + ");"
+                                    : count + " = (" + ctype + ")$;",
+                               t.lb ? "(uint64_t)(" + count + " - " + std::to_string(t.lb) + ")"
+                                    : "(uint64_t)" + count);
+                if (width < 64 && range + 1 != 1ULL << width) {
+                    o.dec_check = "$ > " + std::to_string(range);
+                }
+                o.enc_guard = (t.lb ? count + " < " + std::to_string(t.lb) + " || " : "") + count + " > " +
+                              std::to_string(t.ub);
+                ops.push_back(o);
+                loop.expr = count;
+            }
+            else {
+                loop.count = t.ub;
+                loop.expr = std::to_string(t.ub);
+            }
+            loop.subs.resize(1);
+            build(*t.element, lv + "[" + loop.loop_var + "]", loop.subs[0]);
+            ops.push_back(loop);
+            break;
+        }
+
+        default:
+            break;
+        }
+    }
+
+    std::string default_value(const component &c, const std::string &lv) const {
+        if (c.default_value.empty()) {
+            return "";
+        }
+        const type &r = resolve(*c.type);
+        if (r.kind == type::BOOLEAN && (c.default_value == "TRUE" || c.default_value == "FALSE")) {
+            return lv + " = " + (c.default_value == "TRUE" ? "1" : "0") + ";";
+        }
+        if (r.kind == type::INTEGER) {
+            int64_t v;
+            if (isdigit((unsigned char)c.default_value[0]) || c.default_value[0] == '-') {
+                v = std::stoll(c.default_value);
+            }
+            else if (mod_.values.count(c.default_value)) {
+                v = mod_.values.at(c.default_value);
+            }
+            else {
+                return "";
+            }
+            return lv + " = (" + int_type(r.lb, r.ub) + ")" + literal(v) + ";";
+        }
+        if (r.kind == type::ENUMERATED) {
+            for (size_t i = 0; i < r.items.size(); ++i) {
+                if (r.items[i] == c.default_value) {
+                    return lv + " = " + std::to_string(i) + ";";
+                }
+            }
+        }
+        return "";
+    }
+
+    static std::string subst(const std::string &code, const std::string &raw) {
+        std::string res;
+        for (char c : code) {
+            if (c == '$') {
+                res += raw;
+            }
+            else {
+                res += c;
+            }
+        }
+        return res;
+    }
+
+    // BITS ops [begin, end) in one 64-bit window
+    void window(const plan &ops, size_t begin, size_t end, const std::string &handle, bool decode,
+                const std::string &ind) {
+        unsigned total = 0;
+        for (size_t i = begin; i < end; ++i) {
+            total += ops[i].width;
+        }
+
+        if (decode) {
+            std::string w;
+            if (total) {
+                w = new_var("w");
+                defs_ << ind << "uint64_t " << w << ";\n";
+                defs_ << ind << "bitp_parser_reserved_extract_u64(&" << handle << ", &" << w << ", " << total << ");\n";
+            }
+            unsigned shift = total;
+            for (size_t i = begin; i < end; ++i) {
+                const op &o = ops[i];
+                shift -= o.width;
+                std::string raw = "0";
+                if (o.width) {
+                    std::string shifted = shift ? "(" + w + " >> " + std::to_string(shift) + ")" : w;
+                    raw = o.width == total ? w : "(" + shifted + " & " + hex((1ULL << o.width) - 1) + ")";
+                }
+                if (!o.dec_check.empty()) {
+                    defs_ << ind << "if (" << subst(o.dec_check, raw) << ") {\n"
+                          << ind << "    return BITP_EINVALID_ARG;\n"
+                          << ind << "}\n";
+                }
+                if (!o.dec.empty()) {
+                    defs_ << ind << subst(o.dec, raw) << "\n";
+                }
+            }
+            return;
+        }
+
+        // the values were checked by emit_checks before anything was written
+        if (!total) {
+            return;
+        }
+        std::string w = new_var("w");
+        defs_ << ind << "uint64_t " << w << " = ";
+        unsigned shift = total;
+        bool first = true;
+        for (size_t i = begin; i < end; ++i) {
+            const op &o = ops[i];
+            shift -= o.width;
+            if (!o.width || o.enc == "0") {
+                continue;
+            }
+            std::string val = o.width == 64 ? "(" + o.enc + ")" : "((" + o.enc + ") & " + hex((1ULL << o.width) - 1) + ")";
+            if (!first) {
+                defs_ << " |\n" << ind << "    ";
+            }
+            defs_ << (shift ? "(" + val + " << " + std::to_string(shift) + ")" : val);
+            first = false;
+        }
+        defs_ << (first ? "0;\n" : ";\n");
+        defs_ << ind << "bitp_packer_reserved_add_u64(&" << handle << ", " << w << ", " << total << ");\n";
+    }
+
+    // ops of fixed size inside a reserved block
+    void emit_reserved(const plan &ops, const std::string &handle, bool decode, const std::string &ind) {
+        size_t i = 0;
+        while (i < ops.size()) {
+            if (ops[i].kind == op::BITS) {
+                size_t end = i;
+                unsigned total = 0;
+                while (end < ops.size() && ops[end].kind == op::BITS && total + ops[end].width <= 64) {
+                    total += ops[end++].width;
+                }
+                window(ops, i, end, handle, decode, ind);
+                i = end;
+                continue;
+            }
+            emit_control(ops[i], handle, decode, ind);
+            i++;
+        }
+    }
+
+    void emit_control(const op &o, const std::string &handle, bool decode, const std::string &ind) {
+        std::string in = ind + "    ";
+        switch (o.kind) {
+        case op::IF:
+            if (o.subs[0].empty() && (!decode || o.dec_else.empty())) {
+                return;
+            }
+            defs_ << ind << "if (" << o.expr << ") {\n";
+            emit(o.subs[0], handle, decode, in);
+            if (decode && !o.dec_else.empty()) {
+                defs_ << ind << "}\n" << ind << "else {\n" << in << o.dec_else << "\n";
+            }
+            defs_ << ind << "}\n";
+            return;
+        case op::SWITCH: {
+            bool empty = true;
+            for (const plan &sub : o.subs) {
+                empty &= sub.empty();
+            }
+            if (empty) {
+                return;
+            }
+            defs_ << ind << "switch (" << o.expr << ") {\n";
+            for (size_t i = 0; i < o.subs.size(); ++i) {
+                if (o.subs[i].empty()) {
+                    continue;
+                }
+                defs_ << ind << "case " << i << ": {\n";
+                emit(o.subs[i], handle, decode, in);
+                defs_ << in << "break;\n" << ind << "}\n";
+            }
+            defs_ << ind << "default:\n" << in << "break;\n" << ind << "}\n";
+            return;
+        }
+        case op::LOOP:
+            defs_ << ind << "for (size_t " << o.loop_var << " = 0; " << o.loop_var << " < " << o.expr << "; ++"
+                  << o.loop_var << ") {\n";
+            emit(o.subs[0], handle, decode, in);
+            defs_ << ind << "}\n";
+            return;
+        case op::VAR_BITS: {
+            std::string r = new_var("r");
+            defs_ << ind << "if (" << o.expr << ") {\n";
+            if (decode) {
+                std::string w = new_var("w");
+                reserve(r, o.expr, true, in);
+                defs_ << in << "uint64_t " << w << ";\n"
+                      << in << "bitp_parser_reserved_extract_u64(&" << r << ", &" << w << ", " << o.expr << ");\n"
+                      << in << o.lvalue << " = " << w << ";\n"
+                      << ind << "}\n"
+                      << ind << "else {\n"
+                      << in << o.lvalue << " = 0;\n";
+            }
+            else {
+                reserve(r, o.expr, false, in);
+                defs_ << in << "bitp_packer_reserved_add_u64(&" << r << ", " << o.lvalue << ", " << o.expr << ");\n";
+            }
+            defs_ << ind << "}\n";
+            return;
+        }
+        default:
+            return;
+        }
+    }
+
+    // the encoder's guards and BITP_CHECK_RANGE checks of ops, walked ahead of the first write so
+    // a rejected value leaves the packer and its buffer untouched
+    std::string checks(const plan &ops, const std::string &ind) {
+        std::string res, range;
+        auto flush = [&] {
+            if (!range.empty()) {
+                res += "#if BITP_CHECK_RANGE\n" + range + "#endif\n";
+                range.clear();
+            }
+        };
+        auto reject = [&](const std::string &cond) {
+            return ind + "if (" + cond + ") {\n" + ind + "    return BITP_EINVALID_ARG;\n" + ind + "}\n";
+        };
+        std::string in = ind + "    ";
+        for (const op &o : ops) {
+            switch (o.kind) {
+            case op::BITS:
+                if (!o.enc_guard.empty()) {
+                    flush();
+                    res += reject(o.enc_guard);
+                }
+                if (!o.enc_check.empty()) {
+                    range += reject(o.enc_check);
+                }
+                break;
+            case op::VAR_BITS:
+                range += reject(o.expr + " && " + o.expr + " < 64 && (uint64_t)" + o.lvalue + " >> " + o.expr);
+                break;
+            case op::IF: {
+                std::string sub = checks(o.subs[0], in);
+                if (!sub.empty()) {
+                    flush();
+                    res += ind + "if (" + o.expr + ") {\n" + sub + ind + "}\n";
+                }
+                break;
+            }
+            case op::SWITCH: {
+                std::string cases;
+                for (size_t i = 0; i < o.subs.size(); ++i) {
+                    std::string sub = checks(o.subs[i], in);
+                    if (!sub.empty()) {
+                        cases += ind + "case " + std::to_string(i) + ": {\n" + sub + in + "break;\n" + ind + "}\n";
+                    }
+                }
+                if (!cases.empty()) {
+                    flush();
+                    res += ind + "switch (" + o.expr + ") {\n" + cases + ind + "default:\n" + in + "break;\n" + ind + "}\n";
+                }
+                break;
+            }
+            case op::LOOP: {
+                std::string sub = checks(o.subs[0], in);
+                if (!sub.empty()) {
+                    flush();
+                    res += ind + "for (size_t " + o.loop_var + " = 0; " + o.loop_var + " < " + o.expr + "; ++" +
+                           o.loop_var + ") {\n" + sub + ind + "}\n";
+                }
+                break;
+            }
+            }
+        }
+        flush();
+        return res;
+    }
+
+    void reserve(const std::string &handle, const std::string &n_bits, bool decode, const std::string &ind) {
+        const char *kind = decode ? "parser" : "packer";
+        defs_ << ind << "bitp_" << kind << "_reserved_t " << handle << ";\n"
+              << ind << "if (bitp_" << kind << "_reserve(p, " << n_bits << ", &" << handle << ") != BITP_OK) {\n"
+              << ind << "    return BITP_EFULL;\n"
+              << ind << "}\n";
+    }
+
+    // handle is empty outside reserved blocks: every maximal run of fixed-size ops gets one reservation
+    void emit(const plan &ops, const std::string &handle, bool decode, const std::string &ind) {
+        if (!handle.empty()) {
+            emit_reserved(ops, handle, decode, ind);
+            return;
+        }
+
+        size_t i = 0;
+        while (i < ops.size()) {
+            int64_t element = ops[i].kind == op::LOOP ? plan_size(ops[i].subs[0]) : -1;
+            if (op_size(ops[i]) < 0 && element > 0) {
+                // a variable count of fixed-size elements still needs one reservation only
+                std::string r = new_var("r");
+                reserve(r, "(size_t)" + ops[i].expr + " * " + std::to_string(element), decode, ind);
+                emit_control(ops[i], r, decode, ind);
+                i++;
+                continue;
+            }
+            if (op_size(ops[i]) < 0) {
+                emit_control(ops[i], "", decode, ind);
+                i++;
+                continue;
+            }
+            size_t end = i;
+            int64_t total = 0;
+            while (end < ops.size() && op_size(ops[end]) >= 0) {
+                total += op_size(ops[end++]);
+            }
+            plan run(ops.begin() + i, ops.begin() + end);
+            if (total == 0) {
+                emit_reserved(run, "-", decode, ind);
+            }
+            else {
+                std::string r = new_var("r");
+                reserve(r, std::to_string(total), decode, ind);
+                emit_reserved(run, r, decode, ind);
+            }
+            i = end;
+        }
+    }
+
+    void define(const type &t) {
+        std::string name = t.c_name;
+        plan ops;
+        vars_ = 0;
+        loops_ = 0;
+        build(t, (t.kind == type::SEQUENCE || t.kind == type::CHOICE || t.kind == type::REFERENCE || scalar(t))
+                     ? "(*v)"
+                     : "v->value",
+              ops);
+
+        int64_t size = plan_size(ops);
+        defs_ << "\n";
+        if (size >= 0) {
+            defs_ << "/* " << size << " bits */\n";
+        }
+        std::string body = capture([&] { emit(ops, "", true, "    "); });
+        defs_ << "inline bitp_status_t " << name << "_decode(bitp_parser_t *p, " << name << "_t *v) {\n"
+              << unused_params(body) << body << "    return BITP_OK;\n}\n\n";
+
+        vars_ = 0;
+        body = capture([&] {
+            defs_ << checks(ops, "    ");
+            emit(ops, "", false, "    ");
+        });
+        defs_ << "inline bitp_status_t " << name << "_encode(bitp_packer_t *p, const " << name << "_t *v) {\n"
+              << unused_params(body) << body << "    return BITP_OK;\n}\n";
+    }
+
+    // what fn writes to defs_
+    template <typename Fn>
+    std::string capture(Fn fn) {
+        std::string saved = defs_.str();
+        defs_.str("");
+        fn();
+        std::string res = defs_.str();
+        defs_.str("");
+        defs_ << saved;
+        return res;
+    }
+
+    // casts to void for the parameters a body doesn't use (empty SEQUENCE, NULL), members named
+    // p or v follow "->" or "."
+    static std::string unused_params(const std::string &body) {
+        static const std::regex p_used("(^|[^\\w.>])p\\b");
+        static const std::regex v_used("(^|[^\\w.>])v\\b");
+        std::string res;
+        if (!std::regex_search(body, p_used)) {
+            res += "    (void)p;\n";
+        }
+        if (!std::regex_search(body, v_used)) {
+            res += "    (void)v;\n";
+        }
+        return res;
+    }
+
+    const module &mod_;
+    std::string prefix_;
+    std::set<const type *> declared_;
+    // types being declared or built, a reference back to one is a recursion
+    std::set<const type *> declaring_;
+    std::set<const type *> building_;
+    std::ostringstream decls_;
+    std::ostringstream defs_;
+    int vars_ = 0;
+    int loops_ = 0;
+};
+
+}    // namespace
+
+int main(int argc, char **argv) {
+    std::string prefix = "asn1";
+    std::string output;
+    std::vector<std::string> inputs;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if ((arg == "-p" || arg == "-o") && i + 1 < argc) {
+            (arg == "-p" ? prefix : output) = argv[++i];
+        }
+        else if (!arg.empty() && arg[0] != '-') {
+            inputs.push_back(arg);
+        }
+        else {
+            inputs.clear();
+            break;
+        }
+    }
+    if (inputs.empty() || output.empty()) {
+        fprintf(stderr, "usage: %s [-p prefix] -o out.h in.asn...\n", argv[0]);
+        return 2;
+    }
+
+    module mod;
+    std::string sources;
+    try {
+        for (const std::string &path : inputs) {
+            std::ifstream in(path, std::ios::binary);
+            if (!in) {
+                throw std::runtime_error("can't open " + path);
+            }
+            std::stringstream src;
+            src << in.rdbuf();
+            std::vector<token> tokens = tokenize(src.str());
+            parser(tokens, mod).parse();
+
+            size_t slash = path.find_last_of("/\\");
+            sources += (sources.empty() ? "" : ", ") + (slash == std::string::npos ? path : path.substr(slash + 1));
+        }
+
+        std::string guard;
+        size_t slash = output.find_last_of("/\\");
+        for (char c : slash == std::string::npos ? output : output.substr(slash + 1)) {
+            guard += isalnum((unsigned char)c) ? (char)toupper((unsigned char)c) : '_';
+        }
+        guard += "_";
+
+        std::string code = generator(mod, prefix).run(guard, sources);
+        std::ofstream out(output, std::ios::binary);
+        out << code;
+        if (!out) {
+            throw std::runtime_error("can't write " + output);
+        }
+    }
+    catch (const std::exception &e) {
+        fprintf(stderr, "%s: %s\n", inputs.empty() ? argv[0] : inputs[0].c_str(), e.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,268 @@
+/*
+ * tracereport.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: pavel
+ *
+ * Reads the events written by bitp_trace_dump and prints, for every message type (the outermost
+ * regions), a latency summary and histogram, then the cost of the fields in it: the regions
+ * nested in the type, by their path, with the time spent in them, their own time without the
+ * regions nested in them, their share of the type's time and their length in bits.
+ *
+ * usage: bitp_tracereport trace.txt
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct event {
+    uint64_t ticks;
+    size_t name;
+    uint64_t bit_off;
+    bool end;
+};
+
+struct trace {
+    double ticks_per_second = 1e9;
+    std::vector<std::string> names;
+    std::vector<std::vector<event>> threads;
+};
+
+trace read_trace(const std::string &path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("can't open " + path);
+    }
+    trace res;
+    std::string line, word;
+    size_t n = 0;
+    int version = 0;
+    if (!(in >> word >> version) || word != "bitp_trace" || version != 1) {
+        throw std::runtime_error(path + " is not a bitp_trace dump");
+    }
+    if (!(in >> word >> res.ticks_per_second) || word != "ticks_per_second" || !(in >> word >> n) || word != "names") {
+        throw std::runtime_error(path + ": bad header");
+    }
+    res.names.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        size_t id = 0;
+        if (!(in >> id) || id >= n) {
+            throw std::runtime_error(path + ": bad name table");
+        }
+        in.get();
+        std::getline(in, res.names[id]);
+    }
+    while (in >> word) {
+        size_t index = 0, n_events = 0;
+        if (word != "thread" || !(in >> index >> n_events)) {
+            throw std::runtime_error(path + ": bad thread header");
+        }
+        std::vector<event> events(n_events);
+        for (event &e : events) {
+            char kind = 0;
+            unsigned long long ticks = 0, bit_off = 0;
+            if (!(in >> ticks >> e.name >> bit_off >> kind) || e.name >= n || (kind != 'b' && kind != 'e')) {
+                throw std::runtime_error(path + ": bad event");
+            }
+            e.ticks = ticks;
+            e.bit_off = bit_off;
+            e.end = kind == 'e';
+        }
+        res.threads.push_back(std::move(events));
+    }
+    return res;
+}
+
+struct field_stats {
+    size_t count = 0;
+    double total = 0;
+    double self = 0;
+    double bits = 0;
+};
+
+struct type_stats {
+    std::vector<double> latencies;
+    double bits = 0;
+    std::map<std::string, field_stats> fields;
+};
+
+struct open_region {
+    open_region(size_t name, uint64_t ticks, uint64_t bit_off, std::string path)
+        : name(name), ticks(ticks), bit_off(bit_off), path(std::move(path)) {}
+
+    size_t name;
+    uint64_t ticks;
+    uint64_t bit_off;
+    std::string path;
+    // time in the regions nested in it
+    double nested = 0;
+};
+
+class report {
+  public:
+    explicit report(const trace &t) : trace_(t) {}
+
+    void add_thread(const std::vector<event> &events) {
+        // the ring may begin inside regions whose begin was overwritten: start where the depth
+        // is the lowest it gets, the outermost level
+        long depth = 0, lowest = 0;
+        size_t start = 0;
+        for (size_t i = 0; i < events.size(); ++i) {
+            depth += events[i].end ? -1 : 1;
+            if (depth < lowest) {
+                lowest = depth;
+                start = i + 1;
+            }
+        }
+
+        std::vector<open_region> stack;
+        for (size_t i = start; i < events.size(); ++i) {
+            const event &e = events[i];
+            if (!e.end) {
+                std::string path = stack.empty() ? trace_.names[e.name] : stack.back().path + " > " + trace_.names[e.name];
+                stack.emplace_back(e.name, e.ticks, e.bit_off, std::move(path));
+                continue;
+            }
+            // an end without its begin: the regions above it were left without their ends. Names
+            // match by content, a dump may give copies of one name different ids
+            size_t k = stack.size();
+            while (k > 0 && trace_.names[stack[k - 1].name] != trace_.names[e.name]) {
+                k--;
+            }
+            if (k == 0) {
+                unmatched_++;
+                continue;
+            }
+            unmatched_ += stack.size() - k;
+            stack.erase(stack.begin() + (long)k, stack.end());
+
+            open_region r = stack.back();
+            stack.pop_back();
+            double ns = (double)(e.ticks - r.ticks) / trace_.ticks_per_second * 1e9;
+            double bits = (double)(e.bit_off - r.bit_off);
+            if (stack.empty()) {
+                type_stats &ts = types_[trace_.names[r.name]];
+                ts.latencies.push_back(ns);
+                ts.bits += bits;
+                continue;
+            }
+            stack.back().nested += ns;
+            field_stats &fs = types_[trace_.names[stack.front().name]].fields[r.path];
+            fs.count++;
+            fs.total += ns;
+            fs.self += ns - r.nested;
+            fs.bits += bits;
+        }
+    }
+
+    void print() {
+        size_t n_events = 0;
+        for (const auto &t : trace_.threads) {
+            n_events += t.size();
+        }
+        printf("%zu events, %zu threads, %.3f GHz ticks", n_events, trace_.threads.size(), trace_.ticks_per_second / 1e9);
+        if (unmatched_) {
+            printf(", %zu regions without their ends", unmatched_);
+        }
+        printf("\n");
+
+        for (auto &t : types_) {
+            type_stats &ts = t.second;
+            std::vector<double> &l = ts.latencies;
+            std::sort(l.begin(), l.end());
+            double sum = 0;
+            for (double v : l) {
+                sum += v;
+            }
+            if (l.empty()) {
+                // only fields of a message whose end isn't in the dump: taken mid-message or the
+                // decoder returned without BITP_TRACE_END
+                printf("\n%s: no complete messages\n", t.first.c_str());
+            }
+            else {
+                printf("\n%s: %zu messages, %.1f bits\n", t.first.c_str(), l.size(), ts.bits / l.size());
+                printf("  latency ns: mean %.1f  p50 %.1f  p90 %.1f  p99 %.1f  max %.1f\n", sum / l.size(),
+                       percentile(l, 50), percentile(l, 90), percentile(l, 99), l.back());
+                histogram(l);
+            }
+
+            if (ts.fields.empty()) {
+                continue;
+            }
+            std::vector<std::pair<std::string, field_stats>> fields(ts.fields.begin(), ts.fields.end());
+            std::sort(fields.begin(), fields.end(), [](const std::pair<std::string, field_stats> &a,
+                                                       const std::pair<std::string, field_stats> &b) {
+                return a.second.total > b.second.total;
+            });
+            printf("  %-40s %10s %10s %10s %7s %8s\n", "field", "count", "mean ns", "self ns", "share", "bits");
+            for (const auto &f : fields) {
+                const field_stats &fs = f.second;
+                char share[16] = "-";
+                if (sum > 0) {
+                    snprintf(share, sizeof(share), "%.1f%%", 100.0 * fs.total / sum);
+                }
+                printf("  %-40s %10zu %10.1f %10.1f %7s %8.1f\n", f.first.c_str(), fs.count, fs.total / fs.count,
+                       fs.self / fs.count, share, fs.bits / fs.count);
+            }
+        }
+    }
+
+  private:
+    static double percentile(const std::vector<double> &sorted, double p) {
+        size_t i = (size_t)(p / 100.0 * (double)(sorted.size() - 1) + 0.5);
+        return sorted[i];
+    }
+
+    // power of 2 buckets of nanoseconds
+    static void histogram(const std::vector<double> &sorted) {
+        std::map<int, size_t> buckets;
+        size_t most = 0;
+        for (double v : sorted) {
+            int b = 0;
+            while (b < 40 && (double)(1ULL << (b + 1)) <= v) {
+                b++;
+            }
+            most = std::max(most, ++buckets[b]);
+        }
+        for (const auto &b : buckets) {
+            int width = (int)(50.0 * (double)b.second / (double)most + 0.5);
+            printf("  %10llu ns %10zu %s\n", 1ULL << b.first, b.second, std::string(width ? width : 1, '#').c_str());
+        }
+    }
+
+    const trace &trace_;
+    std::map<std::string, type_stats> types_;
+    size_t unmatched_ = 0;
+};
+
+}    // namespace
+
+int main(int argc, char **argv) {
+    if (argc != 2 || argv[1][0] == '-') {
+        fprintf(stderr, "usage: %s trace.txt\n", argv[0]);
+        return 2;
+    }
+    try {
+        trace t = read_trace(argv[1]);
+        report r(t);
+        for (const auto &events : t.threads) {
+            r.add_thread(events);
+        }
+        r.print();
+    }
+    catch (const std::exception &e) {
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}